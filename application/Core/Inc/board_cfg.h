@@ -66,6 +66,34 @@
 
 #define USB_DEBUG_PRINT 0
 
+// 诊断统计默认关闭，需要时编译打开：make PERF_TRACE=1 LATENCY_TRACE=1
+#ifndef PERF_TRACE_ENABLED
+#define PERF_TRACE_ENABLED                  0       // 主循环各阶段耗时统计（/api/perf-stats），0 关闭且没有任何开销
+#endif
+#define PERF_TRACE_SPIKE_THRESHOLD_US       200     // 单个阶段耗时超过该值时记录为尖峰
+#ifndef LATENCY_TRACE_ENABLED
+#define LATENCY_TRACE_ENABLED               0       // ADC按键状态翻转到USB报告发出的延迟统计（/api/latency-stats）
+#endif
+#define LATENCY_TRACE_TIMEOUT_US            100000  // 超过该时间仍未发出报告的按键事件不计入延迟统计
+#define MESSAGE_MAX_HANDLERS                4       // 每个消息最多订阅者数量
+#define MESSAGE_DEFERRED_QUEUE_SIZE         32      // 中断中发布的消息延迟队列长度，必须为2的幂
+
+// 输入驱动在手柄状态没有变化时强制发送报告的间隔 ms，0 表示只在状态变化时发送
+#define REPORT_KEEPALIVE_XINPUT_MS          0
+#define REPORT_KEEPALIVE_PS4_MS             5       // 部分游戏依赖DS4持续上报，计数器递增后强制发送
+#define REPORT_KEEPALIVE_PS5_MS             5
+#define REPORT_KEEPALIVE_SWITCH_MS          0
+#define REPORT_KEEPALIVE_DEFAULT_MS         0
+
+// 备份SRAM（4KB，复位后保持）分配
+#define BKPSRAM_PERF_TRACE_OFFSET           0x000   // 主循环耗时统计 3KB
+#define BKPSRAM_PERF_TRACE_SIZE             0xC00
+#define BKPSRAM_LATENCY_TRACE_OFFSET        0xC00   // 按键延迟统计 1KB
+#define BKPSRAM_LATENCY_TRACE_SIZE          0x400
+
+// DTCM（0x20000000，128KB，CPU零等待访问）中的热数据，链接脚本 .dtcm 段，启动时清零
+#define DTCM_DATA                           __attribute__((section(".dtcm"), aligned(4)))
+
 #if USB_DEBUG_PRINT
     #define USB_DBG(fmt, ...) printf("[USB] " fmt "\r\n", ##__VA_ARGS__)
     #define USB_ERR(fmt, ...) printf("[USB][ERROR] " fmt "\r\n", ##__VA_ARGS__)
@@ -76,7 +104,7 @@
 
 
 
-#define CONFIG_VERSION                      (uint32_t)0x00000a  //配置版本 三位版本号 0x aa bb cc
+#define CONFIG_VERSION                      (uint32_t)0x00000d  //配置版本 三位版本号 0x aa bb cc
 #define ADC_MAPPING_VERSION                 (uint32_t)0x000001  //ADC值映射表版本
 
 // 双槽地址偏移定义（相对于槽基地址的偏移）
@@ -85,6 +113,11 @@
 
 // 用户配置区固定地址（独立于槽，两个槽共享）
 #define CONFIG_ADDR                         0x90700000      // 用户配置区固定地址
+#define CONFIG_SAVE_QUIET_MS                2000            // 配置延迟写入：最后一次修改后静默该时间（ms），且没有按键按下时才写入Flash
+#define CONFIG_STORE_NUM_SECTORS            16              // 配置日志存储占用的扇区数（64KB），按环依次写入
+#define CONFIG_STORE_MAX_SECTIONS           24              // 配置日志存储最多的分区数（配置头 + 每个profile + 快捷键）
+#define CONFIG_STORE_RESERVED_SECTORS       1               // 保留给回收使用的空闲扇区数，普通写入不能占用
+#define CONFIG_STORE_GC_FREE_SECTORS        6               // 后台回收：空闲扇区少于该值时回收最旧的扇区
 
 // 动态地址获取函数声明（需要在相应的.c文件中实现）
 uint32_t get_current_slot_base_address(void);
@@ -97,6 +130,9 @@ uint32_t get_current_slot_base_address(void);
 #define WEB_RESOURCES_ADDR_STATIC           (0x90000000 + WEB_RESOURCES_OFFSET)       // 0x90100000
 #define ADC_VALUES_MAPPING_ADDR_STATIC      (0x90000000 + ADC_VALUES_MAPPING_OFFSET)  // 0x90280000
 
+#define ADC_CALIBRATION_JOURNAL_OFFSET      0x00010000      // 校准值追加日志相对ADC值映射表的偏移 +64KB（避开映射存储和默认映射镜像）
+#define ADC_CALIBRATION_JOURNAL_SIZE        0x00001000      // 校准值追加日志大小，一个扇区 4KB
+
 #define NUM_ADC_VALUES_MAPPING              8               // 最大8个映射 ADC按钮映射表用于值查找
 #define MAX_ADC_VALUES_LENGTH               40              // 每个映射最大40个值 ADC按钮映射表用于值查找
 #define MAX_NUM_MARKING_VALUE               100             // 每个step最大采集值个数
@@ -107,6 +143,38 @@ uint32_t get_current_slot_base_address(void);
 #define ULTRAFast_THRESHOLD_MAX             30             // 超快版本阈值最大值
 #define ULTRAFast_THRESHOLD_NORMAL          15             // 超快版本阈值一般值
 
+#define ADAPTIVE_DEBOUNCE_NOISE_SHIFT       6              // 自适应防抖：噪声滑动平均系数 1/2^N
+#define ADAPTIVE_DEBOUNCE_NOISE_MARGIN      3              // 自适应防抖：噪声幅度乘以该倍数仍小于触发距离时不需要防抖
+#define ADAPTIVE_DEBOUNCE_MAX_US            2000           // 自适应防抖：最长确认时间 us
+
+#define SOCD_DEPTH_HYSTERESIS               10             // 深度优先SOCD：两个方向行程深度相差超过该值（0.01mm）才切换
+
+#define NUM_DKS_POINTS                      4              // 多点触发（DKS）：每个按键的触发点数量
+#define DKS_RELEASE_HYSTERESIS              0.1f           // 多点触发：回弹越过触发点的迟滞距离（mm），多点触发不经过防抖，由该迟滞抑制噪声
+#define DKS_TAP_DURATION_US                 10000          // 多点触发：点按动作的保持时间 us
+
+#define NUM_MACROS                          4              // 宏：每个 profile 的宏数量
+#define NUM_MACRO_STEPS                     8              // 宏：每个宏的步骤数量
+#define MACRO_STEP_MAX_DURATION_MS          4000           // 宏：单步最长持续时间（ms），按DWT周期计时，不能超过周期计数回绕时间的一半（约4.4s）
+#define TURBO_MAX_RATE_HZ                   30             // 连发：最高频率（Hz）
+#define TURBO_DEFAULT_RATE_HZ               15             // 连发：默认频率（Hz）
+
+#define ADC_DRIFT_COMPENSATION_ENABLED      1              // 温漂补偿：ADC3注入组低频采样内部温度传感器，修正按键静止基准值的漂移
+#define ADC_DRIFT_SAMPLE_INTERVAL_MS        1000           // 温漂补偿：温度和静止基准值的采样间隔 ms
+#define ADC_DRIFT_TEMPERATURE_SHIFT         3              // 温漂补偿：温度滑动平均系数 1/2^N
+#define ADC_DRIFT_MODEL_WINDOW              600            // 温漂补偿：模型遗忘窗口（采样次数），更早的采样权重按指数衰减
+#define ADC_DRIFT_MIN_SAMPLES               30             // 温漂补偿：静止采样少于该次数时不修正
+#define ADC_DRIFT_MIN_TEMP_VARIANCE         1.0f           // 温漂补偿：温度方差正则项（℃²），温度变化不足时斜率收缩为0
+#define ADC_IDLE_DISTANCE                   0.3f           // 温漂补偿/基准值跟踪：行程在顶部该距离（mm）内且未触发时视为静止
+#define ADC_DRIFT_MAX_OFFSET_RATIO          0.1f           // 温漂补偿：最大偏移占完整行程ADC值差的比例
+
+#define ADC_BASELINE_TRACKING_ENABLED       1              // 基准值跟踪：自动校准模式下跟随释放按键的静止值平移校准映射，不需要完整按下
+#define ADC_BASELINE_SAMPLE_INTERVAL_MS     250            // 基准值跟踪：静止值采样间隔 ms
+#define ADC_BASELINE_WINDOW_SIZE            16             // 基准值跟踪：每个窗口的采样数，窗口取中位数
+#define ADC_BASELINE_NUM_WINDOWS            9              // 基准值跟踪：基准值取最近若干个窗口中位数的中位数
+#define ADC_BASELINE_MAX_SHIFT_RATIO        0.1f           // 基准值跟踪：基准值与校准值相差超过完整行程ADC值差的该比例时视为异常，不跟随
+#define ADC_BASELINE_SAVE_INTERVAL_MS       600000         // 基准值跟踪：合并写入Flash的最短间隔 ms（10分钟）
+
 
 #define NUM_PROFILES                        16
 #define NUM_ADC                             3               // 3个ADC
@@ -120,6 +188,10 @@ uint32_t get_current_slot_base_address(void);
 #define MIN_VALUE_DIFF_RATIO                0.8             // 最小值差值比例 按键动态校准的过程中，如果bottom - top的值差 不能小于原mapping的值差*MIN_VALUE_DIFF_RATIO
 
 #define READ_BTNS_INTERVAL                  50            // 检查按钮状态间隔 us
+#define ADC_DMA_PING_PONG                   1             // ADC DMA 双缓冲，半传输/传输完成中断各发布一帧，CPU读取的半区不会被DMA同时改写
+#ifndef ADC_BTNS_FIXED_POINT_ENGINE
+#define ADC_BTNS_FIXED_POINT_ENGINE         1             // ADC按键触发判断使用整数引擎（死区阈值预先换算为ADC值，触发值查行程距离->ADC值表），判断结果与浮点引擎逐值一致；0 使用浮点距离换算
+#endif
 #define DYNAMIC_CALIBRATION_INTERVAL        500000          // 动态校准间隔 500ms
 
 // ========== WebConfig模式ADC按键专用配置宏定义 ==========
@@ -131,6 +203,10 @@ uint32_t get_current_slot_base_address(void);
 
 #define NUM_GPIO_BUTTONS            4               //GPIO按钮数量
 #define GPIO_BUTTONS_DEBOUNCE       1000             //去抖动延迟(us)  1ms
+#define GPIO_BUTTONS_DEBOUNCE_EAGER 1               //立即防抖：边沿立即上报，之后 GPIO_BUTTONS_DEBOUNCE 时间内忽略抖动；0 为状态稳定 GPIO_BUTTONS_DEBOUNCE 后才确认
+#define GPIO_BUTTONS_EXTI_ENABLED   1               //GPIO按钮边沿中断：EXTI中断中用DWT周期记录边沿时间，主循环按真实边沿时间防抖
+#define GPIO_BUTTONS_EXTI_QUEUE_SIZE 32             //边沿队列长度，必须为2的幂
+#define GPIO_BUTTONS_EXTI_IRQ_PRIORITY 1            //EXTI中断优先级，低于ADC DMA
 
 #define FN_BUTTON_VIRTUAL_PIN       (1U << (NUM_ADC_BUTTONS + NUM_GPIO_BUTTONS - 1))  // FN 键虚拟引脚 最后一个GPIO按钮
 
@@ -0,0 +1,51 @@
+#ifndef __ADC_BASELINE_TRACKER_HPP__
+#define __ADC_BASELINE_TRACKER_HPP__
+
+#include <stdint.h>
+#include "board_cfg.h"
+
+static_assert(ADC_BASELINE_WINDOW_SIZE > 0 && ADC_BASELINE_NUM_WINDOWS > 0, "ADC baseline windows must not be empty");
+
+/**
+ * ADC按钮静止基准值跟踪
+ * 动态校准需要按键完整按下/释放的极值，很少按下的按键得不到校准；这里只使用释放按键的静止值。
+ *
+ * 静止值每 ADC_BASELINE_WINDOW_SIZE 个采样取一次中位数，基准值取最近 ADC_BASELINE_NUM_WINDOWS 个窗口中位数的中位数，
+ * 单个窗口内的轻触或干扰不会影响结果。采样保存的是ADC原始值，校准映射平移后不需要清空。
+ */
+class ADCBaselineTracker {
+public:
+    ADCBaselineTracker();
+
+    /**
+     * 加入一次静止采样
+     * @param buttonIndex 按钮索引
+     * @param value 静止时的ADC值
+     * @return 本次采样是否填满了一个窗口（基准值可能更新）
+     */
+    bool addSample(const uint8_t buttonIndex, const uint16_t value);
+
+    /**
+     * 获取按键的基准值
+     * @param buttonIndex 按钮索引
+     * @param baseline 输出 窗口中位数的中位数
+     * @return 是否已经有 ADC_BASELINE_NUM_WINDOWS 个窗口
+     */
+    bool getBaseline(const uint8_t buttonIndex, uint16_t& baseline) const;
+
+    // 清空所有按键的采样
+    void reset();
+
+private:
+    struct ButtonWindows {
+        uint16_t samples[ADC_BASELINE_WINDOW_SIZE];     // 当前窗口的采样
+        uint16_t medians[ADC_BASELINE_NUM_WINDOWS];     // 最近窗口的中位数，环形保存
+        uint8_t sampleCount;                            // 当前窗口的采样数
+        uint8_t medianIndex;                            // 下一个中位数的写入位置
+        uint8_t medianCount;                            // 有效中位数数量
+    };
+
+    ButtonWindows windows_[NUM_ADC_BUTTONS];
+};
+
+#endif // __ADC_BASELINE_TRACKER_HPP__
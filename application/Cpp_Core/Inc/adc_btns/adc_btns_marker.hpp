@@ -51,7 +51,7 @@ class ADCBtnsMarker {
 
         void stepFinish(const ADCChannelStats* const stats);
         void markingFinish();
-        std::function<void(const void*)> messageHandler;
+        static void onSamplingStatsComplete(void* context, const void* data);
 };
 
 #define ADC_BTNS_MARKER ADCBtnsMarker::getInstance()
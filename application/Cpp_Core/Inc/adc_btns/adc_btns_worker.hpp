@@ -13,9 +13,17 @@
 #include "micro_timer.hpp"
 #include "board_cfg.h"
 #include "adc_btns/adc_debounce_filter.hpp"
+#include "adc_btns/adc_drift_compensator.hpp"
+#include "adc_btns/adc_baseline_tracker.hpp"
 
 #define NUM_MAPPING_INDEX_WINDOW_SIZE 32
 
+// ADC值->行程距离查找表：ADC_DISTANCE_LUT_SIZE 个区间，距离以 Q12 定点（mm）存储
+#define ADC_DISTANCE_LUT_SIZE 256
+#define ADC_DISTANCE_LUT_FRAC_BITS 12
+// 多点触发点按动作的保持时间（DWT 周期数）
+#define DKS_TAP_DURATION_CYCLES (DKS_TAP_DURATION_US * ADC_DEBOUNCE_CYCLES_PER_US)
+
 // 外部ADC按键配置结构（用于WebConfig等模式）
 struct ExternalADCButtonConfig {
     float pressAccuracy;      // 按下精度（mm）
@@ -60,6 +68,44 @@ class ADCBtnsWorker {
         
         uint32_t read();
 
+        /**
+         * @brief 处理一帧ADC采样值（与ADC采集解耦，read() 内部也走这里）
+         * 采样值来源可以是DMA缓冲区，也可以是离线录制的采样轨迹，便于在板外回放验证触发逻辑
+         * @param values 按virtualPin排序的ADC值，长度必须为NUM_ADC_BUTTONS
+         * @return 启用按键的虚拟引脚掩码
+         */
+        uint32_t processSamples(const uint32_t* const values);
+
+        /**
+         * @brief 按键行程深度，按virtualPin索引，单位0.01mm，0为完全释放
+         * 每次扫描只更新 setTravelOutputMask 设置的按键，复用触发判断时的行程换算
+         */
+        inline const uint16_t* getTravel() const {
+            return hot.travel;
+        }
+
+        /**
+         * @brief 按键最近一次按下的序号，按virtualPin索引，序号越大按下越晚，0 表示没有按下过
+         * 每次按下加1，不随时间回绕（每秒按下1000次也要约50天才用完32位），按住多久都能直接比较先后
+         * 在确认按下的同一次扫描中更新，多点触发的目标在输出时更新
+         */
+        inline const uint32_t* getPressSequence() const {
+            return hot.pressSequence;
+        }
+
+        // 行程总长度，单位0.01mm
+        inline uint16_t getMaxTravel() const {
+            return maxTravel;
+        }
+
+        /**
+         * @brief 设置需要输出行程深度的按键
+         * @param mask virtualPin掩码
+         */
+        inline void setTravelOutputMask(const uint32_t mask) {
+            travelOutputMask = mask;
+        }
+
         ADCBtnsError deinit();
         ADCBtnsWorker();
         ~ADCBtnsWorker();
@@ -67,6 +113,25 @@ class ADCBtnsWorker {
         // 动态校准
         void dynamicCalibration();
 
+        /**
+         * @brief 温漂补偿，按 ADC_DRIFT_SAMPLE_INTERVAL_MS 低频调用
+         * 采样内部温度，用静止按键的基准值更新每个按键的温漂模型，
+         * 预测的偏移整体平移到预先换算的映射和阈值上，扫描热路径不变
+         */
+        void compensateDrift();
+
+        /**
+         * @brief 静止基准值跟踪，按 ADC_BASELINE_SAMPLE_INTERVAL_MS 低频调用（只在自动校准模式下生效）
+         * 释放按键的静止值按窗口中位数跟踪，校准映射逐步平移到基准值，
+         * 修改过的校准值至少间隔 ADC_BASELINE_SAVE_INTERVAL_MS、在所有按键释放时合并写入Flash一次
+         */
+        void trackBaseline();
+
+        /**
+         * @brief 立即写入基准值跟踪修改过、尚未写入Flash的校准值，重启或切换模式前调用
+         */
+        void flushBaselineValues();
+
         /**
          * @brief 设置防抖过滤器配置
          * @param config 防抖配置
@@ -91,6 +156,22 @@ class ADCBtnsWorker {
          */
         uint8_t getButtonDebounceState(uint8_t buttonIndex) const;
 
+        /**
+         * @brief 获取指定按钮在某个ADC值处的行程距离 (调试用)
+         * @param buttonIndex 按钮索引
+         * @param adcValue ADC值
+         * @param scanMapping true 时遍历映射表计算（生成查找表的方法），false 时查表（扫描时的方法）
+         * @return 行程距离（mm），0为完全按下
+         */
+        float getButtonDistance(uint8_t buttonIndex, uint16_t adcValue, bool scanMapping = false);
+
+        /**
+         * @brief 获取指定按钮自适应防抖使用的噪声幅度 (调试用)
+         * @param buttonIndex 按钮索引
+         * @return 相邻采样差值的滑动平均（Q4，ADC值 × 16）
+         */
+        uint16_t getButtonNoiseLevel(uint8_t buttonIndex) const;
+
     private:
 
         // 校准保存延迟常量 (毫秒)
@@ -98,7 +179,7 @@ class ADCBtnsWorker {
         static constexpr uint32_t MIN_CALIBRATION_INTERVAL_MS = 1000; // 最小校准间隔1秒
 
         // 按钮状态枚举
-        enum class ButtonState {
+        enum class ButtonState : uint8_t {
             RELEASED,       // 完全释放状态
             RELEASING,      // 正在释放过程中
             PRESSED,        // 完全按下状态
@@ -114,35 +195,83 @@ class ADCBtnsWorker {
             RELEASE_COMPLETE// 释放完成
         };
 
-        // 按钮结构体
+        /**
+         * 扫描热路径状态
+         * 每帧都会读写的按键字段按字段连续存放（SoA），整体放在DTCM（.dtcm段），
+         * 以 ADCBtn::index 索引；映射表、查找表和校准窗口等冷数据仍在 ADCBtn 中
+         */
+        struct HotState {
+            uint16_t lastAdcValue[NUM_ADC_BUTTONS];         // 上次ADC值
+            uint16_t limitValue[NUM_ADC_BUTTONS];           // 限制值
+            uint16_t triggerValue[NUM_ADC_BUTTONS];         // 触发值
+            uint16_t noiseQ4[NUM_ADC_BUTTONS];              // 相邻采样来回跳动的差值的滑动平均（Q4），自适应防抖使用
+            int16_t lastDiff[NUM_ADC_BUTTONS];              // 上次相邻采样差值，自适应防抖区分噪声和按键移动
+            #if ADC_BTNS_FIXED_POINT_ENGINE
+            uint16_t topDeadzoneValue[NUM_ADC_BUTTONS];     // 顶部死区边界ADC值，小于该值不触发按下
+            uint16_t bottomDeadzoneValue[NUM_ADC_BUTTONS];  // 底部死区边界ADC值，大于该值不触发释放
+            uint16_t halfwayValue[NUM_ADC_BUTTONS];         // 中点ADC值，大于等于该值使用高精度释放
+            #endif
+            float lastTravelDistance[NUM_ADC_BUTTONS];      // 上次行程距离（mm）
+            ButtonState state[NUM_ADC_BUTTONS];             // 按钮状态
+            bool initCompleted[NUM_ADC_BUTTONS];            // 初始化完成标志
+            uint16_t travel[NUM_ADC_BUTTONS];               // 行程深度（0.01mm），按virtualPin索引
+            uint32_t pressSequence[NUM_ADC_BUTTONS];        // 最近一次按下的序号，按virtualPin索引
+            uint16_t dksPressValue[NUM_ADC_BUTTONS][NUM_DKS_POINTS];     // 多点触发：大于等于该ADC值时下压越过触发点
+            uint16_t dksReleaseValue[NUM_ADC_BUTTONS][NUM_DKS_POINTS];   // 多点触发：小于等于该ADC值时回弹越过触发点
+            uint8_t dksPointCount[NUM_ADC_BUTTONS];         // 多点触发：有效触发点数量，0 表示使用快速触发
+            uint8_t dksCrossedMask[NUM_ADC_BUTTONS];        // 多点触发：当前已下压越过的触发点
+        };
+
+        // 按钮结构体（冷数据）
         struct ADCBtn {
+            uint8_t index;       // 按钮索引，对应 HotState 中的位置
             uint8_t virtualPin;  // 虚拟引脚
             uint16_t valueMapping[MAX_ADC_VALUES_LENGTH];  // 当前使用的校准后映射值
             uint16_t calibratedMapping[MAX_ADC_VALUES_LENGTH];      // 根据校准值生成的完整映射
-            ButtonState state;  // 按钮状态
-            bool initCompleted;  // 初始化完成标志
 
             // 新的基于距离和ADC值的字段
-            float lastTravelDistance = 0.0f;    // 上次行程距离（mm）
-            uint16_t lastAdcValue = 0;           // 上次ADC值
             float pressAccuracyMm = 0.0f;        // 按下精度（mm）
             float releaseAccuracyMm = 0.0f;      // 释放精度（mm）
             float highPrecisionReleaseAccuracyMm = 0.0f; // 高精度释放精度（mm）
             float topDeadzoneMm = 0.0f;          // 顶部死区（mm）
             float bottomDeadzoneMm = 0.0f;       // 底部死区（mm）
             float halfwayDistanceMm = 0.0f;      // 中点距离（mm），用于高精度判断
-            uint16_t triggerValue = 0;            // 触发值
             bool needCalibration = false;
             bool needSaveCalibration = false;          // 需要保存校准值到存储
             uint32_t lastCalibrationTime = 0;         // 上次校准时间
             uint32_t lastSaveTime = 0;                // 上次保存时间
-            RingBufferSlidingWindow<uint16_t> topValueWindow{NUM_MAPPING_INDEX_WINDOW_SIZE};  // 最小值滑动窗口
-            RingBufferSlidingWindow<uint16_t> bottomValueWindow{NUM_MAPPING_INDEX_WINDOW_SIZE};   // 最大值滑动窗口
-            uint16_t limitValue = 0;  // 限制值
+            RingBufferSlidingWindow<uint16_t, NUM_MAPPING_INDEX_WINDOW_SIZE> topValueWindow;  // 最小值滑动窗口
+            RingBufferSlidingWindow<uint16_t, NUM_MAPPING_INDEX_WINDOW_SIZE> bottomValueWindow;   // 最大值滑动窗口
+
+            // ADC值->行程距离查找表，按 (adcValue - lutBaseValue) >> lutShift 索引，节点间线性插值
+            uint16_t distanceLut[ADC_DISTANCE_LUT_SIZE + 1];
+            uint16_t lutBaseValue = 0;   // 查找表起点ADC值（完全释放位置）
+            uint16_t lutTopValue = 0;    // 查找表终点ADC值（完全按下位置）
+            uint8_t lutShift = 0;        // 每个查找表区间覆盖 2^lutShift 个ADC值
+
+            // 行程距离->ADC值查找表（换算触发值），按 distanceQ >> valueLutShift 索引，存放相对 lutTopValue 的ADC下降量，节点间线性插值
+            uint16_t valueLut[ADC_DISTANCE_LUT_SIZE + 1];
+            uint8_t valueLutShift = 0;   // 每个查找表区间覆盖 2^valueLutShift 个Q12距离单位
+            int32_t topSlopeQ16 = 0;     // 越过完全按下位置时外推的斜率：每个Q12距离单位的ADC变化量（Q16）
+            int32_t baseSlopeQ16 = 0;    // 越过完全释放位置时外推的斜率
+            #if ADC_BTNS_FIXED_POINT_ENGINE
+            int32_t pressAccuracyQ = 0;                  // 按下精度（Q12定点mm）
+            int32_t releaseAccuracyQ = 0;                // 释放精度（Q12定点mm）
+            int32_t highPrecisionReleaseAccuracyQ = 0;   // 高精度释放精度（Q12定点mm）
+            #endif
+
+            // 多点触发配置，触发点按行程从浅到深排列
+            float dksDistanceMm[NUM_DKS_POINTS];         // 触发点行程（mm，自顶部算起）
+            uint8_t dksVirtualPin[NUM_DKS_POINTS];       // 触发点目标虚拟引脚
+            DKSAction dksPressAction[NUM_DKS_POINTS];    // 下压越过触发点时的动作
+            DKSAction dksReleaseAction[NUM_DKS_POINTS];  // 回弹越过触发点时的动作
+            uint32_t dksHeldMask = 0;                    // 该按键保持按下的目标虚拟引脚
+
+            int32_t driftOffset = 0;     // 已平移到映射和阈值上的温漂偏移（ADC值），映射重新生成时清零
         };
 
         // 获取按钮事件
-        ButtonEvent getButtonEvent(ADCBtn* btn, const uint16_t currentValue, const uint8_t buttonIndex);
+        ButtonEvent getButtonEvent(ADCBtn* btn, const uint16_t currentValue);
         // 处理状态转换
         void handleButtonState(ADCBtn* btn, const ButtonEvent event);
 
@@ -150,11 +279,52 @@ class ADCBtnsWorker {
 
         // 新的基于距离和ADC值换算的核心方法
         float getDistanceByValue(ADCBtn* btn, const uint16_t adcValue);
+        // 查表得到行程距离（Q12定点mm）
+        int32_t getDistanceQByValue(const ADCBtn* btn, const uint16_t adcValue) const;
+        // 更新按键的行程深度输出
+        void updateTravel(ADCBtn* btn, const uint16_t adcValue);
+        // 遍历映射表计算行程距离，只在生成查找表时使用
+        float calcDistanceByValue(ADCBtn* btn, const uint16_t adcValue);
+        // 在映射表上插值计算行程距离对应的ADC值，只在生成查找表时使用
+        float calcValueByDistance(ADCBtn* btn, const float targetDistance);
+        // 根据当前映射生成ADC值->行程距离、行程距离->ADC值查找表
+        void buildDistanceLut(ADCBtn* btn);
+        // 查表得到行程距离（Q12定点mm）对应的ADC值
+        uint16_t getValueByDistanceQ(const ADCBtn* btn, const int32_t distanceQ) const;
+
+        #if ADC_BTNS_FIXED_POINT_ENGINE
+        // 根据当前映射和死区配置生成整数引擎的距离阈值
+        void buildTriggerThresholds(ADCBtn* btn);
+        // 查找行程距离满足条件的最小ADC值
+        uint32_t findValueByDistance(ADCBtn* btn, const float distanceMm, const bool inclusive);
+        #endif
         uint16_t getValueByDistance(ADCBtn* btn, const uint16_t baseAdcValue, const float distanceMm);
+
+        // 多点触发
+        void loadDksConfig(ADCBtn* btn, const DKSProfile* dks);
+        void buildDksThresholds(ADCBtn* btn);
+        void updateDks(ADCBtn* btn, const uint16_t currentValue);
+        void applyDksAction(ADCBtn* btn, const DKSAction action, const uint8_t target);
+        void updateDksOutput();
+        void resetDks();
         float getCurrentPressAccuracy(ADCBtn* btn, const float currentDistance);
         float getCurrentReleaseAccuracy(ADCBtn* btn, const float currentDistance);
         void updateLimitValue(ADCBtn* btn, const uint16_t currentValue);
+
+        // 自适应防抖
+        void updateScanPeriod(const uint32_t nowCycles);
+        void updateNoiseLevel(ADCBtn* btn, const uint16_t lastValue, const uint16_t currentValue);
+        uint32_t getAdaptiveDebounceWindow(const ADCBtn* btn) const;
         void resetLimitValue(ADCBtn* btn, const uint16_t currentValue);
+
+        // 温漂补偿：把映射和所有预先换算的阈值平移到新的偏移
+        void applyDriftOffset(ADCBtn* btn, const int32_t offset);
+        // 按键是否静止：未触发，且行程在顶部 ADC_IDLE_DISTANCE 内
+        bool isButtonIdle(const ADCBtn* btn) const;
+        // 基准值跟踪：校准映射整体平移，当前使用的映射和阈值同步平移
+        void shiftBaseline(ADCBtn* btn, const int32_t shift);
+        // 基准值跟踪：合并写入修改过的校准值
+        void saveBaselineValues();
         
         // 校准保存相关方法
         void saveCalibrationValues();
@@ -169,14 +339,34 @@ class ADCBtnsWorker {
         void generateCalibratedMapping(ADCBtn* btn, uint16_t topValue, uint16_t bottomValue);
 
         const ADCValuesMapping* mapping = nullptr;  // 映射表指针
-        ADCBtn* buttonPtrs[NUM_ADC_BUTTONS];        // 按钮指针数组
+        ADCBtn* buttonPtrs[NUM_ADC_BUTTONS];        // 按钮指针数组（冷数据）
+        static HotState hot;                        // 扫描热路径状态，位于DTCM
         uint32_t virtualPinMask = 0x0;              // 虚拟引脚掩码
         bool buttonTriggerStatusChanged = false;    // 按钮触发状态是否改变
         uint16_t minValueDiff;                      // 最小值差值
         uint32_t enabledKeysMask = 0x0;             // 启用按键掩码
+        uint32_t travelOutputMask = 0x0;            // 需要输出行程深度的按键掩码
+        uint16_t maxTravel = 0;                     // 行程总长度 0.01mm
+
+        // 多点触发输出
+        uint32_t dksOutputMask = 0x0;               // 多点触发产生的虚拟引脚掩码
+        uint32_t dksTapMask = 0x0;                  // 点按中的目标虚拟引脚
+        uint32_t dksTapStartCycles[32];             // 点按开始时间（DWT 周期计数），按目标虚拟引脚索引
+        uint32_t pressSequence = 0;                 // 按下序号计数，Snap Tap 比较按下先后
+        bool dksChanged = false;                    // 本次扫描多点触发输出是否需要重新计算
         
         // 防抖过滤器
         ADCDebounceFilter debounceFilter_;
+        int32_t scanPeriodCycles = READ_BTNS_INTERVAL * ADC_DEBOUNCE_CYCLES_PER_US;  // 扫描周期滑动平均（DWT周期），自适应防抖使用
+        uint32_t lastScanCycles = 0;                // 上一次扫描时间（DWT周期）
+
+        // 温漂补偿
+        ADCDriftCompensator driftCompensator_;
+
+        // 基准值跟踪
+        ADCBaselineTracker baselineTracker_;
+        uint32_t baselineDirtyMask = 0x0;           // 校准值已平移、尚未写入Flash的按键
+        uint32_t lastBaselineSaveTime = 0;          // 上次写入校准值的时间 ms
 
         // 动态校准相关函数
 };
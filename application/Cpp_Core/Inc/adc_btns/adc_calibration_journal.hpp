@@ -0,0 +1,91 @@
+#ifndef __ADC_CALIBRATION_JOURNAL_HPP__
+#define __ADC_CALIBRATION_JOURNAL_HPP__
+
+#include <stdint.h>
+#include "board_cfg.h"
+#include "qspi-w25q64.h"
+
+/**
+ * 校准值修改记录，16字节，一次页编程写入，不跨页
+ * 记录中的映射索引对应日志基准存储中的索引，映射增删都会整体写入存储并清空日志
+ */
+struct ADCCalibrationRecord {
+    uint8_t mappingIndex;       // 映射索引
+    uint8_t buttonIndex;        // 按钮索引
+    uint8_t flags;              // bit0: 自动校准值
+    uint8_t reserved[5];        // 保留，写入0
+    uint16_t topValue;          // 完全释放时的值
+    uint16_t bottomValue;       // 完全按下时的值
+    uint32_t crc;               // 前面字段的CRC32，掉电写入不完整的记录校验失败后跳过
+};
+
+#define ADC_CALIBRATION_RECORD_FLAG_AUTO    0x01
+
+/**
+ * ADC校准值追加日志
+ * ADCManager 修改单个按键的校准值时，不再重写整个映射存储（擦除扇区后整体编程），
+ * 而是在映射存储区内独立的一个扇区追加一条记录（一次页编程，不擦除）。
+ *
+ * 扇区布局：头部（魔数、版本、基准存储的CRC32、头部校验）之后是连续的记录，未写入的记录保持擦除后的 0xFF。
+ * 上电时映射存储按原样读出，头部的基准CRC与存储一致时按顺序回放记录；
+ * 不一致说明存储在日志之后被整体写入过（或写入日志前掉电），日志中的记录已经包含在存储里，直接丢弃。
+ * 扇区写满后由 ADCManager 整体写入存储并清空日志（压缩）。
+ */
+class ADCCalibrationJournal {
+public:
+    // 回放记录的回调，context 为调用方传入的上下文
+    typedef void (*ReplayHandler)(void* context, const ADCCalibrationRecord& record);
+
+    ADCCalibrationJournal();
+
+    /**
+     * 读取日志扇区并回放记录
+     * @param address 日志扇区的Flash地址（QSPI地址，扇区对齐）
+     * @param baseCrc 当前映射存储的CRC32
+     * @param handler 每条有效记录的回调
+     * @param context 回调上下文
+     * @return 日志是否有效，无效时调用方应调用 reset 清空日志
+     */
+    bool load(const uint32_t address, const uint32_t baseCrc, ReplayHandler handler, void* context);
+
+    /**
+     * 擦除日志扇区并写入新的头部，映射存储整体写入Flash之后调用
+     * @param baseCrc 新写入的映射存储的CRC32
+     * @return QSPI_W25Qxx_OK 或 QSPI 错误码
+     */
+    int8_t reset(const uint32_t baseCrc);
+
+    /**
+     * 追加一条记录
+     * @param record 记录，reserved 和 crc 字段由日志填写
+     * @return QSPI_W25Qxx_OK 或 QSPI 错误码，日志已满或无效时返回 W25Qxx_ERROR_TRANSMIT
+     */
+    int8_t append(const ADCCalibrationRecord& record);
+
+    // 日志是否已满（或尚未初始化），需要整体写入存储
+    inline bool isFull() const {
+        return !valid_ || writeOffset_ + sizeof(ADCCalibrationRecord) > ADC_CALIBRATION_JOURNAL_SIZE;
+    }
+
+    // 已写入的记录数
+    inline uint16_t getRecordCount() const {
+        return valid_ ? (writeOffset_ - sizeof(Header)) / sizeof(ADCCalibrationRecord) : 0;
+    }
+
+private:
+    struct Header {
+        uint32_t magic;
+        uint32_t version;       // ADC_MAPPING_VERSION，存储结构变化后旧日志失效
+        uint32_t baseCrc;       // 日志基于的映射存储的CRC32
+        uint32_t headerCrc;     // 前三个字段的CRC32
+    };
+
+    static uint32_t calculateCrc(const ADCCalibrationRecord& record);
+    static bool isErased(const ADCCalibrationRecord& record);
+
+    uint32_t address_;
+    uint32_t writeOffset_;      // 下一条记录相对扇区起始的偏移
+    bool valid_;
+};
+
+#endif // __ADC_CALIBRATION_JOURNAL_HPP__
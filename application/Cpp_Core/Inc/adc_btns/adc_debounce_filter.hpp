@@ -4,18 +4,29 @@
 #include <stdint.h>
 #include "board_cfg.h"
 
+// 防抖计数器位数，所有按键的计数器按位切片保存在 ADC_DEBOUNCE_COUNTER_BITS 个32位字中
+#define ADC_DEBOUNCE_COUNTER_BITS       5
+#define ADC_DEBOUNCE_COUNTER_MAX        ((1U << ADC_DEBOUNCE_COUNTER_BITS) - 1)
+// 自适应模式的时间单位为DWT周期，CYCCNT按2^32回绕，差值计算不受回绕影响
+#define ADC_DEBOUNCE_CYCLES_PER_US      (SYSTEM_CLOCK_FREQ / 1000000UL)
+
+static_assert(ULTRAFast_THRESHOLD_MAX <= ADC_DEBOUNCE_COUNTER_MAX, "ULTRAFast_THRESHOLD_MAX exceeds debounce counter range");
+static_assert(NUM_ADC_BUTTONS <= 32, "ADC debounce lanes must fit in a 32-bit word");
+
 /**
  * ADC按钮防抖过滤器类 - UltraFast版本
  * 专门用于ADC按钮的防抖处理，使用超快算法
+ * 每个按键占一个位（lane），一次扫描中所有按键的防抖只需要若干次32位逻辑运算
  */
 class ADCDebounceFilter {
 public:
     // 防抖配置结构
     struct Config {
         uint8_t ultrafastThreshold;    // 超快版本的计数阈值
+        bool adaptive;                 // 自适应模式：按时间确认，每个按钮的确认时间由 setButtonWindow 设置
         
         // 默认配置
-        Config() : ultrafastThreshold(ULTRAFast_THRESHOLD_MAX) {}  // 3次采样
+        Config() : ultrafastThreshold(ULTRAFast_THRESHOLD_MAX), adaptive(false) {}  // 3次采样
     };
 
     /**
@@ -30,17 +41,40 @@ public:
     ~ADCDebounceFilter() = default;
 
     /**
-     * 对单个ADC按钮进行超快防抖处理
-     * @param buttonIndex ADC按钮索引 (0 到 NUM_ADC_BUTTONS-1)
-     * @param currentState 当前按钮状态 (true=按下, false=释放)
-     * @return 经过防抖处理的按钮状态
+     * 对一次扫描中需要确认状态变化的ADC按钮进行超快防抖处理
+     * 与逐个按键的状态机逐次等价：只有 activeMask 中的按键参与本次采样，其他按键的状态保持不变
+     * @param inputMask 当前按钮状态掩码 (1=按下, 0=释放)
+     * @param activeMask 本次参与防抖的按钮掩码
+     * @return activeMask 中稳定状态与当前状态一致（已确认）的按钮掩码
      */
-    bool filterUltraFastSingle(uint8_t buttonIndex, bool currentState);
+    uint32_t filter(uint32_t inputMask, uint32_t activeMask);
+
+    /**
+     * 自适应模式：按时间确认状态变化
+     * 候选状态从第一次出现起连续作为候选、持续达到该按钮的确认时间后才更新稳定状态，确认时间为0时立即确认；
+     * 不在 activeMask 中的按钮本次输入与稳定状态一致，未完成的计时作废，孤立的噪声尖峰不会跨扫描累计
+     * @param inputMask 当前按钮状态掩码 (1=按下, 0=释放)
+     * @param activeMask 本次参与防抖的按钮掩码
+     * @param nowCycles 当前时间（DWT周期）
+     * @return activeMask 中稳定状态与当前状态一致（已确认）的按钮掩码
+     */
+    uint32_t filterAdaptive(uint32_t inputMask, uint32_t activeMask, uint32_t nowCycles);
+
+    /**
+     * 设置自适应模式下按钮的确认时间
+     * @param buttonIndex 按钮索引
+     * @param windowCycles 确认时间（DWT周期），必须小于 2^31
+     */
+    inline void setButtonWindow(uint8_t buttonIndex, uint32_t windowCycles) {
+        if (buttonIndex < NUM_ADC_BUTTONS) {
+            windowCycles_[buttonIndex] = windowCycles;
+        }
+    }
 
     /**
      * 对整个ADC按钮掩码进行防抖处理
      * @param currentMask 当前按钮状态掩码
-     * @param currentTime 当前时间戳(微秒) - 未使用，保持接口兼容性
+     * @param currentTime 当前时间（DWT周期） - 仅自适应模式使用
      * @return 经过防抖处理的按钮状态掩码
      */
     uint32_t filterMask(uint32_t currentMask, uint32_t currentTime);
@@ -87,15 +121,17 @@ public:
 private:
     Config config_;                                     // 防抖配置
 
-    // 超快版本的状态变量 (每个按钮独立)
-    struct UltraFastButtonState {
-        bool lastStableValue;           // 最后稳定状态 (true=按下, false=释放)
-        bool lastInputValue;            // 最后输入状态 (true=按下, false=释放)
-        uint8_t sameValueCounter;       // 相同值计数器
-        
-        UltraFastButtonState() : lastStableValue(false), lastInputValue(false), sameValueCounter(0) {}
-    };
-    UltraFastButtonState ultrafastStates_[NUM_ADC_BUTTONS];
+    // 计数器是否大于等于阈值（按位切片比较）
+    uint32_t counterReachedThreshold() const;
+
+    // 超快版本的状态变量，每个按钮占一个位
+    uint32_t lastStableMask_;                           // 最后稳定状态 (1=按下, 0=释放)
+    uint32_t lastInputMask_;                            // 最后输入状态 (1=按下, 0=释放)
+    uint32_t counterPlanes_[ADC_DEBOUNCE_COUNTER_BITS]; // 相同值计数器，counterPlanes_[k] 为所有按钮计数器的第k位
+
+    // 自适应模式的状态变量
+    uint32_t inputSince_[NUM_ADC_BUTTONS];              // 当前输入状态第一次出现的时间（DWT周期）
+    uint32_t windowCycles_[NUM_ADC_BUTTONS];            // 确认时间（DWT周期）
 };
 
 #endif // __ADC_DEBOUNCE_FILTER_HPP__ 
\ No newline at end of file
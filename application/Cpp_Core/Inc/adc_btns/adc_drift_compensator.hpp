@@ -0,0 +1,93 @@
+#ifndef __ADC_DRIFT_COMPENSATOR_HPP__
+#define __ADC_DRIFT_COMPENSATOR_HPP__
+
+#include <stdint.h>
+#include "board_cfg.h"
+
+/**
+ * ADC按钮温漂补偿
+ * 霍尔传感器的静止输出随板温漂移，动态校准只在按键完全按下/释放的过程中更新映射，长时间不动的按键得不到修正。
+ *
+ * 温度：ADC3 注入组（不占用按键的规则组和DMA）低频转换内部温度传感器和 VREFINT，
+ *       用 VREFINT 换算实际 VDDA 后按出厂校准值计算温度，再做滑动平均。
+ * 模型：每个按键对静止时的基准值偏差 r（当前值 - 校准映射的完全释放值）和温度 T 做指数遗忘的加权线性回归 r = a + b·T，
+ *       温度方差不足时斜率收缩为0，退化为基准值的滑动平均；按键被按住时仍按当前温度给出偏移。
+ * 偏移由 ADCBtnsWorker 整体平移到预先换算的映射和阈值上，扫描热路径不变。
+ *
+ * 模型部分不依赖硬件，可以在板外用录制的温度/基准值轨迹回放验证。
+ */
+class ADCDriftCompensator {
+public:
+    ADCDriftCompensator();
+
+    /**
+     * 读取上一次注入组转换的结果并启动下一次转换，按 ADC_DRIFT_SAMPLE_INTERVAL_MS 低频调用
+     * 注入转换在两次调用之间完成，调用方不需要等待
+     * @return 本次是否得到新的温度
+     */
+    bool sampleTemperature();
+
+    /**
+     * 更新温度滑动平均
+     * @param celsius 温度（℃）
+     */
+    void updateTemperature(const float celsius);
+
+    inline bool hasTemperature() const {
+        return temperatureValid_;
+    }
+
+    // 滑动平均后的温度（℃）
+    inline float getTemperature() const {
+        return temperature_;
+    }
+
+    /**
+     * 加入一次静止采样
+     * @param buttonIndex 按钮索引
+     * @param celsius 采样时的温度（℃）
+     * @param residual 静止值与校准映射完全释放值的差（ADC值）
+     */
+    void addIdleSample(const uint8_t buttonIndex, const float celsius, const int32_t residual);
+
+    /**
+     * 按模型预测指定温度下的基准值偏移
+     * @param buttonIndex 按钮索引
+     * @param celsius 温度（℃）
+     * @return 偏移（ADC值），静止采样不足时为0
+     */
+    int32_t getOffset(const uint8_t buttonIndex, const float celsius) const;
+
+    /**
+     * 校准映射的完全释放值平移后，同步平移模型中的基准值偏差，预测的偏移随之减少 delta
+     * @param buttonIndex 按钮索引
+     * @param delta 完全释放值的平移量（ADC值）
+     */
+    void shiftBaseline(const uint8_t buttonIndex, const int32_t delta);
+
+    /**
+     * 清空按键的模型，按键映射重新生成（校准值变化）后调用
+     * @param buttonIndex 按钮索引
+     */
+    void resetButton(const uint8_t buttonIndex);
+
+    // 清空所有按键的模型，温度滑动平均保留
+    void reset();
+
+private:
+    // 每个按键的指数加权统计量
+    struct ButtonModel {
+        uint32_t samples;       // 静止采样次数，超过 ADC_DRIFT_MODEL_WINDOW 后按固定权重遗忘
+        float meanT;            // 温度加权均值
+        float meanR;            // 基准值偏差加权均值
+        float varT;             // 温度加权方差
+        float covTR;            // 温度与基准值偏差的加权协方差
+    };
+
+    ButtonModel models_[NUM_ADC_BUTTONS];
+    float temperature_;
+    bool temperatureValid_;
+    bool conversionStarted_;
+};
+
+#endif // __ADC_DRIFT_COMPENSATOR_HPP__
@@ -16,6 +16,7 @@
 #include "message_center.hpp"
 #include <algorithm>  // 为 std::sort
 #include "board_cfg.h"
+#include "adc_btns/adc_calibration_journal.hpp"
 
 struct ADCValuesMapping {
     char id[16];                                            // 映射ID
@@ -67,6 +68,46 @@ struct ADCChannelStats {
     std::vector<uint32_t> diffValues;
 };
 
+// 单个ADC的最大通道数
+#define NUM_ADC_MAX_CHANNELS    std::max({NUM_ADC1_BUTTONS, NUM_ADC2_BUTTONS, NUM_ADC3_BUTTONS})
+// 每个DMA缓冲区包含的帧数，双缓冲时半传输中断发布第0帧，传输完成中断发布第1帧
+#if ADC_DMA_PING_PONG
+#define ADC_DMA_FRAMES              2
+#else
+#define ADC_DMA_FRAMES              1
+#endif
+// DMA缓冲区按D-Cache行（32字节）对齐并补齐长度，保证按地址无效化缓存时不影响相邻数据
+#define ADC_DMA_BUFFER_LENGTH(n)    ((((n) * ADC_DMA_FRAMES * sizeof(uint32_t) + 31) / 32) * 32 / sizeof(uint32_t))
+// 帧间隔抖动直方图桶数 bin0: <1us, binN: [2^(N-1), 2^N) us，最后一个桶包含更大的抖动
+#define ADC_FRAME_JITTER_HISTOGRAM_BINS 8
+
+/**
+ * @brief ADC帧快照
+ * DMA转换完成中断写入（单生产者），主循环读取（单消费者）
+ * sequence 为奇数表示正在写入，读取前后序号不一致则重读
+ */
+struct ADCFrameSnapshot {
+    volatile uint32_t sequence;
+    uint32_t values[NUM_ADC_MAX_CHANNELS];
+};
+
+/**
+ * @brief 每个ADC的帧统计，时间单位为DWT周期
+ * 在DMA中断中更新，用于观察负载下实际的采样率和抖动
+ */
+struct ADCFrameStats {
+    uint32_t frames;                // DMA发布的帧数
+    uint32_t intervals;             // 已统计的帧间隔数
+    uint32_t droppedFrames;         // 未被主循环读取就被新帧覆盖的帧数
+    uint32_t overrunErrors;         // ADC溢出错误次数
+    uint32_t lastTimestamp;         // 上一帧时间戳
+    uint32_t minPeriod;             // 最小帧间隔
+    uint32_t maxPeriod;             // 最大帧间隔
+    uint64_t totalPeriod;           // 帧间隔累计，用于计算均值
+    uint32_t emaPeriod;             // 帧间隔滑动均值，作为抖动基准
+    uint32_t jitterHistogram[ADC_FRAME_JITTER_HISTOGRAM_BINS];  // |帧间隔 - 滑动均值| 分布
+};
+
 struct ADCButtonValueInfo {
     uint8_t virtualPin;
     uint32_t* valuePtr;
@@ -122,8 +163,11 @@ class ADCManager {
         // 获取校准值
         ADCBtnsError getCalibrationValues(const char* mappingId, uint8_t buttonIndex, bool isAutoCalibration, uint16_t& topValue, uint16_t& bottomValue) const;
         
-        // 设置校准值
-        ADCBtnsError setCalibrationValues(const char* mappingId, uint8_t buttonIndex, bool isAutoCalibration, uint16_t topValue, uint16_t bottomValue);
+        // 设置校准值，写入Flash时追加一条校准日志记录；saveToFlash 为 false 时只更新内存中的存储，由 commitCalibrationValues 合并写入
+        ADCBtnsError setCalibrationValues(const char* mappingId, uint8_t buttonIndex, bool isAutoCalibration, uint16_t topValue, uint16_t bottomValue, bool saveToFlash = true);
+
+        // 把内存中修改过的校准值追加到校准日志
+        ADCBtnsError commitCalibrationValues();
 
         // 开始采样
         ADCBtnsError startADCSamping(bool enableSamplingRate = false, 
@@ -147,6 +191,61 @@ class ADCManager {
             return ADCBufferInfoList;
         }
 
+        /**
+         * @brief 读取新的ADC帧 按virtualPin排序
+         * 只写入自上次读取后有新帧的ADC对应的通道，其余通道保持调用方传入的值（通常为0）
+         * 每个新帧只会被读取一次
+         * @param values 输出 按virtualPin排序的ADC值，长度必须为NUM_ADC_BUTTONS
+         * @return 有新帧的ADC掩码 bit0: ADC1 bit1: ADC2 bit2: ADC3，0 表示没有新数据
+         */
+        uint8_t readFreshADCValues(uint32_t* const values);
+
+        /**
+         * @brief 是否有尚未读取的ADC帧
+         */
+        inline bool hasFreshADCFrame() const {
+            for(uint8_t i = 0; i < NUM_ADC; i++) {
+                if(frameSnapshots[i].sequence != lastFrameSequence[i]) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * @brief 处理ADC DMA半传输/传输完成中断，将DMA缓冲区中完成的帧发布为新的帧快照
+         * @param hadc ADC句柄
+         * @param frameIndex DMA缓冲区中的帧索引 0: 半传输 ADC_DMA_FRAMES - 1: 传输完成
+         */
+        void handleADCConvCplt(const ADC_HandleTypeDef* const hadc, const uint8_t frameIndex);
+
+        /**
+         * @brief 处理ADC错误中断，统计溢出错误
+         * @param hadc ADC句柄
+         */
+        void handleADCError(const ADC_HandleTypeDef* const hadc);
+
+        /**
+         * @brief 获取帧统计
+         * @param adcIndex ADC索引 0: ADC1 1: ADC2 2: ADC3
+         * @param stats 输出 统计快照
+         * @return 是否成功
+         */
+        bool getFrameStats(const uint8_t adcIndex, ADCFrameStats& stats) const;
+
+        /**
+         * @brief 获取ADC通道数
+         * @param adcIndex ADC索引
+         */
+        inline uint8_t getADCChannelCount(const uint8_t adcIndex) const {
+            return adcIndex < NUM_ADC ? adcBufferInfo[adcIndex].count : 0;
+        }
+
+        /**
+         * @brief 重置帧统计
+         */
+        void resetFrameStats();
+
         inline void ADCValuesTestPrint() {
             const std::array<ADCButtonValueInfo, NUM_ADC_BUTTONS>& adcValues = readADCValues();
 
@@ -167,32 +266,42 @@ class ADCManager {
         ~ADCManager();
 
         // ADC DMA 缓冲区必须保持静态
-        static __attribute__((section("._RAM_D1_Area"))) uint32_t ADC1_Values[NUM_ADC1_BUTTONS];
-        static __attribute__((section("._RAM_D1_Area"))) uint32_t ADC2_Values[NUM_ADC2_BUTTONS];
-        static __attribute__((section("._RAM_D3_Area"))) uint32_t ADC3_Values[NUM_ADC3_BUTTONS];
+        static __attribute__((section("._RAM_D1_Area"))) uint32_t ADC1_Values[ADC_DMA_BUFFER_LENGTH(NUM_ADC1_BUTTONS)];
+        static __attribute__((section("._RAM_D1_Area"))) uint32_t ADC2_Values[ADC_DMA_BUFFER_LENGTH(NUM_ADC2_BUTTONS)];
+        static __attribute__((section("._RAM_D3_Area"))) uint32_t ADC3_Values[ADC_DMA_BUFFER_LENGTH(NUM_ADC3_BUTTONS)];
         static uint32_t ADC_Values_Result[NUM_ADC_BUTTONS];
 
-        MessageHandler messageHandler;
-
         // 非静态成员变量
         ADCValuesMappingStore store;
+        ADCCalibrationJournal calibrationJournal;                       // 校准值追加日志
+        uint32_t pendingAutoCalibrationMask[NUM_ADC_VALUES_MAPPING];    // 只更新了内存、尚未写入Flash的自动校准值（按钮掩码）
+        uint32_t pendingManualCalibrationMask[NUM_ADC_VALUES_MAPPING];  // 只更新了内存、尚未写入Flash的手动校准值（按钮掩码）
         ADCBufferInfo adcBufferInfo[NUM_ADC];
         ADCChannelStats ADCButtonStats;
-        bool samplingRateEnabled;
+        volatile bool samplingRateEnabled;                              // 中断中读取
         uint32_t samplingCountMax;
         ADCIndexInfo samplingADCInfo;
 
-        void handleADCStats(ADC_HandleTypeDef *hadc);
+        void captureSample(const uint32_t value);
+        void handleADCStats();
+        static void onADCConvCplt(void* context, const void* data);
         int8_t saveStore();
+        ADCBtnsError appendCalibrationRecord(const uint8_t mappingIndex, const uint8_t buttonIndex, const bool isAutoCalibration);
+        static void onCalibrationRecord(void* context, const ADCCalibrationRecord& record);
         ADCIndexInfo findADCButtonVirtualPin(uint8_t virtualPin);
 
         // 添加 const 修饰符
         ADCBtnsError loadMapping(const char* const id) const;
-        void handleADCConvCplt(const ADC_HandleTypeDef* const hadc);
         void handleADCStats(const ADCChannelStats* const stats) const;
+        int8_t getADCIndex(const ADC_HandleTypeDef* const hadc) const;
+        void updateFrameStats(ADCFrameStats& stats, const uint32_t timestamp);
 
         // 成员变量
         std::array<ADCButtonValueInfo, NUM_ADC_BUTTONS> ADCBufferInfoList;
+        ADCFrameSnapshot frameSnapshots[NUM_ADC];                      // 每个ADC的最新帧快照
+        uint32_t lastFrameSequence[NUM_ADC];                           // 每个ADC上次读取的帧序号
+        ADCFrameStats frameStats[NUM_ADC];                             // 每个ADC的帧统计
+        uint8_t frameIndexMap[NUM_ADC][NUM_ADC_MAX_CHANNELS];          // DMA通道 -> virtualPin排序后的索引
         std::string defaultMappingId;
         ADCValuesMapping* currentMapping;
         bool isStarted;
@@ -1,34 +1,34 @@
 #ifndef RING_BUFFER_SLIDING_WINDOW_HPP
 #define RING_BUFFER_SLIDING_WINDOW_HPP
 
-#include <vector>
 #include <cstdint>
-#include <numeric>
-#include <stdexcept>
-#include <functional>
+#include <cstddef>
+#include <type_traits>
 #include "board_cfg.h"
 
-template<typename T>
+/**
+ * 固定容量的滑动窗口
+ * 数据保存在对象内部的定长数组中，不使用堆内存；
+ * 平均值由滑动求和维护，最小/最大值由单调队列维护，push 和各查询都是均摊 O(1)
+ * @tparam T 数据类型
+ * @tparam N 窗口大小
+ */
+template<typename T, size_t N>
 class RingBufferSlidingWindow {
+    static_assert(N > 0, "RingBufferSlidingWindow size must be greater than 0");
+
+    // 求和类型：整数用 int64_t，浮点用 double
+    using SumType = typename std::conditional<std::is_floating_point<T>::value, double, int64_t>::type;
+
 public:
-    // 构造函数，设置窗口大小
-    explicit RingBufferSlidingWindow(size_t windowSize)
-        : windowSize(windowSize)
-        , currentIndex(0)
-        , validDataCount(0)
-        , cachedAverage(T())
-    {
-        buffer.resize(windowSize);
+    RingBufferSlidingWindow() {
+        clear();
     }
 
     // 添加新数据
     void push(T value, size_t multiplier = 1) {
         for (size_t i = 0; i < multiplier; ++i) {
-            buffer[currentIndex] = value;
-            currentIndex = (currentIndex + 1) % windowSize;
-            if (validDataCount < windowSize) {
-                validDataCount++;
-            }
+            pushOne(value);
         }
         // 更新缓存的平均值
         updateCachedAverage();
@@ -39,8 +39,7 @@ public:
         if (validDataCount == 0) {
             cachedAverage = T();
         } else {
-            int64_t sum = std::accumulate(buffer.begin(), buffer.begin() + validDataCount, int64_t(0));
-            cachedAverage = static_cast<T>(sum / validDataCount);
+            cachedAverage = static_cast<T>(sum / (SumType)validDataCount);
         }
     }
 
@@ -55,7 +54,7 @@ public:
             return T();
         }
 
-        size_t index = (currentIndex - 1 - backSteps + windowSize) % windowSize;
+        size_t index = (currentIndex + N - 1 - backSteps) % N;
         return buffer[index];
     }
 
@@ -68,8 +67,8 @@ public:
         if (validDataCount == 0) {
             return T();
         }
-        
-        return *std::min_element(buffer.begin(), buffer.begin() + validDataCount);
+
+        return buffer[minQueue.front()];
     }
 
     T getMaxValue() const {
@@ -77,19 +76,22 @@ public:
             return T();
         }
 
-        return *std::max_element(buffer.begin(), buffer.begin() + validDataCount);
+        return buffer[maxQueue.front()];
     }
 
     // 清空缓冲区并重置索引
     void clear() {
-        std::fill(buffer.begin(), buffer.end(), T());
         currentIndex = 0;
         validDataCount = 0;
+        sum = SumType();
+        cachedAverage = T();
+        minQueue.clear();
+        maxQueue.clear();
     }
 
     // 获取窗口大小
     size_t getWindowSize() const {
-        return windowSize;
+        return N;
     }
 
     // 获取当前缓冲区中的有效数据量
@@ -121,17 +123,15 @@ public:
         ViolationPoint() : index(0), value(T()), prevValue(T()), found(false) {}
     };
 
-    // 修改 RuleChecker 定义，加入索引参数
-    using RuleChecker = std::function<bool(T current, T previous, size_t currentIndex)>;
-
     /**
      * 从末尾开始回溯检查违规点
-     * @param rule 规则检查函数，接收当前值、前一个值和当前索引，返回是否违规
+     * @param rule 规则检查函数 bool(T current, T previous, size_t currentIndex)，返回是否违规
      * @return 返回违规点信息
      */
-    ViolationPoint findViolationPoint(RuleChecker rule) const {
+    template<typename RuleChecker>
+    ViolationPoint findViolationPoint(RuleChecker&& rule) const {
         ViolationPoint result;
-        
+
         // 如果数据不足2个，无法比较
         if (validDataCount < 2) {
             return result;
@@ -156,11 +156,75 @@ public:
     }
 
 private:
-    std::vector<T> buffer;        // 数据缓冲区
-    size_t windowSize;            // 窗口大小
+    // 单调队列中保存数据在缓冲区中的位置
+    using IndexType = typename std::conditional<(N <= 256), uint8_t, uint16_t>::type;
+    static_assert(N <= 65536, "RingBufferSlidingWindow size too large");
+
+    // 定长环形双端队列，容量为窗口大小，队列中的位置按写入先后排列
+    class MonotonicQueue {
+    public:
+        void clear() {
+            head = 0;
+            count = 0;
+        }
+
+        IndexType front() const {
+            return entries[head];
+        }
+
+        /**
+         * 队尾弹出所有不优于新值的元素后入队
+         * @param buffer 数据缓冲区
+         * @param index 新数据的位置
+         * @param dominates 新值是否使队尾元素不再可能成为极值
+         */
+        template<typename Dominates>
+        void push(const T* buffer, IndexType index, Dominates dominates) {
+            while (count > 0 && dominates(buffer[index], buffer[entries[(head + count - 1) % N]])) {
+                count--;
+            }
+            entries[(head + count) % N] = index;
+            count++;
+        }
+
+        // 位置 index 上的数据即将被覆盖，如果它在队首则出队
+        void expire(IndexType index) {
+            if (count > 0 && entries[head] == index) {
+                head = (head + 1) % N;
+                count--;
+            }
+        }
+
+    private:
+        IndexType entries[N];
+        size_t head;
+        size_t count;
+    };
+
+    void pushOne(T value) {
+        // 窗口已满时移除被覆盖的最旧数据
+        if (validDataCount == N) {
+            sum -= (SumType)buffer[currentIndex];
+            minQueue.expire((IndexType)currentIndex);
+            maxQueue.expire((IndexType)currentIndex);
+        } else {
+            validDataCount++;
+        }
+        buffer[currentIndex] = value;
+        sum += (SumType)value;
+
+        minQueue.push(buffer, (IndexType)currentIndex, [](T v, T back) { return v <= back; });
+        maxQueue.push(buffer, (IndexType)currentIndex, [](T v, T back) { return v >= back; });
+        currentIndex = (currentIndex + 1) % N;
+    }
+
+    T buffer[N];                  // 数据缓冲区
     size_t currentIndex;          // 当前索引位置
     size_t validDataCount;        // 有效数据量
+    SumType sum;                  // 窗口内数据和
     T cachedAverage;              // 缓存的平均值
+    MonotonicQueue minQueue;      // 单调递增队列，队首为最小值
+    MonotonicQueue maxQueue;      // 单调递减队列，队首为最大值
 };
 
 #endif // RING_BUFFER_SLIDING_WINDOW_HPP
@@ -37,6 +37,7 @@ typedef struct
     uint32_t keyButtonA1;
     uint32_t keyButtonA2;
     uint32_t keyButtonFn; 
+    int8_t analogSources[NUM_ANALOG_OUTPUTS];   // 驱动每个模拟输出（AnalogOutput）的ADC按键virtualPin，-1 表示不使用
 } KeysConfig;
 
 typedef struct
@@ -68,6 +69,42 @@ typedef struct __attribute__((packed))
     float_t    bottomDeadzone;         // 底部死区 单位毫米
 } RapidTriggerProfile;
 
+typedef struct __attribute__((packed))
+{
+    float_t    distance;               // 触发点行程 单位毫米（自顶部算起）
+    int8_t     virtualPin;             // 触发的虚拟引脚，按 keyMapping 映射为手柄按键，-1 表示不使用
+    uint8_t    pressAction;            // 下压越过触发点时的动作 DKSAction
+    uint8_t    releaseAction;          // 回弹越过触发点时的动作 DKSAction
+} DKSActuationPoint;
+
+typedef struct __attribute__((packed))
+{
+    bool               enabled;        // 启用后该按键不再使用快速触发，由触发点产生输出
+    DKSActuationPoint  points[NUM_DKS_POINTS];
+} DKSProfile;
+
+typedef struct __attribute__((packed))
+{
+    uint8_t    mode;                   // TurboMode
+    uint8_t    rate;                   // 连发频率 Hz，1 ~ TURBO_MAX_RATE_HZ
+} TurboConfig;
+
+typedef struct __attribute__((packed))
+{
+    uint16_t   buttons;                // 该步按下的手柄按键 GAMEPAD_MASK_B1 ~ GAMEPAD_MASK_A4
+    uint8_t    dpad;                   // 该步按下的方向 GAMEPAD_MASK_UP ~ GAMEPAD_MASK_RIGHT
+    uint16_t   duration;               // 持续时间 ms，1 ~ MACRO_STEP_MAX_DURATION_MS
+} MacroStep;
+
+typedef struct __attribute__((packed))
+{
+    bool       enabled;
+    int8_t     virtualPin;             // 触发键虚拟引脚，-1 表示不使用；触发键不再产生自身映射的按键
+    uint8_t    mode;                   // MacroMode
+    uint8_t    numSteps;               // 有效步骤数 0 ~ NUM_MACRO_STEPS
+    MacroStep  steps[NUM_MACRO_STEPS];
+} MacroConfig;
+
 typedef struct
 {
     bool isAllBtnsConfiguring;
@@ -104,6 +141,9 @@ typedef struct
     KeysConfig keysConfig;
     TriggerConfigs triggerConfigs;
     LEDProfile ledsConfigs;
+    DKSProfile dksConfigs[NUM_ADC_BUTTONS];     // 多点触发配置，按按键索引
+    TurboConfig turboConfigs[NUM_ADC_BUTTONS + NUM_GPIO_BUTTONS];  // 连发/锁定配置，按虚拟引脚索引
+    MacroConfig macros[NUM_MACROS];             // 宏
 } GamepadProfile;
 
 typedef struct
@@ -123,6 +163,7 @@ namespace ConfigUtils {
     bool save(Config& config);
     bool reset(Config& config);
     bool fromStorage(Config& config);
+    bool collectGarbageStep();
     void makeDefaultProfile(GamepadProfile& profile, const char* id, bool isEnabled);
 };
 
@@ -0,0 +1,140 @@
+#ifndef __CONFIG_STORE_HPP__
+#define __CONFIG_STORE_HPP__
+
+#include <stdint.h>
+#include "board_cfg.h"
+#include "qspi-w25q64.h"
+
+/**
+ * @brief 日志结构的配置存储
+ *
+ * 配置按分区（一个 profile、配置头、快捷键等）保存为带序号和CRC的记录，追加写入由 CONFIG_STORE_NUM_SECTORS 个扇区组成的环，
+ * 只写入内容变化的分区，写入耗时与修改的大小成正比，不需要擦除；扇区按环依次使用，擦除次数均匀分布在所有扇区上。
+ *
+ * 扇区：扇区头（魔数、扇区序号、CRC）之后是连续的记录，未写入部分保持 0xFF。
+ * 记录：记录头（魔数、分区、长度、全局序号、数据CRC、记录头CRC）+ 数据（按4字节对齐）。
+ *       先写记录头再写数据，掉电中断的记录CRC校验失败，该分区仍然使用上一条记录，保证单个分区的写入是原子的。
+ * 上电：扫描所有扇区，每个分区取序号最大的有效记录建立索引。
+ *       分区只能在末尾增加字段：比分区短的记录（旧版本写入）只覆盖分区的前一部分，其余部分保留调用方的内容。
+ * 回收：空闲扇区不足时，把最旧扇区中仍是最新的记录复制到环的头部（新序号），全部复制完成后才擦除该扇区。
+ *       回收中掉电只会多出重复的记录，上电后按序号取新的一条。
+ */
+class ConfigStore {
+public:
+    // 分区：配置结构体中的一段连续字节
+    struct Section {
+        uint32_t offset;
+        uint32_t size;
+    };
+
+    /**
+     * @param address 存储区起始地址（QSPI地址，扇区对齐），占用 CONFIG_STORE_NUM_SECTORS 个扇区
+     * @param sections 分区表，数量不超过 CONFIG_STORE_MAX_SECTIONS，每个分区加上记录头不超过一个扇区
+     * @param numSections 分区数量
+     */
+    ConfigStore(const uint32_t address, const Section* sections, const uint8_t numSections);
+
+    /**
+     * 扫描所有扇区，建立每个分区最新记录的索引
+     * @return 是否每个分区都有有效记录
+     */
+    bool mount();
+
+    // 每个分区是否都有有效记录
+    bool isComplete() const;
+
+    /**
+     * 按索引读取每个分区的最新记录
+     * @param image 配置结构体
+     * @return 是否成功，存储不完整时返回 false
+     */
+    bool load(uint8_t* image) const;
+
+    /**
+     * 只为内容变化的分区追加记录，空间不足时先回收最旧的扇区
+     * 存储不完整（尚未格式化）时整体格式化；失败时Flash上保留每个分区最后写入成功的记录
+     * @param image 配置结构体
+     * @return 是否成功
+     */
+    bool save(const uint8_t* image);
+
+    /**
+     * 擦除所有日志扇区，从 firstSector 开始写入所有分区
+     * 没有扇区头的扇区（旧版整块配置）不擦除，在环使用到时再擦除
+     * @param image 配置结构体
+     * @param firstSector 第一个写入的扇区
+     * @return 是否成功
+     */
+    bool format(const uint8_t* image, const uint8_t firstSector);
+
+    /**
+     * 后台回收的一步，每次调用最多执行一个Flash操作，主循环中反复调用直到返回 false：
+     * 空闲扇区少于 CONFIG_STORE_GC_FREE_SECTORS 时回收最旧的扇区，每步复制其中一条有效记录，最后发出非阻塞擦除；
+     * 否则发出下一个要打开的扇区的非阻塞擦除。擦除期间每步只查询一次忙标志
+     * @return 回收或擦除是否还在进行，false 表示没有需要做的工作
+     */
+    bool collectGarbageStep();
+
+    inline uint8_t getFreeSectors() const {
+        return CONFIG_STORE_NUM_SECTORS - usedCount_;
+    }
+
+    // 本次上电以来擦除的扇区数
+    inline uint32_t getEraseCount() const {
+        return eraseCount_;
+    }
+
+private:
+    struct IndexEntry {
+        uint32_t sequence;      // 记录序号
+        uint32_t crc;           // 数据CRC32，与内存中的分区比较判断是否变化
+        uint16_t offset;        // 记录在扇区内的偏移
+        uint16_t length;        // 记录的数据长度，旧版本写入的记录可能比分区短
+        uint8_t sector;         // 记录所在扇区
+        bool valid;
+    };
+
+    inline uint32_t sectorAddress(const uint8_t sector) const {
+        return address_ + (uint32_t)sector * W25Qxx_SECTOR_SIZE;
+    }
+
+    uint16_t scanSector(const uint8_t sector, uint32_t& maxSequence);
+    int8_t nextFreeSector() const;
+    uint32_t liveBytes(const uint8_t sector) const;
+    int8_t pickVictim() const;
+    bool isSectorBlank(const uint8_t sector) const;
+    bool eraseSector(const uint8_t sector);
+    bool openNextSector();
+    bool prepareNextSector();
+    bool reserveSpace(const uint32_t recordSize, const uint8_t minFreeSectors);
+    bool writeRecord(const uint8_t section, const uint8_t* data, const uint32_t crc);
+    bool copyRecord(const uint8_t section);
+    bool compactSector(const int8_t victim);
+    void updateTail();
+    void resetState();
+    bool eraseNextSector();
+    bool startErase(const uint8_t sector, const bool compacting);
+    void finishErase(const bool ok);
+    void waitErase();
+
+    const uint32_t address_;
+    const Section* const sections_;
+    const uint8_t numSections_;
+
+    IndexEntry index_[CONFIG_STORE_MAX_SECTIONS];
+    uint32_t sectorSequences_[CONFIG_STORE_NUM_SECTORS];    // 0 表示空闲（没有有效扇区头）
+    uint32_t nextSequence_;                                 // 下一条记录的序号
+    uint32_t nextSectorSequence_;                           // 下一个打开扇区的序号
+    uint32_t eraseCount_;
+    uint32_t blankMask_;                                    // 已确认擦除的空闲扇区，打开时不需要再检查
+    uint16_t writeOffset_;                                  // 头部扇区的写入位置（扇区内偏移）
+    int8_t head_;                                           // 正在写入的扇区，-1 表示没有
+    int8_t tail_;                                           // 最旧（序号最小）的扇区，-1 表示没有
+    uint8_t usedCount_;
+    uint8_t startSector_;                                   // 环为空时第一个打开的扇区
+    int8_t gcVictim_;                                       // 后台回收中的扇区，-1 表示没有
+    int8_t erasing_;                                        // 非阻塞擦除中的扇区，-1 表示没有
+    bool erasingVictim_;                                    // 擦除的是回收完成的扇区，完成后释放
+};
+
+#endif // __CONFIG_STORE_HPP__
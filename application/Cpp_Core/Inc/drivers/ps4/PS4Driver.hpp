@@ -8,6 +8,7 @@
 
 #include "gpdriver.hpp"
 #include "drivers/ps4/PS4Descriptors.hpp"
+#include "drivers/shared/report_scheduler.hpp"
 
 // Authentication
 #include "drivers/ps4/PS4Auth.hpp"
@@ -54,13 +55,12 @@ public:
     virtual USBListener * get_usb_auth_listener();
     bool getAuthSent() { return authsent;}
 private:
-    uint8_t last_report[CFG_TUD_ENDPOINT0_SIZE] = { };
+    ReportScheduler reportScheduler;
     uint8_t last_report_counter;
     uint16_t last_axis_counter;
     PS4Report ps4Report;
     TouchpadData touchpadData;
     PSSensorData sensorData;
-    uint32_t last_report_timer;
     PS4Auth * ps4AuthDriver;
     PS4AuthData * ps4AuthData;      // PS4 Authentication Data
     uint8_t cur_nonce_chunk;            // PS4 Encryption Nonce Chunk (Max 19)
@@ -8,6 +8,7 @@
 
 #include "gpdriver.hpp"
 #include "drivers/psclassic/PSClassicDescriptors.hpp"
+#include "drivers/shared/report_scheduler.hpp"
 
 class PSClassicDriver : public GPDriver {
 public:
@@ -26,7 +27,7 @@ public:
     virtual uint16_t GetJoystickMidValue();
     virtual USBListener * get_usb_auth_listener() { return nullptr; }
 private:
-    uint8_t last_report[CFG_TUD_ENDPOINT0_SIZE] = { };
+    ReportScheduler reportScheduler;
     PSClassicReport psClassicReport;
 };
 
@@ -0,0 +1,80 @@
+#ifndef _REPORT_SCHEDULER_H_
+#define _REPORT_SCHEDULER_H_
+
+#include <stdint.h>
+#include "enums.hpp"
+#include "board_cfg.h"
+#include "gamepad/GamepadState.hpp"
+
+// 本次是否需要发送报告
+enum class ReportSendReason : uint8_t {
+    NONE = 0,       // 状态没有变化，不需要发送
+    CHANGED,        // 手柄状态有变化（或强制发送）
+    KEEPALIVE,      // 状态没有变化，但距离上次发送已超过保活间隔
+};
+
+/**
+ * @brief 输入驱动共用的报告发送调度
+ *
+ * 用手柄状态（GamepadState）和上次成功发送时的状态比较得到脏标记，不再对整个报告做 memcmp；
+ * 只要状态和已发送的状态不同就保持待发送，tud_hid_ready() / 端点空闲后的第一次 process 立即发出。
+ * 状态没有变化时按输入模式的保活间隔（REPORT_KEEPALIVE_*_MS，0 表示不保活）强制发送。
+ *
+ * 用法：
+ *   reason = scheduler.poll(gamepad->state, HAL_GetTick());
+ *   if(reason != ReportSendReason::NONE) { 生成报告; 发送成功后调用 scheduler.reportSent(gamepad->state, now); }
+ */
+class ReportScheduler {
+    public:
+        ReportScheduler();
+
+        // 使用输入模式对应的保活间隔初始化，并强制发送第一份报告
+        void setup(const InputMode inputMode);
+        void setup(const uint32_t keepaliveMs);
+
+        /**
+         * @brief 判断本次是否需要发送报告
+         * @param state 当前手柄状态
+         * @param now 当前时间 ms
+         */
+        inline ReportSendReason poll(const GamepadState& state, const uint32_t now) const {
+            if(forceSend || isStateChanged(state)) {
+                return ReportSendReason::CHANGED;
+            }
+            if(keepaliveMs != 0 && now - lastSentTime >= keepaliveMs) {
+                return ReportSendReason::KEEPALIVE;
+            }
+            return ReportSendReason::NONE;
+        }
+
+        // 报告已被USB协议栈接受
+        void reportSent(const GamepadState& state, const uint32_t now);
+
+        // 下一次 poll 强制发送（如主机重新枚举后）
+        inline void invalidate() {
+            forceSend = true;
+        }
+
+        // 输入模式对应的保活间隔 ms
+        static uint32_t getKeepaliveMs(const InputMode inputMode);
+
+    private:
+        inline bool isStateChanged(const GamepadState& state) const {
+            return ((state.dpad ^ lastState.dpad)
+                | (state.buttons ^ lastState.buttons)
+                | (state.aux ^ lastState.aux)
+                | (state.lx ^ lastState.lx)
+                | (state.ly ^ lastState.ly)
+                | (state.rx ^ lastState.rx)
+                | (state.ry ^ lastState.ry)
+                | (state.lt ^ lastState.lt)
+                | (state.rt ^ lastState.rt)) != 0;
+        }
+
+        GamepadState lastState;     // 上次成功发送时的手柄状态
+        uint32_t lastSentTime;      // 上次成功发送的时间 ms
+        uint32_t keepaliveMs;       // 保活间隔 ms，0 表示不保活
+        bool forceSend;
+};
+
+#endif // _REPORT_SCHEDULER_H_
@@ -10,6 +10,7 @@
 #include "gamepad.hpp"
 #include "drivers/switch/SwitchDescriptors.hpp"
 #include "drivers/shared/driverhelper.hpp"
+#include "drivers/shared/report_scheduler.hpp"
 
 class SwitchDriver : public GPDriver {
 public:
@@ -28,7 +29,7 @@ public:
     virtual uint16_t GetJoystickMidValue();
     virtual USBListener * get_usb_auth_listener() { return nullptr; }
 private:
-    uint8_t last_report[CFG_TUD_ENDPOINT0_SIZE] = { };
+    ReportScheduler reportScheduler;
     SwitchReport switchReport;
 };
 
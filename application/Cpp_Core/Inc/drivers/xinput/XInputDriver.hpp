@@ -12,6 +12,7 @@
 #include "drivers/xinput/XInputAuth.hpp"
 #include "drivers/xinput/XInputDescriptors.hpp"
 #include "drivers/shared/driverhelper.hpp"
+#include "drivers/shared/report_scheduler.hpp"
 #include "storagemanager.hpp"
 #include "gamepad.hpp"
 
@@ -35,7 +36,7 @@ public:
     virtual USBListener * get_usb_auth_listener();
     bool getAuthEnabled();
 private:
-    uint8_t last_report[CFG_TUD_ENDPOINT0_SIZE] = { };
+    ReportScheduler reportScheduler;
     XInputReport xinputReport;
     XInputAuth * xAuthDriver;
     uint8_t featureBuffer[XINPUT_OUT_SIZE];
@@ -56,6 +56,8 @@ enum SOCDMode
     SOCD_MODE_SECOND_INPUT_PRIORITY,
     SOCD_MODE_FIRST_INPUT_PRIORITY,
     SOCD_MODE_BYPASS,
+    SOCD_MODE_DEEPER_PRIORITY,          // 行程更深的方向优先
+    SOCD_MODE_SNAP_TAP,                 // 最后按下的方向优先，松开后另一方向立即恢复
     NUM_SOCD_MODES,
 };
 
@@ -127,7 +129,53 @@ enum ADCButtonDebounceAlgorithm
     NONE = 0,
     NORMAL = 1,
     MAX = 2,
+    ADAPTIVE = 3,       // 按时间确认，确认窗口根据每个按键实测的噪声自动调整
     NUM_ADC_BUTTON_DEBOUNCE_ALGORITHMS,
 };
 
+// 多点触发（DKS）触发点动作
+enum DKSAction
+{
+    DKS_ACTION_NONE = 0,        // 无动作
+    DKS_ACTION_PRESS = 1,       // 按下目标并保持，直到 DKS_ACTION_RELEASE
+    DKS_ACTION_RELEASE = 2,     // 释放目标
+    DKS_ACTION_TAP = 3,         // 点按目标，保持 DKS_TAP_DURATION_US 后自动释放
+    NUM_DKS_ACTIONS,
+};
+
+// 按键连发/锁定模式
+enum TurboMode
+{
+    TURBO_MODE_OFF = 0,         // 无
+    TURBO_MODE_HOLD = 1,        // 按住时按设定频率连发
+    TURBO_MODE_LATCH = 2,       // 按一次锁定为按下，再按一次释放
+    TURBO_MODE_LATCH_TURBO = 3, // 按一次开始连发，再按一次停止
+    NUM_TURBO_MODES,
+};
+
+// 宏播放模式
+enum MacroMode
+{
+    MACRO_MODE_ONCE = 0,        // 按下触发键播放一次
+    MACRO_MODE_HOLD = 1,        // 按住触发键循环播放，松开立即停止
+    MACRO_MODE_TOGGLE = 2,      // 按一次开始循环播放，再按一次停止
+    NUM_MACRO_MODES,
+};
+
+// 模拟输出：可由任意ADC按键的行程驱动的扳机和摇杆半轴
+enum AnalogOutput
+{
+    ANALOG_OUTPUT_LT = 0,
+    ANALOG_OUTPUT_RT,
+    ANALOG_OUTPUT_LX_NEGATIVE,      // 左摇杆 左
+    ANALOG_OUTPUT_LX_POSITIVE,      // 左摇杆 右
+    ANALOG_OUTPUT_LY_NEGATIVE,      // 左摇杆 上
+    ANALOG_OUTPUT_LY_POSITIVE,      // 左摇杆 下
+    ANALOG_OUTPUT_RX_NEGATIVE,
+    ANALOG_OUTPUT_RX_POSITIVE,
+    ANALOG_OUTPUT_RY_NEGATIVE,
+    ANALOG_OUTPUT_RY_POSITIVE,
+    NUM_ANALOG_OUTPUTS,
+};
+
 #endif /* _NET_DRIVER_H_  */
\ No newline at end of file
@@ -5,18 +5,34 @@
 #include "enums.hpp"
 #include "config.hpp"
 #include "gamepad/GamepadState.hpp"
+#include "gamepad/GamepadMacros.hpp"
 #include "leds/leds_manager.hpp"
+#include "board_cfg.h"
 
-struct GamepadButtonMapping
+// 虚拟引脚掩码按字节查表，每个字节一张256项的表
+#define GAMEPAD_READ_LUT_BYTES      ((NUM_ADC_BUTTONS + NUM_GPIO_BUTTONS + 7) / 8)
+
+/**
+ * @brief 虚拟引脚掩码某个字节取值对应的手柄按键
+ * 一个字节内所有被按下的虚拟引脚映射到的 dpad/buttons/aux 按位或的结果
+ */
+struct GamepadReadLutEntry
 {
-    GamepadButtonMapping(Mask_t pm, Mask_t bm):
-        virtualPinMask(pm),
-        buttonMask(bm)
-    {}
+    uint32_t buttons;
+    uint16_t aux;
+    uint8_t dpad;
+};
 
-    Mask_t virtualPinMask;
-    const Mask_t buttonMask;
-    
+/**
+ * @brief 模拟输出的行程来源
+ * 输出值 = (行程深度 - start) * scale >> 16，饱和于该输出的最大值
+ */
+struct GamepadAnalogRoute
+{
+    int8_t virtualPin;      // 行程来源按键，-1 表示不使用
+    uint16_t start;         // 开始输出的行程深度 0.01mm（顶部死区）
+    uint16_t range;         // 从开始输出到满量程的行程 0.01mm
+    uint32_t scale;         // 满量程 << 16 / range
 };
 
 
@@ -83,25 +99,9 @@ class Gamepad {
         
         GamepadState rawState;
         GamepadState state;
-        GamepadButtonMapping *mapDpadUp;
-        GamepadButtonMapping *mapDpadDown;
-        GamepadButtonMapping *mapDpadLeft;
-        GamepadButtonMapping *mapDpadRight;
-        GamepadButtonMapping *mapButtonB1;
-        GamepadButtonMapping *mapButtonB2;
-        GamepadButtonMapping *mapButtonB3;
-        GamepadButtonMapping *mapButtonB4;
-        GamepadButtonMapping *mapButtonL1;
-        GamepadButtonMapping *mapButtonR1;
-        GamepadButtonMapping *mapButtonL2;
-        GamepadButtonMapping *mapButtonR2;
-        GamepadButtonMapping *mapButtonS1;
-        GamepadButtonMapping *mapButtonS2;
-        GamepadButtonMapping *mapButtonL3;
-        GamepadButtonMapping *mapButtonR3;
-        GamepadButtonMapping *mapButtonA1;
-        GamepadButtonMapping *mapButtonA2;
-        GamepadButtonMapping *mapButtonFn;
+
+        // keysConfig.analogSources 为 LT 或 RT 配置了行程来源，驱动发送 state.lt/rt 而不是按键的 0/0xFF
+        bool hasAnalogTriggers = false;
 
         // These are special to SOCD
         inline static const SOCDMode resolveSOCDMode(const GamepadProfile& options) {
@@ -110,6 +110,11 @@ class Gamepad {
                     STORAGE_MANAGER.getInputMode() == INPUT_MODE_PS4)) ?
                 SOCD_MODE_NEUTRAL : options.keysConfig.socdMode;
         };
+
+        // 使用按键行程深度和按下先后的SOCD模式
+        inline static bool isAnalogSOCDMode(const SOCDMode mode) {
+            return mode == SOCD_MODE_DEEPER_PRIORITY || mode == SOCD_MODE_SNAP_TAP;
+        };
     
     private:
         Gamepad();
@@ -117,7 +122,28 @@ class Gamepad {
         GamepadProfile* options;
 
         void process();
-        
+        void buildReadLut();
+        void buildAnalogRoutes();
+        void buildSOCDDirectionPins();
+        void updateTravelOutputMask();
+        void readAnalog();
+        void readSOCDInputs(Mask_t values);
+        uint16_t getAnalogOutput(const uint16_t* travel, const AnalogOutput output) const;
+
+        // 由 keysConfig 生成的查找表，readLut[i][v] 为虚拟引脚掩码第i个字节取值为v时的按键状态
+        GamepadReadLutEntry readLut[GAMEPAD_READ_LUT_BYTES][256];
+
+        // 由 keysConfig.analogSources 生成的模拟输出来源
+        GamepadAnalogRoute analogRoutes[NUM_ANALOG_OUTPUTS];
+        uint32_t analogSourceMask = 0;      // 作为模拟输出来源的按键virtualPin掩码
+
+        // 模拟SOCD模式：上下左右四个方向的按键virtualPin掩码和本次扫描的输入
+        Mask_t socdDirectionPins[4];
+        SOCDAnalogInputs socdInputs;
+        SOCDAnalogState socdState;      // 模拟SOCD模式：上一次扫描每个轴的胜出方向，切换配置或SOCD模式时清空
+
+        // 由 turboConfigs 和 macros 生成的连发/锁定和宏引擎
+        GamepadMacroEngine macroEngine;
 
 };
 
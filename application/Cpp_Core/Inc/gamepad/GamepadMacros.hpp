@@ -0,0 +1,97 @@
+#ifndef __GAMEPAD_MACROS_HPP__
+#define __GAMEPAD_MACROS_HPP__
+
+#include <stdint.h>
+#include "config.hpp"
+#include "types.hpp"
+#include "board_cfg.h"
+
+#define GAMEPAD_MACRO_NUM_PINS          (NUM_ADC_BUTTONS + NUM_GPIO_BUTTONS)
+// 时间单位为DWT周期，CYCCNT按2^32回绕，差值计算不受回绕影响
+#define GAMEPAD_MACRO_CYCLES_PER_MS     (SYSTEM_CLOCK_FREQ / 1000UL)
+
+static_assert(GAMEPAD_MACRO_NUM_PINS <= 32, "turbo lanes must fit in a 32-bit mask");
+static_assert((uint64_t)MACRO_STEP_MAX_DURATION_MS * GAMEPAD_MACRO_CYCLES_PER_MS < 0x80000000ULL, "macro step must be shorter than half the cycle counter period");
+
+/**
+ * 连发/锁定和宏引擎，位于 Gamepad::read 的按键映射和 Gamepad::process 之间
+ *
+ * 连发/锁定作用在虚拟引脚上（与 triggerConfigs 一样按按键配置），结果再经过 keysConfig 映射：
+ *   - 锁定：按下沿翻转锁定状态，锁定期间该引脚保持按下
+ *   - 连发：引脚按下（或锁定）期间按半周期交替输出，开始时立即输出按下
+ * 宏由触发键启动，按步骤输出手柄按键和方向，叠加在映射结果上后统一经过 SOCD/四向等处理；触发键本身不再映射。
+ *
+ * 配置在 setup 时编译为每个引脚的半周期表和每个宏的步骤表（DWT周期），每次扫描只比较到期时间，
+ * 开销上限为 按下的连发引脚数 + NUM_MACROS，时间精度为一次扫描。
+ * 不访问硬件，时间戳由调用方传入，可以在板外验证。
+ */
+class GamepadMacroEngine {
+public:
+    GamepadMacroEngine();
+
+    /**
+     * 根据 profile 生成连发半周期表和宏步骤表，并清除运行状态
+     * @param profile 当前 profile
+     */
+    void setup(const GamepadProfile& profile);
+
+    // 清除锁定、连发相位和正在播放的宏
+    void reset();
+
+    /**
+     * 处理一次扫描的虚拟引脚：应用锁定和连发，推进宏
+     * @param pins 虚拟引脚掩码
+     * @param now 扫描时间（DWT周期）
+     * @return 应用锁定和连发、去掉宏触发键之后的虚拟引脚掩码
+     */
+    Mask_t filterPins(const Mask_t pins, const uint32_t now);
+
+    // 是否有任何连发、锁定或宏配置，没有时 Gamepad 跳过引擎
+    inline bool isActive() const {
+        return turboMask_ != 0 || latchMask_ != 0 || numMacros_ != 0;
+    }
+
+    // 正在播放的宏本次扫描输出的手柄按键
+    inline uint32_t getButtons() const {
+        return buttons_;
+    }
+
+    // 正在播放的宏本次扫描输出的方向
+    inline uint8_t getDpad() const {
+        return dpad_;
+    }
+
+private:
+    struct MacroSlot {
+        Mask_t triggerMask;                         // 触发键虚拟引脚掩码
+        MacroMode mode;
+        uint8_t numSteps;
+        uint8_t step;                               // 当前步骤
+        bool playing;
+        uint32_t stepEnd;                           // 当前步骤结束时间（DWT周期）
+        uint32_t stepCycles[NUM_MACRO_STEPS];       // 每一步持续时间（DWT周期）
+        uint16_t buttons[NUM_MACRO_STEPS];
+        uint8_t dpad[NUM_MACRO_STEPS];
+    };
+
+    void startMacro(MacroSlot& slot, const uint32_t now);
+    void advanceMacro(MacroSlot& slot, const uint32_t now);
+
+    Mask_t turboMask_;                              // 连发引脚（HOLD 和 LATCH_TURBO）
+    Mask_t latchMask_;                              // 锁定引脚（LATCH 和 LATCH_TURBO）
+    Mask_t macroTriggerMask_;                       // 所有宏的触发键
+    uint32_t halfPeriod_[GAMEPAD_MACRO_NUM_PINS];   // 连发半周期（DWT周期）
+
+    Mask_t lastPins_;                               // 上一次扫描的虚拟引脚，检测按下沿
+    Mask_t latched_;                                // 处于锁定状态的引脚
+    Mask_t turboRunning_;                           // 正在连发的引脚
+    Mask_t turboPhase_;                             // 连发引脚当前是否输出按下
+    uint32_t turboToggleAt_[GAMEPAD_MACRO_NUM_PINS];// 连发引脚下一次翻转的时间（DWT周期）
+
+    MacroSlot macros_[NUM_MACROS];
+    uint8_t numMacros_;
+    uint32_t buttons_;
+    uint8_t dpad_;
+};
+
+#endif // __GAMEPAD_MACROS_HPP__
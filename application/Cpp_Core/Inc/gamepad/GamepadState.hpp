@@ -184,3 +184,46 @@ uint8_t filterToFourWayMode(uint8_t dpad);
  * @return uint8_t The clean D-pad value.
  */
 uint8_t runSOCDCleaner(SOCDMode mode, uint8_t dpad);
+
+/**
+ * @brief Analog state of the keys pressed for one D-pad direction.
+ */
+struct SOCDDirectionInput
+{
+	uint16_t depth;			// Deepest travel of the pressed keys, 0.01mm
+	uint32_t pressSequence;	// Latest press sequence number of the pressed keys, larger is later
+};
+
+struct SOCDAnalogInputs
+{
+	SOCDDirectionInput up;
+	SOCDDirectionInput down;
+	SOCDDirectionInput left;
+	SOCDDirectionInput right;
+};
+
+/**
+ * @brief Winner of each axis on the previous scan, kept by the caller between scans.
+ */
+struct SOCDAnalogState
+{
+	uint8_t lastUD;			// D-pad bits that won the up/down axis
+	uint8_t lastLR;			// D-pad bits that won the left/right axis
+};
+
+/**
+ * @brief Run SOCD cleaning using the travel depth and press order of each direction.
+ *
+ * SOCD_MODE_DEEPER_PRIORITY: the deeper direction wins, the winner only changes
+ * once the other side is SOCD_DEPTH_HYSTERESIS deeper.
+ * SOCD_MODE_SNAP_TAP: the most recently pressed direction wins and the other one
+ * becomes active again in the same scan it is released; equal press sequence numbers fall back to depth.
+ *
+ * @param mode SOCD_MODE_DEEPER_PRIORITY or SOCD_MODE_SNAP_TAP.
+ * @param dpad The GamepadState.dpad value.
+ * @param inputs Depth and press sequence number of each direction.
+ * @param state Winner of each axis on the previous scan, updated in place. Clear it when
+ * the profile or the SOCD mode changes.
+ * @return uint8_t The clean D-pad value.
+ */
+uint8_t runAnalogSOCDCleaner(SOCDMode mode, uint8_t dpad, const SOCDAnalogInputs& inputs, SOCDAnalogState& state);
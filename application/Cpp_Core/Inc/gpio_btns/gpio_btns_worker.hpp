@@ -6,6 +6,7 @@
 #include "storagemanager.hpp"
 #include "message_center.hpp"
 #include "gpio-btn.h"
+#include "gpio_btns/gpio_debounce_filter.hpp"
 #include "micro_timer.hpp"
 #include <array>
 #include <algorithm>
@@ -25,32 +26,37 @@ class GPIOBtnsWorker {
         uint32_t read();
         GPIOBtnsWorker();
 
+        // 边沿队列溢出次数（中断中边沿过多，主循环来不及读取）
+        inline uint32_t getEdgeOverflows() const {
+            return edgeOverflows;
+        }
+
     private:
-        // 按钮状态枚举
-        enum class ButtonState {
-            RELEASED,       // 完全释放状态
-            RELEASING,      // 正在释放过程中
-            PRESSED,        // 完全按下状态
-            PRESSING,       // 正在按下过程中
+        // 一次边沿中断：中断时所有按钮的状态和DWT时间戳
+        struct EdgeEvent {
+            uint32_t buttonMask;
+            uint32_t timestamp;
         };
 
-        typedef struct {
-            uint32_t virtualPin;         // 虚拟引脚
-            ButtonState state;           // 当前状态
-            uint32_t lastStateTime;      // 进入当前状态的时间
-            uint32_t debounceTime;       // 防抖时间
-            bool lastRawState;           // 上一次的原始状态
-        } GPIOBtn;
+        // 一次采样经过防抖，状态变化时发布消息
+        void filterSample(uint32_t buttonMask, uint32_t timestamp);
+        // 按钮状态变化时发布消息并更新虚拟引脚掩码
+        void publishChanges(const uint32_t changedMask, const uint32_t timestamp);
+        // 边沿中断回调，写入边沿队列（中断上下文）
+        static void onEdge(uint32_t buttonMask, uint32_t timestamp);
 
-        // 按钮初始化回调函数
         static GPIOBtnsWorker* instance_;
-        static void initCallback(uint8_t virtualPin, bool isPressed, uint8_t idx);
-        static void readCallback(uint8_t virtualPin, bool isPressed, uint8_t idx);
-        
-        std::array<GPIOBtn, NUM_GPIO_BUTTONS> buttonStates;
+
+        GPIODebounceFilter debounceFilter;
+        uint32_t lastTimestamp;                  // 上一次防抖采样的时间戳，保证送入防抖的时间戳单调
+        bool stateChanged;                       // 本次 read 中稳定状态是否变化
+        // 单生产者（EXTI中断）单消费者（read）无锁队列，head/tail 只增不减，按 GPIO_BUTTONS_EXTI_QUEUE_SIZE 取模
+        EdgeEvent edgeQueue[GPIO_BUTTONS_EXTI_QUEUE_SIZE];
+        volatile uint32_t edgeHead;
+        volatile uint32_t edgeTail;
+        volatile uint32_t edgeOverflows;
+        uint32_t virtualPins[NUM_GPIO_BUTTONS];  // 按钮索引 -> 虚拟引脚
         uint32_t virtualPinMask = 0x0;  // 虚拟引脚掩码
-        bool buttonStateChanged = false;
-        uint8_t currentInitIndex = 0;    // 当前初始化的按钮索引
 };
 
 #define GPIO_BTNS_WORKER GPIOBtnsWorker::getInstance()
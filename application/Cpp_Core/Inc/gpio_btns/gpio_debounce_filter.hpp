@@ -0,0 +1,60 @@
+#ifndef __GPIO_DEBOUNCE_FILTER_HPP__
+#define __GPIO_DEBOUNCE_FILTER_HPP__
+
+#include <stdint.h>
+#include "board_cfg.h"
+
+static_assert(NUM_GPIO_BUTTONS <= 32, "GPIO debounce lanes must fit in a 32-bit word");
+
+// 防抖时间单位为DWT周期，CYCCNT按2^32回绕，差值计算不受回绕影响
+#define GPIO_DEBOUNCE_CYCLES_PER_US         (SYSTEM_CLOCK_FREQ / 1000000UL)
+
+/**
+ * GPIO按钮防抖过滤器
+ * 输入输出都是按钮掩码（bit i 对应 gpio_btns_mapping[i]），时间戳为DWT周期，不访问硬件，可以在板外用模拟的IDR序列验证
+ *
+ * 延迟确认（eager = false）：状态变化持续 window 后才确认，期间变回则取消，每次按下都晚 window 上报。
+ * 立即确认（eager = true）：稳定状态变化的边沿立即上报，之后 window 内该按钮的抖动全部忽略；
+ *                           锁定期结束时若原始状态与稳定状态不同（锁定期内松开/按下），下一次扫描立即跟随。
+ */
+class GPIODebounceFilter {
+public:
+    struct Config {
+        uint32_t windowCycles;  // 确认时间/锁定时间（DWT周期）
+        bool eager;             // 是否立即确认
+
+        Config() : windowCycles(GPIO_BUTTONS_DEBOUNCE * GPIO_DEBOUNCE_CYCLES_PER_US), eager(GPIO_BUTTONS_DEBOUNCE_EAGER) {}
+    };
+
+    explicit GPIODebounceFilter(const Config& config = Config());
+
+    /**
+     * 对一次采样的原始状态进行防抖，时间戳必须单调不减
+     * @param rawMask 原始按钮掩码 (1=按下, 0=释放)
+     * @param timestamp 采样时间（DWT周期）
+     * @return 防抖后的稳定按钮掩码
+     */
+    uint32_t filter(const uint32_t rawMask, const uint32_t timestamp);
+
+    /**
+     * 重置防抖状态，以 stableMask 作为当前稳定状态，不进入锁定期
+     * @param stableMask 稳定按钮掩码
+     */
+    void reset(const uint32_t stableMask = 0);
+
+    inline void setConfig(const Config& config) {
+        config_ = config;
+    }
+
+    inline uint32_t getStableMask() const {
+        return stableMask_;
+    }
+
+private:
+    Config config_;
+    uint32_t stableMask_;                       // 稳定状态
+    uint32_t pendingMask_;                      // 延迟确认：正在确认状态变化的按钮 立即确认：处于锁定期的按钮
+    uint32_t timestamps_[NUM_GPIO_BUTTONS];     // 延迟确认：变化开始的时间 立即确认：上一次边沿的时间
+};
+
+#endif // __GPIO_DEBOUNCE_FILTER_HPP__
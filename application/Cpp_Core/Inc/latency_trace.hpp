@@ -0,0 +1,132 @@
+#ifndef __LATENCY_TRACE_HPP__
+#define __LATENCY_TRACE_HPP__
+
+#include <stdint.h>
+#include "stm32h7xx.h"
+#include "board_cfg.h"
+#include "micro_timer.hpp"
+
+/**
+ * @brief 按键输入到USB报告的延迟统计
+ *
+ * 在 ADCBtnsWorker::handleButtonState 翻转 virtualPinMask 时记录按键事件时间戳，
+ * GPIO按键在 GPIOBtnsWorker 确认状态变化时记录（边沿中断模式下为EXTI中断记录的边沿时间），
+ * 在输入驱动的 process 中报告被 tud_hid_report / XInput端点 接受时结束计时，
+ * 按按键统计这段固件内部延迟的分布（不包含主机轮询间隔）。
+ *
+ * 和 PerfTrace 一样保存在备份SRAM中，输入模式下采集，重启进入网页配置模式后通过 /api/latency-stats 读取。
+ */
+
+// 直方图 bin0: <1us, binN: [2^(N-1), 2^N) us，最后一个桶包含更大的延迟
+#define LATENCY_TRACE_HISTOGRAM_BINS    16
+#define LATENCY_TRACE_MAGIC             0x4C41544E  // "LATN"
+#define LATENCY_TRACE_VERSION           2
+// ADC按键和GPIO按键的虚拟引脚连续编号
+#define LATENCY_TRACE_NUM_BUTTONS       (NUM_ADC_BUTTONS + NUM_GPIO_BUTTONS)
+
+// 每个按键的延迟统计
+struct LatencyButtonStats {
+    uint32_t count;                                     // 事件数
+    uint32_t maxCycles;                                 // 最大延迟
+    uint64_t totalCycles;                               // 总延迟，用于计算均值
+    uint16_t histogram[LATENCY_TRACE_HISTOGRAM_BINS];   // 延迟分布，计数饱和于 UINT16_MAX
+};
+
+// 备份SRAM中的数据布局
+struct LatencyTraceData {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t timeoutEvents;                             // 超时未发出报告的事件数
+    uint32_t discardedEvents;                           // 没有对应报告的事件数（如FN组合键）
+    LatencyButtonStats buttons[LATENCY_TRACE_NUM_BUTTONS];
+};
+
+static_assert(sizeof(LatencyTraceData) <= BKPSRAM_LATENCY_TRACE_SIZE, "LatencyTraceData must fit in its BKPSRAM area");
+
+class LatencyTrace {
+    public:
+        LatencyTrace(LatencyTrace const&) = delete;
+        void operator=(LatencyTrace const&) = delete;
+
+        static LatencyTrace& getInstance() {
+            static LatencyTrace instance;
+            return instance;
+        }
+
+        /**
+         * @brief 记录按键状态翻转
+         * 同一个按键在报告发出前多次翻转时，保留最早的时间戳
+         * @param virtualPin 按键虚拟引脚
+         */
+        inline void buttonChanged(const uint8_t virtualPin) {
+            buttonChanged(virtualPin, MICROS_TIMER.cycles());
+        }
+
+        /**
+         * @brief 记录按键状态翻转，使用已经记录的时间戳
+         * @param virtualPin 按键虚拟引脚
+         * @param timestamp 翻转时的DWT周期
+         */
+        inline void buttonChanged(const uint8_t virtualPin, const uint32_t timestamp) {
+            if(virtualPin >= LATENCY_TRACE_NUM_BUTTONS || (pendingMask & (1U << virtualPin))) {
+                return;
+            }
+            pendingTimestamps[virtualPin] = timestamp;
+            pendingMask |= (1U << virtualPin);
+        }
+
+        /**
+         * @brief 报告已被USB协议栈接受，结束所有待处理按键事件的计时
+         */
+        inline void reportSent() {
+            if(pendingMask != 0) {
+                commit(MICROS_TIMER.cycles());
+            }
+        }
+
+        /**
+         * @brief 丢弃待处理的按键事件（本次按键不会产生报告，如FN组合键）
+         */
+        void discardPending();
+
+        // 清空统计，开始新的统计会话
+        void reset();
+
+        // 将统计写回备份SRAM，复位前调用
+        void flush();
+
+        // 备份SRAM中的统计是否有效
+        bool isValid() const;
+
+        inline const LatencyTraceData& getData() const {
+            return *data;
+        }
+
+        // 根据直方图计算百分位延迟（us，返回所在桶的上限），percent 取值 0 ~ 100
+        uint32_t getPercentileUs(const uint8_t virtualPin, const uint8_t percent) const;
+
+    private:
+        LatencyTrace();
+
+        void commit(const uint32_t now);
+
+        LatencyTraceData* const data;
+        uint32_t pendingMask;                               // 等待报告发出的按键
+        uint32_t pendingTimestamps[LATENCY_TRACE_NUM_BUTTONS];  // 按键翻转时间戳（DWT周期）
+};
+
+#define LATENCY_TRACE LatencyTrace::getInstance()
+
+#if LATENCY_TRACE_ENABLED
+    #define LATENCY_TRACE_BUTTON_CHANGED(virtualPin)    LATENCY_TRACE.buttonChanged(virtualPin)
+    #define LATENCY_TRACE_BUTTON_CHANGED_AT(virtualPin, timestamp)  LATENCY_TRACE.buttonChanged(virtualPin, timestamp)
+    #define LATENCY_TRACE_REPORT_SENT()                 LATENCY_TRACE.reportSent()
+    #define LATENCY_TRACE_DISCARD()                     LATENCY_TRACE.discardPending()
+#else
+    #define LATENCY_TRACE_BUTTON_CHANGED(virtualPin)    ((void)0)
+    #define LATENCY_TRACE_BUTTON_CHANGED_AT(virtualPin, timestamp)  ((void)0)
+    #define LATENCY_TRACE_REPORT_SENT()                 ((void)0)
+    #define LATENCY_TRACE_DISCARD()                     ((void)0)
+#endif
+
+#endif // __LATENCY_TRACE_HPP__
@@ -1,13 +1,11 @@
 #ifndef _MESSAGE_CENTER_H_
 #define _MESSAGE_CENTER_H_
 
-#include <functional>
-#include <map>
-#include <vector>
 #include <cstdint>
+#include "board_cfg.h"
 
-// 消息ID枚举
-enum class MessageId {
+// 消息ID枚举，作为处理函数表的下标，取值必须唯一且小于 NUM_MESSAGE_IDS
+enum class MessageId : uint8_t {
     NONE = 0,
 
     DMA_ADC_CONV_CPLT = 1,
@@ -15,24 +13,41 @@ enum class MessageId {
     GPIO_BTNS_STATE_CHANGED = 2,
     ADC_BTNS_STATE_CHANGED = 3,
 
-    GPIO_BTNS_PRESSED = 3,
-    GPIO_BTNS_RELEASED = 4,
+    GPIO_BTNS_PRESSED = 4,
+    GPIO_BTNS_RELEASED = 5,
 
-    ADC_BTNS_PRESSED = 5,
-    ADC_BTNS_RELEASED = 6,
+    ADC_BTNS_PRESSED = 6,
+    ADC_BTNS_RELEASED = 7,
 
     ADC_BTNS_CALIBRATOR_START = 11,
     ADC_BTNS_CALIBRATOR_STOP_WITH_FINISH = 12,
     ADC_BTNS_CALIBRATOR_STOP_WITHOUT_FINISH = 13,
 
     ADC_SAMPLING_STATS_COMPLETE = 14,  // 添加新的消息类型用于ADC采样统计更新
+
+    NUM_MESSAGE_IDS
 };
 
+#define NUM_MESSAGE_IDS ((uint8_t)MessageId::NUM_MESSAGE_IDS)
 
+// 消息回调函数类型，context 为订阅时传入的上下文（通常是对象指针），data 为发布时传入的数据
+using MessageCallback = void (*)(void* context, const void* data);
 
-// 消息处理函数类型
-using MessageHandler = std::function<void(const void*)>;
+// 消息处理函数：函数指针 + 上下文，可以直接比较，不需要堆分配
+struct MessageHandler {
+    MessageCallback callback;
+    void* context;
+};
 
+/**
+ * @brief 静态消息中心
+ *
+ * 处理函数表按 MessageId 直接索引，每个消息最多 MESSAGE_MAX_HANDLERS 个订阅者，
+ * 所有存储在编译期确定大小，运行期不使用堆。
+ *
+ * publish 在调用方上下文中同步调用处理函数，只能在主循环中使用；
+ * 中断（如DMA回调）中使用 publishFromISR 写入延迟队列，由主循环调用 dispatchDeferred 分发。
+ */
 class MessageCenter {
 public:
     // 禁止拷贝构造和赋值
@@ -48,25 +63,73 @@ public:
     // 注册新的消息类型
     bool registerMessage(MessageId msgId);
 
-    // 取消注册消息类型
+    // 取消注册消息类型，同时清空该消息的所有订阅
     bool unregisterMessage(MessageId msgId);
 
-    // 订阅消息
-    bool subscribe(MessageId msgId, MessageHandler handler);
+    // 订阅消息，同一个 callback + context 只会订阅一次
+    bool subscribe(MessageId msgId, MessageCallback callback, void* context);
 
-    // 取消订阅消息
-    bool unsubscribe(MessageId msgId, MessageHandler handler);
+    // 取消订阅消息，按 callback + context 匹配
+    bool unsubscribe(MessageId msgId, MessageCallback callback, void* context);
 
-    // 发送消息
-    bool publish(MessageId msgId, const void* data);
+    // 发送消息，同步调用所有处理函数
+    inline bool publish(MessageId msgId, const void* data) {
+        const uint8_t id = (uint8_t)msgId;
+        if(id >= NUM_MESSAGE_IDS || !registered[id]) {
+            return false;
+        }
 
-private:
-    MessageCenter() = default;
+        for(uint8_t i = 0; i < handlerCount[id]; i++) {
+            handlers[id][i].callback(handlers[id][i].context, data);
+        }
+        return true;
+    }
+
+    // 是否有订阅者，发布方可以用来跳过准备数据的开销
+    inline bool hasSubscribers(MessageId msgId) const {
+        const uint8_t id = (uint8_t)msgId;
+        return id < NUM_MESSAGE_IDS && handlerCount[id] != 0;
+    }
 
-    // 存储消息ID和对应的处理函数列表
-    std::map<MessageId, std::vector<MessageHandler>> handlers;
+    /**
+     * @brief 在中断中发布消息
+     * 消息写入延迟队列，由主循环调用 dispatchDeferred 分发，data 指向的数据在分发前必须保持有效
+     * 没有订阅者时直接丢弃，队列满时丢弃并计数
+     */
+    bool publishFromISR(MessageId msgId, const void* data);
+
+    // 分发延迟队列中的消息，在主循环中调用；上次调用之后有消息被丢弃时输出错误日志
+    void dispatchDeferred();
+
+    // 延迟队列满而丢弃的消息数
+    inline uint32_t getDroppedDeferred() const {
+        return droppedDeferred;
+    }
+
+private:
+    MessageCenter();
+
+    // 延迟队列中的消息
+    struct DeferredMessage {
+        MessageId msgId;
+        const void* data;
+    };
+
+    // 处理函数表，按消息ID索引
+    MessageHandler handlers[NUM_MESSAGE_IDS][MESSAGE_MAX_HANDLERS];
+    uint8_t handlerCount[NUM_MESSAGE_IDS];
+    bool registered[NUM_MESSAGE_IDS];
+
+    // 中断 -> 主循环 的延迟队列，head 只由主循环修改，tail 只在关中断时修改
+    DeferredMessage deferredQueue[MESSAGE_DEFERRED_QUEUE_SIZE];
+    volatile uint32_t deferredHead;
+    volatile uint32_t deferredTail;
+    volatile uint32_t droppedDeferred;
+    uint32_t reportedDropped;       // 已经输出过日志的丢弃数
 };
 
+static_assert((MESSAGE_DEFERRED_QUEUE_SIZE & (MESSAGE_DEFERRED_QUEUE_SIZE - 1)) == 0, "MESSAGE_DEFERRED_QUEUE_SIZE must be a power of 2");
+
 // 全局简写
 #define MC MessageCenter::getInstance()
 
@@ -3,6 +3,10 @@
 
 #include <stdint.h>
 #include "tim.h"
+#include "board_cfg.h"
+
+// STM32H750的CPU频率 - 根据实际系统时钟配置调整
+#define CYCLES_PER_MICROSECOND (SYSTEM_CLOCK_FREQ / 1000000UL)
 
 class MicrosTimer {
 public:
@@ -19,6 +23,11 @@ public:
     // 获取当前微秒时间
     uint32_t micros();
 
+    // 获取当前DWT周期计数，可在中断中调用
+    inline uint32_t cycles() const {
+        return DWT->CYCCNT;
+    }
+
     // 检查是否达到指定的时间间隔
     // 如果达到间隔则返回true并更新时间戳，否则返回false
     bool checkInterval(uint32_t interval_us, uint32_t& lastTime);
@@ -0,0 +1,142 @@
+#ifndef __PERF_TRACE_HPP__
+#define __PERF_TRACE_HPP__
+
+#include <stdint.h>
+#include "stm32h7xx.h"
+#include "board_cfg.h"
+#include "micro_timer.hpp"
+
+/**
+ * @brief 主循环热路径耗时统计
+ *
+ * 记录 InputState::loop 各阶段的DWT周期耗时，每个阶段保存 min/max/总和 以及对数直方图（用于估算p99），
+ * 另外用一个环形缓冲区记录最近的耗时尖峰。
+ *
+ * 数据保存在备份SRAM（BKPSRAM）中，系统复位后仍然保留：在输入模式下采集，
+ * 通过热键重启进入网页配置模式后，可以通过 /api/perf-stats 读取上一次输入模式的统计。
+ *
+ * 通过 PERF_TRACE_ENABLED 编译开关控制，关闭时埋点宏为空，没有任何开销。
+ */
+
+// 耗时统计阶段
+enum class PerfStage : uint8_t {
+    GPIO_READ = 0,          // GPIO按键读取
+    ADC_READ,               // ADC按键读取
+    GAMEPAD_READ,           // Gamepad::read
+    DRIVER_PROCESS,         // inputDriver->process（包含 Gamepad::process 和报告发送）
+    TUD_TASK,               // tud_task
+    USB_HOST_PROCESS,       // USB_HOST_MANAGER.process
+    DRIVER_PROCESS_AUX,     // inputDriver->processAux
+    LEDS_LOOP,              // LEDS_MANAGER.loop
+    LOOP_TOTAL,             // 整个 InputState::loop
+    NUM_PERF_STAGES
+};
+
+#define NUM_PERF_STAGES                 ((uint8_t)PerfStage::NUM_PERF_STAGES)
+
+// 直方图：小于 2^PERF_TRACE_HISTOGRAM_MIN_BITS 个周期的进入 bin0，之后每个2倍区间再线性细分为4个桶
+#define PERF_TRACE_HISTOGRAM_MIN_BITS   4
+#define PERF_TRACE_HISTOGRAM_SUB_BITS   2
+#define PERF_TRACE_HISTOGRAM_BINS       72      // 最后一个桶包含 >= 6 << 19 周期（约6.5ms）的耗时
+#define PERF_TRACE_SPIKE_RING_SIZE      16
+#define PERF_TRACE_MAGIC                0x50455246  // "PERF"
+#define PERF_TRACE_VERSION              2
+
+// 每个阶段的统计
+struct PerfStageStats {
+    uint32_t count;                                 // 采样次数
+    uint32_t minCycles;                             // 最小耗时
+    uint32_t maxCycles;                             // 最大耗时
+    uint32_t reserved;
+    uint64_t totalCycles;                           // 总耗时，用于计算均值
+    uint32_t histogram[PERF_TRACE_HISTOGRAM_BINS];  // 耗时分布
+};
+
+// 耗时尖峰记录
+struct PerfSpikeRecord {
+    uint32_t tick;          // 发生时间 ms
+    uint32_t cycles;        // 耗时
+    uint8_t stage;          // 阶段
+    uint8_t reserved[3];
+};
+
+// 备份SRAM中的数据布局
+struct PerfTraceData {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t spikeCount;                            // 尖峰总数，环形缓冲区写入位置为 spikeCount % PERF_TRACE_SPIKE_RING_SIZE
+    uint32_t reserved;
+    PerfStageStats stages[NUM_PERF_STAGES];
+    PerfSpikeRecord spikes[PERF_TRACE_SPIKE_RING_SIZE];
+};
+
+static_assert(sizeof(PerfTraceData) <= BKPSRAM_PERF_TRACE_SIZE, "PerfTraceData must fit in its BKPSRAM area");
+
+class PerfTrace {
+    public:
+        PerfTrace(PerfTrace const&) = delete;
+        void operator=(PerfTrace const&) = delete;
+
+        static PerfTrace& getInstance() {
+            static PerfTrace instance;
+            return instance;
+        }
+
+        /**
+         * @brief 记录一个阶段的耗时
+         * @param stage 阶段
+         * @param startCycles 阶段开始时的DWT周期
+         * @return 当前DWT周期，可作为下一个阶段的开始
+         */
+        inline uint32_t record(const PerfStage stage, const uint32_t startCycles) {
+            const uint32_t now = MICROS_TIMER.cycles();
+            update((uint8_t)stage, now - startCycles);
+            return now;
+        }
+
+        // 清空统计，开始新的统计会话
+        void reset();
+
+        // 将统计写回备份SRAM，复位前调用
+        void flush();
+
+        // 备份SRAM中的统计是否有效
+        bool isValid() const;
+
+        inline const PerfTraceData& getData() const {
+            return *data;
+        }
+
+        // 根据直方图计算百分位耗时（返回所在桶的上限），percent 取值 0 ~ 100
+        uint32_t getPercentileCycles(const uint8_t stage, const uint8_t percent) const;
+
+        // 直方图桶的下限（周期）
+        static uint32_t getBinLowerCycles(const uint8_t bin);
+
+        static const char* getStageName(const uint8_t stage);
+
+    private:
+        PerfTrace();
+
+        void update(const uint8_t stage, const uint32_t cycles);
+        static uint8_t getBin(const uint32_t cycles);
+
+        PerfTraceData* const data;
+};
+
+#define PERF_TRACE PerfTrace::getInstance()
+
+#if PERF_TRACE_ENABLED
+    // 在函数内开始计时
+    #define PERF_TRACE_BEGIN(var)           uint32_t var = MICROS_TIMER.cycles()
+    // 记录从上一个标记到当前的耗时，并把当前时间作为下一个阶段的开始
+    #define PERF_TRACE_MARK(var, stage)     (var) = PERF_TRACE.record((stage), (var))
+    // 重新开始计时，跳过不需要统计的代码
+    #define PERF_TRACE_RESTART(var)         (var) = MICROS_TIMER.cycles()
+#else
+    #define PERF_TRACE_BEGIN(var)           ((void)0)
+    #define PERF_TRACE_MARK(var, stage)     ((void)0)
+    #define PERF_TRACE_RESTART(var)         ((void)0)
+#endif
+
+#endif // __PERF_TRACE_HPP__
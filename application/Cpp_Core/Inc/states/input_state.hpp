@@ -31,8 +31,11 @@ class InputState : public BaseState {
         uint32_t workTime = 0;
         uint32_t calibrationTime = 0;
         uint32_t ledAnimationTime = 0;
+        uint32_t driftCompensationTime = 0;
+        uint32_t baselineTrackingTime = 0;
         uint32_t virtualPinMask = 0x0;
         uint32_t lastVirtualPinMask = 0x0;
+        uint32_t adcVirtualPinMask = 0x0;    // 最近一帧ADC按键的状态掩码
 };
 
 // 定义一个宏方便使用
@@ -20,7 +20,18 @@ public:
 	Config config;
 	
 	void initConfig();
+	// 立即写入Flash（擦除并重写整个配置），写入期间输入扫描暂停
 	bool saveConfig();
+
+	// 标记配置已修改，由 processDeferredSave 延迟合并写入，用于输入模式下热键修改的配置
+	void markConfigDirty();
+	// 主循环调用：配置已修改、最后一次修改后静默 CONFIG_SAVE_QUIET_MS 且 idle 为 true（没有按键按下）时写入，之后的空闲循环中分步回收旧扇区
+	void processDeferredSave(bool idle);
+	// 有未写入的修改时立即写入，重启或切换模式前调用
+	bool flushConfig();
+	bool isConfigDirty() const {
+		return configDirty;
+	}
 	bool resetConfig();
 	void setInputMode(InputMode inputMode);
 	const InputMode getInputMode() {
@@ -42,6 +53,10 @@ public:
 private:
 	Storage() {}  // 私有构造函数
 
+	bool configDirty = false;			// 有未写入Flash的修改
+	uint32_t configDirtyTime = 0;		// 最后一次修改的时间 ms
+	bool gcPending = false;				// 写入之后还需要分步回收旧扇区
+
 };
 
 #define STORAGE_MANAGER Storage::getInstance()
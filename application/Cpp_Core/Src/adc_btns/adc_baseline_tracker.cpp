@@ -0,0 +1,49 @@
+#include "adc_btns/adc_baseline_tracker.hpp"
+#include <string.h>
+#include <algorithm>
+
+// 中位数：拷贝后部分排序，不改变原数组的顺序
+template<size_t N>
+static uint16_t median(const uint16_t (&values)[N], const uint8_t count) {
+    uint16_t sorted[N];
+    memcpy(sorted, values, count * sizeof(uint16_t));
+    std::nth_element(sorted, sorted + count / 2, sorted + count);
+    return sorted[count / 2];
+}
+
+ADCBaselineTracker::ADCBaselineTracker() {
+    reset();
+}
+
+bool ADCBaselineTracker::addSample(const uint8_t buttonIndex, const uint16_t value) {
+    if(buttonIndex >= NUM_ADC_BUTTONS) {
+        return false;
+    }
+
+    ButtonWindows& windows = windows_[buttonIndex];
+    windows.samples[windows.sampleCount++] = value;
+    if(windows.sampleCount < ADC_BASELINE_WINDOW_SIZE) {
+        return false;
+    }
+
+    windows.medians[windows.medianIndex] = median(windows.samples, ADC_BASELINE_WINDOW_SIZE);
+    windows.medianIndex = (windows.medianIndex + 1) % ADC_BASELINE_NUM_WINDOWS;
+    if(windows.medianCount < ADC_BASELINE_NUM_WINDOWS) {
+        windows.medianCount++;
+    }
+    windows.sampleCount = 0;
+    return true;
+}
+
+bool ADCBaselineTracker::getBaseline(const uint8_t buttonIndex, uint16_t& baseline) const {
+    if(buttonIndex >= NUM_ADC_BUTTONS || windows_[buttonIndex].medianCount < ADC_BASELINE_NUM_WINDOWS) {
+        return false;
+    }
+
+    baseline = median(windows_[buttonIndex].medians, ADC_BASELINE_NUM_WINDOWS);
+    return true;
+}
+
+void ADCBaselineTracker::reset() {
+    memset(windows_, 0, sizeof(windows_));
+}
@@ -22,10 +22,7 @@ void ADCBtnsMarker::reset() {
     // ADC_MANAGER.stopADCSamping();
 
     // 取消订阅ADC转换完成回调
-    if (messageHandler) {
-        MC.unsubscribe(MessageId::ADC_SAMPLING_STATS_COMPLETE, messageHandler);
-        messageHandler = nullptr;
-    }
+    MC.unsubscribe(MessageId::ADC_SAMPLING_STATS_COMPLETE, &ADCBtnsMarker::onSamplingStatsComplete, this);
 
 }
 
@@ -65,17 +62,23 @@ ADCBtnsError ADCBtnsMarker::setup(const char* const id) {
 
 
     // 订阅ADC转换完成回调
-    messageHandler = [this](const void* data) {
-        if (data) {
-            this->stepFinish((ADCChannelStats*)data);
-        }
-    };
-    MC.subscribe(MessageId::ADC_SAMPLING_STATS_COMPLETE, messageHandler);
+    MC.subscribe(MessageId::ADC_SAMPLING_STATS_COMPLETE, &ADCBtnsMarker::onSamplingStatsComplete, this);
 
     return ADCBtnsError::SUCCESS;
 }
 
 
+/**
+ * @brief ADC_SAMPLING_STATS_COMPLETE 消息回调
+ * @param context ADCBtnsMarker 实例
+ * @param data 采样统计信息
+ */
+void ADCBtnsMarker::onSamplingStatsComplete(void* context, const void* data) {
+    if (data) {
+        ((ADCBtnsMarker*)context)->stepFinish((const ADCChannelStats*)data);
+    }
+}
+
 /**
  * @brief 步进
  * 将标记值保存到映射中，并重置标记器
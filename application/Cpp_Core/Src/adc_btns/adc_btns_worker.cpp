@@ -1,4 +1,5 @@
 #include "adc_btns/adc_btns_worker.hpp"
+#include "latency_trace.hpp"
 #include "board_cfg.h"
 
 /*
@@ -14,8 +15,8 @@
  *    - 启动 ADC 采样。
  * 
  * 3. 读取：
- *    - 从 ADC 管理器读取 ADC 值。
- *    - 对每个按钮，检查其状态并根据当前 ADC 值更新其状态。
+ *    - read() 从 ADC 管理器读取DMA转换完成后发布的新帧，交给 processSamples() 处理。
+ *    - processSamples() 只依赖传入的采样值，对每个按钮检查其状态并根据当前 ADC 值更新其状态。
  *    - 如果按钮状态发生变化，发布状态改变消息。
  * 
  * 4. 动态校准（如果启用）：
@@ -34,16 +35,38 @@
  *    - 按下逻辑：通过比较当前索引与上次状态索引，判断是否满足按下条件（索引差值大于等于按下精度索引，且当前索引小于顶部死区索引）。
  *    - 回弹逻辑：通过比较当前索引与上次状态索引，判断是否满足回弹条件（索引差值大于等于释放精度索引，且当前索引大于底部死区索引）。
  *    - 映射分区：根据映射数组，将行程分为不同的区间，通过索引判断按钮的状态变化。
+ * 
+ * 8. 多点触发（DKS）：
+ *    - 启用多点触发的按键不走快速触发状态机，在 getButtonEvent 中与预先换算为ADC值的触发点阈值比较。
+ *    - 下压/回弹越过触发点时执行配置的动作（按下、释放、点按目标虚拟引脚），输出与快速触发的结果合并。
+ * 
+ * 9. 温漂补偿（如果启用）：
+ *    - compensateDrift() 低频采样内部温度，用静止按键的基准值拟合每个按键的温漂模型。
+ *    - 预测的偏移整体平移到映射、查找表起止值和预先换算的阈值上，getButtonEvent 不做任何额外计算。
+ * 
+ * 10. 基准值跟踪（自动校准模式）：
+ *    - trackBaseline() 按窗口中位数跟踪释放按键的静止值，校准映射逐步平移到基准值，不需要按键完整按下。
+ *    - 修改过的校准值按最短间隔、在所有按键释放时合并写入Flash。
  */
 
+// 扫描热路径状态放在DTCM，CPU零等待访问，不经过D-Cache
+DTCM_DATA ADCBtnsWorker::HotState ADCBtnsWorker::hot;
+
+// 行程距离（mm）换算为Q12定点
+static inline int32_t toDistanceQ(const float distanceMm) {
+    return (int32_t)lroundf(distanceMm * (1 << ADC_DISTANCE_LUT_FRAC_BITS));
+}
+
 ADCBtnsWorker::ADCBtnsWorker()
 {
     // 初始化指针数组为 nullptr
     memset(buttonPtrs, 0, sizeof(buttonPtrs));
 
     // 初始化按钮配置
+    memset(&hot, 0, sizeof(hot));
     for (uint8_t i = 0; i < NUM_ADC_BUTTONS; i++) {
         buttonPtrs[i] = new ADCBtn();  // 动态分配新对象
+        buttonPtrs[i]->index = i;
     }
 
     // 初始化防抖过滤器，使用ULTRAFAST算法以获得最低延迟
@@ -62,6 +85,13 @@ ADCBtnsWorker::ADCBtnsWorker()
         case ADCButtonDebounceAlgorithm::MAX:
             debounceConfig.ultrafastThreshold = ULTRAFast_THRESHOLD_MAX;
             break;
+        case ADCButtonDebounceAlgorithm::ADAPTIVE:
+            // 自适应：确认时间由每个按键的噪声和触发距离决定，见 getAdaptiveDebounceWindow
+            debounceConfig.ultrafastThreshold = ULTRAFast_THRESHOLD_NONE;
+            debounceConfig.adaptive = true;
+            break;
+        default:
+            break;
     }
     debounceFilter_.setConfig(debounceConfig);
 
@@ -115,8 +145,16 @@ ADCBtnsError ADCBtnsWorker::setup() {
     // 获取校准模式配置
     bool isAutoCalibrationEnabled = STORAGE_MANAGER.config.autoCalibrationEnabled;
 
+    // 行程总长度，用于行程深度输出
+    maxTravel = (uint16_t)((this->mapping->length - 1) * this->mapping->step * 100.0f + 0.5f);
+
     // 计算最小值差值 - 使用原始映射计算
     minValueDiff = (uint16_t)((float_t)(this->mapping->originalValues[0] - this->mapping->originalValues[this->mapping->length - 1]) * MIN_VALUE_DIFF_RATIO);
+
+    resetDks();
+    baselineTracker_.reset();
+    baselineDirtyMask = 0;
+    lastBaselineSaveTime = HAL_GetTick();
     
     // 初始化按钮配置
     for(uint8_t i = 0; i < adcBtnInfos.size(); i++) {
@@ -150,6 +188,9 @@ ADCBtnsError ADCBtnsWorker::setup() {
         float totalTravelMm = (this->mapping->length - 1) * this->mapping->step;
         buttonPtrs[i]->halfwayDistanceMm = totalTravelMm / 2.0f;
 
+        // 多点触发配置，禁用的按键不启用
+        loadDksConfig(buttonPtrs[i], (enabledKeysMask & (1U << i)) ? &profile->dksConfigs[i] : nullptr);
+
         // 根据校准模式初始化按键映射
         uint16_t topValue, bottomValue;
         ADCBtnsError calibrationResult = ADC_MANAGER.getCalibrationValues(id.c_str(), i, isAutoCalibrationEnabled, topValue, bottomValue);
@@ -157,10 +198,10 @@ ADCBtnsError ADCBtnsWorker::setup() {
         if(calibrationResult == ADCBtnsError::SUCCESS && topValue != 0 && bottomValue != 0) {
             // 使用校准值生成完整的校准后映射
             generateCalibratedMapping(buttonPtrs[i], topValue, bottomValue);
-            buttonPtrs[i]->initCompleted = true;
+            hot.initCompleted[i] = true;
         } else {
             // 这里需要等待第一次ADC读取来初始化
-            buttonPtrs[i]->initCompleted = false;
+            hot.initCompleted[i] = false;
             // 清空映射数组
             memset(buttonPtrs[i]->valueMapping, 0, this->mapping->length * sizeof(uint16_t));
             memset(buttonPtrs[i]->calibratedMapping, 0, this->mapping->length * sizeof(uint16_t));
@@ -168,9 +209,9 @@ ADCBtnsError ADCBtnsWorker::setup() {
 
         // 只有在自动校准模式下才启用动态校准
         if(isAutoCalibrationEnabled) {
-            buttonPtrs[i]->bottomValueWindow = RingBufferSlidingWindow<uint16_t>(NUM_MAPPING_INDEX_WINDOW_SIZE);
-            buttonPtrs[i]->topValueWindow = RingBufferSlidingWindow<uint16_t>(NUM_MAPPING_INDEX_WINDOW_SIZE);
-            buttonPtrs[i]->limitValue = UINT16_MAX; // 初始状态为释放，记录最小值
+            buttonPtrs[i]->bottomValueWindow.clear();
+            buttonPtrs[i]->topValueWindow.clear();
+            hot.limitValue[i] = UINT16_MAX; // 初始状态为释放，记录最小值
             buttonPtrs[i]->needCalibration = false;
             buttonPtrs[i]->needSaveCalibration = false;
             buttonPtrs[i]->lastCalibrationTime = 0;
@@ -178,9 +219,9 @@ ADCBtnsError ADCBtnsWorker::setup() {
         }
         
         // 初始化状态
-        buttonPtrs[i]->lastTravelDistance = 0.0f;
-        buttonPtrs[i]->lastAdcValue = 0;
-        buttonPtrs[i]->state = ButtonState::RELEASED;  // 明确设置初始状态为释放
+        hot.lastTravelDistance[i] = 0.0f;
+        hot.lastAdcValue[i] = 0;
+        hot.state[i] = ButtonState::RELEASED;  // 明确设置初始状态为释放
     }
 
     ADC_MANAGER.startADCSamping();
@@ -215,8 +256,16 @@ ADCBtnsError ADCBtnsWorker::setup(const ExternalADCButtonConfig* externalConfigs
     // 获取校准模式配置
     bool isAutoCalibrationEnabled = STORAGE_MANAGER.config.autoCalibrationEnabled;
 
+    // 行程总长度，用于行程深度输出
+    maxTravel = (uint16_t)((this->mapping->length - 1) * this->mapping->step * 100.0f + 0.5f);
+
     // 计算最小值差值 - 使用原始映射计算
     minValueDiff = (uint16_t)((float)(this->mapping->originalValues[0] - this->mapping->originalValues[this->mapping->length - 1]) * MIN_VALUE_DIFF_RATIO);
+
+    resetDks();
+    baselineTracker_.reset();
+    baselineDirtyMask = 0;
+    lastBaselineSaveTime = HAL_GetTick();
     
     // 使用外部配置初始化按钮配置
     for(uint8_t i = 0; i < adcBtnInfos.size(); i++) {
@@ -248,6 +297,9 @@ ADCBtnsError ADCBtnsWorker::setup(const ExternalADCButtonConfig* externalConfigs
         float totalTravelMm = (this->mapping->length - 1) * this->mapping->step;
         buttonPtrs[i]->halfwayDistanceMm = totalTravelMm / 2.0f;
 
+        // WebConfig模式不使用多点触发
+        loadDksConfig(buttonPtrs[i], nullptr);
+
         // 根据校准模式初始化按键映射
         uint16_t topValue, bottomValue;
         ADCBtnsError calibrationResult = ADC_MANAGER.getCalibrationValues(id.c_str(), i, isAutoCalibrationEnabled, topValue, bottomValue);
@@ -255,10 +307,10 @@ ADCBtnsError ADCBtnsWorker::setup(const ExternalADCButtonConfig* externalConfigs
         if(calibrationResult == ADCBtnsError::SUCCESS && topValue != 0 && bottomValue != 0) {
             // 使用校准值生成完整的校准后映射
             generateCalibratedMapping(buttonPtrs[i], topValue, bottomValue);
-            buttonPtrs[i]->initCompleted = true;
+            hot.initCompleted[i] = true;
         } else {
             // 这里需要等待第一次ADC读取来初始化
-            buttonPtrs[i]->initCompleted = false;
+            hot.initCompleted[i] = false;
             // 清空映射数组
             memset(buttonPtrs[i]->valueMapping, 0, this->mapping->length * sizeof(uint16_t));
             memset(buttonPtrs[i]->calibratedMapping, 0, this->mapping->length * sizeof(uint16_t));
@@ -266,9 +318,9 @@ ADCBtnsError ADCBtnsWorker::setup(const ExternalADCButtonConfig* externalConfigs
 
         // 只有在自动校准模式下才启用动态校准
         if(isAutoCalibrationEnabled) {
-            buttonPtrs[i]->bottomValueWindow = RingBufferSlidingWindow<uint16_t>(NUM_MAPPING_INDEX_WINDOW_SIZE);
-            buttonPtrs[i]->topValueWindow = RingBufferSlidingWindow<uint16_t>(NUM_MAPPING_INDEX_WINDOW_SIZE);
-            buttonPtrs[i]->limitValue = UINT16_MAX; // 初始状态为释放，记录最小值
+            buttonPtrs[i]->bottomValueWindow.clear();
+            buttonPtrs[i]->topValueWindow.clear();
+            hot.limitValue[i] = UINT16_MAX; // 初始状态为释放，记录最小值
             buttonPtrs[i]->needCalibration = false;
             buttonPtrs[i]->needSaveCalibration = false;
             buttonPtrs[i]->lastCalibrationTime = 0;
@@ -276,9 +328,9 @@ ADCBtnsError ADCBtnsWorker::setup(const ExternalADCButtonConfig* externalConfigs
         }
         
         // 初始化状态
-        buttonPtrs[i]->lastTravelDistance = 0.0f;
-        buttonPtrs[i]->lastAdcValue = 0;
-        buttonPtrs[i]->state = ButtonState::RELEASED;  // 明确设置初始状态为释放
+        hot.lastTravelDistance[i] = 0.0f;
+        hot.lastAdcValue[i] = 0;
+        hot.state[i] = ButtonState::RELEASED;  // 明确设置初始状态为释放
     }
 
     ADC_MANAGER.startADCSamping();
@@ -307,12 +359,88 @@ ADCBtnsError ADCBtnsWorker::deinit() {
 
 
 /**
- * 处理ADC转换完成消息
- * @param data ADC句柄指针
+ * 读取新的ADC帧并处理
+ * ADC帧由DMA转换完成中断发布，每帧只处理一次；没有新帧的ADC对应的按键值为0，处理时跳过
  */
 uint32_t ADCBtnsWorker::read() {
-    // 使用引用避免拷贝
-    const std::array<ADCButtonValueInfo, NUM_ADC_BUTTONS>& adcValues = ADC_MANAGER.readADCValues();
+    uint32_t values[NUM_ADC_BUTTONS] = {0};
+
+    if(ADC_MANAGER.readFreshADCValues(values) == 0) {
+        return (this->virtualPinMask & enabledKeysMask) | dksOutputMask;
+    }
+
+    return processSamples(values);
+}
+
+/**
+ * 更新扫描周期的滑动平均，自适应防抖把需要的采样次数换算成时间
+ * @param nowCycles 当前时间（DWT周期）
+ */
+void ADCBtnsWorker::updateScanPeriod(const uint32_t nowCycles) {
+    if(lastScanCycles != 0) {
+        const int32_t period = (int32_t)std::min<uint32_t>(nowCycles - lastScanCycles, ADAPTIVE_DEBOUNCE_MAX_US * ADC_DEBOUNCE_CYCLES_PER_US);
+        scanPeriodCycles += (period - scanPeriodCycles) >> 3;
+    }
+    lastScanCycles = nowCycles;
+}
+
+/**
+ * 更新相邻采样差值的滑动平均（Q4），作为该通道的噪声幅度
+ * 只在没有候选事件、且差值为0或与上一次差值方向相反时更新：按键移动时相邻差值方向一致，
+ * 来回跳动的只有噪声，平稳的按下/释放行程不会计入噪声
+ */
+void ADCBtnsWorker::updateNoiseLevel(ADCBtn* btn, const uint16_t lastValue, const uint16_t currentValue) {
+    const uint8_t idx = btn->index;
+    if(lastValue == 0) {
+        return;
+    }
+    const int32_t diff = (int32_t)currentValue - (int32_t)lastValue;
+    const int32_t lastDiff = hot.lastDiff[idx];
+    hot.lastDiff[idx] = (int16_t)std::max<int32_t>(INT16_MIN, std::min<int32_t>(diff, INT16_MAX));
+    if((diff > 0 && lastDiff >= 0) || (diff < 0 && lastDiff <= 0)) {
+        return;
+    }
+    const int32_t diffQ4 = (int32_t)std::min<uint32_t>(abs(diff), UINT16_MAX >> 4) << 4;
+    hot.noiseQ4[idx] = (uint16_t)((int32_t)hot.noiseQ4[idx] + ((diffQ4 - (int32_t)hot.noiseQ4[idx]) >> ADAPTIVE_DEBOUNCE_NOISE_SHIFT));
+}
+
+/**
+ * 自适应防抖的确认时间
+ * 触发距离（当前值与限制值的差）大于 噪声 × ADAPTIVE_DEBOUNCE_NOISE_MARGIN 时不可能由噪声引起，立即确认；
+ * 否则需要的采样次数按 噪声 / 触发距离 增加，换算成时间后不超过 ADAPTIVE_DEBOUNCE_MAX_US
+ * @return 确认时间（DWT周期）
+ */
+uint32_t ADCBtnsWorker::getAdaptiveDebounceWindow(const ADCBtn* btn) const {
+    const uint8_t idx = btn->index;
+    const uint32_t noiseQ4 = (uint32_t)hot.noiseQ4[idx] * ADAPTIVE_DEBOUNCE_NOISE_MARGIN;
+    const uint32_t distanceQ4 = (uint32_t)abs((int32_t)hot.lastAdcValue[idx] - (int32_t)hot.limitValue[idx]) << 4;
+
+    if(noiseQ4 <= distanceQ4) {
+        return 0;
+    }
+    const uint32_t maxWindow = ADAPTIVE_DEBOUNCE_MAX_US * ADC_DEBOUNCE_CYCLES_PER_US;
+    if(distanceQ4 == 0) {
+        return maxWindow;
+    }
+
+    const uint32_t samples = (noiseQ4 + distanceQ4 - 1) / distanceQ4;
+    return (uint32_t)std::min<uint64_t>((uint64_t)samples * (uint32_t)scanPeriodCycles, maxWindow);
+}
+
+/**
+ * 处理一帧ADC采样值
+ * @param values 按virtualPin排序的ADC值
+ */
+uint32_t ADCBtnsWorker::processSamples(const uint32_t* const values) {
+    uint32_t candidateMask = 0;     // 达到触发阈值、需要防抖确认的按键
+    uint32_t pressMask = 0;         // 其中候选事件为按下的按键
+
+    const bool adaptiveDebounce = debounceFilter_.getConfig().adaptive;
+    uint32_t nowCycles = 0;
+    if(adaptiveDebounce) {
+        nowCycles = MICROS_TIMER.cycles();
+        updateScanPeriod(nowCycles);
+    }
 
     for(uint8_t i = 0; i < NUM_ADC_BUTTONS; i++) {
         ADCBtn* const btn = buttonPtrs[i];
@@ -320,30 +448,64 @@ uint32_t ADCBtnsWorker::read() {
             continue;
         }
 
-        // 使用 valuePtr 获取 ADC 值
-        const uint16_t adcValue = *adcValues[i].valuePtr;
-
-        if(adcValue == 0 || adcValue > UINT16_MAX) {
+        if(values[i] == 0 || values[i] > UINT16_MAX) {
             continue;
         }
 
-        if(!btn->initCompleted) {
+        const uint16_t adcValue = (uint16_t)values[i];
+
+        if(!hot.initCompleted[i]) {
 
             initButtonMapping(btn, adcValue);
 
-            btn->initCompleted = true;
+            hot.initCompleted[i] = true;
             continue;
         }
         
-        // 获取按钮事件（新算法直接基于ADC值）
-        const ButtonEvent event = getButtonEvent(btn, adcValue, i);
-        
-
-        // 处理状态转换
+        // 获取候选按钮事件（新算法直接基于ADC值）
+        const uint16_t lastAdcValue = hot.lastAdcValue[i];
+        const ButtonEvent event = getButtonEvent(btn, adcValue);
+        if(adaptiveDebounce && event == ButtonEvent::NONE) {
+            updateNoiseLevel(btn, lastAdcValue, adcValue);
+        }
+        if(travelOutputMask & (1U << btn->virtualPin)) {
+            updateTravel(btn, adcValue);
+        }
         if(event != ButtonEvent::NONE) {
-            APP_DBG("event: %d", event);
-            handleButtonState(btn, event);
+            candidateMask |= (1U << i);
+            if(event == ButtonEvent::PRESS_COMPLETE) {
+                pressMask |= (1U << i);
+            }
+        }
+    }
+
+    // 所有候选按键一次完成防抖，再依次处理确认的状态转换
+    uint32_t confirmedMask = 0;
+    if(candidateMask && adaptiveDebounce) {
+        uint32_t lanes = candidateMask;
+        while(lanes) {
+            const uint8_t i = (uint8_t)__builtin_ctz(lanes);
+            lanes &= lanes - 1;
+            debounceFilter_.setButtonWindow(i, getAdaptiveDebounceWindow(buttonPtrs[i]));
         }
+        confirmedMask = debounceFilter_.filterAdaptive(pressMask, candidateMask, nowCycles);
+    } else if(candidateMask) {
+        confirmedMask = debounceFilter_.filter(pressMask, candidateMask);
+    }
+    while(confirmedMask) {
+        const uint8_t i = (uint8_t)__builtin_ctz(confirmedMask);
+        confirmedMask &= confirmedMask - 1;
+
+        ADCBtn* const btn = buttonPtrs[i];
+        const ButtonEvent event = (pressMask & (1U << i)) ? ButtonEvent::PRESS_COMPLETE : ButtonEvent::RELEASE_COMPLETE;
+        resetLimitValue(btn, hot.lastAdcValue[i]);
+
+        APP_DBG("event: %d", event);
+        handleButtonState(btn, event);
+    }
+
+    if(dksChanged || dksTapMask) {
+        updateDksOutput();
     }
 
     if(buttonTriggerStatusChanged) {
@@ -351,8 +513,8 @@ uint32_t ADCBtnsWorker::read() {
         buttonTriggerStatusChanged = false;
     }
 
-    // 返回按键状态掩码，只返回启用的按键，其他按键不返回
-    return (this->virtualPinMask & enabledKeysMask);
+    // 返回按键状态掩码，只返回启用的按键，其他按键不返回；多点触发的目标只来自启用的按键
+    return (this->virtualPinMask & enabledKeysMask) | dksOutputMask;
 }
 
 /**
@@ -454,6 +616,198 @@ bool ADCBtnsWorker::shouldSaveCalibration(ADCBtn* btn, uint32_t currentTime) {
     return (currentTime - btn->lastCalibrationTime) >= CALIBRATION_SAVE_DELAY_MS;
 }
 
+/**
+ * 按键是否静止：快速触发处于释放状态、多点触发没有越过任何触发点，且行程在顶部 ADC_IDLE_DISTANCE 内
+ * @param btn 按钮指针
+ */
+bool ADCBtnsWorker::isButtonIdle(const ADCBtn* btn) const {
+    const uint8_t idx = btn->index;
+    if (!hot.initCompleted[idx] || hot.lastAdcValue[idx] == 0
+        || hot.state[idx] != ButtonState::RELEASED || hot.dksCrossedMask[idx] != 0) {
+        return false;
+    }
+
+    const float maxTravelDistance = (mapping->length - 1) * this->mapping->step;
+    const int32_t idleDistanceQ = (int32_t)((maxTravelDistance - ADC_IDLE_DISTANCE) * (1 << ADC_DISTANCE_LUT_FRAC_BITS));
+    return getDistanceQByValue(btn, hot.lastAdcValue[idx]) >= idleDistanceQ;
+}
+
+/**
+ * 温漂补偿
+ * 静止按键的当前值与校准映射完全释放值的差作为模型的采样，
+ * 模型按当前温度预测的偏移变化超过采样噪声的一半时才重新平移阈值
+ */
+void ADCBtnsWorker::compensateDrift() {
+    if (!mapping || mapping->length < 2 || !driftCompensator_.sampleTemperature()) {
+        return;
+    }
+
+    const float temperature = driftCompensator_.getTemperature();
+    const int32_t applyThreshold = std::max<int32_t>(1, mapping->samplingNoise / 2);
+
+    for (uint8_t i = 0; i < NUM_ADC_BUTTONS; i++) {
+        ADCBtn* const btn = buttonPtrs[i];
+        if (!btn || !hot.initCompleted[i]) {
+            continue;
+        }
+
+        const uint16_t restValue = btn->calibratedMapping[mapping->length - 1];
+        if (isButtonIdle(btn)) {
+            driftCompensator_.addIdleSample(i, temperature, (int32_t)hot.lastAdcValue[i] - restValue);
+        }
+
+        // 偏移限制在完整行程ADC值差的 ADC_DRIFT_MAX_OFFSET_RATIO 内
+        const int32_t maxOffset = (int32_t)((btn->calibratedMapping[0] - restValue) * ADC_DRIFT_MAX_OFFSET_RATIO);
+        const int32_t offset = std::max<int32_t>(-maxOffset, std::min<int32_t>(maxOffset, driftCompensator_.getOffset(i, temperature)));
+        if (std::abs(offset - btn->driftOffset) >= applyThreshold) {
+            applyDriftOffset(btn, offset);
+        }
+    }
+}
+
+/**
+ * 把映射和所有预先换算的阈值平移到新的偏移
+ * 查找表按相对 lutBaseValue 的偏移索引，整体平移后与按新映射重新生成的结果一致
+ * @param btn 按钮指针
+ * @param offset 相对校准映射的偏移（ADC值）
+ */
+void ADCBtnsWorker::applyDriftOffset(ADCBtn* btn, const int32_t offset) {
+    const int32_t delta = offset - btn->driftOffset;
+    if (delta == 0) {
+        return;
+    }
+
+    const uint8_t idx = btn->index;
+    auto shift = [delta](const uint16_t value) {
+        return (uint16_t)std::max<int32_t>(0, std::min<int32_t>(UINT16_MAX, (int32_t)value + delta));
+    };
+
+    for (size_t i = 0; i < mapping->length; i++) {
+        btn->valueMapping[i] = (uint16_t)std::max<int32_t>(0, std::min<int32_t>(UINT16_MAX, (int32_t)btn->calibratedMapping[i] + offset));
+    }
+    btn->lutBaseValue = btn->valueMapping[mapping->length - 1];
+    btn->lutTopValue = btn->valueMapping[0];
+
+    #if ADC_BTNS_FIXED_POINT_ENGINE
+    hot.topDeadzoneValue[idx] = shift(hot.topDeadzoneValue[idx]);
+    hot.bottomDeadzoneValue[idx] = shift(hot.bottomDeadzoneValue[idx]);
+    hot.halfwayValue[idx] = shift(hot.halfwayValue[idx]);
+    #endif
+    for (uint8_t p = 0; p < hot.dksPointCount[idx]; p++) {
+        hot.dksPressValue[idx][p] = shift(hot.dksPressValue[idx][p]);
+        hot.dksReleaseValue[idx][p] = shift(hot.dksReleaseValue[idx][p]);
+    }
+
+    // 正在跟踪的极值和触发值一起平移，UINT16_MAX 表示还没有记录极值
+    if (hot.limitValue[idx] != UINT16_MAX) {
+        hot.limitValue[idx] = shift(hot.limitValue[idx]);
+        hot.triggerValue[idx] = shift(hot.triggerValue[idx]);
+    }
+
+    btn->driftOffset = offset;
+}
+
+/**
+ * 静止基准值跟踪
+ * 每填满一个窗口比较一次基准值和校准映射的完全释放值，差值超过采样噪声的一半时平移校准映射，
+ * 每次最多平移一个采样噪声，差值过大（按键可能被卡住或映射不对）时不跟随
+ */
+void ADCBtnsWorker::trackBaseline() {
+    if (!mapping || mapping->length < 2 || !STORAGE_MANAGER.config.autoCalibrationEnabled) {
+        return;
+    }
+
+    const int32_t deadband = std::max<int32_t>(1, mapping->samplingNoise / 2);
+    const int32_t maxStep = std::max<int32_t>(1, mapping->samplingNoise);
+
+    for (uint8_t i = 0; i < NUM_ADC_BUTTONS; i++) {
+        ADCBtn* const btn = buttonPtrs[i];
+        if (!btn || !isButtonIdle(btn) || !baselineTracker_.addSample(i, hot.lastAdcValue[i])) {
+            continue;
+        }
+
+        uint16_t baseline;
+        if (!baselineTracker_.getBaseline(i, baseline)) {
+            continue;
+        }
+
+        const int32_t restValue = btn->calibratedMapping[mapping->length - 1];
+        const int32_t maxShift = (int32_t)((btn->calibratedMapping[0] - restValue) * ADC_BASELINE_MAX_SHIFT_RATIO);
+        const int32_t diff = (int32_t)baseline - restValue;
+        if (std::abs(diff) <= deadband || std::abs(diff) > maxShift) {
+            continue;
+        }
+
+        shiftBaseline(btn, std::max<int32_t>(-maxStep, std::min<int32_t>(maxStep, diff)));
+        baselineDirtyMask |= (1U << i);
+    }
+
+    if (baselineDirtyMask) {
+        saveBaselineValues();
+    }
+}
+
+/**
+ * 校准映射整体平移，当前使用的映射和阈值同步平移
+ * 温漂补偿启用时，当前映射 = 校准映射 + 温漂偏移，校准映射平移后温漂模型的基准值偏差同步平移，
+ * 当前映射和阈值保持不变，由温漂偏移抵消
+ * @param btn 按钮指针
+ * @param shift 平移量（ADC值）
+ */
+void ADCBtnsWorker::shiftBaseline(ADCBtn* btn, const int32_t shift) {
+    for (size_t i = 0; i < mapping->length; i++) {
+        btn->calibratedMapping[i] = (uint16_t)std::max<int32_t>(0, std::min<int32_t>(UINT16_MAX, (int32_t)btn->calibratedMapping[i] + shift));
+    }
+    btn->driftOffset -= shift;
+
+    #if ADC_DRIFT_COMPENSATION_ENABLED
+    driftCompensator_.shiftBaseline(btn->index, shift);
+    #else
+    applyDriftOffset(btn, 0);
+    #endif
+}
+
+/**
+ * 合并写入基准值跟踪修改过的校准值
+ * 每个按键追加一条校准日志记录，日志写满时整体写入映射存储，写入期间扫描暂停，
+ * 所以只在间隔足够且所有按键释放时写入；失败时等下一个间隔重试
+ */
+void ADCBtnsWorker::saveBaselineValues() {
+    const uint32_t currentTime = HAL_GetTick();
+    if (currentTime - lastBaselineSaveTime < ADC_BASELINE_SAVE_INTERVAL_MS
+        || ((virtualPinMask & enabledKeysMask) | dksOutputMask) != 0) {
+        return;
+    }
+    lastBaselineSaveTime = currentTime;
+    flushBaselineValues();
+}
+
+void ADCBtnsWorker::flushBaselineValues() {
+    if (baselineDirtyMask == 0) {
+        return;
+    }
+
+    std::string mappingId = ADC_MANAGER.getDefaultMapping();
+    if (mappingId.empty()) {
+        return;
+    }
+
+    uint32_t dirty = baselineDirtyMask;
+    while (dirty) {
+        const uint8_t i = (uint8_t)__builtin_ctz(dirty);
+        dirty &= dirty - 1;
+
+        // 与 saveCalibrationValues 一致：topValue 为完全释放值（较小），bottomValue 为完全按下值（较大）
+        const ADCBtn* const btn = buttonPtrs[i];
+        ADC_MANAGER.setCalibrationValues(mappingId.c_str(), i, true,
+            btn->calibratedMapping[mapping->length - 1], btn->calibratedMapping[0], false);
+    }
+
+    if (ADC_MANAGER.commitCalibrationValues() == ADCBtnsError::SUCCESS) {
+        baselineDirtyMask = 0;
+    }
+}
+
 /**
  * 初始化按钮映射
  * @param btn 按钮指针
@@ -464,6 +818,8 @@ void ADCBtnsWorker::initButtonMapping(ADCBtn* btn, const uint16_t releaseValue)
         return;
     }
 
+    const uint8_t idx = btn->index;
+
     // 计算差值：当前释放值与原始映射末尾值的差
     const int32_t offset = (int32_t)releaseValue - (int32_t)mapping->originalValues[mapping->length - 1];
 
@@ -481,18 +837,28 @@ void ADCBtnsWorker::initButtonMapping(ADCBtn* btn, const uint16_t releaseValue)
     
     // 将校准后的映射复制到当前使用的映射
     memcpy(btn->valueMapping, btn->calibratedMapping, mapping->length * sizeof(uint16_t));
+    btn->driftOffset = 0;
+    driftCompensator_.resetButton(idx);
+    buildDistanceLut(btn);
+    // 自适应防抖的噪声初值取映射标定时测得的采样噪声，之后按实际采样收敛
+    hot.noiseQ4[idx] = (uint16_t)std::min<uint32_t>((uint32_t)mapping->samplingNoise << 4, UINT16_MAX);
+    hot.lastDiff[idx] = 0;
+    #if ADC_BTNS_FIXED_POINT_ENGINE
+    buildTriggerThresholds(btn);
+    #endif
+    buildDksThresholds(btn);
 
     // 只有在自动校准模式下才初始化滑动窗口
     if (STORAGE_MANAGER.config.autoCalibrationEnabled) {
         btn->bottomValueWindow.clear();
         btn->topValueWindow.clear();
-        btn->limitValue = UINT16_MAX; // 初始状态为释放，需要记录最小值，所以初始化为最大值
+        hot.limitValue[idx] = UINT16_MAX; // 初始状态为释放，需要记录最小值，所以初始化为最大值
 
         btn->bottomValueWindow.push(btn->valueMapping[0]);
         btn->topValueWindow.push(btn->valueMapping[mapping->length - 1]);
     } else {
         // 非自动校准模式下也需要初始化limitValue
-        btn->limitValue = UINT16_MAX; // 初始状态为释放，需要记录最小值，所以初始化为最大值
+        hot.limitValue[idx] = UINT16_MAX; // 初始状态为释放，需要记录最小值，所以初始化为最大值
     }
 }
 
@@ -507,6 +873,8 @@ void ADCBtnsWorker::generateCalibratedMapping(ADCBtn* btn, uint16_t topValue, ui
         return;
     }
 
+    const uint8_t idx = btn->index;
+
     // 确保topValue < bottomValue (完全释放的值应该小于完全按下的值)
     if (topValue > bottomValue) {
         uint16_t temp = topValue;
@@ -538,69 +906,210 @@ void ADCBtnsWorker::generateCalibratedMapping(ADCBtn* btn, uint16_t topValue, ui
     
     // 将校准后的映射复制到当前使用的映射
     memcpy(btn->valueMapping, btn->calibratedMapping, this->mapping->length * sizeof(uint16_t));
+    // 新的校准值已包含当前的漂移，温漂模型从头开始
+    btn->driftOffset = 0;
+    driftCompensator_.resetButton(idx);
+    buildDistanceLut(btn);
+    #if ADC_BTNS_FIXED_POINT_ENGINE
+    buildTriggerThresholds(btn);
+    #endif
+    buildDksThresholds(btn);
     
     // 只有在自动校准模式下才初始化滑动窗口
     if (STORAGE_MANAGER.config.autoCalibrationEnabled) {
         btn->bottomValueWindow.clear();
         btn->topValueWindow.clear();
-        btn->limitValue = UINT16_MAX; // 初始状态为释放，需要记录最小值，所以初始化为最大值
+        hot.limitValue[idx] = UINT16_MAX; // 初始状态为释放，需要记录最小值，所以初始化为最大值
 
         btn->bottomValueWindow.push(btn->valueMapping[0]);
         btn->topValueWindow.push(btn->valueMapping[mapping->length - 1]);
     } else {
         // 非自动校准模式下也需要初始化limitValue
-        btn->limitValue = UINT16_MAX; // 初始状态为释放，需要记录最小值，所以初始化为最大值
+        hot.limitValue[idx] = UINT16_MAX; // 初始状态为释放，需要记录最小值，所以初始化为最大值
     }
 }
 
 // 状态转换处理函数
-ADCBtnsWorker::ButtonEvent ADCBtnsWorker::getButtonEvent(ADCBtn* btn, const uint16_t currentValue, const uint8_t buttonIndex) {
-    if (!btn || !btn->initCompleted) {
+#if ADC_BTNS_FIXED_POINT_ENGINE
+/**
+ * 整数引擎：所有阈值已预先换算为ADC值，扫描路径上只有整数比较
+ * 返回达到触发阈值的候选事件，防抖在一次扫描的所有按键处理完后统一进行
+ */
+ADCBtnsWorker::ButtonEvent ADCBtnsWorker::getButtonEvent(ADCBtn* btn, const uint16_t currentValue) {
+    if (!btn || !hot.initCompleted[btn->index]) {
+        return ButtonEvent::NONE;
+    }
+
+    const uint8_t idx = btn->index;
+
+    // 多点触发按键不走快速触发状态机，只比较预先换算的触发点阈值
+    // 触发点越过后直接生效，不经过防抖过滤器：回弹阈值带 DKS_RELEASE_HYSTERESIS 迟滞，
+    // ADC 噪声无法在同一触发点上来回抖动，防抖算法配置对多点触发按键不生效
+    if (hot.dksPointCount[idx] != 0) {
+        hot.lastAdcValue[idx] = currentValue;
+        updateDks(btn, currentValue);
         return ButtonEvent::NONE;
     }
 
+    updateLimitValue(btn, currentValue);
+    hot.lastAdcValue[idx] = currentValue;
+
+    switch(hot.state[idx]) {
+        case ButtonState::RELEASED:
+            // 达到按下阈值，且不在顶部死区内
+            if (currentValue >= hot.triggerValue[idx] && currentValue >= hot.topDeadzoneValue[idx]) {
+                return ButtonEvent::PRESS_COMPLETE;
+            }
+            break;
+
+        case ButtonState::PRESSED:
+            // 达到释放阈值，且不在底部死区内
+            if (currentValue <= hot.triggerValue[idx] && currentValue <= hot.bottomDeadzoneValue[idx]) {
+                return ButtonEvent::RELEASE_COMPLETE;
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    return ButtonEvent::NONE;
+}
+
+/**
+ * 在没有触发时，更新limitValue和triggerValue
+ * 触发值只在极值移动时换算一次：查ADC值->行程距离表，加上预先换算的Q12精度，再查行程距离->ADC值表，
+ * 与浮点路径的 getValueByDistance 换算相同，保证两个引擎的判断逐值一致
+ */
+void ADCBtnsWorker::updateLimitValue(ADCBtn* btn, const uint16_t currentValue) {
+    const uint8_t idx = btn->index;
+    uint16_t noise = this->mapping->samplingNoise;
+    if(hot.state[idx] == ButtonState::RELEASED) {
+        if(currentValue + noise < hot.limitValue[idx]) {
+            hot.limitValue[idx] = currentValue + noise;
+            hot.triggerValue[idx] = getValueByDistanceQ(btn, getDistanceQByValue(btn, hot.limitValue[idx]) - btn->pressAccuracyQ);
+        }
+    } else if(hot.state[idx] == ButtonState::PRESSED) {
+        if(currentValue - noise > hot.limitValue[idx]) {
+            hot.limitValue[idx] = currentValue - noise;
+            const int32_t accuracyQ = currentValue >= hot.halfwayValue[idx] ? btn->highPrecisionReleaseAccuracyQ : btn->releaseAccuracyQ;
+            hot.triggerValue[idx] = getValueByDistanceQ(btn, getDistanceQByValue(btn, hot.limitValue[idx]) + accuracyQ);
+        }
+    }
+}
+
+/**
+ * 在触发时，重置limitValue和triggerValue
+ */
+void ADCBtnsWorker::resetLimitValue(ADCBtn* btn, const uint16_t currentValue) {
+    const uint8_t idx = btn->index;
+    uint16_t noise = this->mapping->samplingNoise;
+    if(hot.state[idx] == ButtonState::RELEASED) {
+        hot.limitValue[idx] = currentValue - noise;
+        hot.triggerValue[idx] = getValueByDistanceQ(btn, getDistanceQByValue(btn, hot.limitValue[idx]) - btn->pressAccuracyQ);
+    } else if(hot.state[idx] == ButtonState::PRESSED) {
+        hot.limitValue[idx] = currentValue + noise;
+        const int32_t accuracyQ = currentValue >= hot.halfwayValue[idx] ? btn->highPrecisionReleaseAccuracyQ : btn->releaseAccuracyQ;
+        hot.triggerValue[idx] = getValueByDistanceQ(btn, getDistanceQByValue(btn, hot.limitValue[idx]) + accuracyQ);
+    }
+}
+
+/**
+ * 查找行程距离满足条件的最小ADC值
+ * getDistanceByValue 随ADC值单调不增，二分查找得到的边界与逐值比较距离的结果完全一致
+ * @param btn 按钮指针
+ * @param distanceMm 行程距离（mm）
+ * @param inclusive true 查找距离 <= distanceMm 的最小值，false 查找距离 < distanceMm 的最小值
+ * @return 满足条件的最小ADC值，没有满足条件的值时返回 UINT16_MAX + 1
+ */
+uint32_t ADCBtnsWorker::findValueByDistance(ADCBtn* btn, const float distanceMm, const bool inclusive) {
+    uint32_t low = 0;
+    uint32_t high = UINT16_MAX + 1;
+    while (low < high) {
+        const uint32_t mid = (low + high) >> 1;
+        const float distance = getDistanceByValue(btn, (uint16_t)mid);
+        if (inclusive ? distance <= distanceMm : distance < distanceMm) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+    return low;
+}
+
+/**
+ * 根据当前映射和死区配置生成整数引擎的距离阈值
+ * 距离越大ADC值越小，距离比较换算为ADC值比较：
+ * 按下要求 距离 <= 最大行程 - 顶部死区，即 ADC值 >= topDeadzoneValue；
+ * 释放要求 距离 >= 底部死区，即 ADC值 <= bottomDeadzoneValue；
+ * 距离 <= 中点 时使用高精度释放，即 ADC值 >= halfwayValue
+ * @param btn 按钮指针
+ */
+void ADCBtnsWorker::buildTriggerThresholds(ADCBtn* btn) {
+    if (!btn || !mapping || mapping->length < 2) {
+        return;
+    }
+
+    const uint8_t idx = btn->index;
+    const float maxTravelDistance = (mapping->length - 1) * this->mapping->step;
+
+    hot.topDeadzoneValue[idx] = (uint16_t)std::min<uint32_t>(UINT16_MAX,
+        findValueByDistance(btn, maxTravelDistance - btn->topDeadzoneMm, true));
+    // 距离 < 底部死区的最小值减一即为满足释放条件的最大值；为0时没有值满足条件，采样值0不参与判断
+    const uint32_t bottomExclusive = findValueByDistance(btn, btn->bottomDeadzoneMm, false);
+    hot.bottomDeadzoneValue[idx] = (uint16_t)(bottomExclusive == 0 ? 0 : std::min<uint32_t>(UINT16_MAX, bottomExclusive - 1));
+    hot.halfwayValue[idx] = (uint16_t)std::min<uint32_t>(UINT16_MAX,
+        findValueByDistance(btn, btn->halfwayDistanceMm, true));
+
+    // 触发值换算使用的精度，与 getValueByDistance 的换算相同
+    btn->pressAccuracyQ = toDistanceQ(btn->pressAccuracyMm);
+    btn->releaseAccuracyQ = toDistanceQ(btn->releaseAccuracyMm);
+    btn->highPrecisionReleaseAccuracyQ = toDistanceQ(btn->highPrecisionReleaseAccuracyMm);
+}
+
+#else
+/**
+ * 返回达到触发阈值的候选事件，防抖在一次扫描的所有按键处理完后统一进行
+ */
+ADCBtnsWorker::ButtonEvent ADCBtnsWorker::getButtonEvent(ADCBtn* btn, const uint16_t currentValue) {
+    if (!btn || !hot.initCompleted[btn->index]) {
+        return ButtonEvent::NONE;
+    }
+
+    const uint8_t idx = btn->index;
+
     // 获取当前行程距离
     float currentDistance = getDistanceByValue(btn, currentValue);
     float maxTravelDistance = (this->mapping->length - 1) * this->mapping->step;
 
+    // 多点触发按键不走快速触发状态机，只比较预先换算的触发点阈值
+    // 触发点越过后直接生效，不经过防抖过滤器：回弹阈值带 DKS_RELEASE_HYSTERESIS 迟滞，
+    // ADC 噪声无法在同一触发点上来回抖动，防抖算法配置对多点触发按键不生效
+    if (hot.dksPointCount[idx] != 0) {
+        hot.lastTravelDistance[idx] = currentDistance;
+        hot.lastAdcValue[idx] = currentValue;
+        updateDks(btn, currentValue);
+        return ButtonEvent::NONE;
+    }
+
     updateLimitValue(btn, currentValue);
 
-    switch(btn->state) {
+    // 更新位置信息
+    hot.lastTravelDistance[idx] = currentDistance;
+    hot.lastAdcValue[idx] = currentValue;
+
+    switch(hot.state[idx]) {
         case ButtonState::RELEASED:
             // 判断当前值是否达到按下阈值
-            if (currentValue >= btn->triggerValue && currentDistance <= maxTravelDistance - btn->topDeadzoneMm) {
-                // 应用防抖过滤
-                bool debounceConfirmed = debounceFilter_.filterUltraFastSingle(buttonIndex, true);
-                
-                if(buttonIndex == 0) {
-                    APP_DBG("Btn[%d]: RELEASE attempt, confirmed=%d", buttonIndex, debounceConfirmed);
-                }
-
-                if (debounceConfirmed) {
-                    resetLimitValue(btn, currentValue);
-                    btn->lastTravelDistance = currentDistance;
-                    btn->lastAdcValue = currentValue;
-                    return ButtonEvent::PRESS_COMPLETE;
-                }
+            if (currentValue >= hot.triggerValue[idx] && currentDistance <= maxTravelDistance - btn->topDeadzoneMm) {
+                return ButtonEvent::PRESS_COMPLETE;
             }
             break;
 
         case ButtonState::PRESSED:
             // 判断当前值是否达到释放阈值
-            if (currentValue <= btn->triggerValue && currentDistance >= btn->bottomDeadzoneMm) {
-                // 应用防抖过滤
-                bool debounceConfirmed = debounceFilter_.filterUltraFastSingle(buttonIndex, false);
-                
-                if(buttonIndex == 0) {
-                    APP_DBG("Btn[%d]: PRESS attempt, confirmed=%d", buttonIndex, debounceConfirmed);
-                }
-
-                if (debounceConfirmed) {
-                    resetLimitValue(btn, currentValue);
-                    btn->lastTravelDistance = currentDistance;
-                    btn->lastAdcValue = currentValue;
-                    return ButtonEvent::RELEASE_COMPLETE;
-                }
+            if (currentValue <= hot.triggerValue[idx] && currentDistance >= btn->bottomDeadzoneMm) {
+                return ButtonEvent::RELEASE_COMPLETE;
             }
             break;
 
@@ -608,9 +1117,6 @@ ADCBtnsWorker::ButtonEvent ADCBtnsWorker::getButtonEvent(ADCBtn* btn, const uint
             break;
     }
     
-    // 无状态切换，更新位置信息
-    btn->lastTravelDistance = currentDistance;
-    btn->lastAdcValue = currentValue;
     return ButtonEvent::NONE;
 }
 
@@ -618,26 +1124,27 @@ ADCBtnsWorker::ButtonEvent ADCBtnsWorker::getButtonEvent(ADCBtn* btn, const uint
  * 在没有触发时，更新limitValue和triggerValue
  */
 void ADCBtnsWorker::updateLimitValue(ADCBtn* btn, const uint16_t currentValue) {
+    const uint8_t idx = btn->index;
     uint16_t noise = this->mapping->samplingNoise;
-    if(btn->state == ButtonState::RELEASED) {
-        if(currentValue + noise < btn->limitValue) {
-            btn->limitValue = currentValue + noise;
+    if(hot.state[idx] == ButtonState::RELEASED) {
+        if(currentValue + noise < hot.limitValue[idx]) {
+            hot.limitValue[idx] = currentValue + noise;
             float currentDistance = getDistanceByValue(btn, currentValue);
             float currentPressAccuracy = getCurrentPressAccuracy(btn, currentDistance);
-            float startDistance = getDistanceByValue(btn, btn->limitValue);
+            float startDistance = getDistanceByValue(btn, hot.limitValue[idx]);
             float endDistance = startDistance - currentPressAccuracy;
-            uint16_t endAdcValue = getValueByDistance(btn, btn->limitValue, -currentPressAccuracy);
-            btn->triggerValue = endAdcValue;
+            uint16_t endAdcValue = getValueByDistance(btn, hot.limitValue[idx], -currentPressAccuracy);
+            hot.triggerValue[idx] = endAdcValue;
         }
-    } else if(btn->state == ButtonState::PRESSED) {
-        if(currentValue - noise > btn->limitValue) {
-            btn->limitValue = currentValue - noise;
+    } else if(hot.state[idx] == ButtonState::PRESSED) {
+        if(currentValue - noise > hot.limitValue[idx]) {
+            hot.limitValue[idx] = currentValue - noise;
             float currentDistance = getDistanceByValue(btn, currentValue);
             float currentReleaseAccuracy = getCurrentReleaseAccuracy(btn, currentDistance);
-            float startDistance = getDistanceByValue(btn, btn->limitValue);
+            float startDistance = getDistanceByValue(btn, hot.limitValue[idx]);
             float endDistance = startDistance + currentReleaseAccuracy;
-            uint16_t endAdcValue = getValueByDistance(btn, btn->limitValue, currentReleaseAccuracy);
-            btn->triggerValue = endAdcValue;
+            uint16_t endAdcValue = getValueByDistance(btn, hot.limitValue[idx], currentReleaseAccuracy);
+            hot.triggerValue[idx] = endAdcValue;
         }
     }
 }
@@ -646,28 +1153,31 @@ void ADCBtnsWorker::updateLimitValue(ADCBtn* btn, const uint16_t currentValue) {
  * 在触发时，重置limitValue和triggerValue
  */
 void ADCBtnsWorker::resetLimitValue(ADCBtn* btn, const uint16_t currentValue) {
+    const uint8_t idx = btn->index;
     uint16_t noise = this->mapping->samplingNoise;
-    if(btn->state == ButtonState::RELEASED) {
-        btn->limitValue = currentValue - noise;
+    if(hot.state[idx] == ButtonState::RELEASED) {
+        hot.limitValue[idx] = currentValue - noise;
         float currentDistance = getDistanceByValue(btn, currentValue);
         float currentPressAccuracy = getCurrentPressAccuracy(btn, currentDistance);
-        float startDistance = getDistanceByValue(btn, btn->limitValue);
+        float startDistance = getDistanceByValue(btn, hot.limitValue[idx]);
         float endDistance = startDistance - currentPressAccuracy;
-        uint16_t endAdcValue = getValueByDistance(btn, btn->limitValue, -currentPressAccuracy);
-        btn->triggerValue = endAdcValue;
-    } else if(btn->state == ButtonState::PRESSED) {
-        btn->limitValue = currentValue + noise;
+        uint16_t endAdcValue = getValueByDistance(btn, hot.limitValue[idx], -currentPressAccuracy);
+        hot.triggerValue[idx] = endAdcValue;
+    } else if(hot.state[idx] == ButtonState::PRESSED) {
+        hot.limitValue[idx] = currentValue + noise;
         float currentDistance = getDistanceByValue(btn, currentValue);
         float currentReleaseAccuracy = getCurrentReleaseAccuracy(btn, currentDistance);
-        float startDistance = getDistanceByValue(btn, btn->limitValue);
+        float startDistance = getDistanceByValue(btn, hot.limitValue[idx]);
         float endDistance = startDistance + currentReleaseAccuracy;
-        uint16_t endAdcValue = getValueByDistance(btn, btn->limitValue, currentReleaseAccuracy);
-        btn->triggerValue = endAdcValue;
+        uint16_t endAdcValue = getValueByDistance(btn, hot.limitValue[idx], currentReleaseAccuracy);
+        hot.triggerValue[idx] = endAdcValue;
     }
 }
 
+#endif
+
 /**
- * 根据ADC值计算对应的行程距离
+ * 根据ADC值计算对应的行程距离（查表 + 一次线性插值）
  * @param btn 按钮指针
  * @param adcValue ADC值
  * @return 对应的行程距离（mm）
@@ -677,6 +1187,115 @@ float ADCBtnsWorker::getDistanceByValue(ADCBtn* btn, const uint16_t adcValue) {
         return 0.0f;
     }
 
+    // 完全释放位置，距离最大
+    if (adcValue <= btn->lutBaseValue) {
+        return (mapping->length - 1) * this->mapping->step;
+    }
+
+    return (float)getDistanceQByValue(btn, adcValue) * (1.0f / (1 << ADC_DISTANCE_LUT_FRAC_BITS));
+}
+
+/**
+ * 根据ADC值查表计算行程距离（Q12定点mm），完全释放位置取查找表末尾节点
+ * @param btn 按钮指针
+ * @param adcValue ADC值
+ */
+int32_t ADCBtnsWorker::getDistanceQByValue(const ADCBtn* btn, const uint16_t adcValue) const {
+    // 完全按下位置，距离为0
+    if (adcValue >= btn->lutTopValue) {
+        return 0;
+    }
+    if (adcValue <= btn->lutBaseValue) {
+        return btn->distanceLut[0];
+    }
+
+    const uint32_t offset = adcValue - btn->lutBaseValue;
+    const uint32_t index = offset >> btn->lutShift;
+    const int32_t fraction = (int32_t)(offset & ((1U << btn->lutShift) - 1));
+    const int32_t d0 = btn->distanceLut[index];
+    const int32_t d1 = btn->distanceLut[index + 1];
+
+    return d0 + (((d1 - d0) * fraction) >> btn->lutShift);
+}
+
+/**
+ * 更新按键的行程深度输出（0.01mm，0为完全释放）
+ * 浮点引擎直接使用 getButtonEvent 已经换算的行程距离，整数引擎查一次距离表
+ * @param btn 按钮指针
+ * @param adcValue 当前ADC值
+ */
+void ADCBtnsWorker::updateTravel(ADCBtn* btn, const uint16_t adcValue) {
+    #if ADC_BTNS_FIXED_POINT_ENGINE
+    const int32_t distance = (getDistanceQByValue(btn, adcValue) * 100) >> ADC_DISTANCE_LUT_FRAC_BITS;
+    #else
+    (void)adcValue;
+    const int32_t distance = (int32_t)(hot.lastTravelDistance[btn->index] * 100.0f);
+    #endif
+    hot.travel[btn->virtualPin] = (uint16_t)std::max<int32_t>(0, (int32_t)maxTravel - distance);
+}
+
+/**
+ * 根据当前映射生成ADC值->行程距离查找表和行程距离->ADC值查找表
+ * 查找表覆盖 [完全释放值, 完全按下值]，区间宽度取2的幂，保证查表只需移位；
+ * 行程距离->ADC值查找表存放相对完全按下值的下降量，温漂平移映射时不需要重新生成
+ * @param btn 按钮指针
+ */
+void ADCBtnsWorker::buildDistanceLut(ADCBtn* btn) {
+    if (!btn || !mapping || mapping->length < 2) {
+        return;
+    }
+
+    const uint16_t topValue = btn->valueMapping[0];
+    const uint16_t baseValue = btn->valueMapping[mapping->length - 1];
+    const uint32_t span = topValue > baseValue ? (uint32_t)(topValue - baseValue) : 0;
+
+    // 找到最小的区间宽度，使最大索引+1不超过查找表长度
+    uint8_t shift = 0;
+    while (span > 0 && ((span - 1) >> shift) >= ADC_DISTANCE_LUT_SIZE) {
+        shift++;
+    }
+
+    btn->lutBaseValue = baseValue;
+    btn->lutTopValue = topValue;
+    btn->lutShift = shift;
+
+    for (uint32_t i = 0; i <= ADC_DISTANCE_LUT_SIZE; i++) {
+        const uint32_t value = std::min<uint32_t>(baseValue + (i << shift), topValue);
+        const float distanceQ = calcDistanceByValue(btn, (uint16_t)value) * (1 << ADC_DISTANCE_LUT_FRAC_BITS) + 0.5f;
+        btn->distanceLut[i] = (uint16_t)std::min<float>(distanceQ, UINT16_MAX);
+    }
+
+    // 行程距离->ADC值：覆盖 [0, 最大行程)，最后一个节点越过最大行程时按映射末端外推
+    const uint32_t maxDistanceQ = btn->distanceLut[0];
+    uint8_t valueShift = 0;
+    while (maxDistanceQ > 0 && ((maxDistanceQ - 1) >> valueShift) >= ADC_DISTANCE_LUT_SIZE) {
+        valueShift++;
+    }
+    btn->valueLutShift = valueShift;
+
+    for (uint32_t i = 0; i <= ADC_DISTANCE_LUT_SIZE; i++) {
+        const float value = calcValueByDistance(btn, (float)(i << valueShift) * (1.0f / (1 << ADC_DISTANCE_LUT_FRAC_BITS)));
+        const float drop = (float)topValue - value + 0.5f;
+        btn->valueLut[i] = (uint16_t)std::max<float>(0.0f, std::min<float>(drop, UINT16_MAX));
+    }
+
+    // 越过映射两端时的外推斜率，与映射两端的两个点一致
+    const float slopeScale = 65536.0f / (this->mapping->step * (1 << ADC_DISTANCE_LUT_FRAC_BITS));
+    btn->topSlopeQ16 = (int32_t)lroundf(((int32_t)btn->valueMapping[0] - (int32_t)btn->valueMapping[1]) * slopeScale);
+    btn->baseSlopeQ16 = (int32_t)lroundf(((int32_t)btn->valueMapping[mapping->length - 2] - (int32_t)btn->valueMapping[mapping->length - 1]) * slopeScale);
+}
+
+/**
+ * 遍历映射表计算ADC值对应的行程距离（只在生成查找表时使用）
+ * @param btn 按钮指针
+ * @param adcValue ADC值
+ * @return 对应的行程距离（mm）
+ */
+float ADCBtnsWorker::calcDistanceByValue(ADCBtn* btn, const uint16_t adcValue) {
+    if (!btn || !mapping || mapping->length == 0) {
+        return 0.0f;
+    }
+
     // 处理边界情况
     // valueMapping[0] 是最大值（完全按下位置，距离为0）
     if (adcValue >= btn->valueMapping[0]) {
@@ -713,22 +1332,16 @@ float ADCBtnsWorker::getDistanceByValue(ADCBtn* btn, const uint16_t adcValue) {
 }
 
 /**
- * 根据行程距离计算对应的ADC值
+ * 在映射表上插值计算行程距离对应的ADC值（只在生成查找表时使用）
  * @param btn 按钮指针
- * @param baseAdcValue 基准ADC值（起始点）
- * @param distanceMm 要移动的行程距离（mm），正值表示向释放方向移动，负值表示向按下方向移动
- * @return 移动指定距离后的目标ADC值
+ * @param targetDistance 行程距离（mm），超出映射两端时按两端的两个点外推
+ * @return 对应的ADC值
  */
-uint16_t ADCBtnsWorker::getValueByDistance(ADCBtn* btn, const uint16_t baseAdcValue, const float distanceMm) {
+float ADCBtnsWorker::calcValueByDistance(ADCBtn* btn, const float targetDistance) {
     if (!btn || !mapping || mapping->length == 0) {
-        return baseAdcValue;
+        return 0.0f;
     }
 
-    // 首先获取基准ADC值对应的距离
-    float baseDistance = getDistanceByValue(btn, baseAdcValue);
-    // 计算目标距离
-    float targetDistance = baseDistance + distanceMm;
-
     // 获取最大距离
     float maxDistance = (mapping->length - 1) * this->mapping->step;
 
@@ -747,7 +1360,7 @@ uint16_t ADCBtnsWorker::getValueByDistance(ADCBtn* btn, const uint16_t baseAdcVa
             if (extrapolatedValue > UINT16_MAX) extrapolatedValue = UINT16_MAX;
             if (extrapolatedValue < 0) extrapolatedValue = 0;
             
-            return (uint16_t)extrapolatedValue;
+            return extrapolatedValue;
         } else {
             return btn->valueMapping[0];
         }
@@ -767,7 +1380,7 @@ uint16_t ADCBtnsWorker::getValueByDistance(ADCBtn* btn, const uint16_t baseAdcVa
             if (extrapolatedValue > UINT16_MAX) extrapolatedValue = UINT16_MAX;
             if (extrapolatedValue < 0) extrapolatedValue = 0;
             
-            return (uint16_t)extrapolatedValue;
+            return extrapolatedValue;
         } else {
             return btn->valueMapping[mapping->length - 1];
         }
@@ -796,10 +1409,48 @@ uint16_t ADCBtnsWorker::getValueByDistance(ADCBtn* btn, const uint16_t baseAdcVa
     uint16_t upperValue = btn->valueMapping[lowerIndex];   // 距离小，ADC值大
     uint16_t lowerValue = btn->valueMapping[upperIndex];   // 距离大，ADC值小
     
-    uint16_t result = (uint16_t)(upperValue - fraction * (upperValue - lowerValue));
-    
+    return upperValue - fraction * (upperValue - lowerValue);
+}
+
+
+/**
+ * 根据行程距离查表计算对应的ADC值，超出映射两端时按两端的斜率外推
+ * @param btn 按钮指针
+ * @param distanceQ 行程距离（Q12定点mm）
+ */
+uint16_t ADCBtnsWorker::getValueByDistanceQ(const ADCBtn* btn, const int32_t distanceQ) const {
+    const int32_t maxDistanceQ = btn->distanceLut[0];
+    int32_t value;
+
+    if (distanceQ <= 0) {
+        value = (int32_t)btn->lutTopValue + (int32_t)(((int64_t)-distanceQ * btn->topSlopeQ16) >> 16);
+    } else if (distanceQ >= maxDistanceQ) {
+        value = (int32_t)btn->lutBaseValue - (int32_t)(((int64_t)(distanceQ - maxDistanceQ) * btn->baseSlopeQ16) >> 16);
+    } else {
+        const uint32_t index = (uint32_t)distanceQ >> btn->valueLutShift;
+        const int32_t fraction = distanceQ & ((1 << btn->valueLutShift) - 1);
+        const int32_t d0 = btn->valueLut[index];
+        const int32_t d1 = btn->valueLut[index + 1];
+        value = (int32_t)btn->lutTopValue - (d0 + (((d1 - d0) * fraction) >> btn->valueLutShift));
+    }
+
+    return (uint16_t)std::max<int32_t>(0, std::min<int32_t>(UINT16_MAX, value));
+}
+
+/**
+ * 根据行程距离计算对应的ADC值
+ * 距离换算为Q12定点后查表，整数引擎扫描时用预先换算的精度直接调用 getValueByDistanceQ，两个引擎的触发值逐值一致
+ * @param btn 按钮指针
+ * @param baseAdcValue 基准ADC值（起始点）
+ * @param distanceMm 要移动的行程距离（mm），正值表示向释放方向移动，负值表示向按下方向移动
+ * @return 移动指定距离后的目标ADC值
+ */
+uint16_t ADCBtnsWorker::getValueByDistance(ADCBtn* btn, const uint16_t baseAdcValue, const float distanceMm) {
+    if (!btn || !mapping || mapping->length < 2) {
+        return baseAdcValue;
+    }
 
-    return result;
+    return getValueByDistanceQ(btn, getDistanceQByValue(btn, baseAdcValue) + toDistanceQ(distanceMm));
 }
 
 /**
@@ -848,6 +1499,8 @@ void ADCBtnsWorker::handleButtonState(ADCBtn* btn, const ButtonEvent event) {
         return;
     }
 
+    const uint8_t idx = btn->index;
+
     // 确定原始状态转换
     bool newRawState = false;
     bool stateChanged = false;
@@ -856,13 +1509,13 @@ void ADCBtnsWorker::handleButtonState(ADCBtn* btn, const ButtonEvent event) {
         case ButtonEvent::PRESS_COMPLETE:
             newRawState = true;
             stateChanged = true;
-            btn->state = ButtonState::PRESSED;
+            hot.state[idx] = ButtonState::PRESSED;
             break;
 
         case ButtonEvent::RELEASE_COMPLETE:
             newRawState = false; 
             stateChanged = true;
-            btn->state = ButtonState::RELEASED;
+            hot.state[idx] = ButtonState::RELEASED;
             break;
 
         default:
@@ -878,9 +1531,195 @@ void ADCBtnsWorker::handleButtonState(ADCBtn* btn, const ButtonEvent event) {
     
     if (newRawState) {
         this->virtualPinMask |= (1U << btn->virtualPin);
+        hot.pressSequence[btn->virtualPin] = ++pressSequence;
     } else {
         this->virtualPinMask &= ~(1U << btn->virtualPin);
     }
+
+    // 延迟统计：记录启用按键的状态翻转时间，报告发出时结束计时
+    if (enabledKeysMask & (1U << btn->virtualPin)) {
+        LATENCY_TRACE_BUTTON_CHANGED(btn->virtualPin);
+    }
+}
+
+/**
+ * 读取按键的多点触发配置，丢弃无效触发点并按行程从浅到深排序
+ * @param btn 按钮指针
+ * @param dks 多点触发配置，nullptr 表示不使用
+ */
+void ADCBtnsWorker::loadDksConfig(ADCBtn* btn, const DKSProfile* dks) {
+    const uint8_t idx = btn->index;
+    uint8_t count = 0;
+
+    btn->dksHeldMask = 0;
+    hot.dksCrossedMask[idx] = 0;
+
+    if (dks && dks->enabled) {
+        for (uint8_t p = 0; p < NUM_DKS_POINTS; p++) {
+            const DKSActuationPoint& point = dks->points[p];
+            const DKSAction pressAction = point.pressAction < NUM_DKS_ACTIONS ? (DKSAction)point.pressAction : DKSAction::DKS_ACTION_NONE;
+            const DKSAction releaseAction = point.releaseAction < NUM_DKS_ACTIONS ? (DKSAction)point.releaseAction : DKSAction::DKS_ACTION_NONE;
+
+            if (point.virtualPin < 0 || point.virtualPin >= 32 || point.distance <= 0.0f
+                || (pressAction == DKSAction::DKS_ACTION_NONE && releaseAction == DKSAction::DKS_ACTION_NONE)) {
+                continue;
+            }
+
+            // 插入排序
+            uint8_t pos = count;
+            while (pos > 0 && btn->dksDistanceMm[pos - 1] > point.distance) {
+                btn->dksDistanceMm[pos] = btn->dksDistanceMm[pos - 1];
+                btn->dksVirtualPin[pos] = btn->dksVirtualPin[pos - 1];
+                btn->dksPressAction[pos] = btn->dksPressAction[pos - 1];
+                btn->dksReleaseAction[pos] = btn->dksReleaseAction[pos - 1];
+                pos--;
+            }
+            btn->dksDistanceMm[pos] = point.distance;
+            btn->dksVirtualPin[pos] = (uint8_t)point.virtualPin;
+            btn->dksPressAction[pos] = pressAction;
+            btn->dksReleaseAction[pos] = releaseAction;
+            count++;
+        }
+    }
+
+    hot.dksPointCount[idx] = count;
+}
+
+/**
+ * 根据当前映射把触发点行程换算为ADC阈值，校准或映射变化时重新生成
+ * 触发点限制在死区之间，回弹阈值比按下阈值浅 DKS_RELEASE_HYSTERESIS，避免在触发点附近抖动
+ * @param btn 按钮指针
+ */
+void ADCBtnsWorker::buildDksThresholds(ADCBtn* btn) {
+    if (!btn || !mapping || mapping->length < 2) {
+        return;
+    }
+
+    const uint8_t idx = btn->index;
+    const float maxTravelDistance = (mapping->length - 1) * this->mapping->step;
+
+    for (uint8_t p = 0; p < hot.dksPointCount[idx]; p++) {
+        const float distance = std::min<float>(
+            std::max<float>(btn->dksDistanceMm[p], btn->topDeadzoneMm + DKS_RELEASE_HYSTERESIS),
+            maxTravelDistance - btn->bottomDeadzoneMm);
+
+        // 距离越大ADC值越小，自顶部算起的行程换算为到底部的距离
+        hot.dksPressValue[idx][p] = getValueByDistance(btn, btn->lutTopValue, maxTravelDistance - distance);
+        hot.dksReleaseValue[idx][p] = getValueByDistance(btn, btn->lutTopValue, maxTravelDistance - distance + DKS_RELEASE_HYSTERESIS);
+    }
+}
+
+/**
+ * 多点触发：检查当前值越过了哪些触发点并执行对应动作
+ * 下压按从浅到深、回弹按从深到浅的顺序处理，每次扫描最多比较 2 × NUM_DKS_POINTS 次
+ * 越过触发点的动作在本次扫描直接执行，不经过防抖过滤器，由触发点的回弹迟滞抑制噪声
+ * @param btn 按钮指针
+ * @param currentValue 当前ADC值
+ */
+void ADCBtnsWorker::updateDks(ADCBtn* btn, const uint16_t currentValue) {
+    const uint8_t idx = btn->index;
+    const uint8_t count = hot.dksPointCount[idx];
+    uint8_t crossed = hot.dksCrossedMask[idx];
+
+    for (uint8_t p = 0; p < count; p++) {
+        if (!(crossed & (1U << p)) && currentValue >= hot.dksPressValue[idx][p]) {
+            crossed |= (1U << p);
+            applyDksAction(btn, btn->dksPressAction[p], btn->dksVirtualPin[p]);
+        }
+    }
+
+    for (uint8_t p = count; p-- > 0;) {
+        if ((crossed & (1U << p)) && currentValue <= hot.dksReleaseValue[idx][p]) {
+            crossed &= ~(1U << p);
+            applyDksAction(btn, btn->dksReleaseAction[p], btn->dksVirtualPin[p]);
+        }
+    }
+
+    hot.dksCrossedMask[idx] = crossed;
+}
+
+/**
+ * 执行触发点动作
+ * @param btn 按钮指针
+ * @param action 动作
+ * @param target 目标虚拟引脚
+ */
+void ADCBtnsWorker::applyDksAction(ADCBtn* btn, const DKSAction action, const uint8_t target) {
+    const uint32_t bit = 1U << target;
+
+    switch (action) {
+        case DKSAction::DKS_ACTION_PRESS:
+            btn->dksHeldMask |= bit;
+            break;
+        case DKSAction::DKS_ACTION_RELEASE:
+            btn->dksHeldMask &= ~bit;
+            break;
+        case DKSAction::DKS_ACTION_TAP:
+            dksTapMask |= bit;
+            dksTapStartCycles[target] = MICROS_TIMER.cycles();
+            break;
+        default:
+            return;
+    }
+
+    dksChanged = true;
+}
+
+/**
+ * 合并所有按键保持的目标和点按中的目标，点按超过 DKS_TAP_DURATION_US 后释放
+ */
+void ADCBtnsWorker::updateDksOutput() {
+    if (dksTapMask) {
+        // DWT 周期计数无符号相减，跨越计数器回绕时仍然正确
+        const uint32_t nowCycles = MICROS_TIMER.cycles();
+        uint32_t taps = dksTapMask;
+        while (taps) {
+            const uint8_t target = (uint8_t)__builtin_ctz(taps);
+            taps &= taps - 1;
+            if ((uint32_t)(nowCycles - dksTapStartCycles[target]) >= DKS_TAP_DURATION_CYCLES) {
+                dksTapMask &= ~(1U << target);
+            }
+        }
+    }
+
+    uint32_t mask = dksTapMask;
+    for (uint8_t i = 0; i < NUM_ADC_BUTTONS; i++) {
+        if (hot.dksPointCount[i] != 0) {
+            mask |= buttonPtrs[i]->dksHeldMask;
+        }
+    }
+
+    uint32_t changed = mask ^ dksOutputMask;
+    if (changed) {
+        // 新按下的目标记录按下序号，同一次扫描按下的目标序号相同
+        uint32_t pressed = changed & mask & ((1U << NUM_ADC_BUTTONS) - 1);
+        if (pressed) {
+            const uint32_t sequence = ++pressSequence;
+            while (pressed) {
+                hot.pressSequence[__builtin_ctz(pressed)] = sequence;
+                pressed &= pressed - 1;
+            }
+        }
+
+        dksOutputMask = mask;
+        buttonTriggerStatusChanged = true;
+        while (changed) {
+            LATENCY_TRACE_BUTTON_CHANGED((uint8_t)__builtin_ctz(changed));
+            changed &= changed - 1;
+        }
+    }
+
+    dksChanged = false;
+}
+
+/**
+ * 清空多点触发的输出状态
+ */
+void ADCBtnsWorker::resetDks() {
+    dksOutputMask = 0;
+    dksTapMask = 0;
+    dksChanged = false;
+    memset(dksTapStartCycles, 0, sizeof(dksTapStartCycles));
 }
 
 /**
@@ -913,4 +1752,31 @@ void ADCBtnsWorker::resetDebounceState() {
  */
 uint8_t ADCBtnsWorker::getButtonDebounceState(uint8_t buttonIndex) const {
     return debounceFilter_.getButtonDebounceState(buttonIndex);
+}
+
+/**
+ * @brief 获取指定按钮在某个ADC值处的行程距离 (调试用)
+ * @param buttonIndex 按钮索引
+ * @param adcValue ADC值
+ * @param scanMapping true 时遍历映射表计算，false 时查表
+ * @return 行程距离（mm）
+ */
+float ADCBtnsWorker::getButtonDistance(uint8_t buttonIndex, uint16_t adcValue, bool scanMapping) {
+    if (buttonIndex >= NUM_ADC_BUTTONS || !buttonPtrs[buttonIndex]) {
+        return 0.0f;
+    }
+    ADCBtn* btn = buttonPtrs[buttonIndex];
+    return scanMapping ? calcDistanceByValue(btn, adcValue) : getDistanceByValue(btn, adcValue);
+}
+
+/**
+ * @brief 获取指定按钮自适应防抖使用的噪声幅度 (调试用)
+ * @param buttonIndex 按钮索引
+ * @return 相邻采样差值的滑动平均（Q4，ADC值 × 16）
+ */
+uint16_t ADCBtnsWorker::getButtonNoiseLevel(uint8_t buttonIndex) const {
+    if (buttonIndex >= NUM_ADC_BUTTONS) {
+        return 0;
+    }
+    return hot.noiseQ4[buttonIndex];
 }
\ No newline at end of file
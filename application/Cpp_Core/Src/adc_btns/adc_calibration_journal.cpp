@@ -0,0 +1,137 @@
+#include "adc_btns/adc_calibration_journal.hpp"
+#include <stddef.h>
+#include <string.h>
+#include "CRC32.hpp"
+#include "system_logger.h"
+
+#define ADC_CALIBRATION_JOURNAL_MAGIC       0x4A434441      // "ADCJ"
+// 按页读取日志扇区，记录按16字节对齐，不会跨页
+#define ADC_CALIBRATION_JOURNAL_READ_SIZE   W25Qxx_PageSize
+
+static_assert(ADC_CALIBRATION_JOURNAL_SIZE == W25Qxx_SECTOR_SIZE, "ADC calibration journal must occupy exactly one sector");
+static_assert(sizeof(ADCCalibrationRecord) == 16, "ADC calibration record must stay 16 bytes");
+static_assert(ADC_CALIBRATION_JOURNAL_READ_SIZE % sizeof(ADCCalibrationRecord) == 0, "ADC calibration records must not cross pages");
+
+ADCCalibrationJournal::ADCCalibrationJournal()
+    : address_(0)
+    , writeOffset_(0)
+    , valid_(false) {
+}
+
+uint32_t ADCCalibrationJournal::calculateCrc(const ADCCalibrationRecord& record) {
+    return CRC32::calculate((const uint8_t*)&record, offsetof(ADCCalibrationRecord, crc));
+}
+
+bool ADCCalibrationJournal::isErased(const ADCCalibrationRecord& record) {
+    const uint8_t* bytes = (const uint8_t*)&record;
+    for(uint8_t i = 0; i < sizeof(ADCCalibrationRecord); i++) {
+        if(bytes[i] != 0xFF) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ADCCalibrationJournal::load(const uint32_t address, const uint32_t baseCrc, ReplayHandler handler, void* context) {
+    address_ = address;
+    writeOffset_ = sizeof(Header);
+    valid_ = false;
+
+    uint8_t buffer[ADC_CALIBRATION_JOURNAL_READ_SIZE];
+    if(QSPI_W25Qxx_ReadBuffer_WithXIPOrNot(buffer, address_, sizeof(buffer)) != QSPI_W25Qxx_OK) {
+        APP_ERR("ADCCalibrationJournal: read header failed");
+        return false;
+    }
+
+    Header header;
+    memcpy(&header, buffer, sizeof(Header));
+    if(header.magic != ADC_CALIBRATION_JOURNAL_MAGIC
+        || header.version != ADC_MAPPING_VERSION
+        || header.headerCrc != CRC32::calculate((const uint8_t*)&header, offsetof(Header, headerCrc))) {
+        APP_DBG("ADCCalibrationJournal: no valid header");
+        return false;
+    }
+
+    if(header.baseCrc != baseCrc) {
+        APP_DBG("ADCCalibrationJournal: base store changed, discard journal");
+        return false;
+    }
+
+    uint16_t applied = 0;
+    uint16_t skipped = 0;
+    for(uint32_t page = 0; page < ADC_CALIBRATION_JOURNAL_SIZE; page += ADC_CALIBRATION_JOURNAL_READ_SIZE) {
+        if(page > 0 && QSPI_W25Qxx_ReadBuffer_WithXIPOrNot(buffer, address_ + page, sizeof(buffer)) != QSPI_W25Qxx_OK) {
+            APP_ERR("ADCCalibrationJournal: read page failed, offset: 0x%x", (unsigned int)page);
+            return false;
+        }
+
+        for(uint32_t offset = (page == 0 ? sizeof(Header) : 0); offset < sizeof(buffer); offset += sizeof(ADCCalibrationRecord)) {
+            ADCCalibrationRecord record;
+            memcpy(&record, buffer + offset, sizeof(ADCCalibrationRecord));
+
+            // 记录按顺序追加，第一条空记录之后都是空的
+            if(isErased(record)) {
+                valid_ = true;
+                APP_DBG("ADCCalibrationJournal: replayed %d records, skipped %d", applied, skipped);
+                return true;
+            }
+
+            writeOffset_ = page + offset + sizeof(ADCCalibrationRecord);
+            if(record.crc != calculateCrc(record) || record.mappingIndex >= NUM_ADC_VALUES_MAPPING || record.buttonIndex >= NUM_ADC_BUTTONS) {
+                skipped++;
+                continue;
+            }
+
+            if(handler) {
+                handler(context, record);
+            }
+            applied++;
+        }
+    }
+
+    // 扇区已写满，记录仍然有效，下一次追加前由调用方压缩
+    valid_ = true;
+    APP_DBG("ADCCalibrationJournal: replayed %d records, skipped %d, journal full", applied, skipped);
+    return true;
+}
+
+int8_t ADCCalibrationJournal::reset(const uint32_t baseCrc) {
+    valid_ = false;
+    writeOffset_ = sizeof(Header);
+
+    int8_t status = QSPI_W25Qxx_SectorErase_WithXIPOrNot(address_);
+    if(status != QSPI_W25Qxx_OK) {
+        APP_ERR("ADCCalibrationJournal: erase failed, status: %d", status);
+        return status;
+    }
+
+    Header header;
+    header.magic = ADC_CALIBRATION_JOURNAL_MAGIC;
+    header.version = ADC_MAPPING_VERSION;
+    header.baseCrc = baseCrc;
+    header.headerCrc = CRC32::calculate((const uint8_t*)&header, offsetof(Header, headerCrc));
+
+    status = QSPI_W25Qxx_ProgramBuffer_WithXIPOrNot((uint8_t*)&header, address_, sizeof(Header));
+    if(status != QSPI_W25Qxx_OK) {
+        APP_ERR("ADCCalibrationJournal: write header failed, status: %d", status);
+        return status;
+    }
+
+    valid_ = true;
+    return QSPI_W25Qxx_OK;
+}
+
+int8_t ADCCalibrationJournal::append(const ADCCalibrationRecord& record) {
+    if(isFull()) {
+        return W25Qxx_ERROR_TRANSMIT;
+    }
+
+    ADCCalibrationRecord entry = record;
+    memset(entry.reserved, 0, sizeof(entry.reserved));
+    entry.crc = calculateCrc(entry);
+
+    const uint32_t offset = writeOffset_;
+    // 写入失败的位置可能已经部分编程，不再复用
+    writeOffset_ += sizeof(ADCCalibrationRecord);
+    return QSPI_W25Qxx_ProgramBuffer_WithXIPOrNot((uint8_t*)&entry, address_ + offset, sizeof(ADCCalibrationRecord));
+}
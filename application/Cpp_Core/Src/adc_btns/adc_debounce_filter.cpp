@@ -1,4 +1,5 @@
 #include "adc_btns/adc_debounce_filter.hpp"
+#include <string.h>
 
 /*
  * ======================================================================
@@ -16,6 +17,8 @@
  * 1. 每个按钮维护独立的状态机
  * 2. 连续N次检测到相同状态才确认状态变化
  * 3. 状态变化时重置计数器
+ * 4. 状态机按位切片保存：每个按钮占32位字中的一位，计数器拆成 ADC_DEBOUNCE_COUNTER_BITS 个位平面，
+ *    一次扫描所有按钮的状态更新都是整字逻辑运算
  * 
  * ======================================================================
  */
@@ -24,23 +27,98 @@ ADCDebounceFilter::ADCDebounceFilter(const Config& config) : config_(config) {
     reset();
 }
 
-uint32_t ADCDebounceFilter::filterMask(uint32_t currentMask, uint32_t currentTime) {
-    uint32_t result = 0;
-    for (uint8_t i = 0; i < NUM_ADC_BUTTONS; i++) {
-        bool currentBit = (currentMask & (1U << i)) != 0;
-        bool filteredBit = filterUltraFastSingle(i, currentBit);
-        if (filteredBit) {
-            result |= (1U << i);
+/**
+ * 计数器 >= 阈值 的按钮掩码
+ * 从最高位开始逐位和阈值常量比较，分支只依赖阈值，不依赖按钮
+ */
+uint32_t ADCDebounceFilter::counterReachedThreshold() const {
+    const uint8_t threshold = config_.ultrafastThreshold;
+    uint32_t greater = 0;
+    uint32_t equal = 0xFFFFFFFF;
+
+    for (int8_t k = ADC_DEBOUNCE_COUNTER_BITS - 1; k >= 0; k--) {
+        if (threshold & (1U << k)) {
+            equal &= counterPlanes_[k];
+        } else {
+            greater |= equal & counterPlanes_[k];
+            equal &= ~counterPlanes_[k];
+        }
+    }
+    return greater | equal;
+}
+
+uint32_t ADCDebounceFilter::filter(uint32_t inputMask, uint32_t activeMask) {
+    activeMask &= (1U << NUM_ADC_BUTTONS) - 1;
+
+    const uint32_t changed = activeMask & (inputMask ^ lastInputMask_);
+    const uint32_t same = activeMask & ~changed;
+
+    // 输入值未变化：计数器未达到阈值时加1（按位切片的行波进位加法）
+    uint32_t carry = same & ~counterReachedThreshold();
+    for (uint8_t k = 0; k < ADC_DEBOUNCE_COUNTER_BITS; k++) {
+        const uint32_t nextCarry = counterPlanes_[k] & carry;
+        counterPlanes_[k] ^= carry;
+        carry = nextCarry;
+    }
+
+    // 输入值发生变化：计数器置1，记录新的输入值
+    counterPlanes_[0] |= changed;
+    for (uint8_t k = 1; k < ADC_DEBOUNCE_COUNTER_BITS; k++) {
+        counterPlanes_[k] &= ~changed;
+    }
+    lastInputMask_ = (lastInputMask_ & ~changed) | (inputMask & changed);
+
+    // 输入值未变化且达到阈值，更新稳定状态
+    const uint32_t reached = same & counterReachedThreshold();
+    lastStableMask_ = (lastStableMask_ & ~reached) | (inputMask & reached);
+
+    // 返回稳定状态与当前状态一致的按钮
+    return activeMask & ~(lastStableMask_ ^ inputMask);
+}
+
+uint32_t ADCDebounceFilter::filterAdaptive(uint32_t inputMask, uint32_t activeMask, uint32_t nowCycles) {
+    const uint32_t lanes = (1U << NUM_ADC_BUTTONS) - 1;
+    activeMask &= lanes;
+
+    // 不是候选的按钮输入回到稳定状态，下次成为候选时重新开始计时
+    lastInputMask_ = (lastInputMask_ & activeMask) | (lastStableMask_ & ~activeMask & lanes);
+
+    // 输入值发生变化的按钮重新开始计时
+    uint32_t changed = activeMask & (inputMask ^ lastInputMask_);
+    lastInputMask_ = (lastInputMask_ & ~changed) | (inputMask & changed);
+    while (changed) {
+        const uint8_t i = (uint8_t)__builtin_ctz(changed);
+        changed &= changed - 1;
+        inputSince_[i] = nowCycles;
+    }
+
+    // 持续时间达到确认时间的按钮更新稳定状态
+    uint32_t pending = activeMask & (lastStableMask_ ^ inputMask);
+    while (pending) {
+        const uint8_t i = (uint8_t)__builtin_ctz(pending);
+        pending &= pending - 1;
+        if (nowCycles - inputSince_[i] >= windowCycles_[i]) {
+            lastStableMask_ ^= (1U << i);
         }
     }
-    return result;
+
+    return activeMask & ~(lastStableMask_ ^ inputMask);
+}
+
+uint32_t ADCDebounceFilter::filterMask(uint32_t currentMask, uint32_t currentTime) {
+    if (config_.adaptive) {
+        return filterAdaptive(currentMask, (1U << NUM_ADC_BUTTONS) - 1, currentTime);
+    }
+    return filter(currentMask, (1U << NUM_ADC_BUTTONS) - 1);
 }
 
 void ADCDebounceFilter::reset() {
     // 重置超快版本状态
-    for (uint8_t i = 0; i < NUM_ADC_BUTTONS; i++) {
-        ultrafastStates_[i] = UltraFastButtonState();
-    }
+    lastStableMask_ = 0;
+    lastInputMask_ = 0;
+    memset(counterPlanes_, 0, sizeof(counterPlanes_));
+    memset(inputSince_, 0, sizeof(inputSince_));
+    memset(windowCycles_, 0, sizeof(windowCycles_));
 }
 
 void ADCDebounceFilter::resetButton(uint8_t buttonIndex) {
@@ -49,11 +127,21 @@ void ADCDebounceFilter::resetButton(uint8_t buttonIndex) {
     }
     
     // 超快版本
-    ultrafastStates_[buttonIndex] = UltraFastButtonState();
+    const uint32_t clearMask = ~(1U << buttonIndex);
+    lastStableMask_ &= clearMask;
+    lastInputMask_ &= clearMask;
+    for (uint8_t k = 0; k < ADC_DEBOUNCE_COUNTER_BITS; k++) {
+        counterPlanes_[k] &= clearMask;
+    }
+    inputSince_[buttonIndex] = 0;
+    windowCycles_[buttonIndex] = 0;
 }
 
 void ADCDebounceFilter::setConfig(const Config& config) {
     config_ = config;
+    if (config_.ultrafastThreshold > ADC_DEBOUNCE_COUNTER_MAX) {
+        config_.ultrafastThreshold = ADC_DEBOUNCE_COUNTER_MAX;
+    }
     reset(); // 重置状态以应用新配置
 }
 
@@ -62,7 +150,11 @@ uint8_t ADCDebounceFilter::getButtonDebounceState(uint8_t buttonIndex) const {
         return 0;
     }
     
-    return ultrafastStates_[buttonIndex].sameValueCounter;
+    uint8_t counter = 0;
+    for (uint8_t k = 0; k < ADC_DEBOUNCE_COUNTER_BITS; k++) {
+        counter |= ((counterPlanes_[k] >> buttonIndex) & 1U) << k;
+    }
+    return counter;
 }
 
 void ADCDebounceFilter::getDetailedDebounceState(uint8_t buttonIndex, bool& lastInput, bool& stableValue, uint8_t& counter) const {
@@ -73,35 +165,7 @@ void ADCDebounceFilter::getDetailedDebounceState(uint8_t buttonIndex, bool& last
         return;
     }
     
-    const UltraFastButtonState& state = ultrafastStates_[buttonIndex];
-    lastInput = state.lastInputValue;
-    stableValue = state.lastStableValue;
-    counter = state.sameValueCounter;
+    lastInput = (lastInputMask_ >> buttonIndex) & 1U;
+    stableValue = (lastStableMask_ >> buttonIndex) & 1U;
+    counter = getButtonDebounceState(buttonIndex);
 }
-
-bool ADCDebounceFilter::filterUltraFastSingle(uint8_t buttonIndex, bool currentState) {
-    if (buttonIndex >= NUM_ADC_BUTTONS) {
-        return currentState; // 边界检查
-    }
-    
-    UltraFastButtonState& state = ultrafastStates_[buttonIndex];
-    
-    if (currentState == state.lastInputValue) {
-        // 输入值未变化，增加相同值计数器
-        if (state.sameValueCounter < config_.ultrafastThreshold) {
-            state.sameValueCounter++;
-        }
-        
-        // 如果达到阈值且与当前稳定状态不同，则更新稳定状态
-        if (state.sameValueCounter >= config_.ultrafastThreshold && currentState != state.lastStableValue) {
-            state.lastStableValue = currentState;
-        }
-    } else {
-        // 输入值发生变化，重置计数器并记录新的输入值
-        state.lastInputValue = currentState;
-        state.sameValueCounter = 1;
-    }
-    
-    // 返回当前稳定状态
-    return (state.lastStableValue == currentState);
-} 
\ No newline at end of file
@@ -0,0 +1,103 @@
+#include "adc_btns/adc_drift_compensator.hpp"
+#include <string.h>
+#include "adc.h"
+
+ADCDriftCompensator::ADCDriftCompensator()
+    : temperature_(0.0f)
+    , temperatureValid_(false)
+    , conversionStarted_(false) {
+    reset();
+}
+
+bool ADCDriftCompensator::sampleTemperature() {
+    bool updated = false;
+
+    if(conversionStarted_ && __HAL_ADC_GET_FLAG(&hadc3, ADC_FLAG_JEOS)) {
+        const uint32_t tsData = HAL_ADCEx_InjectedGetValue(&hadc3, ADC_INJECTED_RANK_1);
+        const uint32_t vrefData = HAL_ADCEx_InjectedGetValue(&hadc3, ADC_INJECTED_RANK_2);
+        __HAL_ADC_CLEAR_FLAG(&hadc3, ADC_FLAG_JEOC | ADC_FLAG_JEOS);
+        conversionStarted_ = false;
+
+        const int32_t tsCal1 = *TEMPSENSOR_CAL1_ADDR;
+        const int32_t tsCal2 = *TEMPSENSOR_CAL2_ADDR;
+        if(vrefData != 0 && tsCal2 != tsCal1) {
+            // 出厂校准值在 VDDA = 3.3V 下采集，先按 VREFINT 换算实际 VDDA，再把温度传感器读数归一到校准电压
+            const float vddaMv = (float)VREFINT_CAL_VREF * (float)(*VREFINT_CAL_ADDR) / (float)vrefData;
+            const float tsScaled = (float)tsData * vddaMv / (float)TEMPSENSOR_CAL_VREFANALOG;
+            const float celsius = (float)(TEMPSENSOR_CAL2_TEMP - TEMPSENSOR_CAL1_TEMP) * (tsScaled - (float)tsCal1)
+                / (float)(tsCal2 - tsCal1) + (float)TEMPSENSOR_CAL1_TEMP;
+            updateTemperature(celsius);
+            updated = true;
+        }
+    }
+
+    // 注入转换插入在规则组转换之间，按键的DMA采样只会推迟一次转换的时间
+    if(!conversionStarted_) {
+        conversionStarted_ = HAL_ADCEx_InjectedStart(&hadc3) == HAL_OK;
+    }
+
+    return updated;
+}
+
+void ADCDriftCompensator::updateTemperature(const float celsius) {
+    if(!temperatureValid_) {
+        temperature_ = celsius;
+        temperatureValid_ = true;
+        return;
+    }
+    temperature_ += (celsius - temperature_) * (1.0f / (1 << ADC_DRIFT_TEMPERATURE_SHIFT));
+}
+
+/**
+ * 指数加权的均值/方差/协方差递推
+ * 采样次数不足窗口时按 1/n 等权累积，之后固定权重 1/ADC_DRIFT_MODEL_WINDOW
+ */
+void ADCDriftCompensator::addIdleSample(const uint8_t buttonIndex, const float celsius, const int32_t residual) {
+    if(buttonIndex >= NUM_ADC_BUTTONS) {
+        return;
+    }
+
+    ButtonModel& model = models_[buttonIndex];
+    if(model.samples < ADC_DRIFT_MODEL_WINDOW) {
+        model.samples++;
+    }
+    const float weight = 1.0f / (float)model.samples;
+
+    const float dT = celsius - model.meanT;
+    const float dR = (float)residual - model.meanR;
+    model.meanT += weight * dT;
+    model.meanR += weight * dR;
+    model.varT = (1.0f - weight) * (model.varT + weight * dT * dT);
+    model.covTR = (1.0f - weight) * (model.covTR + weight * dT * dR);
+}
+
+int32_t ADCDriftCompensator::getOffset(const uint8_t buttonIndex, const float celsius) const {
+    if(buttonIndex >= NUM_ADC_BUTTONS) {
+        return 0;
+    }
+
+    const ButtonModel& model = models_[buttonIndex];
+    if(model.samples < ADC_DRIFT_MIN_SAMPLES) {
+        return 0;
+    }
+
+    const float slope = model.covTR / (model.varT + ADC_DRIFT_MIN_TEMP_VARIANCE);
+    const float offset = model.meanR + slope * (celsius - model.meanT);
+    return (int32_t)(offset + (offset >= 0.0f ? 0.5f : -0.5f));
+}
+
+void ADCDriftCompensator::shiftBaseline(const uint8_t buttonIndex, const int32_t delta) {
+    if(buttonIndex < NUM_ADC_BUTTONS) {
+        models_[buttonIndex].meanR -= (float)delta;
+    }
+}
+
+void ADCDriftCompensator::resetButton(const uint8_t buttonIndex) {
+    if(buttonIndex < NUM_ADC_BUTTONS) {
+        memset(&models_[buttonIndex], 0, sizeof(ButtonModel));
+    }
+}
+
+void ADCDriftCompensator::reset() {
+    memset(models_, 0, sizeof(models_));
+}
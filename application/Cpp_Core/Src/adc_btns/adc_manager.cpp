@@ -4,6 +4,7 @@
 #include "board_cfg.h"
 #include "micro_timer.hpp"
 #include "system_logger.h"
+#include "CRC32.hpp"
 
 // 内存图
 /*
@@ -22,19 +23,36 @@
  * | - ADCValuesMapping[1] |
  * | ...                   |
  * +------------------------+
+ *
+ * 校准值追加日志 (ADC_VALUES_MAPPING_ADDR + ADC_CALIBRATION_JOURNAL_OFFSET，一个扇区):
+ * +------------------------+ 0x00
+ * | 头部 (16 bytes)       |  魔数 / 版本 / 基准存储CRC32 / 头部CRC32
+ * +------------------------+ 0x10
+ * | 校准记录 (8 bytes)    |  映射索引 / 按钮索引 / 标志 / 校验 / 释放值 / 按下值
+ * | ...                   |
+ * | 0xFF (未写入)         |
+ * +------------------------+ 0x1000
+ *
+ * 单个按键的校准值修改只追加一条记录，上电时在读出的存储上按顺序回放；
+ * 日志写满或映射存储整体写入时，存储写入后清空日志。
  */
 
 
 
-// 定义静态 ADC DMA 缓冲区
-__attribute__((section(".DMA_Section"))) uint32_t ADCManager::ADC1_Values[NUM_ADC1_BUTTONS];
-__attribute__((section(".DMA_Section"))) uint32_t ADCManager::ADC2_Values[NUM_ADC2_BUTTONS];
+// 定义静态 ADC DMA 缓冲区，按D-Cache行对齐，转换完成中断中只无效化各自的缓存行
+__attribute__((section(".DMA_Section"), aligned(32))) uint32_t ADCManager::ADC1_Values[ADC_DMA_BUFFER_LENGTH(NUM_ADC1_BUTTONS)];
+__attribute__((section(".DMA_Section"), aligned(32))) uint32_t ADCManager::ADC2_Values[ADC_DMA_BUFFER_LENGTH(NUM_ADC2_BUTTONS)];
 // ADC3 BDMA 只能访问 _RAM_D3_Area 区域
-__attribute__((section(".BDMA_Section"))) uint32_t ADCManager::ADC3_Values[NUM_ADC3_BUTTONS];
+__attribute__((section(".BDMA_Section"), aligned(32))) uint32_t ADCManager::ADC3_Values[ADC_DMA_BUFFER_LENGTH(NUM_ADC3_BUTTONS)];
 
 uint32_t ADCManager::ADC_Values_Result[NUM_ADC_BUTTONS];
 
 #define ADC_VALUES_MAPPING_ADDR_QSPI (ADC_VALUES_MAPPING_ADDR & 0x0FFFFFFF)
+#define ADC_CALIBRATION_JOURNAL_ADDR_QSPI (ADC_VALUES_MAPPING_ADDR_QSPI + ADC_CALIBRATION_JOURNAL_OFFSET)
+
+static_assert(sizeof(ADCValuesMappingStore) <= ADC_CALIBRATION_JOURNAL_OFFSET, "ADC mapping store overlaps the calibration journal");
+static_assert(sizeof(ADCValuesMappingStore) <= UINT16_MAX, "ADC mapping store too large for CRC32::calculate");
+static_assert(NUM_ADC_BUTTONS <= 32, "pending calibration masks hold at most 32 buttons");
 
 const uint8_t ADC1_BUTTONS_MAPPING[NUM_ADC1_BUTTONS] = ADC1_BUTTONS_MAPPING_DMA_TO_VIRTUALPIN;
 const uint8_t ADC2_BUTTONS_MAPPING[NUM_ADC2_BUTTONS] = ADC2_BUTTONS_MAPPING_DMA_TO_VIRTUALPIN;
@@ -68,6 +86,16 @@ ADCManager::ADCManager() {
         }
     }
     
+    // 回放校准日志，日志与存储不匹配时清空日志
+    memset(pendingAutoCalibrationMask, 0, sizeof(pendingAutoCalibrationMask));
+    memset(pendingManualCalibrationMask, 0, sizeof(pendingManualCalibrationMask));
+    const uint32_t storeCrc = CRC32::calculate((const uint8_t*)&store, sizeof(ADCValuesMappingStore));
+    if(!calibrationJournal.load(ADC_CALIBRATION_JOURNAL_ADDR_QSPI, storeCrc, onCalibrationRecord, this)) {
+        if(calibrationJournal.reset(storeCrc) != QSPI_W25Qxx_OK) {
+            APP_ERR("ADCManager: calibration journal reset failed");
+        }
+    }
+
     APP_DBG("ADCManager init: store version - %d, num - %d, defaultId - %s", store.version, store.num, store.defaultId);
 
     // 注册消息
@@ -104,6 +132,19 @@ ADCManager::ADCManager() {
             return a.virtualPin < b.virtualPin;
         });
 
+    // 建立 DMA通道 -> 排序后索引 的映射，用于帧快照的读取
+    memset(this->frameSnapshots, 0, sizeof(this->frameSnapshots));
+    memset(this->lastFrameSequence, 0, sizeof(this->lastFrameSequence));
+    memset(this->frameIndexMap, 0, sizeof(this->frameIndexMap));
+    resetFrameStats();
+    for(uint8_t i = 0; i < NUM_ADC_BUTTONS; i++) {
+        for(uint8_t adcIndex = 0; adcIndex < NUM_ADC; adcIndex++) {
+            const ADCBufferInfo& info = this->adcBufferInfo[adcIndex];
+            if(this->ADCBufferInfoList[i].valuePtr >= info.buffer && this->ADCBufferInfoList[i].valuePtr < info.buffer + info.count) {
+                this->frameIndexMap[adcIndex][this->ADCBufferInfoList[i].valuePtr - info.buffer] = i;
+            }
+        }
+    }
 
 }
 
@@ -115,10 +156,69 @@ ADCManager::~ADCManager() {
     MC.unregisterMessage(MessageId::ADC_SAMPLING_STATS_COMPLETE);
 }
 
-// 保存整个存储结构到Flash
+// 保存整个存储结构到Flash，之前的校准日志已经包含在存储中，随后清空日志
 int8_t ADCManager::saveStore() {
     APP_DBG("ADCManager: saveStore - begin save store to flash.");
-    return QSPI_W25Qxx_WriteBuffer_WithXIPOrNot((uint8_t*)&store, ADC_VALUES_MAPPING_ADDR_QSPI, sizeof(ADCValuesMappingStore));
+    int8_t status = QSPI_W25Qxx_WriteBuffer_WithXIPOrNot((uint8_t*)&store, ADC_VALUES_MAPPING_ADDR_QSPI, sizeof(ADCValuesMappingStore));
+    if(status != QSPI_W25Qxx_OK) {
+        return status;
+    }
+
+    memset(pendingAutoCalibrationMask, 0, sizeof(pendingAutoCalibrationMask));
+    memset(pendingManualCalibrationMask, 0, sizeof(pendingManualCalibrationMask));
+
+    // 日志清空失败时存储已经是最新的，日志保持无效，下一次追加记录时重新整体写入
+    if(calibrationJournal.reset(CRC32::calculate((const uint8_t*)&store, sizeof(ADCValuesMappingStore))) != QSPI_W25Qxx_OK) {
+        APP_ERR("ADCManager: saveStore - calibration journal reset failed.");
+    }
+    return QSPI_W25Qxx_OK;
+}
+
+// 回放一条校准日志记录到内存中的存储
+void ADCManager::onCalibrationRecord(void* context, const ADCCalibrationRecord& record) {
+    ADCManager* manager = static_cast<ADCManager*>(context);
+    if(record.mappingIndex >= manager->store.num) {
+        return;
+    }
+
+    ADCValuesMapping& mapping = manager->store.mapping[record.mappingIndex];
+    if(record.flags & ADC_CALIBRATION_RECORD_FLAG_AUTO) {
+        mapping.autoCalibrationValues[record.buttonIndex].topValue = record.topValue;
+        mapping.autoCalibrationValues[record.buttonIndex].bottomValue = record.bottomValue;
+    } else {
+        mapping.manualCalibrationValues[record.buttonIndex].topValue = record.topValue;
+        mapping.manualCalibrationValues[record.buttonIndex].bottomValue = record.bottomValue;
+    }
+}
+
+/**
+ * @brief 把内存中一个按键的校准值追加到校准日志
+ * 日志已满（或无效、写入失败）时整体写入存储，相当于压缩日志
+ * @param mappingIndex 映射索引
+ * @param buttonIndex 按钮索引
+ * @param isAutoCalibration 是否为自动校准
+ * @return 错误码
+ */
+ADCBtnsError ADCManager::appendCalibrationRecord(const uint8_t mappingIndex, const uint8_t buttonIndex, const bool isAutoCalibration) {
+    if(!calibrationJournal.isFull()) {
+        const ADCValuesMapping& mapping = store.mapping[mappingIndex];
+        ADCCalibrationRecord record;
+        record.mappingIndex = mappingIndex;
+        record.buttonIndex = buttonIndex;
+        record.flags = isAutoCalibration ? ADC_CALIBRATION_RECORD_FLAG_AUTO : 0;
+        record.topValue = isAutoCalibration ? mapping.autoCalibrationValues[buttonIndex].topValue : mapping.manualCalibrationValues[buttonIndex].topValue;
+        record.bottomValue = isAutoCalibration ? mapping.autoCalibrationValues[buttonIndex].bottomValue : mapping.manualCalibrationValues[buttonIndex].bottomValue;
+
+        if(calibrationJournal.append(record) == QSPI_W25Qxx_OK) {
+            return ADCBtnsError::SUCCESS;
+        }
+        APP_ERR("ADCManager: calibration journal append failed, save whole store.");
+    }
+
+    if(saveStore() != QSPI_W25Qxx_OK) {
+        return ADCBtnsError::MAPPING_UPDATE_FAILED;
+    }
+    return ADCBtnsError::SUCCESS;
 }
 
 /**
@@ -365,9 +465,10 @@ ADCBtnsError ADCManager::getCalibrationValues(const char* mappingId, uint8_t but
  * @param isAutoCalibration 是否为自动校准
  * @param topValue 顶部值(完全按下)
  * @param bottomValue 底部值(完全释放)
+ * @param saveToFlash 是否立即写入Flash（追加一条校准日志记录），为 false 时只更新内存，再调用 commitCalibrationValues 写入
  * @return 错误码
  */
-ADCBtnsError ADCManager::setCalibrationValues(const char* mappingId, uint8_t buttonIndex, bool isAutoCalibration, uint16_t topValue, uint16_t bottomValue) {
+ADCBtnsError ADCManager::setCalibrationValues(const char* mappingId, uint8_t buttonIndex, bool isAutoCalibration, uint16_t topValue, uint16_t bottomValue, bool saveToFlash) {
     if (!mappingId || buttonIndex >= NUM_ADC_BUTTONS) {
         return ADCBtnsError::INVALID_PARAMS;
     }
@@ -387,9 +488,36 @@ ADCBtnsError ADCManager::setCalibrationValues(const char* mappingId, uint8_t but
         mapping.manualCalibrationValues[buttonIndex].bottomValue = bottomValue;
     }
     
-    // 保存到存储
-    if (saveStore() != QSPI_W25Qxx_OK) {
-        return ADCBtnsError::MAPPING_UPDATE_FAILED;
+    uint32_t& pendingMask = isAutoCalibration ? pendingAutoCalibrationMask[idx] : pendingManualCalibrationMask[idx];
+    if (!saveToFlash) {
+        pendingMask |= (1U << buttonIndex);
+        return ADCBtnsError::SUCCESS;
+    }
+
+    // 追加到校准日志
+    pendingMask &= ~(1U << buttonIndex);
+    return appendCalibrationRecord(idx, buttonIndex, isAutoCalibration);
+}
+
+/**
+ * @brief 把内存中修改过的校准值写入Flash
+ * 每个修改过的按键追加一条校准日志记录，日志写满时整体写入存储（同时包含其余尚未写入的修改）
+ * @return 错误码
+ */
+ADCBtnsError ADCManager::commitCalibrationValues() {
+    for (uint8_t i = 0; i < NUM_ADC_VALUES_MAPPING; i++) {
+        // 整体写入存储会清空所有掩码，每次从掩码中重新取下一个按键
+        while (pendingAutoCalibrationMask[i] != 0 || pendingManualCalibrationMask[i] != 0) {
+            const bool isAutoCalibration = pendingAutoCalibrationMask[i] != 0;
+            uint32_t& pendingMask = isAutoCalibration ? pendingAutoCalibrationMask[i] : pendingManualCalibrationMask[i];
+            const uint8_t buttonIndex = __builtin_ctz(pendingMask);
+            pendingMask &= ~(1U << buttonIndex);
+
+            if (appendCalibrationRecord(i, buttonIndex, isAutoCalibration) != ADCBtnsError::SUCCESS) {
+                pendingMask |= (1U << buttonIndex);
+                return ADCBtnsError::MAPPING_UPDATE_FAILED;
+            }
+        }
     }
     
     return ADCBtnsError::SUCCESS;
@@ -466,6 +594,12 @@ ADCBtnsError ADCManager::startADCSamping(bool enableSamplingRate,
     memset(ADC2_Values, 0, sizeof(ADC2_Values)); // DMA缓存清零  
     memset(ADC3_Values, 0, sizeof(ADC3_Values)); // DMA缓存清零
     memset(ADC_Values_Result, 0, sizeof(ADC_Values_Result)); // DMA缓存清零
+    // 写回清零数据，之后中断中只做无效化，避免脏缓存行覆盖DMA数据
+    for(uint8_t i = 0; i < NUM_ADC; i++) {
+        SCB_CleanDCache_by_Addr(adcBufferInfo[i].buffer, adcBufferInfo[i].size);
+        lastFrameSequence[i] = frameSnapshots[i].sequence;
+    }
+    resetFrameStats();
 
     // 校准 ADC1
     if (HAL_ADCEx_Calibration_Start(&hadc1, ADC_CALIB_OFFSET, ADC_SINGLE_ENDED) != HAL_OK) {
@@ -486,7 +620,7 @@ ADCBtnsError ADCManager::startADCSamping(bool enableSamplingRate,
     }
 
     // 启动 ADC1
-    if (HAL_ADC_Start_DMA(&hadc1, (uint32_t*)&ADC1_Values[0], NUM_ADC1_BUTTONS) != HAL_OK) {
+    if (HAL_ADC_Start_DMA(&hadc1, (uint32_t*)&ADC1_Values[0], NUM_ADC1_BUTTONS * ADC_DMA_FRAMES) != HAL_OK) {
         APP_ERR("ADC1 DMA start failed\n");
         return ADCBtnsError::DMA1_START_FAILED;
     }
@@ -494,7 +628,7 @@ ADCBtnsError ADCManager::startADCSamping(bool enableSamplingRate,
     // MICROS_TIMER.delayMicros(READ_BTNS_INTERVAL); // 等待一个轮询周期，均摊延时
 
     // 启动 ADC2
-    if (HAL_ADC_Start_DMA(&hadc2, (uint32_t*)&ADC2_Values[0], NUM_ADC2_BUTTONS) != HAL_OK) {
+    if (HAL_ADC_Start_DMA(&hadc2, (uint32_t*)&ADC2_Values[0], NUM_ADC2_BUTTONS * ADC_DMA_FRAMES) != HAL_OK) {
         APP_ERR("ADC2 DMA start failed\n");
         HAL_ADC_Stop_DMA(&hadc1);  // 清理已启动的 ADC1
         return ADCBtnsError::DMA2_START_FAILED;
@@ -503,7 +637,7 @@ ADCBtnsError ADCManager::startADCSamping(bool enableSamplingRate,
     // MICROS_TIMER.delayMicros(READ_BTNS_INTERVAL); // 等待一个轮询周期，均摊延时
 
     // 启动 ADC3
-    if (HAL_ADC_Start_DMA(&hadc3, (uint32_t*)&ADC3_Values[0], NUM_ADC3_BUTTONS) != HAL_OK) {
+    if (HAL_ADC_Start_DMA(&hadc3, (uint32_t*)&ADC3_Values[0], NUM_ADC3_BUTTONS * ADC_DMA_FRAMES) != HAL_OK) {
         APP_ERR("ADC3 DMA start failed\n");
         HAL_ADC_Stop_DMA(&hadc1);  // 清理已启动的 ADC
         HAL_ADC_Stop_DMA(&hadc2);
@@ -512,8 +646,6 @@ ADCBtnsError ADCManager::startADCSamping(bool enableSamplingRate,
 
     // 如果启用采样率统计，则注册回调
     if(enableSamplingRate) {
-        // 设置采样率统计状态
-        samplingRateEnabled = enableSamplingRate;
         if(samplingCountMax > 0) {
             this->samplingCountMax = samplingCountMax;
         }
@@ -535,13 +667,10 @@ ADCBtnsError ADCManager::startADCSamping(bool enableSamplingRate,
         ADCButtonStats.diffValues.clear();
         ADCButtonStats.diffValues.resize(this->samplingCountMax);
 
-        // 注册ADC转换完成回调
-        messageHandler = [this](const void* data) {
-            if (data) {
-                this->handleADCStats((ADC_HandleTypeDef*)data);
-            }
-        };
-        MC.subscribe(MessageId::DMA_ADC_CONV_CPLT, messageHandler);
+        // 注册采样完成回调，统计准备好之后才允许中断写入采样值
+        MC.subscribe(MessageId::DMA_ADC_CONV_CPLT, &ADCManager::onADCConvCplt, this);
+        __DMB();
+        samplingRateEnabled = true;
 
         APP_DBG("All ADCs started sampling successfully\n");
     }
@@ -551,6 +680,8 @@ ADCBtnsError ADCManager::startADCSamping(bool enableSamplingRate,
 }
 
 void ADCManager::stopADCSamping() {
+    samplingRateEnabled = false;
+
     if(HAL_ADC_Stop_DMA(&hadc1) != HAL_OK) {
         return;
     }
@@ -563,64 +694,238 @@ void ADCManager::stopADCSamping() {
         return;
     }
 
-    if(messageHandler) {
-        MC.unsubscribe(MessageId::DMA_ADC_CONV_CPLT, messageHandler);
-        messageHandler = nullptr;
-    }
+    MC.unsubscribe(MessageId::DMA_ADC_CONV_CPLT, &ADCManager::onADCConvCplt, this);
 }   
 
-
 /**
- * @brief 处理ADC转换完成中断
- * 在每次采样完成后，会调用此函数，用于更新采样统计信息
- * 更新ADCButtonValues的值
- * 如果采样率统计开启，则更新采样统计信息，包括每个通道的平均值、最小值、最大值
- * @param hadc ADC句柄
+ * @brief DMA_ADC_CONV_CPLT 消息回调，采样值采集完成后由主循环分发延迟队列时调用
+ * @param context ADCManager 实例
+ * @param data 采样统计（ADCButtonStats）
  */
-void ADCManager::handleADCStats(ADC_HandleTypeDef *hadc) {
-    uint32_t adcIndex = (hadc->Instance == ADC1) ? 0 : 
-                        (hadc->Instance == ADC2) ? 1 : 
-                        (hadc->Instance == ADC3) ? 2 : 3;
-    
-    // 如果采样ADC索引不匹配，则返回，此处只处理采样ADC索引对应的ADC
-    if(!samplingRateEnabled || adcIndex != this->samplingADCInfo.ADCIndex) return;
+void ADCManager::onADCConvCplt(void* context, const void* data) {
+    if (data) {
+        ((ADCManager*)context)->handleADCStats();
+    }
+}
 
-    // 处理数据...
-    const auto& info = adcBufferInfo[adcIndex];
-    SCB_CleanInvalidateDCache_by_Addr(info.buffer, info.size);
-    
-    uint32_t value = info.buffer[this->samplingADCInfo.indexInDMA];
+/**
+ * @brief 采集一个采样值（中断中调用）
+ * 每一帧的值在中断中保存，采满 samplingCountMax 个后记录结束时间并发布一次消息，
+ * 统计计算放到主循环；采满之后不再写入，消息只入队一次，不会因为主循环来不及处理而重复读取同一帧或丢失采样
+ * @param value 采样按钮在本帧的ADC值
+ */
+void ADCManager::captureSample(const uint32_t value) {
+    if(value == 0 || ADCButtonStats.count >= samplingCountMax) {
+        return;
+    }
 
-    if(value == 0) return;
-    ADCButtonStats.values[ADCButtonStats.count] = value; // 保存当前值
-    ADCButtonStats.count++;                          // 计数器加1
+    ADCButtonStats.values[ADCButtonStats.count] = value;
+    ADCButtonStats.count++;
 
     if(ADCButtonStats.count >= samplingCountMax) {
+        ADCButtonStats.endTime = HAL_GetTick();
+        if(!MC.publishFromISR(MessageId::DMA_ADC_CONV_CPLT, &ADCButtonStats)) {
+            // 消息没有入队时重新采集，避免标记器一直等待
+            ADCButtonStats.count = 0;
+            ADCButtonStats.startTime = ADCButtonStats.endTime;
+        }
+    }
+}
 
-        uint32_t t = HAL_GetTick();
-        ADCButtonStats.samplingFreq = (uint32_t)(ADCButtonStats.count * 1000 / (t - ADCButtonStats.startTime));
-        ADCButtonStats.endTime = t;
+/**
+ * @brief 计算采样统计（主循环中调用）
+ * 根据中断中采集的 samplingCountMax 个采样值计算采样频率、均值和噪声，发布 ADC_SAMPLING_STATS_COMPLETE
+ */
+void ADCManager::handleADCStats() {
+    if(!samplingRateEnabled || ADCButtonStats.count < samplingCountMax) {
+        return;
+    }
 
-        ADCButtonStats.averageValue = std::accumulate(ADCButtonStats.values.begin(), ADCButtonStats.values.end(), 0) / ADCButtonStats.count;
+    const uint32_t elapsed = std::max<uint32_t>(ADCButtonStats.endTime - ADCButtonStats.startTime, 1);
+    ADCButtonStats.samplingFreq = (uint32_t)(ADCButtonStats.count * 1000 / elapsed);
 
-        for(uint32_t i = 0; i < ADCButtonStats.count; i++) {
-            ADCButtonStats.diffValues[i] = abs((int32_t)ADCButtonStats.averageValue - (int32_t)ADCButtonStats.values[i]);
+    ADCButtonStats.averageValue = std::accumulate(ADCButtonStats.values.begin(), ADCButtonStats.values.end(), 0) / ADCButtonStats.count;
+
+    for(uint32_t i = 0; i < ADCButtonStats.count; i++) {
+        ADCButtonStats.diffValues[i] = abs((int32_t)ADCButtonStats.averageValue - (int32_t)ADCButtonStats.values[i]);
+    }
+
+    ADCButtonStats.noiseValue = std::accumulate(ADCButtonStats.diffValues.begin(), ADCButtonStats.diffValues.end(), 0) / ADCButtonStats.count * 2;
+    // ADCButtonStats.noiseValue = 100;
+
+    uint32_t crossCount = 0;
+    for(uint32_t i = 0; i < ADCButtonStats.count; i++) {
+        if(ADCButtonStats.diffValues[i] > ADCButtonStats.noiseValue * 2) {
+            crossCount++;
         }
+    }
 
-        ADCButtonStats.noiseValue = std::accumulate(ADCButtonStats.diffValues.begin(), ADCButtonStats.diffValues.end(), 0) / ADCButtonStats.count * 2;
-        // ADCButtonStats.noiseValue = 100;
+    APP_DBG("avg: %d, noise: %d, freq: %d, cross: %d", ADCButtonStats.averageValue, ADCButtonStats.noiseValue, ADCButtonStats.samplingFreq, crossCount);
 
-        uint32_t crossCount = 0;
-        for(uint32_t i = 0; i < ADCButtonStats.count; i++) {
-            if(ADCButtonStats.diffValues[i] > ADCButtonStats.noiseValue * 2) {
-                crossCount++;
-            }
+    MC.publish(MessageId::ADC_SAMPLING_STATS_COMPLETE, &ADCButtonStats);
+}
+
+/**
+ * @brief 获取ADC句柄对应的ADC索引
+ * @param hadc ADC句柄
+ * @return 0: ADC1 1: ADC2 2: ADC3 -1: 未知
+ */
+int8_t ADCManager::getADCIndex(const ADC_HandleTypeDef* const hadc) const {
+    return (hadc->Instance == ADC1) ? 0 :
+           (hadc->Instance == ADC2) ? 1 :
+           (hadc->Instance == ADC3) ? 2 : -1;
+}
+
+/**
+ * @brief 处理ADC DMA半传输/传输完成中断
+ * 只无效化刚完成的那一帧所在的缓存行，然后以序号锁方式写入帧快照并更新帧统计
+ * 在中断中执行，中断不会被主循环打断，所以写入过程不会被读取方打断
+ * @param hadc ADC句柄
+ * @param frameIndex DMA缓冲区中的帧索引
+ */
+void ADCManager::handleADCConvCplt(const ADC_HandleTypeDef* const hadc, const uint8_t frameIndex) {
+    const uint32_t timestamp = MICROS_TIMER.cycles();
+    const int8_t adcIndex = getADCIndex(hadc);
+    if(adcIndex < 0 || frameIndex >= ADC_DMA_FRAMES) {
+        return;
+    }
+
+    const ADCBufferInfo& info = adcBufferInfo[adcIndex];
+    const uint32_t* const frame = info.buffer + frameIndex * info.count;
+    SCB_InvalidateDCache_by_Addr((void*)frame, info.count * sizeof(uint32_t));
+
+    ADCFrameSnapshot& snapshot = frameSnapshots[adcIndex];
+    snapshot.sequence++;    // 奇数：正在写入
+    __DMB();
+    for(uint8_t i = 0; i < info.count; i++) {
+        snapshot.values[i] = frame[i];
+    }
+    __DMB();
+    snapshot.sequence++;    // 偶数：写入完成
+
+    updateFrameStats(frameStats[adcIndex], timestamp);
+
+    // 采样统计：每一帧的值都在中断中保存，统计计算放到主循环中执行
+    if(samplingRateEnabled && adcIndex == samplingADCInfo.ADCIndex) {
+        captureSample(frame[samplingADCInfo.indexInDMA]);
+    }
+}
+
+/**
+ * @brief 更新帧统计（中断中调用）
+ * @param stats 帧统计
+ * @param timestamp 当前帧时间戳（DWT周期）
+ */
+void ADCManager::updateFrameStats(ADCFrameStats& stats, const uint32_t timestamp) {
+    if(stats.frames > 0) {
+        const uint32_t period = timestamp - stats.lastTimestamp;
+
+        if(stats.intervals == 0) {
+            stats.emaPeriod = period;
+        } else {
+            stats.emaPeriod += (int32_t)(period - stats.emaPeriod) >> 4;
         }
 
-        APP_DBG("avg: %d, noise: %d, freq: %d, cross: %d", ADCButtonStats.averageValue, ADCButtonStats.noiseValue, ADCButtonStats.samplingFreq, crossCount);
+        stats.minPeriod = std::min(stats.minPeriod, period);
+        stats.maxPeriod = std::max(stats.maxPeriod, period);
+        stats.totalPeriod += period;
+        stats.intervals++;
+
+        const uint32_t deviation = period > stats.emaPeriod ? period - stats.emaPeriod : stats.emaPeriod - period;
+        const uint32_t deviationUs = deviation / CYCLES_PER_MICROSECOND;
+        const uint32_t bin = deviationUs == 0 ? 0 : std::min<uint32_t>(32 - __CLZ(deviationUs), ADC_FRAME_JITTER_HISTOGRAM_BINS - 1);
+        stats.jitterHistogram[bin]++;
+    }
+
+    stats.lastTimestamp = timestamp;
+    stats.frames++;
+}
+
+/**
+ * @brief 处理ADC错误中断，统计溢出错误
+ * @param hadc ADC句柄
+ */
+void ADCManager::handleADCError(const ADC_HandleTypeDef* const hadc) {
+    const int8_t adcIndex = getADCIndex(hadc);
+    if(adcIndex < 0) {
+        return;
+    }
+
+    if(HAL_ADC_GetError((ADC_HandleTypeDef*)hadc) & HAL_ADC_ERROR_OVR) {
+        frameStats[adcIndex].overrunErrors++;
+    }
+}
+
+/**
+ * @brief 获取帧统计
+ * 统计在中断中更新，复制时短暂关闭中断保证快照一致
+ * @param adcIndex ADC索引
+ * @param stats 输出 统计快照
+ * @return 是否成功
+ */
+bool ADCManager::getFrameStats(const uint8_t adcIndex, ADCFrameStats& stats) const {
+    if(adcIndex >= NUM_ADC) {
+        return false;
+    }
+
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    stats = frameStats[adcIndex];
+    __set_PRIMASK(primask);
+
+    return true;
+}
+
+/**
+ * @brief 重置帧统计
+ */
+void ADCManager::resetFrameStats() {
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    memset(frameStats, 0, sizeof(frameStats));
+    for(uint8_t i = 0; i < NUM_ADC; i++) {
+        frameStats[i].minPeriod = UINT32_MAX;
+    }
+    __set_PRIMASK(primask);
+}
 
-        MC.publish(MessageId::ADC_SAMPLING_STATS_COMPLETE, &ADCButtonStats);
+/**
+ * @brief 读取新的ADC帧 按virtualPin排序
+ * @param values 输出 按virtualPin排序的ADC值
+ * @return 有新帧的ADC掩码
+ */
+uint8_t ADCManager::readFreshADCValues(uint32_t* const values) {
+    uint8_t freshMask = 0;
+
+    for(uint8_t adcIndex = 0; adcIndex < NUM_ADC; adcIndex++) {
+        const ADCFrameSnapshot& snapshot = frameSnapshots[adcIndex];
+        const uint8_t count = adcBufferInfo[adcIndex].count;
+        uint32_t sequence;
+        bool fresh = true;
+
+        do {
+            sequence = snapshot.sequence;
+            // 正在写入或没有新帧
+            if((sequence & 1) != 0 || sequence == lastFrameSequence[adcIndex]) {
+                fresh = false;
+                break;
+            }
+            __DMB();
+            for(uint8_t i = 0; i < count; i++) {
+                values[frameIndexMap[adcIndex][i]] = snapshot.values[i];
+            }
+            __DMB();
+        } while(snapshot.sequence != sequence); // 读取过程中被中断更新，重读
+
+        if(fresh) {
+            // 序号每帧加2，中间跳过的帧没有被读取
+            frameStats[adcIndex].droppedFrames += ((sequence - lastFrameSequence[adcIndex]) >> 1) - 1;
+            lastFrameSequence[adcIndex] = sequence;
+            freshMask |= (1 << adcIndex);
+        }
     }
+
+    return freshMask;
 }
 
 // 根据按钮索引查找对应的ADC索引
@@ -651,13 +956,21 @@ ADCIndexInfo ADCManager::findADCButtonVirtualPin(uint8_t virtualPin) {
 
 // ADC转换完成回调
 void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc) {
-    MC.publish(MessageId::DMA_ADC_CONV_CPLT, hadc);
+    ADC_MANAGER.handleADCConvCplt(hadc, ADC_DMA_FRAMES - 1);
+}
+
+#if ADC_DMA_PING_PONG
+// ADC半传输回调，DMA缓冲区前半部分（第0帧）已完成
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc) {
+    ADC_MANAGER.handleADCConvCplt(hadc, 0);
 }
+#endif
 
 // ADC错误回调
 void HAL_ADC_ErrorCallback(ADC_HandleTypeDef *hadc)
 {
     uint32_t error = HAL_ADC_GetError(hadc);
+    ADC_MANAGER.handleADCError(hadc);
     LOG_ERROR("ADC", "ADC Error: Instance=0x%p", (void*)hadc->Instance);
     LOG_ERROR("ADC", "State=0x%x", HAL_ADC_GetState(hadc));
     LOG_ERROR("ADC", "Error flags: 0x%lx", error);
@@ -1,12 +1,14 @@
 #include "adc_btns/ring_buffer_sliding_window.hpp"
 
 // 显式实例化常用类型
-template class RingBufferSlidingWindow<float>;
-template class RingBufferSlidingWindow<double>;
-template class RingBufferSlidingWindow<int>;
-template class RingBufferSlidingWindow<uint32_t>;
-template class RingBufferSlidingWindow<uint16_t>;
-template class RingBufferSlidingWindow<uint8_t>;
-template class RingBufferSlidingWindow<int32_t>;
-template class RingBufferSlidingWindow<int16_t>;
-template class RingBufferSlidingWindow<int8_t>;
+#define RING_BUFFER_SLIDING_WINDOW_INSTANCE_SIZE 32
+
+template class RingBufferSlidingWindow<float, RING_BUFFER_SLIDING_WINDOW_INSTANCE_SIZE>;
+template class RingBufferSlidingWindow<double, RING_BUFFER_SLIDING_WINDOW_INSTANCE_SIZE>;
+template class RingBufferSlidingWindow<int, RING_BUFFER_SLIDING_WINDOW_INSTANCE_SIZE>;
+template class RingBufferSlidingWindow<uint32_t, RING_BUFFER_SLIDING_WINDOW_INSTANCE_SIZE>;
+template class RingBufferSlidingWindow<uint16_t, RING_BUFFER_SLIDING_WINDOW_INSTANCE_SIZE>;
+template class RingBufferSlidingWindow<uint8_t, RING_BUFFER_SLIDING_WINDOW_INSTANCE_SIZE>;
+template class RingBufferSlidingWindow<int32_t, RING_BUFFER_SLIDING_WINDOW_INSTANCE_SIZE>;
+template class RingBufferSlidingWindow<int16_t, RING_BUFFER_SLIDING_WINDOW_INSTANCE_SIZE>;
+template class RingBufferSlidingWindow<int8_t, RING_BUFFER_SLIDING_WINDOW_INSTANCE_SIZE>;
@@ -5,10 +5,279 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <stddef.h>
 #include "board_cfg.h"
+#include "config_store.hpp"
 
 #define CONFIG_ADDR_ORIGIN  CONFIG_ADDR
 
+// 配置日志存储的分区：配置头、每个 profile、快捷键及之后的字段，修改一个 profile 只写入该 profile
+#define CONFIG_STORE_NUM_CONFIG_SECTIONS    (NUM_PROFILES + 2)
+// 旧版整块配置占用的扇区，转换时日志从其后开始写入，转换完成前掉电旧配置仍然完整
+#define CONFIG_LEGACY_SECTORS               ((sizeof(Config) + W25Qxx_SECTOR_SIZE - 1) / W25Qxx_SECTOR_SIZE)
+
+static_assert(CONFIG_STORE_NUM_CONFIG_SECTIONS <= CONFIG_STORE_MAX_SECTIONS, "too many config store sections");
+// 扇区头16字节 + 记录头20字节
+static_assert(sizeof(GamepadProfile) + 36 <= W25Qxx_SECTOR_SIZE, "a profile record must fit in one sector");
+// 有效记录（含记录头和扇区末尾碎片）不到整块配置的 1.5 倍，其余扇区留给追加和回收
+static_assert(2 * CONFIG_LEGACY_SECTORS + 2 <= CONFIG_STORE_NUM_SECTORS, "config store too small for the config");
+
+static ConfigStore::Section configSections[CONFIG_STORE_NUM_CONFIG_SECTIONS];
+static ConfigStore configStore(CONFIG_ADDR_ORIGIN, configSections, CONFIG_STORE_NUM_CONFIG_SECTIONS);
+
+static void initConfigSections()
+{
+    configSections[0] = { 0, offsetof(Config, profiles) };
+    for(uint8_t k = 0; k < NUM_PROFILES; k++) {
+        configSections[k + 1] = { (uint32_t)(offsetof(Config, profiles) + k * sizeof(GamepadProfile)), sizeof(GamepadProfile) };
+    }
+    configSections[NUM_PROFILES + 1] = { offsetof(Config, hotkeys), sizeof(Config) - offsetof(Config, hotkeys) };
+}
+
+// 0.0.10 版本的配置布局：KeysConfig 末尾还没有 analogSources，GamepadProfile 末尾还没有 dksConfigs、turboConfigs 和 macros
+#define CONFIG_VERSION_0_0_10   (uint32_t)0x00000a
+
+typedef struct
+{
+    SOCDMode socdMode;
+    bool fourWayMode;
+    bool invertXAxis;
+    bool invertYAxis;
+    bool keysEnableTag[NUM_ADC_BUTTONS];
+    uint32_t keyDpadUp;
+    uint32_t keyDpadDown;
+    uint32_t keyDpadLeft;
+    uint32_t keyDpadRight;
+    uint32_t keyButtonB1;
+    uint32_t keyButtonB2;
+    uint32_t keyButtonB3;
+    uint32_t keyButtonB4;
+    uint32_t keyButtonL1;
+    uint32_t keyButtonR1;
+    uint32_t keyButtonL2;
+    uint32_t keyButtonR2;
+    uint32_t keyButtonS1;
+    uint32_t keyButtonS2;
+    uint32_t keyButtonL3;
+    uint32_t keyButtonR3;
+    uint32_t keyButtonA1;
+    uint32_t keyButtonA2;
+    uint32_t keyButtonFn;
+} KeysConfigV0_0_10;
+
+typedef struct
+{
+    char id[16];
+    char name[24];
+    bool enabled;
+    KeysConfigV0_0_10 keysConfig;
+    TriggerConfigs triggerConfigs;
+    LEDProfile ledsConfigs;
+} GamepadProfileV0_0_10;
+
+typedef struct
+{
+    uint32_t version;
+    BootMode bootMode;
+    InputMode inputMode;
+    char defaultProfileId[16];
+    uint8_t numProfilesMax;
+    GamepadProfileV0_0_10 profiles[NUM_PROFILES];
+    GamepadHotkeyEntry hotkeys[NUM_GAMEPAD_HOTKEYS];
+    bool autoCalibrationEnabled;
+} ConfigV0_0_10;
+
+static_assert(sizeof(KeysConfigV0_0_10) == offsetof(KeysConfig, analogSources), "keys config layout changed");
+static_assert(offsetof(GamepadProfileV0_0_10, keysConfig) == offsetof(GamepadProfile, keysConfig), "profile layout changed");
+static_assert(offsetof(GamepadProfileV0_0_10, triggerConfigs) <= offsetof(GamepadProfile, triggerConfigs), "profile fields must not move forward");
+static_assert(offsetof(GamepadProfileV0_0_10, ledsConfigs) <= offsetof(GamepadProfile, ledsConfigs), "profile fields must not move forward");
+static_assert(offsetof(ConfigV0_0_10, profiles) == offsetof(Config, profiles), "config header layout changed");
+static_assert(sizeof(ConfigV0_0_10) <= sizeof(Config), "legacy config must fit in the read buffer");
+
+// 0.0.11 版本的配置布局：GamepadProfile 末尾还没有 dksConfigs、turboConfigs 和 macros，其余字段相同
+#define CONFIG_VERSION_0_0_11   (uint32_t)0x00000b
+
+typedef struct
+{
+    char id[16];
+    char name[24];
+    bool enabled;
+    KeysConfig keysConfig;
+    TriggerConfigs triggerConfigs;
+    LEDProfile ledsConfigs;
+} GamepadProfileV0_0_11;
+
+typedef struct
+{
+    uint32_t version;
+    BootMode bootMode;
+    InputMode inputMode;
+    char defaultProfileId[16];
+    uint8_t numProfilesMax;
+    GamepadProfileV0_0_11 profiles[NUM_PROFILES];
+    GamepadHotkeyEntry hotkeys[NUM_GAMEPAD_HOTKEYS];
+    bool autoCalibrationEnabled;
+} ConfigV0_0_11;
+
+static_assert(offsetof(ConfigV0_0_11, profiles) == offsetof(Config, profiles), "config header layout changed");
+static_assert(offsetof(GamepadProfileV0_0_11, ledsConfigs) == offsetof(GamepadProfile, ledsConfigs), "profile layout changed");
+static_assert(sizeof(ConfigV0_0_11) <= sizeof(Config), "legacy config must fit in the read buffer");
+
+// 0.0.12 版本的配置布局：GamepadProfile 末尾还没有 turboConfigs 和 macros，其余字段相同
+#define CONFIG_VERSION_0_0_12   (uint32_t)0x00000c
+
+typedef struct
+{
+    char id[16];
+    char name[24];
+    bool enabled;
+    KeysConfig keysConfig;
+    TriggerConfigs triggerConfigs;
+    LEDProfile ledsConfigs;
+    DKSProfile dksConfigs[NUM_ADC_BUTTONS];
+} GamepadProfileV0_0_12;
+
+typedef struct
+{
+    uint32_t version;
+    BootMode bootMode;
+    InputMode inputMode;
+    char defaultProfileId[16];
+    uint8_t numProfilesMax;
+    GamepadProfileV0_0_12 profiles[NUM_PROFILES];
+    GamepadHotkeyEntry hotkeys[NUM_GAMEPAD_HOTKEYS];
+    bool autoCalibrationEnabled;
+} ConfigV0_0_12;
+
+static_assert(offsetof(ConfigV0_0_12, profiles) == offsetof(Config, profiles), "config header layout changed");
+static_assert(offsetof(GamepadProfileV0_0_12, dksConfigs) == offsetof(GamepadProfile, dksConfigs), "profile layout changed");
+// 旧 profile 末尾的填充字节与新字段重叠，迁移时新字段整体填入默认值
+static_assert(sizeof(GamepadProfileV0_0_12) >= offsetof(GamepadProfile, turboConfigs), "new profile fields must be appended");
+static_assert(sizeof(GamepadProfileV0_0_12) <= sizeof(GamepadProfile), "legacy profile must fit in the current profile");
+static_assert(sizeof(ConfigV0_0_12) <= sizeof(Config), "legacy config must fit in the read buffer");
+
+/**
+ * @brief 默认的多点触发配置：不启用，触发点为空
+ */
+static void makeDefaultDksConfigs(GamepadProfile& profile)
+{
+    for(uint8_t i = 0; i < NUM_ADC_BUTTONS; i++) {
+        profile.dksConfigs[i].enabled = false;
+        for(uint8_t p = 0; p < NUM_DKS_POINTS; p++) {
+            profile.dksConfigs[i].points[p] = {
+                .distance = 0.0f,
+                .virtualPin = -1,
+                .pressAction = DKSAction::DKS_ACTION_NONE,
+                .releaseAction = DKSAction::DKS_ACTION_NONE
+            };
+        }
+    }
+}
+
+/**
+ * @brief 默认的连发和宏配置：不连发，宏不启用
+ */
+static void makeDefaultMacroConfigs(GamepadProfile& profile)
+{
+    for(uint8_t i = 0; i < NUM_ADC_BUTTONS + NUM_GPIO_BUTTONS; i++) {
+        profile.turboConfigs[i].mode = TurboMode::TURBO_MODE_OFF;
+        profile.turboConfigs[i].rate = TURBO_DEFAULT_RATE_HZ;
+    }
+    memset(profile.macros, 0, sizeof(profile.macros));
+    for(uint8_t m = 0; m < NUM_MACROS; m++) {
+        profile.macros[m].virtualPin = -1;
+        profile.macros[m].mode = MacroMode::MACRO_MODE_ONCE;
+    }
+}
+
+/**
+ * @brief 将按旧布局整块读出的配置原地转换为当前布局的 profile 位置
+ * 新的 GamepadProfile 更大，从最后一个 profile 开始向后搬移，不需要额外的整份配置缓冲区；
+ * 旧 profile 之后新增的字段由调用方填入默认值
+ * @param profileSize 旧布局的 GamepadProfile 大小
+ * @param hotkeysOffset 旧布局中 hotkeys 的偏移
+ * @param autoCalibrationOffset 旧布局中 autoCalibrationEnabled 的偏移
+ */
+static void relayoutProfiles(Config& config, const size_t profileSize, const size_t hotkeysOffset, const size_t autoCalibrationOffset)
+{
+    uint8_t* const raw = (uint8_t*)&config;
+
+    // profiles 之后的字段会被搬移的 profile 覆盖，先取出
+    GamepadHotkeyEntry hotkeys[NUM_GAMEPAD_HOTKEYS];
+    bool autoCalibrationEnabled;
+    memcpy(hotkeys, raw + hotkeysOffset, sizeof(hotkeys));
+    memcpy(&autoCalibrationEnabled, raw + autoCalibrationOffset, sizeof(autoCalibrationEnabled));
+
+    for(int8_t k = NUM_PROFILES - 1; k >= 0; k--) {
+        memmove(&config.profiles[k], raw + offsetof(Config, profiles) + k * profileSize, profileSize);
+    }
+
+    memcpy(config.hotkeys, hotkeys, sizeof(hotkeys));
+    config.autoCalibrationEnabled = autoCalibrationEnabled;
+}
+
+/**
+ * @brief 将按 0.0.10 布局读出的配置原地转换为当前布局
+ * KeysConfig 中间新增了 analogSources，profile 内 triggerConfigs 之后的字段整体后移；
+ * 与 relayoutProfiles 一样从最后一个 profile 开始，profile 内从最后一个字段开始向后搬移，目标位置都不在未搬移的字段之前
+ */
+static void migrateFromV0_0_10(Config& config)
+{
+    uint8_t* const raw = (uint8_t*)&config;
+
+    GamepadHotkeyEntry hotkeys[NUM_GAMEPAD_HOTKEYS];
+    bool autoCalibrationEnabled;
+    memcpy(hotkeys, raw + offsetof(ConfigV0_0_10, hotkeys), sizeof(hotkeys));
+    memcpy(&autoCalibrationEnabled, raw + offsetof(ConfigV0_0_10, autoCalibrationEnabled), sizeof(autoCalibrationEnabled));
+
+    for(int8_t k = NUM_PROFILES - 1; k >= 0; k--) {
+        const uint8_t* const src = raw + offsetof(Config, profiles) + k * sizeof(GamepadProfileV0_0_10);
+        GamepadProfile& profile = config.profiles[k];
+
+        memmove(&profile.ledsConfigs, src + offsetof(GamepadProfileV0_0_10, ledsConfigs), sizeof(LEDProfile));
+        memmove(&profile.triggerConfigs, src + offsetof(GamepadProfileV0_0_10, triggerConfigs), sizeof(TriggerConfigs));
+        memmove(&profile.keysConfig, src + offsetof(GamepadProfileV0_0_10, keysConfig), sizeof(KeysConfigV0_0_10));
+        memmove(&profile, src, offsetof(GamepadProfileV0_0_10, keysConfig));
+
+        memset(profile.keysConfig.analogSources, -1, sizeof(profile.keysConfig.analogSources));
+        makeDefaultDksConfigs(profile);
+        makeDefaultMacroConfigs(profile);
+    }
+
+    memcpy(config.hotkeys, hotkeys, sizeof(hotkeys));
+    config.autoCalibrationEnabled = autoCalibrationEnabled;
+    config.version = CONFIG_VERSION;
+}
+
+/**
+ * @brief 将按 0.0.11 布局读出的配置原地转换为当前布局
+ */
+static void migrateFromV0_0_11(Config& config)
+{
+    relayoutProfiles(config, sizeof(GamepadProfileV0_0_11), offsetof(ConfigV0_0_11, hotkeys), offsetof(ConfigV0_0_11, autoCalibrationEnabled));
+    for(uint8_t k = 0; k < NUM_PROFILES; k++) {
+        makeDefaultDksConfigs(config.profiles[k]);
+        makeDefaultMacroConfigs(config.profiles[k]);
+    }
+    config.version = CONFIG_VERSION;
+}
+
+/**
+ * @brief 将 0.0.12 的配置转换为当前布局
+ * 从旧版整块配置读出时先搬移 profile；从日志存储读出时 profile 记录比当前分区短，已经按分区落在当前位置
+ * @param isLegacyImage 是否按旧布局整块读出
+ */
+static void migrateFromV0_0_12(Config& config, const bool isLegacyImage)
+{
+    if(isLegacyImage) {
+        relayoutProfiles(config, sizeof(GamepadProfileV0_0_12), offsetof(ConfigV0_0_12, hotkeys), offsetof(ConfigV0_0_12, autoCalibrationEnabled));
+    }
+    for(uint8_t k = 0; k < NUM_PROFILES; k++) {
+        makeDefaultMacroConfigs(config.profiles[k]);
+    }
+    config.version = CONFIG_VERSION;
+}
+
 void ConfigUtils::makeDefaultProfile(GamepadProfile& profile, const char* id, bool isEnabled)
 {
     // 设置profile id, name, enabled
@@ -41,6 +310,7 @@ void ConfigUtils::makeDefaultProfile(GamepadProfile& profile, const char* id, bo
     profile.keysConfig.keyButtonS1 = 1 << 17;
     profile.keysConfig.keyButtonS2 = 1 << 18;
     profile.keysConfig.keyButtonFn = FN_BUTTON_VIRTUAL_PIN;
+    memset(profile.keysConfig.analogSources, -1, sizeof(profile.keysConfig.analogSources)); // 默认不输出模拟量
 
     // 设置triggerConfigs 
     profile.triggerConfigs.isAllBtnsConfiguring = true;
@@ -76,17 +346,45 @@ void ConfigUtils::makeDefaultProfile(GamepadProfile& profile, const char* id, bo
     profile.ledsConfigs.aroundLedColor3 = 0x0000ff;  // 蓝色
     profile.ledsConfigs.aroundLedBrightness = 100;
     profile.ledsConfigs.aroundLedAnimationSpeed = 3;
+
+    // 设置多点触发配置
+    makeDefaultDksConfigs(profile);
+
+    // 设置连发和宏配置
+    makeDefaultMacroConfigs(profile);
 }
 
 bool ConfigUtils::load(Config& config)
 {
-    bool fjResult;
-    fjResult = fromStorage(config);
+    initConfigSections();
+
+    // 日志存储不完整时读取旧版整块配置
+    const bool fromStore = configStore.mount();
+    bool fjResult = fromStore ? configStore.load((uint8_t*)&config) : fromStorage(config);
 
     if(fjResult == true && config.version == CONFIG_VERSION) { // 版本号一致
         uint32_t ver = config.version;
         APP_DBG("Config Version: %d.%d.%d", (ver>>16) & 0xff, (ver>>8) & 0xff, ver & 0xff);
+        if(!fromStore) {
+            APP_DBG("convert legacy config to config store");
+            return configStore.format((uint8_t*)&config, CONFIG_LEGACY_SECTORS);
+        }
         return true;
+    } else if(fjResult == true && config.version == CONFIG_VERSION_0_0_12) { // 上一版本，保留用户配置
+
+        APP_DBG("migrate config, version: 0.0.12 -> %d.%d.%d", (CONFIG_VERSION>>16) & 0xff, (CONFIG_VERSION>>8) & 0xff, CONFIG_VERSION & 0xff);
+        migrateFromV0_0_12(config, !fromStore);
+        return fromStore ? save(config) : configStore.format((uint8_t*)&config, CONFIG_LEGACY_SECTORS);
+    } else if(fjResult == true && !fromStore && config.version == CONFIG_VERSION_0_0_11) { // 0.0.11 只有整块配置
+
+        APP_DBG("migrate config, version: 0.0.11 -> %d.%d.%d", (CONFIG_VERSION>>16) & 0xff, (CONFIG_VERSION>>8) & 0xff, CONFIG_VERSION & 0xff);
+        migrateFromV0_0_11(config);
+        return configStore.format((uint8_t*)&config, CONFIG_LEGACY_SECTORS);
+    } else if(fjResult == true && !fromStore && config.version == CONFIG_VERSION_0_0_10) { // 0.0.10 只有整块配置
+
+        APP_DBG("migrate config, version: 0.0.10 -> %d.%d.%d", (CONFIG_VERSION>>16) & 0xff, (CONFIG_VERSION>>8) & 0xff, CONFIG_VERSION & 0xff);
+        migrateFromV0_0_10(config);
+        return configStore.format((uint8_t*)&config, CONFIG_LEGACY_SECTORS);
     } else {
 
         APP_DBG("init config, version: %d.%d.%d", (CONFIG_VERSION>>16) & 0xff, (CONFIG_VERSION>>8) & 0xff, CONFIG_VERSION & 0xff);
@@ -181,9 +479,8 @@ bool ConfigUtils::save(Config& config)
     APP_DBG("ConfigUtils::save begin");
 
 
-    // 写入配置数据
-    int8_t result = QSPI_W25Qxx_WriteBuffer_WithXIPOrNot((uint8_t*)&config, CONFIG_ADDR_ORIGIN, sizeof(Config));
-    if(result == QSPI_W25Qxx_OK) {
+    // 只追加内容变化的分区
+    if(configStore.save((const uint8_t*)&config)) {
         APP_DBG("ConfigUtils::save - success.");
         return true;
     } else {
@@ -201,7 +498,7 @@ bool ConfigUtils::save(Config& config)
  */
 bool ConfigUtils::reset(Config& config)
 {
-    int8_t result = QSPI_W25Qxx_BufferErase(CONFIG_ADDR_ORIGIN, 64*1024);
+    int8_t result = QSPI_W25Qxx_BufferErase(CONFIG_ADDR_ORIGIN, CONFIG_STORE_NUM_SECTORS * W25Qxx_SECTOR_SIZE);
     if(result != QSPI_W25Qxx_OK) {
         APP_ERR("ConfigUtils::reset - block erase failure.");
         return false;
@@ -210,7 +507,18 @@ bool ConfigUtils::reset(Config& config)
 }
 
 /**
- * @brief 从存储中读取配置
+ * @brief 后台回收配置存储的旧扇区的一步，空闲时在主循环中反复调用，每次最多执行一个Flash操作
+ * 
+ * @return true 回收或预擦除还在进行
+ * @return false 不需要回收
+ */
+bool ConfigUtils::collectGarbageStep()
+{
+    return configStore.collectGarbageStep();
+}
+
+/**
+ * @brief 从存储中读取旧版整块配置（日志存储之前的布局，按 Config 原样保存在 CONFIG_ADDR）
  * 
  * @param config 
  * @return true 
@@ -0,0 +1,630 @@
+#include "config_store.hpp"
+#include <stddef.h>
+#include <string.h>
+#include "CRC32.hpp"
+#include "system_logger.h"
+
+#define CONFIG_STORE_SECTOR_MAGIC       0x53474643      // "CFGS"
+#define CONFIG_STORE_RECORD_MAGIC       0x52474643      // "CFGR"
+#define CONFIG_STORE_FORMAT_VERSION     1
+// 按页读取，记录数据分块复制和计算CRC
+#define CONFIG_STORE_CHUNK_SIZE         W25Qxx_PageSize
+
+struct ConfigStoreSectorHeader {
+    uint32_t magic;
+    uint32_t sequence;          // 扇区序号，越大越新，0 保留给空闲扇区
+    uint32_t version;           // CONFIG_STORE_FORMAT_VERSION
+    uint32_t headerCrc;         // 前三个字段的CRC32
+};
+
+struct ConfigStoreRecordHeader {
+    uint32_t magic;
+    uint16_t section;           // 分区索引
+    uint16_t length;            // 数据长度（不含对齐填充）
+    uint32_t sequence;          // 记录序号，同一分区取最大的有效记录
+    uint32_t payloadCrc;        // 数据CRC32
+    uint32_t headerCrc;         // 前面字段的CRC32
+};
+
+static_assert(sizeof(ConfigStoreSectorHeader) == 16, "config store sector header must stay 16 bytes");
+static_assert(sizeof(ConfigStoreRecordHeader) == 20, "config store record header must stay 20 bytes");
+static_assert(CONFIG_STORE_NUM_SECTORS >= 2 + CONFIG_STORE_RESERVED_SECTORS, "config store needs spare sectors for compaction");
+static_assert(CONFIG_STORE_NUM_SECTORS <= 32, "config store blank mask must fit in a 32-bit word");
+static_assert(CONFIG_STORE_NUM_SECTORS <= 127, "config store sector index must fit in int8_t");
+
+static inline uint32_t alignRecord(const uint32_t size) {
+    return (size + 3) & ~3U;
+}
+
+static inline uint32_t recordSize(const uint32_t length) {
+    return sizeof(ConfigStoreRecordHeader) + alignRecord(length);
+}
+
+static inline bool isErased(const uint8_t* bytes, const uint32_t size) {
+    for(uint32_t i = 0; i < size; i++) {
+        if(bytes[i] != 0xFF) {
+            return false;
+        }
+    }
+    return true;
+}
+
+ConfigStore::ConfigStore(const uint32_t address, const Section* sections, const uint8_t numSections)
+    : address_(address)
+    , sections_(sections)
+    , numSections_(numSections < CONFIG_STORE_MAX_SECTIONS ? numSections : CONFIG_STORE_MAX_SECTIONS)
+    , eraseCount_(0)
+    , blankMask_(0)
+    , erasing_(-1)
+    , erasingVictim_(false) {
+    resetState();
+}
+
+void ConfigStore::resetState() {
+    memset(index_, 0, sizeof(index_));
+    memset(sectorSequences_, 0, sizeof(sectorSequences_));
+    nextSequence_ = 1;
+    nextSectorSequence_ = 1;
+    writeOffset_ = W25Qxx_SECTOR_SIZE;
+    head_ = -1;
+    tail_ = -1;
+    usedCount_ = 0;
+    startSector_ = 0;
+    gcVictim_ = -1;
+}
+
+bool ConfigStore::isComplete() const {
+    for(uint8_t i = 0; i < numSections_; i++) {
+        if(!index_[i].valid) {
+            return false;
+        }
+    }
+    return numSections_ > 0;
+}
+
+/**
+ * 扫描一个扇区，更新分区索引
+ * @return 扇区内下一条记录的写入偏移，没有有效扇区头时返回 0，记录头损坏时返回扇区大小（不再写入）
+ */
+uint16_t ConfigStore::scanSector(const uint8_t sector, uint32_t& maxSequence) {
+    const uint32_t base = sectorAddress(sector);
+
+    ConfigStoreSectorHeader header;
+    if(QSPI_W25Qxx_ReadBuffer_WithXIPOrNot((uint8_t*)&header, base, sizeof(header)) != QSPI_W25Qxx_OK
+        || header.magic != CONFIG_STORE_SECTOR_MAGIC
+        || header.version != CONFIG_STORE_FORMAT_VERSION
+        || header.sequence == 0
+        || header.headerCrc != CRC32::calculate((const uint8_t*)&header, offsetof(ConfigStoreSectorHeader, headerCrc))) {
+        return 0;
+    }
+    sectorSequences_[sector] = header.sequence;
+
+    uint8_t buffer[CONFIG_STORE_CHUNK_SIZE];
+    uint32_t offset = sizeof(ConfigStoreSectorHeader);
+    while(offset + sizeof(ConfigStoreRecordHeader) <= W25Qxx_SECTOR_SIZE) {
+        ConfigStoreRecordHeader record;
+        if(QSPI_W25Qxx_ReadBuffer_WithXIPOrNot((uint8_t*)&record, base + offset, sizeof(record)) != QSPI_W25Qxx_OK) {
+            APP_ERR("ConfigStore: read record failed, sector: %d, offset: 0x%x", sector, (unsigned int)offset);
+            return W25Qxx_SECTOR_SIZE;
+        }
+
+        // 记录按顺序追加，第一个空记录头之后都是空的
+        if(isErased((const uint8_t*)&record, sizeof(record))) {
+            return offset;
+        }
+
+        // 记录头写入不完整，长度不可信，扇区不再写入
+        if(record.magic != CONFIG_STORE_RECORD_MAGIC
+            || record.headerCrc != CRC32::calculate((const uint8_t*)&record, offsetof(ConfigStoreRecordHeader, headerCrc))
+            || offset + recordSize(record.length) > W25Qxx_SECTOR_SIZE) {
+            APP_DBG("ConfigStore: torn record header, sector: %d, offset: 0x%x", sector, (unsigned int)offset);
+            return W25Qxx_SECTOR_SIZE;
+        }
+
+        if(record.sequence > maxSequence) {
+            maxSequence = record.sequence;
+        }
+
+        const uint32_t recordOffset = offset;
+        offset += recordSize(record.length);
+
+        if(record.section >= numSections_ || record.length > sections_[record.section].size) {
+            continue;
+        }
+        IndexEntry& entry = index_[record.section];
+        if(entry.valid && entry.sequence > record.sequence) {
+            continue;
+        }
+
+        // 数据写入不完整的记录CRC校验失败，跳过，该分区保留之前的记录
+        CRC32 crc;
+        bool readOk = true;
+        for(uint32_t done = 0; done < record.length; done += sizeof(buffer)) {
+            const uint32_t n = (record.length - done) < sizeof(buffer) ? (record.length - done) : sizeof(buffer);
+            if(QSPI_W25Qxx_ReadBuffer_WithXIPOrNot(buffer, base + recordOffset + sizeof(ConfigStoreRecordHeader) + done, n) != QSPI_W25Qxx_OK) {
+                readOk = false;
+                break;
+            }
+            crc.update(buffer, (uint16_t)n);
+        }
+        if(!readOk || crc.finalize() != record.payloadCrc) {
+            APP_DBG("ConfigStore: skip corrupted record, section: %d, sequence: %d", record.section, (int)record.sequence);
+            continue;
+        }
+
+        entry.sequence = record.sequence;
+        entry.crc = record.payloadCrc;
+        entry.offset = recordOffset;
+        entry.length = record.length;
+        entry.sector = sector;
+        entry.valid = true;
+    }
+    return W25Qxx_SECTOR_SIZE;
+}
+
+bool ConfigStore::mount() {
+    waitErase();
+    resetState();
+    blankMask_ = 0;
+
+    uint32_t maxSequence = 0;
+    uint16_t offsets[CONFIG_STORE_NUM_SECTORS];
+    for(uint8_t s = 0; s < CONFIG_STORE_NUM_SECTORS; s++) {
+        offsets[s] = scanSector(s, maxSequence);
+        if(sectorSequences_[s] == 0) {
+            continue;
+        }
+        usedCount_++;
+        if(head_ < 0 || sectorSequences_[s] > sectorSequences_[head_]) {
+            head_ = s;
+        }
+    }
+
+    if(head_ >= 0) {
+        writeOffset_ = offsets[head_];
+        nextSectorSequence_ = sectorSequences_[head_] + 1;
+    }
+    nextSequence_ = maxSequence + 1;
+    updateTail();
+
+    APP_DBG("ConfigStore: mounted, used sectors: %d, head: %d, tail: %d, complete: %d", usedCount_, head_, tail_, isComplete());
+    return isComplete();
+}
+
+bool ConfigStore::load(uint8_t* image) const {
+    if(!isComplete()) {
+        return false;
+    }
+
+    for(uint8_t i = 0; i < numSections_; i++) {
+        const IndexEntry& entry = index_[i];
+        const uint32_t address = sectorAddress(entry.sector) + entry.offset + sizeof(ConfigStoreRecordHeader);
+        if(QSPI_W25Qxx_ReadBuffer_WithXIPOrNot(image + sections_[i].offset, address, entry.length) != QSPI_W25Qxx_OK) {
+            APP_ERR("ConfigStore: read section %d failed", i);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ConfigStore::save(const uint8_t* image) {
+    waitErase();
+    if(!isComplete()) {
+        return format(image, head_ >= 0 ? (head_ + 1) % CONFIG_STORE_NUM_SECTORS : startSector_);
+    }
+
+    uint8_t written = 0;
+    for(uint8_t i = 0; i < numSections_; i++) {
+        const uint32_t crc = CRC32::calculate(image + sections_[i].offset, (uint16_t)sections_[i].size);
+        if(crc == index_[i].crc && index_[i].length == sections_[i].size) {
+            continue;
+        }
+
+        // 失败时已写入的分区保留新记录，其余分区仍是旧记录，由调用方稍后重试
+        if(!reserveSpace(recordSize(sections_[i].size), 1 + CONFIG_STORE_RESERVED_SECTORS)
+            || !writeRecord(i, image + sections_[i].offset, crc)) {
+            APP_ERR("ConfigStore: append section %d failed", i);
+            return false;
+        }
+        written++;
+    }
+
+    APP_DBG("ConfigStore: saved %d sections, free sectors: %d", written, getFreeSectors());
+    return true;
+}
+
+bool ConfigStore::format(const uint8_t* image, const uint8_t firstSector) {
+    APP_DBG("ConfigStore: format, first sector: %d", firstSector);
+    waitErase();
+
+    for(uint8_t s = 0; s < CONFIG_STORE_NUM_SECTORS; s++) {
+        if(sectorSequences_[s] != 0 && !eraseSector(s)) {
+            return false;
+        }
+    }
+
+    resetState();
+    startSector_ = firstSector % CONFIG_STORE_NUM_SECTORS;
+
+    for(uint8_t i = 0; i < numSections_; i++) {
+        const uint32_t crc = CRC32::calculate(image + sections_[i].offset, (uint16_t)sections_[i].size);
+        if(!reserveSpace(recordSize(sections_[i].size), 0) || !writeRecord(i, image + sections_[i].offset, crc)) {
+            APP_ERR("ConfigStore: format failed, section: %d", i);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ConfigStore::collectGarbageStep() {
+    // 擦除进行中：只查询一次忙标志，不等待
+    if(erasing_ >= 0) {
+        const int8_t status = QSPI_W25Qxx_PollEraseDone();
+        if(status > 0) {
+            return true;
+        }
+        finishErase(status == QSPI_W25Qxx_OK);
+        return true;
+    }
+
+    if(!isComplete()) {
+        return false;
+    }
+
+    // 回收的扇区可能已经被保存时的同步回收释放
+    if(gcVictim_ >= 0 && (gcVictim_ == head_ || sectorSequences_[gcVictim_] == 0)) {
+        gcVictim_ = -1;
+    }
+    if(gcVictim_ < 0 && getFreeSectors() < CONFIG_STORE_GC_FREE_SECTORS) {
+        gcVictim_ = pickVictim();
+    }
+
+    if(gcVictim_ >= 0) {
+        // 每步复制一条仍在该扇区中的有效记录，全部复制完成后擦除
+        for(uint8_t i = 0; i < numSections_; i++) {
+            if(index_[i].valid && index_[i].sector == gcVictim_) {
+                // 头部扇区放不下时要打开新扇区，先在单独的一步中擦除它
+                if((head_ < 0 || writeOffset_ + recordSize(index_[i].length) > W25Qxx_SECTOR_SIZE) && eraseNextSector()) {
+                    return true;
+                }
+                if(!copyRecord(i)) {
+                    gcVictim_ = -1;
+                    return false;
+                }
+                return true;
+            }
+        }
+        const int8_t victim = gcVictim_;
+        gcVictim_ = -1;
+        return startErase(victim, true);
+    }
+
+    // 提前擦除下一个要打开的扇区，保存时不需要等待擦除
+    return eraseNextSector();
+}
+
+/**
+ * 下一个要打开的扇区还没有确认擦除时发出非阻塞擦除
+ * @return 是否发出了擦除
+ */
+bool ConfigStore::eraseNextSector() {
+    const int8_t next = nextFreeSector();
+    if(next < 0 || (blankMask_ & (1U << next))) {
+        return false;
+    }
+    if(isSectorBlank(next)) {
+        blankMask_ |= 1U << next;
+        return false;
+    }
+    return startErase(next, false);
+}
+
+/**
+ * 发出非阻塞擦除，完成后由 collectGarbageStep 或 waitErase 更新扇区状态
+ * @param compacting 擦除的是回收完成的扇区，完成后释放
+ */
+bool ConfigStore::startErase(const uint8_t sector, const bool compacting) {
+    blankMask_ &= ~(1U << sector);
+    eraseCount_++;
+    const int8_t status = QSPI_W25Qxx_SectorEraseStart_WithXIPOrNot(sectorAddress(sector));
+    if(status != QSPI_W25Qxx_OK) {
+        APP_ERR("ConfigStore: start erase sector %d failed, status: %d", sector, status);
+        return false;
+    }
+    erasing_ = sector;
+    erasingVictim_ = compacting;
+    return true;
+}
+
+void ConfigStore::finishErase(const bool ok) {
+    const int8_t sector = erasing_;
+    erasing_ = -1;
+    if(!ok) {
+        APP_ERR("ConfigStore: erase sector %d failed", sector);
+        return;
+    }
+
+    blankMask_ |= 1U << sector;
+    if(erasingVictim_ && sectorSequences_[sector] != 0) {
+        sectorSequences_[sector] = 0;
+        usedCount_--;
+        updateTail();
+        APP_DBG("ConfigStore: compacted sector %d, free sectors: %d", sector, getFreeSectors());
+    }
+}
+
+/**
+ * 保存、格式化、挂载前等待进行中的非阻塞擦除完成
+ */
+void ConfigStore::waitErase() {
+    if(erasing_ >= 0) {
+        finishErase(QSPI_W25Qxx_WaitEraseDone() == QSPI_W25Qxx_OK);
+    }
+}
+
+bool ConfigStore::isSectorBlank(const uint8_t sector) const {
+    uint8_t buffer[CONFIG_STORE_CHUNK_SIZE];
+    for(uint32_t offset = 0; offset < W25Qxx_SECTOR_SIZE; offset += sizeof(buffer)) {
+        if(QSPI_W25Qxx_ReadBuffer_WithXIPOrNot(buffer, sectorAddress(sector) + offset, sizeof(buffer)) != QSPI_W25Qxx_OK
+            || !isErased(buffer, sizeof(buffer))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ConfigStore::eraseSector(const uint8_t sector) {
+    const int8_t status = QSPI_W25Qxx_SectorErase_WithXIPOrNot(sectorAddress(sector));
+    eraseCount_++;
+    if(status != QSPI_W25Qxx_OK) {
+        APP_ERR("ConfigStore: erase sector %d failed, status: %d", sector, status);
+        blankMask_ &= ~(1U << sector);
+        return false;
+    }
+    blankMask_ |= 1U << sector;
+    return true;
+}
+
+/**
+ * 下一个要打开的扇区：从头部的下一个扇区开始沿环查找第一个空闲扇区
+ * 正常情况下就是头部的下一个扇区，掉电恢复回收了环中间的扇区时才会跳过
+ * @return 扇区索引，没有空闲扇区时返回 -1
+ */
+int8_t ConfigStore::nextFreeSector() const {
+    const uint8_t first = head_ >= 0 ? (head_ + 1) % CONFIG_STORE_NUM_SECTORS : startSector_;
+    for(uint8_t i = 0; i < CONFIG_STORE_NUM_SECTORS; i++) {
+        const uint8_t s = (first + i) % CONFIG_STORE_NUM_SECTORS;
+        if(sectorSequences_[s] == 0) {
+            return s;
+        }
+    }
+    return -1;
+}
+
+bool ConfigStore::prepareNextSector() {
+    const int8_t next = nextFreeSector();
+    if(next < 0 || (blankMask_ & (1U << next))) {
+        return false;
+    }
+
+    if(isSectorBlank(next)) {
+        blankMask_ |= 1U << next;
+        return false;
+    }
+    return eraseSector(next);
+}
+
+bool ConfigStore::openNextSector() {
+    const int8_t next = nextFreeSector();
+    if(next < 0) {
+        APP_ERR("ConfigStore: no free sector");
+        return false;
+    }
+
+    prepareNextSector();
+    if(!(blankMask_ & (1U << next))) {
+        return false;
+    }
+    blankMask_ &= ~(1U << next);
+
+    ConfigStoreSectorHeader header;
+    header.magic = CONFIG_STORE_SECTOR_MAGIC;
+    header.sequence = nextSectorSequence_++;
+    header.version = CONFIG_STORE_FORMAT_VERSION;
+    header.headerCrc = CRC32::calculate((const uint8_t*)&header, offsetof(ConfigStoreSectorHeader, headerCrc));
+
+    const int8_t status = QSPI_W25Qxx_ProgramBuffer_WithXIPOrNot((uint8_t*)&header, sectorAddress(next), sizeof(header));
+    if(status != QSPI_W25Qxx_OK) {
+        // 扇区头可能已经部分编程，下次打开前重新擦除
+        APP_ERR("ConfigStore: write sector header failed, sector: %d, status: %d", next, status);
+        return false;
+    }
+
+    sectorSequences_[next] = header.sequence;
+    usedCount_++;
+    head_ = next;
+    writeOffset_ = sizeof(ConfigStoreSectorHeader);
+    if(tail_ < 0) {
+        tail_ = next;
+    }
+    return true;
+}
+
+/**
+ * 保证头部扇区能写入一条记录，需要打开新扇区时先回收最旧的扇区，直到打开后仍有 minFreeSectors - 1 个空闲扇区
+ */
+bool ConfigStore::reserveSpace(const uint32_t size, const uint8_t minFreeSectors) {
+    if(head_ >= 0 && writeOffset_ + size <= W25Qxx_SECTOR_SIZE) {
+        return true;
+    }
+
+    // 每次回收释放一个扇区，找不到可回收的扇区时不再继续
+    for(uint8_t i = 0; i < CONFIG_STORE_NUM_SECTORS && getFreeSectors() < minFreeSectors; i++) {
+        if(!compactSector(pickVictim())) {
+            break;
+        }
+    }
+    if(getFreeSectors() < (minFreeSectors > 0 ? minFreeSectors : 1)) {
+        return false;
+    }
+
+    // 回收过程中可能已经打开了有足够空间的新扇区
+    if(head_ >= 0 && writeOffset_ + size <= W25Qxx_SECTOR_SIZE) {
+        return true;
+    }
+    return openNextSector();
+}
+
+bool ConfigStore::writeRecord(const uint8_t section, const uint8_t* data, const uint32_t crc) {
+    ConfigStoreRecordHeader header;
+    header.magic = CONFIG_STORE_RECORD_MAGIC;
+    header.section = section;
+    header.length = (uint16_t)sections_[section].size;
+    header.sequence = nextSequence_++;
+    header.payloadCrc = crc;
+    header.headerCrc = CRC32::calculate((const uint8_t*)&header, offsetof(ConfigStoreRecordHeader, headerCrc));
+
+    const uint32_t offset = writeOffset_;
+    const uint32_t address = sectorAddress(head_) + offset;
+    // 写入失败的位置可能已经部分编程，不再复用
+    writeOffset_ += recordSize(header.length);
+
+    // 先写记录头再写数据，数据写入完成前掉电的记录CRC校验失败
+    int8_t status = QSPI_W25Qxx_ProgramBuffer_WithXIPOrNot((uint8_t*)&header, address, sizeof(header));
+    if(status == QSPI_W25Qxx_OK) {
+        status = QSPI_W25Qxx_ProgramBuffer_WithXIPOrNot((uint8_t*)data, address + sizeof(header), header.length);
+    }
+    if(status != QSPI_W25Qxx_OK) {
+        APP_ERR("ConfigStore: write record failed, section: %d, status: %d", section, status);
+        return false;
+    }
+
+    IndexEntry& entry = index_[section];
+    entry.sequence = header.sequence;
+    entry.crc = crc;
+    entry.offset = offset;
+    entry.length = header.length;
+    entry.sector = head_;
+    entry.valid = true;
+    return true;
+}
+
+/**
+ * 把分区的最新记录从Flash复制到头部扇区，使用新的序号
+ */
+bool ConfigStore::copyRecord(const uint8_t section) {
+    const IndexEntry source = index_[section];
+    const uint32_t length = source.length;
+    if(!reserveSpace(recordSize(length), 0)) {
+        return false;
+    }
+
+    ConfigStoreRecordHeader header;
+    header.magic = CONFIG_STORE_RECORD_MAGIC;
+    header.section = section;
+    header.length = (uint16_t)length;
+    header.sequence = nextSequence_++;
+    header.payloadCrc = source.crc;
+    header.headerCrc = CRC32::calculate((const uint8_t*)&header, offsetof(ConfigStoreRecordHeader, headerCrc));
+
+    const uint32_t offset = writeOffset_;
+    const uint32_t address = sectorAddress(head_) + offset;
+    const uint32_t from = sectorAddress(source.sector) + source.offset + sizeof(header);
+    writeOffset_ += recordSize(length);
+
+    int8_t status = QSPI_W25Qxx_ProgramBuffer_WithXIPOrNot((uint8_t*)&header, address, sizeof(header));
+    uint8_t buffer[CONFIG_STORE_CHUNK_SIZE];
+    for(uint32_t done = 0; status == QSPI_W25Qxx_OK && done < length; done += sizeof(buffer)) {
+        const uint32_t n = (length - done) < sizeof(buffer) ? (length - done) : sizeof(buffer);
+        status = QSPI_W25Qxx_ReadBuffer_WithXIPOrNot(buffer, from + done, n);
+        if(status == QSPI_W25Qxx_OK) {
+            status = QSPI_W25Qxx_ProgramBuffer_WithXIPOrNot(buffer, address + sizeof(header) + done, n);
+        }
+    }
+    if(status != QSPI_W25Qxx_OK) {
+        APP_ERR("ConfigStore: copy record failed, section: %d, status: %d", section, status);
+        return false;
+    }
+
+    IndexEntry& entry = index_[section];
+    entry.sequence = header.sequence;
+    entry.offset = offset;
+    entry.sector = head_;
+    return true;
+}
+
+uint32_t ConfigStore::liveBytes(const uint8_t sector) const {
+    uint32_t bytes = 0;
+    for(uint8_t i = 0; i < numSections_; i++) {
+        if(index_[i].valid && index_[i].sector == sector) {
+            bytes += recordSize(index_[i].length);
+        }
+    }
+    return bytes;
+}
+
+/**
+ * 选择要回收的扇区
+ * 通常回收最旧的扇区，不变的分区也随之搬移，所有扇区轮流擦除；
+ * 回收过程中掉电可能用掉了最后一个空闲扇区，此时改为回收有效记录能放进头部扇区剩余空间的扇区（优先没有有效记录的）
+ * @return 扇区索引，没有可回收的扇区时返回 -1
+ */
+int8_t ConfigStore::pickVictim() const {
+    const uint32_t room = head_ >= 0 ? W25Qxx_SECTOR_SIZE - writeOffset_ : 0;
+    if(tail_ >= 0 && tail_ != head_ && (getFreeSectors() > 0 || liveBytes(tail_) <= room)) {
+        return tail_;
+    }
+
+    int8_t victim = -1;
+    uint32_t victimBytes = 0;
+    for(uint8_t s = 0; s < CONFIG_STORE_NUM_SECTORS; s++) {
+        if(sectorSequences_[s] == 0 || s == head_) {
+            continue;
+        }
+        const uint32_t bytes = liveBytes(s);
+        if(bytes <= room && (victim < 0 || bytes < victimBytes)) {
+            victim = s;
+            victimBytes = bytes;
+        }
+    }
+    return victim;
+}
+
+/**
+ * 回收扇区：其中仍是最新的记录复制到头部，全部复制完成后擦除
+ * 复制过程中掉电，新旧记录内容相同，上电时取序号大的一条
+ */
+bool ConfigStore::compactSector(const int8_t victim) {
+    if(victim < 0 || victim == head_ || sectorSequences_[victim] == 0) {
+        return false;
+    }
+
+    uint8_t moved = 0;
+    for(uint8_t i = 0; i < numSections_; i++) {
+        if(index_[i].valid && index_[i].sector == victim) {
+            if(!copyRecord(i)) {
+                return false;
+            }
+            moved++;
+        }
+    }
+
+    if(!eraseSector(victim)) {
+        return false;
+    }
+    sectorSequences_[victim] = 0;
+    usedCount_--;
+    updateTail();
+
+    APP_DBG("ConfigStore: compacted sector %d, moved %d records, free sectors: %d", victim, moved, getFreeSectors());
+    return true;
+}
+
+void ConfigStore::updateTail() {
+    tail_ = -1;
+    for(uint8_t s = 0; s < CONFIG_STORE_NUM_SECTORS; s++) {
+        if(sectorSequences_[s] != 0 && (tail_ < 0 || sectorSequences_[s] < sectorSequences_[tail_])) {
+            tail_ = s;
+        }
+    }
+}
@@ -3,13 +3,17 @@
 #include "board_cfg.h"
 #include "adc_btns/adc_calibration.hpp"
 #include "configs/webconfig_btns_manager.hpp"
+#include "gamepad/GamepadState.hpp"
 #include "leds/leds_manager.hpp"
 #include "configs/webconfig_leds_manager.hpp"
 #include "firmware/firmware_manager.hpp"
 #include <cctype>
 #include <cstring>
 #include <cstdlib>
+#include <map>
 #include "system_logger.h"
+#include "perf_trace.hpp"
+#include "latency_trace.hpp"
 
 extern "C" struct fsdata_file file__index_html[];
 
@@ -470,6 +474,13 @@ cJSON* buildProfileJSON(GamepadProfile* profile) {
     }
     cJSON_AddItemToObject(keysConfigJSON, "keysEnableTag", enabledKeysJSON);
 
+    // 模拟输出来源，按 AnalogOutput 顺序，-1 表示不使用
+    cJSON* analogSourcesJSON = cJSON_CreateArray();
+    for(uint8_t i = 0; i < NUM_ANALOG_OUTPUTS; i++) {
+        cJSON_AddItemToArray(analogSourcesJSON, cJSON_CreateNumber(profile->keysConfig.analogSources[i]));
+    }
+    cJSON_AddItemToObject(keysConfigJSON, "analogSources", analogSourcesJSON);
+
     // 按键映射
     cJSON* keyMappingJSON = cJSON_CreateObject();
 
@@ -559,10 +570,33 @@ cJSON* buildProfileJSON(GamepadProfile* profile) {
     cJSON_AddNumberToObject(triggerConfigsJSON, "debounceAlgorithm", debounceAlgorithm);
     cJSON_AddItemToObject(triggerConfigsJSON, "triggerConfigs", triggerConfigsArrayJSON);
 
+    // 多点触发配置
+    cJSON* dksConfigsJSON = cJSON_CreateArray();
+    for(uint8_t i = 0; i < NUM_ADC_BUTTONS; i++) {
+        const DKSProfile* dks = &profile->dksConfigs[i];
+        cJSON* dksJSON = cJSON_CreateObject();
+        cJSON_AddBoolToObject(dksJSON, "enabled", dks->enabled);
+
+        cJSON* pointsJSON = cJSON_CreateArray();
+        for(uint8_t p = 0; p < NUM_DKS_POINTS; p++) {
+            cJSON* pointJSON = cJSON_CreateObject();
+            char buffer[32];
+            snprintf(buffer, sizeof(buffer), "%.4f", dks->points[p].distance);
+            cJSON_AddRawToObject(pointJSON, "distance", buffer);
+            cJSON_AddNumberToObject(pointJSON, "virtualPin", dks->points[p].virtualPin);
+            cJSON_AddNumberToObject(pointJSON, "pressAction", dks->points[p].pressAction);
+            cJSON_AddNumberToObject(pointJSON, "releaseAction", dks->points[p].releaseAction);
+            cJSON_AddItemToArray(pointsJSON, pointJSON);
+        }
+        cJSON_AddItemToObject(dksJSON, "points", pointsJSON);
+        cJSON_AddItemToArray(dksConfigsJSON, dksJSON);
+    }
+
     // // 组装最终结构
     cJSON_AddItemToObject(profileDetailsJSON, "keysConfig", keysConfigJSON);
     cJSON_AddItemToObject(profileDetailsJSON, "ledsConfigs", ledsConfigJSON);
     cJSON_AddItemToObject(profileDetailsJSON, "triggerConfigs", triggerConfigsJSON);
+    cJSON_AddItemToObject(profileDetailsJSON, "dksConfigs", dksConfigsJSON);
 
     return profileDetailsJSON;
 }
@@ -599,6 +633,49 @@ cJSON* buildHotkeysConfigJSON(Config& config) {
     return hotkeysConfigJSON;
 }
 
+// 辅助函数：构建连发/锁定和宏配置的JSON结构
+cJSON* buildMacrosConfigJSON(const GamepadProfile* profile) {
+    cJSON* macrosConfigJSON = cJSON_CreateObject();
+    cJSON_AddStringToObject(macrosConfigJSON, "profileId", profile->id);
+    cJSON_AddNumberToObject(macrosConfigJSON, "maxTurboRateHz", TURBO_MAX_RATE_HZ);
+    cJSON_AddNumberToObject(macrosConfigJSON, "maxStepDurationMs", MACRO_STEP_MAX_DURATION_MS);
+    cJSON_AddNumberToObject(macrosConfigJSON, "numMacroSteps", NUM_MACRO_STEPS);
+
+    // 连发/锁定配置，按虚拟引脚索引
+    cJSON* turboConfigsJSON = cJSON_CreateArray();
+    for(uint8_t i = 0; i < NUM_ADC_BUTTONS + NUM_GPIO_BUTTONS; i++) {
+        cJSON* turboJSON = cJSON_CreateObject();
+        cJSON_AddNumberToObject(turboJSON, "mode", profile->turboConfigs[i].mode);
+        cJSON_AddNumberToObject(turboJSON, "rate", profile->turboConfigs[i].rate);
+        cJSON_AddItemToArray(turboConfigsJSON, turboJSON);
+    }
+    cJSON_AddItemToObject(macrosConfigJSON, "turboConfigs", turboConfigsJSON);
+
+    // 宏，steps 只输出有效步骤
+    cJSON* macrosJSON = cJSON_CreateArray();
+    for(uint8_t m = 0; m < NUM_MACROS; m++) {
+        const MacroConfig* macro = &profile->macros[m];
+        cJSON* macroJSON = cJSON_CreateObject();
+        cJSON_AddBoolToObject(macroJSON, "enabled", macro->enabled);
+        cJSON_AddNumberToObject(macroJSON, "virtualPin", macro->virtualPin);
+        cJSON_AddNumberToObject(macroJSON, "mode", macro->mode);
+
+        cJSON* stepsJSON = cJSON_CreateArray();
+        for(uint8_t s = 0; s < macro->numSteps && s < NUM_MACRO_STEPS; s++) {
+            cJSON* stepJSON = cJSON_CreateObject();
+            cJSON_AddNumberToObject(stepJSON, "buttons", macro->steps[s].buttons);
+            cJSON_AddNumberToObject(stepJSON, "dpad", macro->steps[s].dpad);
+            cJSON_AddNumberToObject(stepJSON, "duration", macro->steps[s].duration);
+            cJSON_AddItemToArray(stepsJSON, stepJSON);
+        }
+        cJSON_AddItemToObject(macroJSON, "steps", stepsJSON);
+        cJSON_AddItemToArray(macrosJSON, macroJSON);
+    }
+    cJSON_AddItemToObject(macrosConfigJSON, "macros", macrosJSON);
+
+    return macrosConfigJSON;
+}
+
 /**
  * @brief 获取profile列表
  * 
@@ -937,6 +1014,19 @@ std::string apiUpdateProfile() {
                 targetProfile->keysConfig.keysEnableTag[i] = cJSON_GetArrayItem(keysEnableTag, i)->type == cJSON_True;
             }
         }
+
+        // 更新模拟输出来源
+        cJSON* analogSources = cJSON_GetObjectItem(keysConfig, "analogSources");
+        if(analogSources && cJSON_IsArray(analogSources)) {
+            for(uint8_t i = 0; i < NUM_ANALOG_OUTPUTS; i++) {
+                cJSON* source = cJSON_GetArrayItem(analogSources, i);
+                if(!source || !cJSON_IsNumber(source)) {
+                    continue;
+                }
+                targetProfile->keysConfig.analogSources[i] =
+                    (source->valueint >= 0 && source->valueint < NUM_ADC_BUTTONS) ? (int8_t)source->valueint : -1;
+            }
+        }
       
         // 更新按键映射
         cJSON* keyMapping = cJSON_GetObjectItem(keysConfig, "keyMapping");                                          
@@ -1087,6 +1177,42 @@ std::string apiUpdateProfile() {
         }
     }
 
+    // 更新多点触发配置
+    cJSON* dksConfigs = cJSON_GetObjectItem(details, "dksConfigs");
+    if(dksConfigs && cJSON_IsArray(dksConfigs)) {
+        for(uint8_t i = 0; i < NUM_ADC_BUTTONS && i < cJSON_GetArraySize(dksConfigs); i++) {
+            cJSON* dksJSON = cJSON_GetArrayItem(dksConfigs, i);
+            DKSProfile* dks = &targetProfile->dksConfigs[i];
+            if(!dksJSON) {
+                continue;
+            }
+
+            cJSON* item;
+            if((item = cJSON_GetObjectItem(dksJSON, "enabled")))
+                dks->enabled = item->type == cJSON_True;
+
+            cJSON* points = cJSON_GetObjectItem(dksJSON, "points");
+            if(!points || !cJSON_IsArray(points)) {
+                continue;
+            }
+            for(uint8_t p = 0; p < NUM_DKS_POINTS && p < cJSON_GetArraySize(points); p++) {
+                cJSON* pointJSON = cJSON_GetArrayItem(points, p);
+                DKSActuationPoint* point = &dks->points[p];
+                if(!pointJSON) {
+                    continue;
+                }
+                if((item = cJSON_GetObjectItem(pointJSON, "distance")))
+                    point->distance = item->valuedouble;
+                if((item = cJSON_GetObjectItem(pointJSON, "virtualPin")))
+                    point->virtualPin = (item->valueint >= 0 && item->valueint < 32) ? (int8_t)item->valueint : -1;
+                if((item = cJSON_GetObjectItem(pointJSON, "pressAction")))
+                    point->pressAction = (item->valueint >= 0 && item->valueint < NUM_DKS_ACTIONS) ? (uint8_t)item->valueint : DKSAction::DKS_ACTION_NONE;
+                if((item = cJSON_GetObjectItem(pointJSON, "releaseAction")))
+                    point->releaseAction = (item->valueint >= 0 && item->valueint < NUM_DKS_ACTIONS) ? (uint8_t)item->valueint : DKSAction::DKS_ACTION_NONE;
+            }
+        }
+    }
+
     // 保存配置
     if(!STORAGE_MANAGER.saveConfig()) {
         cJSON_Delete(params);
@@ -1554,6 +1680,187 @@ std::string apiUpdateHotkeysConfig() {
     return response;
 }
 
+/**
+ * @brief 获取profile的连发/锁定和宏配置
+ * @param std::string
+ * {
+ *      "profileId": "profile-0"
+ * }
+ * @return std::string 
+ * {
+ *      "errNo": 0,
+ *      "data": {
+ *          "macrosConfig": {
+ *              "profileId": "profile-0",
+ *              "maxTurboRateHz": 30,
+ *              "maxStepDurationMs": 4000,
+ *              "numMacroSteps": 8,
+ *              "turboConfigs": [               // 按虚拟引脚索引
+ *                  { "mode": 1, "rate": 15 },  // mode: TurboMode 0 无 1 按住连发 2 锁定 3 锁定连发
+ *                  ...
+ *              ],
+ *              "macros": [
+ *                  {
+ *                      "enabled": true,
+ *                      "virtualPin": 3,        // 触发键
+ *                      "mode": 0,              // MacroMode 0 播放一次 1 按住循环 2 开关循环
+ *                      "steps": [
+ *                          { "buttons": 1, "dpad": 2, "duration": 16 },  // GAMEPAD_MASK_* 按键/方向掩码，持续时间 ms
+ *                          ...
+ *                      ]
+ *                  },
+ *                  ...
+ *              ]
+ *          }
+ *      }
+ * }
+ */
+std::string apiGetMacrosConfig() {
+    LOG_INFO("WEBAPI", "apiGetMacrosConfig start.");
+    Config& config = Storage::getInstance().config;
+    cJSON* params = get_post_data();
+
+    // 未指定profile时使用默认profile
+    GamepadProfile* targetProfile = nullptr;
+    cJSON* profileIdItem = params ? cJSON_GetObjectItem(params, "profileId") : NULL;
+    const char* profileId = (profileIdItem && cJSON_IsString(profileIdItem)) ? profileIdItem->valuestring : config.defaultProfileId;
+    for(uint8_t i = 0; i < NUM_PROFILES; i++) {
+        if(strcmp(profileId, config.profiles[i].id) == 0) {
+            targetProfile = &config.profiles[i];
+            break;
+        }
+    }
+    if(params) {
+        cJSON_Delete(params);
+    }
+
+    if(!targetProfile) {
+        LOG_ERROR("WEBAPI", "apiGetMacrosConfig: Profile not found");
+        return get_response_temp(STORAGE_ERROR_NO::PARAMETERS_ERROR, NULL, "Profile not found");
+    }
+
+    cJSON* dataJSON = cJSON_CreateObject();
+    cJSON_AddItemToObject(dataJSON, "macrosConfig", buildMacrosConfigJSON(targetProfile));
+
+    std::string response = get_response_temp(STORAGE_ERROR_NO::ACTION_SUCCESS, dataJSON);
+    LOG_INFO("WEBAPI", "apiGetMacrosConfig success.");
+    return response;
+}
+
+/**
+ * @brief 更新profile的连发/锁定和宏配置，重启进入输入模式后生效
+ * @param std::string
+ * {
+ *      "profileId": "profile-0",
+ *      "turboConfigs": [ { "mode": 1, "rate": 15 }, ... ],    // 可选，按虚拟引脚索引
+ *      "macros": [ { "enabled": true, "virtualPin": 3, "mode": 0, "steps": [ ... ] }, ... ]  // 可选
+ * }
+ * @return std::string 同 apiGetMacrosConfig
+ */
+std::string apiUpdateMacrosConfig() {
+    LOG_INFO("WEBAPI", "apiUpdateMacrosConfig start.");
+    Config& config = Storage::getInstance().config;
+    cJSON* params = get_post_data();
+
+    if(!params) {
+        LOG_ERROR("WEBAPI", "apiUpdateMacrosConfig: Invalid parameters");
+        return get_response_temp(STORAGE_ERROR_NO::PARAMETERS_ERROR, NULL, "Invalid parameters");
+    }
+
+    cJSON* profileIdItem = cJSON_GetObjectItem(params, "profileId");
+    if(!profileIdItem || !cJSON_IsString(profileIdItem)) {
+        cJSON_Delete(params);
+        LOG_ERROR("WEBAPI", "apiUpdateMacrosConfig: Profile ID not provided");
+        return get_response_temp(STORAGE_ERROR_NO::PARAMETERS_ERROR, NULL, "Profile ID not provided");
+    }
+
+    GamepadProfile* targetProfile = nullptr;
+    for(uint8_t i = 0; i < NUM_PROFILES; i++) {
+        if(strcmp(profileIdItem->valuestring, config.profiles[i].id) == 0) {
+            targetProfile = &config.profiles[i];
+            break;
+        }
+    }
+    if(!targetProfile) {
+        cJSON_Delete(params);
+        LOG_ERROR("WEBAPI", "apiUpdateMacrosConfig: Profile not found");
+        return get_response_temp(STORAGE_ERROR_NO::PARAMETERS_ERROR, NULL, "Profile not found");
+    }
+
+    cJSON* item;
+
+    // 更新连发/锁定配置
+    cJSON* turboConfigs = cJSON_GetObjectItem(params, "turboConfigs");
+    if(turboConfigs && cJSON_IsArray(turboConfigs)) {
+        for(uint8_t i = 0; i < NUM_ADC_BUTTONS + NUM_GPIO_BUTTONS && i < cJSON_GetArraySize(turboConfigs); i++) {
+            cJSON* turboJSON = cJSON_GetArrayItem(turboConfigs, i);
+            TurboConfig* turbo = &targetProfile->turboConfigs[i];
+            if((item = cJSON_GetObjectItem(turboJSON, "mode")) && cJSON_IsNumber(item)) {
+                turbo->mode = (item->valueint >= 0 && item->valueint < NUM_TURBO_MODES) ? (uint8_t)item->valueint : TurboMode::TURBO_MODE_OFF;
+            }
+            if((item = cJSON_GetObjectItem(turboJSON, "rate")) && cJSON_IsNumber(item)) {
+                turbo->rate = (uint8_t)std::min(std::max(item->valueint, 1), TURBO_MAX_RATE_HZ);
+            }
+        }
+    }
+
+    // 更新宏
+    cJSON* macros = cJSON_GetObjectItem(params, "macros");
+    if(macros && cJSON_IsArray(macros)) {
+        for(uint8_t m = 0; m < NUM_MACROS && m < cJSON_GetArraySize(macros); m++) {
+            cJSON* macroJSON = cJSON_GetArrayItem(macros, m);
+            MacroConfig* macro = &targetProfile->macros[m];
+            if((item = cJSON_GetObjectItem(macroJSON, "enabled"))) {
+                macro->enabled = cJSON_IsTrue(item);
+            }
+            if((item = cJSON_GetObjectItem(macroJSON, "virtualPin")) && cJSON_IsNumber(item)) {
+                macro->virtualPin = (item->valueint >= 0 && item->valueint < NUM_ADC_BUTTONS + NUM_GPIO_BUTTONS) ? (int8_t)item->valueint : -1;
+            }
+            if((item = cJSON_GetObjectItem(macroJSON, "mode")) && cJSON_IsNumber(item)) {
+                macro->mode = (item->valueint >= 0 && item->valueint < NUM_MACRO_MODES) ? (uint8_t)item->valueint : MacroMode::MACRO_MODE_ONCE;
+            }
+
+            cJSON* steps = cJSON_GetObjectItem(macroJSON, "steps");
+            if(!steps || !cJSON_IsArray(steps)) {
+                continue;
+            }
+            macro->numSteps = (uint8_t)std::min(cJSON_GetArraySize(steps), NUM_MACRO_STEPS);
+            memset(macro->steps, 0, sizeof(macro->steps));
+            for(uint8_t s = 0; s < macro->numSteps; s++) {
+                cJSON* stepJSON = cJSON_GetArrayItem(steps, s);
+                MacroStep* step = &macro->steps[s];
+                if((item = cJSON_GetObjectItem(stepJSON, "buttons")) && cJSON_IsNumber(item)) {
+                    step->buttons = (uint16_t)item->valueint;
+                }
+                if((item = cJSON_GetObjectItem(stepJSON, "dpad")) && cJSON_IsNumber(item)) {
+                    step->dpad = (uint8_t)(item->valueint & GAMEPAD_MASK_DPAD);
+                }
+                step->duration = 1;
+                if((item = cJSON_GetObjectItem(stepJSON, "duration")) && cJSON_IsNumber(item)) {
+                    step->duration = (uint16_t)std::min(std::max(item->valueint, 1), MACRO_STEP_MAX_DURATION_MS);
+                }
+            }
+        }
+    }
+
+    // 保存配置
+    if(!STORAGE_MANAGER.saveConfig()) {
+        cJSON_Delete(params);
+        LOG_ERROR("WEBAPI", "apiUpdateMacrosConfig: Failed to save configuration");
+        return get_response_temp(STORAGE_ERROR_NO::ACTION_FAILURE, NULL, "Failed to save configuration");
+    }
+
+    cJSON* dataJSON = cJSON_CreateObject();
+    cJSON_AddItemToObject(dataJSON, "macrosConfig", buildMacrosConfigJSON(targetProfile));
+
+    std::string response = get_response_temp(STORAGE_ERROR_NO::ACTION_SUCCESS, dataJSON);
+
+    cJSON_Delete(params);
+
+    LOG_INFO("WEBAPI", "apiUpdateMacrosConfig success.");
+    return response;
+}
+
 /**
  * @brief 重启
  * 
@@ -2626,6 +2933,258 @@ std::string apiGetButtonStates() {
 
 
 
+/**
+ * @brief 获取ADC帧统计（DMA实际帧间隔、抖动分布、丢帧）
+ * 用于观察USB、LED、lwIP等负载下每个ADC实际的有效采样率
+ * @return std::string 
+ * {
+ *      "errNo": 0,
+ *      "data": {
+ *          "pingPong": true,
+ *          "jitterBinsUs": [0, 1, 2, 4, 8, 16, 32, 64],  // 每个抖动桶的下限（us）
+ *          "adcs": [
+ *              {
+ *                  "adc": 1,
+ *                  "channels": 6,
+ *                  "frames": 100000,
+ *                  "periodMinUs": 95.2,
+ *                  "periodAvgUs": 96.1,
+ *                  "periodMaxUs": 130.5,
+ *                  "frameRateHz": 10405.8,       // 每个通道的有效采样率
+ *                  "droppedFrames": 0,           // 未被读取就被覆盖的帧
+ *                  "overrunErrors": 0,
+ *                  "jitterHistogram": [99000, 900, 80, 15, 5, 0, 0, 0]
+ *              }
+ *          ]
+ *      }
+ * }
+ */
+std::string apiGetADCFrameStats() {
+    cJSON* dataJSON = cJSON_CreateObject();
+    if (!dataJSON) {
+        return get_response_temp(STORAGE_ERROR_NO::ACTION_FAILURE, NULL, "Failed to create JSON object");
+    }
+
+    cJSON_AddBoolToObject(dataJSON, "pingPong", ADC_DMA_PING_PONG != 0);
+
+    cJSON* binsJSON = cJSON_CreateArray();
+    for (uint8_t bin = 0; bin < ADC_FRAME_JITTER_HISTOGRAM_BINS; bin++) {
+        cJSON_AddItemToArray(binsJSON, cJSON_CreateNumber(bin == 0 ? 0 : (1U << (bin - 1))));
+    }
+    cJSON_AddItemToObject(dataJSON, "jitterBinsUs", binsJSON);
+
+    cJSON* adcsJSON = cJSON_CreateArray();
+    for (uint8_t adcIndex = 0; adcIndex < NUM_ADC; adcIndex++) {
+        ADCFrameStats stats;
+        if (!ADC_MANAGER.getFrameStats(adcIndex, stats)) {
+            continue;
+        }
+
+        const double periodAvg = stats.intervals > 0 ? (double)stats.totalPeriod / stats.intervals : 0.0;
+
+        cJSON* adcJSON = cJSON_CreateObject();
+        cJSON_AddNumberToObject(adcJSON, "adc", adcIndex + 1);
+        cJSON_AddNumberToObject(adcJSON, "channels", ADC_MANAGER.getADCChannelCount(adcIndex));
+        cJSON_AddNumberToObject(adcJSON, "frames", stats.frames);
+        cJSON_AddNumberToObject(adcJSON, "periodMinUs", stats.intervals > 0 ? (double)stats.minPeriod / CYCLES_PER_MICROSECOND : 0.0);
+        cJSON_AddNumberToObject(adcJSON, "periodAvgUs", periodAvg / CYCLES_PER_MICROSECOND);
+        cJSON_AddNumberToObject(adcJSON, "periodMaxUs", (double)stats.maxPeriod / CYCLES_PER_MICROSECOND);
+        cJSON_AddNumberToObject(adcJSON, "frameRateHz", periodAvg > 0.0 ? (double)SYSTEM_CLOCK_FREQ / periodAvg : 0.0);
+        cJSON_AddNumberToObject(adcJSON, "droppedFrames", stats.droppedFrames);
+        cJSON_AddNumberToObject(adcJSON, "overrunErrors", stats.overrunErrors);
+
+        cJSON* histogramJSON = cJSON_CreateArray();
+        for (uint8_t bin = 0; bin < ADC_FRAME_JITTER_HISTOGRAM_BINS; bin++) {
+            cJSON_AddItemToArray(histogramJSON, cJSON_CreateNumber(stats.jitterHistogram[bin]));
+        }
+        cJSON_AddItemToObject(adcJSON, "jitterHistogram", histogramJSON);
+
+        cJSON_AddItemToArray(adcsJSON, adcJSON);
+    }
+    cJSON_AddItemToObject(dataJSON, "adcs", adcsJSON);
+
+    return get_response_temp(STORAGE_ERROR_NO::ACTION_SUCCESS, dataJSON);
+}
+
+/**
+ * @brief 重置ADC帧统计
+ * @return std::string 
+ * {
+ *      "errNo": 0,
+ *      "data": {
+ *          "message": "ADC frame stats reset successfully"
+ *      }
+ * }
+ */
+std::string apiResetADCFrameStats() {
+    ADC_MANAGER.resetFrameStats();
+
+    cJSON* dataJSON = cJSON_CreateObject();
+    if (!dataJSON) {
+        return get_response_temp(STORAGE_ERROR_NO::ACTION_FAILURE, NULL, "Failed to create JSON object");
+    }
+    cJSON_AddStringToObject(dataJSON, "message", "ADC frame stats reset successfully");
+
+    return get_response_temp(STORAGE_ERROR_NO::ACTION_SUCCESS, dataJSON);
+}
+
+/**
+ * @brief 获取主循环耗时统计
+ * 统计在输入模式下采集并保存在备份SRAM中，这里返回的是重启进入网页配置模式之前最后一次输入模式会话的统计
+ * 完整直方图可以用 tools/perf_stats_decoder.py 解析
+ * @return std::string 
+ * {
+ *      "errNo": 0,
+ *      "data": {
+ *          "enabled": true,
+ *          "valid": true,
+ *          "cyclesPerUs": 480,
+ *          "histogramMinBits": 4,
+ *          "histogramSubBits": 2,
+ *          "stages": [
+ *              {
+ *                  "name": "adcRead",
+ *                  "count": 123456,
+ *                  "minCycles": 800, "avgCycles": 950, "p99Cycles": 1280, "maxCycles": 4100,
+ *                  "histogram": [0, 0, ...]
+ *              }
+ *          ],
+ *          "spikeCount": 3,
+ *          "spikes": [ { "tick": 123456, "stage": "tudTask", "cycles": 150000 } ]
+ *      }
+ * }
+ */
+std::string apiGetPerfStats() {
+    cJSON* dataJSON = cJSON_CreateObject();
+    if (!dataJSON) {
+        return get_response_temp(STORAGE_ERROR_NO::ACTION_FAILURE, NULL, "Failed to create JSON object");
+    }
+
+    const bool valid = PERF_TRACE.isValid();
+    cJSON_AddBoolToObject(dataJSON, "enabled", PERF_TRACE_ENABLED != 0);
+    cJSON_AddBoolToObject(dataJSON, "valid", valid);
+    cJSON_AddNumberToObject(dataJSON, "cyclesPerUs", CYCLES_PER_MICROSECOND);
+    cJSON_AddNumberToObject(dataJSON, "histogramMinBits", PERF_TRACE_HISTOGRAM_MIN_BITS);
+    cJSON_AddNumberToObject(dataJSON, "histogramSubBits", PERF_TRACE_HISTOGRAM_SUB_BITS);
+
+    if (!valid) {
+        return get_response_temp(STORAGE_ERROR_NO::ACTION_SUCCESS, dataJSON);
+    }
+
+    const PerfTraceData& perfData = PERF_TRACE.getData();
+
+    cJSON* stagesJSON = cJSON_CreateArray();
+    for (uint8_t stage = 0; stage < NUM_PERF_STAGES; stage++) {
+        const PerfStageStats& stats = perfData.stages[stage];
+
+        cJSON* stageJSON = cJSON_CreateObject();
+        cJSON_AddStringToObject(stageJSON, "name", PerfTrace::getStageName(stage));
+        cJSON_AddNumberToObject(stageJSON, "count", stats.count);
+        cJSON_AddNumberToObject(stageJSON, "minCycles", stats.count > 0 ? stats.minCycles : 0);
+        cJSON_AddNumberToObject(stageJSON, "avgCycles", stats.count > 0 ? (double)stats.totalCycles / stats.count : 0.0);
+        cJSON_AddNumberToObject(stageJSON, "p99Cycles", PERF_TRACE.getPercentileCycles(stage, 99));
+        cJSON_AddNumberToObject(stageJSON, "maxCycles", stats.maxCycles);
+
+        cJSON* histogramJSON = cJSON_CreateArray();
+        for (uint8_t bin = 0; bin < PERF_TRACE_HISTOGRAM_BINS; bin++) {
+            cJSON_AddItemToArray(histogramJSON, cJSON_CreateNumber(stats.histogram[bin]));
+        }
+        cJSON_AddItemToObject(stageJSON, "histogram", histogramJSON);
+
+        cJSON_AddItemToArray(stagesJSON, stageJSON);
+    }
+    cJSON_AddItemToObject(dataJSON, "stages", stagesJSON);
+
+    // 尖峰记录，按时间从旧到新输出
+    const uint32_t spikeCount = perfData.spikeCount;
+    const uint32_t numSpikes = std::min<uint32_t>(spikeCount, PERF_TRACE_SPIKE_RING_SIZE);
+    cJSON_AddNumberToObject(dataJSON, "spikeCount", spikeCount);
+    cJSON* spikesJSON = cJSON_CreateArray();
+    for (uint32_t i = spikeCount - numSpikes; i < spikeCount; i++) {
+        const PerfSpikeRecord& spike = perfData.spikes[i % PERF_TRACE_SPIKE_RING_SIZE];
+        cJSON* spikeJSON = cJSON_CreateObject();
+        cJSON_AddNumberToObject(spikeJSON, "tick", spike.tick);
+        cJSON_AddStringToObject(spikeJSON, "stage", PerfTrace::getStageName(spike.stage));
+        cJSON_AddNumberToObject(spikeJSON, "cycles", spike.cycles);
+        cJSON_AddItemToArray(spikesJSON, spikeJSON);
+    }
+    cJSON_AddItemToObject(dataJSON, "spikes", spikesJSON);
+
+    return get_response_temp(STORAGE_ERROR_NO::ACTION_SUCCESS, dataJSON);
+}
+
+/**
+ * @brief 获取按键（ADC按键和GPIO按键）输入到USB报告的延迟统计
+ * 统计在输入模式下采集并保存在备份SRAM中，这里返回的是重启进入网页配置模式之前最后一次输入模式会话的统计
+ * 延迟从按键状态翻转开始，到报告被USB协议栈接受为止，不包含主机轮询间隔
+ * @return std::string 
+ * {
+ *      "errNo": 0,
+ *      "data": {
+ *          "enabled": true,
+ *          "valid": true,
+ *          "timeoutEvents": 0,
+ *          "discardedEvents": 12,
+ *          "histogramBinsUs": [0, 1, 2, 4, ...],  // 每个桶的下限（us）
+ *          "buttons": [
+ *              {
+ *                  "virtualPin": 0,
+ *                  "count": 520,
+ *                  "avgUs": 3.2, "p99Us": 8, "maxUs": 250.5,
+ *                  "histogram": [0, 10, 500, 8, 2, ...]
+ *              }
+ *          ]
+ *      }
+ * }
+ */
+std::string apiGetLatencyStats() {
+    cJSON* dataJSON = cJSON_CreateObject();
+    if (!dataJSON) {
+        return get_response_temp(STORAGE_ERROR_NO::ACTION_FAILURE, NULL, "Failed to create JSON object");
+    }
+
+    const bool valid = LATENCY_TRACE.isValid();
+    cJSON_AddBoolToObject(dataJSON, "enabled", LATENCY_TRACE_ENABLED != 0);
+    cJSON_AddBoolToObject(dataJSON, "valid", valid);
+
+    if (!valid) {
+        return get_response_temp(STORAGE_ERROR_NO::ACTION_SUCCESS, dataJSON);
+    }
+
+    const LatencyTraceData& latencyData = LATENCY_TRACE.getData();
+    cJSON_AddNumberToObject(dataJSON, "timeoutEvents", latencyData.timeoutEvents);
+    cJSON_AddNumberToObject(dataJSON, "discardedEvents", latencyData.discardedEvents);
+
+    cJSON* binsJSON = cJSON_CreateArray();
+    for (uint8_t bin = 0; bin < LATENCY_TRACE_HISTOGRAM_BINS; bin++) {
+        cJSON_AddItemToArray(binsJSON, cJSON_CreateNumber(bin == 0 ? 0 : (1U << (bin - 1))));
+    }
+    cJSON_AddItemToObject(dataJSON, "histogramBinsUs", binsJSON);
+
+    cJSON* buttonsJSON = cJSON_CreateArray();
+    for (uint8_t virtualPin = 0; virtualPin < LATENCY_TRACE_NUM_BUTTONS; virtualPin++) {
+        const LatencyButtonStats& stats = latencyData.buttons[virtualPin];
+
+        cJSON* buttonJSON = cJSON_CreateObject();
+        cJSON_AddNumberToObject(buttonJSON, "virtualPin", virtualPin);
+        cJSON_AddNumberToObject(buttonJSON, "count", stats.count);
+        cJSON_AddNumberToObject(buttonJSON, "avgUs", stats.count > 0 ? (double)stats.totalCycles / stats.count / CYCLES_PER_MICROSECOND : 0.0);
+        cJSON_AddNumberToObject(buttonJSON, "p99Us", LATENCY_TRACE.getPercentileUs(virtualPin, 99));
+        cJSON_AddNumberToObject(buttonJSON, "maxUs", (double)stats.maxCycles / CYCLES_PER_MICROSECOND);
+
+        cJSON* histogramJSON = cJSON_CreateArray();
+        for (uint8_t bin = 0; bin < LATENCY_TRACE_HISTOGRAM_BINS; bin++) {
+            cJSON_AddItemToArray(histogramJSON, cJSON_CreateNumber(stats.histogram[bin]));
+        }
+        cJSON_AddItemToObject(buttonJSON, "histogram", histogramJSON);
+
+        cJSON_AddItemToArray(buttonsJSON, buttonJSON);
+    }
+    cJSON_AddItemToObject(dataJSON, "buttons", buttonsJSON);
+
+    return get_response_temp(STORAGE_ERROR_NO::ACTION_SUCCESS, dataJSON);
+}
+
 /**
  * @brief 推送前端 LED 配置到后端硬件
  * POST 请求体格式：
@@ -3791,6 +4350,8 @@ static const std::pair<const char*, HandlerFuncPtr> handlerFuncs[] =
     { "/api/delete-profile", apiDeleteProfile },
     { "/api/switch-default-profile", apiSwitchDefaultProfile },
     { "/api/update-hotkeys-config", apiUpdateHotkeysConfig },
+    { "/api/macros-config", apiGetMacrosConfig },                   // 获取连发/锁定和宏配置
+    { "/api/update-macros-config", apiUpdateMacrosConfig },         // 更新连发/锁定和宏配置
     { "/api/reboot", apiReboot },
     { "/api/ms-get-list", apiMSGetList },          //获取轴体映射列表
     { "/api/ms-get-mark-status", apiMSGetMarkStatus },      // 获取标记状态
@@ -3810,6 +4371,10 @@ static const std::pair<const char*, HandlerFuncPtr> handlerFuncs[] =
     { "/api/start-button-monitoring", apiStartButtonMonitoring },   // 开启按键功能
     { "/api/stop-button-monitoring", apiStopButtonMonitoring },     // 关闭按键功能
     { "/api/get-button-states", apiGetButtonStates },               // 轮询获取按键状态
+    { "/api/adc-frame-stats", apiGetADCFrameStats },                // 获取ADC帧统计
+    { "/api/reset-adc-frame-stats", apiResetADCFrameStats },        // 重置ADC帧统计
+    { "/api/perf-stats", apiGetPerfStats },                         // 获取主循环耗时统计
+    { "/api/latency-stats", apiGetLatencyStats },                   // 获取按键到USB报告的延迟统计
     { "/api/push-leds-config", apiPushLedsConfig },                 // 推送 LED 配置
     { "/api/clear-leds-preview", apiClearLedsPreview },             // 清除 LED 预览模式
     { "/api/firmware-metadata", apiFirmwareMetadata },               // 获取固件元数据信息
@@ -16,10 +16,6 @@
 // PS4/PS5 Auth Systems
 #include "drivers/ps4/PS4Auth.hpp"
 
-
-// force a report to be sent every X ms
-#define PS4_KEEPALIVE_TIMER 5
-
 // Controller calibration
 static constexpr uint8_t output_0x02[] = {
     0xfe, 0xff, 0x0e, 0x00, 0x04, 0x00, 0xd4, 0x22,
@@ -147,7 +143,7 @@ void PS4Driver::initialize() {
 
     last_report_counter = 0; // PS4 Reports
     last_axis_counter = 0;
-    last_report_timer = HAL_GetTick();
+    reportScheduler.setup(controllerType == PS4_ARCADESTICK ? INPUT_MODE_PS5 : INPUT_MODE_PS4);
     cur_nonce_id = 1; // PS4 Auth
     cur_nonce_chunk = 0;
 
@@ -175,6 +171,12 @@ void PS4Driver::initializeAux() {
 
 void PS4Driver::process(Gamepad * gamepad) {
     // const GamepadOptions & options = gamepad->getOptions();
+    const uint32_t now = HAL_GetTick();
+    const ReportSendReason reason = reportScheduler.poll(gamepad->state, now);
+    if (reason == ReportSendReason::NONE) {
+        return;
+    }
+
     switch (gamepad->state.dpad & GAMEPAD_MASK_DPAD)
     {
         case GAMEPAD_MASK_UP:                        ps4Report.dpad = PS4_HAT_UP;        break;
@@ -210,14 +212,14 @@ void PS4Driver::process(Gamepad * gamepad) {
     ps4Report.right_stick_x = static_cast<uint8_t>(gamepad->state.rx >> 8);
     ps4Report.right_stick_y = static_cast<uint8_t>(gamepad->state.ry >> 8);
 
-    // if (gamepad->hasAnalogTriggers)
-    // {
-    //     ps4Report.left_trigger = gamepad->state.lt;
-    //     ps4Report.right_trigger = gamepad->state.rt;
-    // } else {
+    if (gamepad->hasAnalogTriggers)
+    {
+        ps4Report.left_trigger = gamepad->pressedL2() ? 0xFF : gamepad->state.lt;
+        ps4Report.right_trigger = gamepad->pressedR2() ? 0xFF : gamepad->state.rt;
+    } else {
         ps4Report.left_trigger = gamepad->pressedL2() ? 0xFF : 0;
         ps4Report.right_trigger = gamepad->pressedR2() ? 0xFF : 0;
-    // }
+    }
 
     // if the touchpad is pressed (note A2 vs. S1 choice above), emulate one finger of the touchpad
     touchpadData.p1.unpressed = ps4Report.button_touchpad ? 0 : 1;
@@ -293,30 +295,21 @@ void PS4Driver::process(Gamepad * gamepad) {
     if (tud_suspended())
         tud_remote_wakeup();
 
-    uint32_t now = HAL_GetTick();
-    void * report = &ps4Report;
-    uint16_t report_size = sizeof(ps4Report);
-    if (memcmp(last_report, report, report_size) != 0)
-    {
-        // HID ready + report sent, copy previous report
-        if (tud_hid_ready() && tud_hid_report(0, report, report_size) == true ) {
-            memcpy(last_report, report, report_size);
-        }
-        // keep track of our last successful report, for keepalive purposes
-        last_report_timer = now;
-    } else {
-        // some games apparently can miss reports, or they rely on official behavior of getting frequent
-        // updates. we normally only send a report when the value changes; if we increment the counters
-        // every time we generate the report (every GP2040::run loop), we apparently overburden
-        // TinyUSB and introduce roughly 1ms of latency. but we want to loop often and report on every
-        // true update in order to achieve our tight <1ms report timing when we *do* have a different
-        // report to send.
-        if ((now - last_report_timer) > PS4_KEEPALIVE_TIMER) {
-            last_report_counter = (last_report_counter+1) & 0x3F;
-            ps4Report.report_counter = last_report_counter;		// report counter is 6 bits
-            ps4Report.axis_timing = now;		 		// axis counter is 16 bits
-            // the *next* process() will be a forced report (or real user input)
-        }
+    // some games apparently can miss reports, or they rely on official behavior of getting frequent
+    // updates. we normally only send a report when the value changes; if we increment the counters
+    // every time we generate the report, we apparently overburden TinyUSB and introduce roughly 1ms
+    // of latency. so the counters only advance when the keepalive interval forces a report.
+    // the new counter is only committed once the report actually went out, so a busy endpoint
+    // doesn't skip counter values on retry.
+    if (reason == ReportSendReason::KEEPALIVE) {
+        ps4Report.report_counter = (last_report_counter+1) & 0x3F;	// report counter is 6 bits
+        ps4Report.axis_timing = now;		 		// axis counter is 16 bits
+    }
+
+    // HID ready + report sent, otherwise the report stays pending until the next process
+    if (tud_hid_ready() && tud_hid_report(0, &ps4Report, sizeof(ps4Report)) == true ) {
+        last_report_counter = ps4Report.report_counter;
+        reportScheduler.reportSent(gamepad->state, now);
     }
 
     // uint16_t featureSize = sizeof(PS4FeatureOutputReport);
@@ -18,9 +18,16 @@ void PSClassicDriver::initialize() {
 		.xfer_cb = hidd_xfer_cb,
 		.sof = NULL
 	};
+
+	reportScheduler.setup((uint32_t)REPORT_KEEPALIVE_DEFAULT_MS);
 }
 
 void PSClassicDriver::process(Gamepad * gamepad) {
+	const uint32_t now = HAL_GetTick();
+	if (reportScheduler.poll(gamepad->state, now) == ReportSendReason::NONE) {
+		return;
+	}
+
 	psClassicReport.buttons = PSCLASSIC_MASK_CENTER;
 
 	switch (gamepad->state.dpad & GAMEPAD_MASK_DPAD)
@@ -53,13 +60,9 @@ void PSClassicDriver::process(Gamepad * gamepad) {
 	if (tud_suspended())
 		tud_remote_wakeup();
 
-	void * report = &psClassicReport;
-	uint16_t report_size = sizeof(psClassicReport);
-	if (memcmp(last_report, report, report_size) != 0) {
-		// HID ready + report sent, copy previous report
-		if (tud_hid_ready() && tud_hid_report(0, report, report_size) == true ) {
-			memcpy(last_report, report, report_size);
-		}
+	// HID ready + report sent, otherwise the report stays pending until the next process
+	if (tud_hid_ready() && tud_hid_report(0, &psClassicReport, sizeof(psClassicReport)) == true ) {
+		reportScheduler.reportSent(gamepad->state, now);
 	}
 }
 
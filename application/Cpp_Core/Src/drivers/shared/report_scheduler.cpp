@@ -0,0 +1,36 @@
+#include "drivers/shared/report_scheduler.hpp"
+#include "latency_trace.hpp"
+
+ReportScheduler::ReportScheduler()
+    : lastSentTime(0)
+    , keepaliveMs(0)
+    , forceSend(true) {
+}
+
+void ReportScheduler::setup(const InputMode inputMode) {
+    setup(getKeepaliveMs(inputMode));
+}
+
+void ReportScheduler::setup(const uint32_t keepaliveMs) {
+    this->keepaliveMs = keepaliveMs;
+    this->lastState = GamepadState();
+    this->lastSentTime = HAL_GetTick();
+    this->forceSend = true;
+}
+
+void ReportScheduler::reportSent(const GamepadState& state, const uint32_t now) {
+    lastState = state;
+    lastSentTime = now;
+    forceSend = false;
+    LATENCY_TRACE_REPORT_SENT();
+}
+
+uint32_t ReportScheduler::getKeepaliveMs(const InputMode inputMode) {
+    switch(inputMode) {
+        case INPUT_MODE_XINPUT:     return REPORT_KEEPALIVE_XINPUT_MS;
+        case INPUT_MODE_PS4:        return REPORT_KEEPALIVE_PS4_MS;
+        case INPUT_MODE_PS5:        return REPORT_KEEPALIVE_PS5_MS;
+        case INPUT_MODE_SWITCH:     return REPORT_KEEPALIVE_SWITCH_MS;
+        default:                    return REPORT_KEEPALIVE_DEFAULT_MS;
+    }
+}
@@ -23,9 +23,16 @@ void SwitchDriver::initialize() {
 		.xfer_cb = hidd_xfer_cb,
 		.sof = NULL
 	};
+
+	reportScheduler.setup(INPUT_MODE_SWITCH);
 }
 
 void SwitchDriver::process(Gamepad * gamepad) {
+	const uint32_t now = HAL_GetTick();
+	if (reportScheduler.poll(gamepad->state, now) == ReportSendReason::NONE) {
+		return;
+	}
+
 	switch (gamepad->state.dpad & GAMEPAD_MASK_DPAD)
 	{
 		case GAMEPAD_MASK_UP:                        switchReport.hat = SWITCH_HAT_UP;        break;
@@ -65,13 +72,9 @@ void SwitchDriver::process(Gamepad * gamepad) {
 	if (tud_suspended())
 		tud_remote_wakeup();
 
-	void * report = &switchReport;
-	uint16_t report_size = sizeof(switchReport);
-	if (memcmp(last_report, report, report_size) != 0) {
-		// HID ready + report sent, copy previous report
-		if (tud_hid_ready() && tud_hid_report(0, report, report_size) == true ) {
-			memcpy(last_report, report, report_size);
-		}
+	// HID ready + report sent, otherwise the report stays pending until the next process
+	if (tud_hid_ready() && tud_hid_report(0, &switchReport, sizeof(switchReport)) == true ) {
+		reportScheduler.reportSent(gamepad->state, now);
 	}
 }
 
@@ -151,6 +151,8 @@ void XInputDriver::initialize() {
 	};
 
 	xAuthDriver = nullptr;
+
+	reportScheduler.setup(INPUT_MODE_XINPUT);
 }
 
 void XInputDriver::initializeAux() {
@@ -178,52 +180,53 @@ void XInputDriver::process(Gamepad * gamepad) {
 	// processedGamepad 用于处理手柄的player led 和 震动反馈，hitbox不需要
 	// Gamepad * processedGamepad = Storage::getInstance().GetProcessedGamepad();
 
-	xinputReport.buttons1 = 0
-		| (gamepad->pressedUp()    ? XBOX_MASK_UP    : 0)
-		| (gamepad->pressedDown()  ? XBOX_MASK_DOWN  : 0)
-		| (gamepad->pressedLeft()  ? XBOX_MASK_LEFT  : 0)
-		| (gamepad->pressedRight() ? XBOX_MASK_RIGHT : 0)
-		| (gamepad->pressedS2()    ? XBOX_MASK_START : 0)
-		| (gamepad->pressedS1()    ? XBOX_MASK_BACK  : 0)
-		| (gamepad->pressedL3()    ? XBOX_MASK_LS    : 0)
-		| (gamepad->pressedR3()    ? XBOX_MASK_RS    : 0)
-	;
-
-	xinputReport.buttons2 = 0
-		| (gamepad->pressedL1() ? XBOX_MASK_LB   : 0)
-		| (gamepad->pressedR1() ? XBOX_MASK_RB   : 0)
-		| (gamepad->pressedA1() ? XBOX_MASK_HOME : 0)
-		| (gamepad->pressedB1() ? XBOX_MASK_A    : 0)
-		| (gamepad->pressedB2() ? XBOX_MASK_B    : 0)
-		| (gamepad->pressedB3() ? XBOX_MASK_X    : 0)
-		| (gamepad->pressedB4() ? XBOX_MASK_Y    : 0)
-	;
-
-	xinputReport.lx = static_cast<int16_t>(gamepad->state.lx) + INT16_MIN;
-	xinputReport.ly = static_cast<int16_t>(~gamepad->state.ly) + INT16_MIN;
-	xinputReport.rx = static_cast<int16_t>(gamepad->state.rx) + INT16_MIN;
-	xinputReport.ry = static_cast<int16_t>(~gamepad->state.ry) + INT16_MIN;
-
-	// if (gamepad->hasAnalogTriggers)
-	// {
-	// 	xinputReport.lt = gamepad->pressedL2() ? 0xFF : gamepad->state.lt;
-	// 	xinputReport.rt = gamepad->pressedR2() ? 0xFF : gamepad->state.rt;
-	// }
-	// else
-	// {
-		xinputReport.lt = gamepad->pressedL2() ? 0xFF : 0;
-		xinputReport.rt = gamepad->pressedR2() ? 0xFF : 0;
-	// }
-
-	// compare against previous report and send new
-	if ( memcmp(last_report, &xinputReport, sizeof(XInputReport)) != 0) {
+	const uint32_t now = HAL_GetTick();
+	if (reportScheduler.poll(gamepad->state, now) != ReportSendReason::NONE) {
+		xinputReport.buttons1 = 0
+			| (gamepad->pressedUp()    ? XBOX_MASK_UP    : 0)
+			| (gamepad->pressedDown()  ? XBOX_MASK_DOWN  : 0)
+			| (gamepad->pressedLeft()  ? XBOX_MASK_LEFT  : 0)
+			| (gamepad->pressedRight() ? XBOX_MASK_RIGHT : 0)
+			| (gamepad->pressedS2()    ? XBOX_MASK_START : 0)
+			| (gamepad->pressedS1()    ? XBOX_MASK_BACK  : 0)
+			| (gamepad->pressedL3()    ? XBOX_MASK_LS    : 0)
+			| (gamepad->pressedR3()    ? XBOX_MASK_RS    : 0)
+		;
+
+		xinputReport.buttons2 = 0
+			| (gamepad->pressedL1() ? XBOX_MASK_LB   : 0)
+			| (gamepad->pressedR1() ? XBOX_MASK_RB   : 0)
+			| (gamepad->pressedA1() ? XBOX_MASK_HOME : 0)
+			| (gamepad->pressedB1() ? XBOX_MASK_A    : 0)
+			| (gamepad->pressedB2() ? XBOX_MASK_B    : 0)
+			| (gamepad->pressedB3() ? XBOX_MASK_X    : 0)
+			| (gamepad->pressedB4() ? XBOX_MASK_Y    : 0)
+		;
+
+		xinputReport.lx = static_cast<int16_t>(gamepad->state.lx) + INT16_MIN;
+		xinputReport.ly = static_cast<int16_t>(~gamepad->state.ly) + INT16_MIN;
+		xinputReport.rx = static_cast<int16_t>(gamepad->state.rx) + INT16_MIN;
+		xinputReport.ry = static_cast<int16_t>(~gamepad->state.ry) + INT16_MIN;
+
+		if (gamepad->hasAnalogTriggers)
+		{
+			xinputReport.lt = gamepad->pressedL2() ? 0xFF : gamepad->state.lt;
+			xinputReport.rt = gamepad->pressedR2() ? 0xFF : gamepad->state.rt;
+		}
+		else
+		{
+			xinputReport.lt = gamepad->pressedL2() ? 0xFF : 0;
+			xinputReport.rt = gamepad->pressedR2() ? 0xFF : 0;
+		}
+
+		// send new report, otherwise it stays pending until the next process
 		if ( tud_ready() &&											// Is the device ready?
 			(endpoint_in != 0) && (!usbd_edpt_busy(0, endpoint_in)) ) // Is the IN endpoint available?
 		{
 			usbd_edpt_claim(0, endpoint_in);								// Take control of IN endpoint
 			usbd_edpt_xfer(0, endpoint_in, (uint8_t *)&xinputReport, sizeof(XInputReport)); // Send report buffer
 			usbd_edpt_release(0, endpoint_in);								// Release control of IN endpoint
-			memcpy(last_report, &xinputReport, sizeof(XInputReport)); // save if we sent it
+			reportScheduler.reportSent(gamepad->state, now);
 		}
 	}
 
@@ -2,6 +2,7 @@
 #include "storagemanager.hpp"
 #include "drivermanager.hpp"
 #include "micro_timer.hpp"
+#include "adc_btns/adc_btns_worker.hpp"
 
 /*
  * ======================================================================
@@ -54,26 +55,136 @@ Gamepad::Gamepad()
 
 void Gamepad::setup()
 {
-    mapDpadUp    = new GamepadButtonMapping(options->keysConfig.keyDpadUp, GAMEPAD_MASK_UP);
-	mapDpadDown  = new GamepadButtonMapping(options->keysConfig.keyDpadDown, GAMEPAD_MASK_DOWN);
-	mapDpadLeft  = new GamepadButtonMapping(options->keysConfig.keyDpadLeft, GAMEPAD_MASK_LEFT);
-	mapDpadRight = new GamepadButtonMapping(options->keysConfig.keyDpadRight, GAMEPAD_MASK_RIGHT);
-	mapButtonB1  = new GamepadButtonMapping(options->keysConfig.keyButtonB1, GAMEPAD_MASK_B1);
-	mapButtonB2  = new GamepadButtonMapping(options->keysConfig.keyButtonB2, GAMEPAD_MASK_B2);
-	mapButtonB3  = new GamepadButtonMapping(options->keysConfig.keyButtonB3, GAMEPAD_MASK_B3);
-	mapButtonB4  = new GamepadButtonMapping(options->keysConfig.keyButtonB4, GAMEPAD_MASK_B4);
-	mapButtonL1  = new GamepadButtonMapping(options->keysConfig.keyButtonL1, GAMEPAD_MASK_L1);
-	mapButtonR1  = new GamepadButtonMapping(options->keysConfig.keyButtonR1, GAMEPAD_MASK_R1);
-	mapButtonL2  = new GamepadButtonMapping(options->keysConfig.keyButtonL2, GAMEPAD_MASK_L2);
-	mapButtonR2  = new GamepadButtonMapping(options->keysConfig.keyButtonR2, GAMEPAD_MASK_R2);
-	mapButtonS1  = new GamepadButtonMapping(options->keysConfig.keyButtonS1, GAMEPAD_MASK_S1);
-	mapButtonS2  = new GamepadButtonMapping(options->keysConfig.keyButtonS2, GAMEPAD_MASK_S2);
-	mapButtonL3  = new GamepadButtonMapping(options->keysConfig.keyButtonL3, GAMEPAD_MASK_L3);
-	mapButtonR3  = new GamepadButtonMapping(options->keysConfig.keyButtonR3, GAMEPAD_MASK_R3);
-	mapButtonA1  = new GamepadButtonMapping(options->keysConfig.keyButtonA1, GAMEPAD_MASK_A1);
-	mapButtonA2  = new GamepadButtonMapping(options->keysConfig.keyButtonA2, GAMEPAD_MASK_A2);
-	mapButtonFn  = new GamepadButtonMapping(options->keysConfig.keyButtonFn, AUX_MASK_FUNCTION);
+	buildReadLut();
+	buildAnalogRoutes();
+	buildSOCDDirectionPins();
+	updateTravelOutputMask();
+	macroEngine.setup(*options);
+}
+
+/**
+ * @brief 模拟SOCD模式使用的上下左右四个方向的按键
+ */
+void Gamepad::buildSOCDDirectionPins()
+{
+	socdDirectionPins[0] = options->keysConfig.keyDpadUp;
+	socdDirectionPins[1] = options->keysConfig.keyDpadDown;
+	socdDirectionPins[2] = options->keysConfig.keyDpadLeft;
+	socdDirectionPins[3] = options->keysConfig.keyDpadRight;
+	memset(&socdInputs, 0, sizeof(socdInputs));
+	memset(&socdState, 0, sizeof(socdState));
+}
+
+/**
+ * @brief 通知 ADCBtnsWorker 需要输出行程深度的按键：模拟输出的来源，模拟SOCD模式下还包括方向键
+ */
+void Gamepad::updateTravelOutputMask()
+{
+	uint32_t mask = analogSourceMask;
+	if (isAnalogSOCDMode(resolveSOCDMode(*options))) {
+		for (uint8_t d = 0; d < 4; d++) {
+			mask |= socdDirectionPins[d];
+		}
+	}
+	ADC_BTNS_WORKER.setTravelOutputMask(mask & ((1U << NUM_ADC_BUTTONS) - 1));
+}
+
+/**
+ * @brief 根据 keysConfig.analogSources 生成模拟输出来源
+ * 有效行程取来源按键的顶部死区到底部死区之间，并通知 ADCBtnsWorker 为这些按键输出行程深度
+ */
+void Gamepad::buildAnalogRoutes()
+{
+	const uint16_t maxTravel = ADC_BTNS_WORKER.getMaxTravel();
+	analogSourceMask = 0;
+
+	for (uint8_t output = 0; output < NUM_ANALOG_OUTPUTS; output++) {
+		GamepadAnalogRoute& route = analogRoutes[output];
+		const int8_t virtualPin = options->keysConfig.analogSources[output];
+
+		route.virtualPin = -1;
+		if (virtualPin < 0 || virtualPin >= NUM_ADC_BUTTONS || maxTravel == 0) {
+			continue;
+		}
+
+		const RapidTriggerProfile& trigger = options->triggerConfigs.triggerConfigs[virtualPin];
+		const uint16_t start = (uint16_t)std::min<float>(std::max<float>(trigger.topDeadzone, MIN_ADC_TOP_DEADZONE) * 100.0f, maxTravel - 1);
+		const uint16_t end = (uint16_t)std::max<float>(maxTravel - std::max<float>(trigger.bottomDeadzone, MIN_ADC_BOTTOM_DEADZONE) * 100.0f, start + 1);
 
+		uint32_t fullScale;
+		switch (output) {
+			case ANALOG_OUTPUT_LT:
+			case ANALOG_OUTPUT_RT:
+				fullScale = GAMEPAD_TRIGGER_MAX;
+				break;
+			case ANALOG_OUTPUT_LX_NEGATIVE:
+			case ANALOG_OUTPUT_LY_NEGATIVE:
+			case ANALOG_OUTPUT_RX_NEGATIVE:
+			case ANALOG_OUTPUT_RY_NEGATIVE:
+				fullScale = GAMEPAD_JOYSTICK_MID - GAMEPAD_JOYSTICK_MIN;
+				break;
+			default:
+				fullScale = GAMEPAD_JOYSTICK_MAX - GAMEPAD_JOYSTICK_MID;
+				break;
+		}
+
+		route.virtualPin = virtualPin;
+		route.start = start;
+		route.range = end - start;
+		route.scale = (fullScale << 16) / route.range;
+		analogSourceMask |= (1U << virtualPin);
+	}
+
+	hasAnalogTriggers = analogRoutes[ANALOG_OUTPUT_LT].virtualPin >= 0 || analogRoutes[ANALOG_OUTPUT_RT].virtualPin >= 0;
+}
+
+/**
+ * @brief 将 keysConfig 编译为按字节索引的查找表
+ * 某个功能键配置的虚拟引脚中任意一个被按下，该功能键即被按下，
+ * 因此整个掩码的结果等于各字节查表结果按位或
+ */
+void Gamepad::buildReadLut()
+{
+	const KeysConfig& keys = options->keysConfig;
+	const struct {
+		Mask_t virtualPinMask;
+		GamepadReadLutEntry output;
+	} mappings[] = {
+		{ keys.keyDpadUp,    { 0, 0, GAMEPAD_MASK_UP } },
+		{ keys.keyDpadDown,  { 0, 0, GAMEPAD_MASK_DOWN } },
+		{ keys.keyDpadLeft,  { 0, 0, GAMEPAD_MASK_LEFT } },
+		{ keys.keyDpadRight, { 0, 0, GAMEPAD_MASK_RIGHT } },
+		{ keys.keyButtonB1,  { GAMEPAD_MASK_B1, 0, 0 } },
+		{ keys.keyButtonB2,  { GAMEPAD_MASK_B2, 0, 0 } },
+		{ keys.keyButtonB3,  { GAMEPAD_MASK_B3, 0, 0 } },
+		{ keys.keyButtonB4,  { GAMEPAD_MASK_B4, 0, 0 } },
+		{ keys.keyButtonL1,  { GAMEPAD_MASK_L1, 0, 0 } },
+		{ keys.keyButtonR1,  { GAMEPAD_MASK_R1, 0, 0 } },
+		{ keys.keyButtonL2,  { GAMEPAD_MASK_L2, 0, 0 } },
+		{ keys.keyButtonR2,  { GAMEPAD_MASK_R2, 0, 0 } },
+		{ keys.keyButtonS1,  { GAMEPAD_MASK_S1, 0, 0 } },
+		{ keys.keyButtonS2,  { GAMEPAD_MASK_S2, 0, 0 } },
+		{ keys.keyButtonL3,  { GAMEPAD_MASK_L3, 0, 0 } },
+		{ keys.keyButtonR3,  { GAMEPAD_MASK_R3, 0, 0 } },
+		{ keys.keyButtonA1,  { GAMEPAD_MASK_A1, 0, 0 } },
+		{ keys.keyButtonA2,  { GAMEPAD_MASK_A2, 0, 0 } },
+		{ keys.keyButtonFn,  { 0, AUX_MASK_FUNCTION, 0 } },
+	};
+
+	memset(readLut, 0, sizeof(readLut));
+	for (uint8_t byteIndex = 0; byteIndex < GAMEPAD_READ_LUT_BYTES; byteIndex++) {
+		for (uint32_t value = 1; value < 256; value++) {
+			GamepadReadLutEntry& entry = readLut[byteIndex][value];
+			const Mask_t pins = value << (byteIndex * 8);
+			for (const auto& mapping : mappings) {
+				if (mapping.virtualPinMask & pins) {
+					entry.buttons |= mapping.output.buttons;
+					entry.aux |= mapping.output.aux;
+					entry.dpad |= mapping.output.dpad;
+				}
+			}
+		}
+	}
 }
 
 void Gamepad::process()
@@ -82,23 +193,23 @@ void Gamepad::process()
 
 	// NOTE: Inverted X/Y-axis must run before SOCD and Dpad processing
 	if (options->keysConfig.invertXAxis) {
-		bool left = (state.dpad & mapDpadLeft->buttonMask) != 0;
-		bool right = (state.dpad & mapDpadRight->buttonMask) != 0;
-		state.dpad &= ~(mapDpadLeft->buttonMask | mapDpadRight->buttonMask);
+		bool left = (state.dpad & GAMEPAD_MASK_LEFT) != 0;
+		bool right = (state.dpad & GAMEPAD_MASK_RIGHT) != 0;
+		state.dpad &= ~(GAMEPAD_MASK_LEFT | GAMEPAD_MASK_RIGHT);
 		if (left)
-			state.dpad |= mapDpadRight->buttonMask;
+			state.dpad |= GAMEPAD_MASK_RIGHT;
 		if (right)
-			state.dpad |= mapDpadLeft->buttonMask;
+			state.dpad |= GAMEPAD_MASK_LEFT;
 	}
 
 	if (options->keysConfig.invertYAxis) {
-		bool up = (state.dpad & mapDpadUp->buttonMask) != 0;
-		bool down = (state.dpad & mapDpadDown->buttonMask) != 0;
-		state.dpad &= ~(mapDpadUp->buttonMask | mapDpadDown->buttonMask);
+		bool up = (state.dpad & GAMEPAD_MASK_UP) != 0;
+		bool down = (state.dpad & GAMEPAD_MASK_DOWN) != 0;
+		state.dpad &= ~(GAMEPAD_MASK_UP | GAMEPAD_MASK_DOWN);
 		if (up)
-			state.dpad |= mapDpadDown->buttonMask;
+			state.dpad |= GAMEPAD_MASK_DOWN;
 		if (down)
-			state.dpad |= mapDpadUp->buttonMask;
+			state.dpad |= GAMEPAD_MASK_UP;
 	}
 
 	// 4-way before SOCD, might have better history without losing any coherent functionality
@@ -106,76 +217,148 @@ void Gamepad::process()
 		state.dpad = filterToFourWayMode(state.dpad);
 	}
 
-	state.dpad = runSOCDCleaner(resolveSOCDMode(*options), state.dpad);
+	const SOCDMode socdMode = resolveSOCDMode(*options);
+	if (isAnalogSOCDMode(socdMode)) {
+		// 方向反转后，行程和按下序号也跟着方向交换
+		if (options->keysConfig.invertXAxis) {
+			std::swap(socdInputs.left, socdInputs.right);
+		}
+		if (options->keysConfig.invertYAxis) {
+			std::swap(socdInputs.up, socdInputs.down);
+		}
+		state.dpad = runAnalogSOCDCleaner(socdMode, state.dpad, socdInputs, socdState);
+	} else {
+		state.dpad = runSOCDCleaner(socdMode, state.dpad);
+	}
+}
+
+/**
+ * @brief 读取四个方向按下的按键中最深的行程和最近的按下序号，和按键状态来自同一次扫描
+ * GPIO按键没有行程和按下序号，按完全按下、最早按下（序号0）处理
+ * @param values 虚拟引脚掩码
+ */
+void Gamepad::readSOCDInputs(Mask_t values)
+{
+	const uint16_t* travel = ADC_BTNS_WORKER.getTravel();
+	const uint32_t* pressSequence = ADC_BTNS_WORKER.getPressSequence();
+	const uint16_t maxTravel = ADC_BTNS_WORKER.getMaxTravel();
+	SOCDDirectionInput* const inputs[4] = { &socdInputs.up, &socdInputs.down, &socdInputs.left, &socdInputs.right };
+
+	for (uint8_t d = 0; d < 4; d++) {
+		SOCDDirectionInput& input = *inputs[d];
+		Mask_t pins = socdDirectionPins[d] & values;
+
+		input.depth = 0;
+		input.pressSequence = 0;
+		while (pins) {
+			const uint8_t pin = (uint8_t)__builtin_ctz(pins);
+			pins &= pins - 1;
+
+			const bool analog = pin < NUM_ADC_BUTTONS;
+			const uint16_t depth = analog ? travel[pin] : maxTravel;
+			const uint32_t sequence = analog ? pressSequence[pin] : 0;
+			if (depth > input.depth) {
+				input.depth = depth;
+			}
+			if (sequence > input.pressSequence) {
+				input.pressSequence = sequence;
+			}
+		}
+	}
 }
 
 void Gamepad::deinit()
 {
-    delete mapDpadUp;
-	delete mapDpadDown;
-	delete mapDpadLeft;
-	delete mapDpadRight;
-	delete mapButtonB1;
-	delete mapButtonB2;
-	delete mapButtonB3;
-	delete mapButtonB4;
-	delete mapButtonL1;
-	delete mapButtonR1;
-	delete mapButtonL2;
-	delete mapButtonR2;
-	delete mapButtonS1;
-	delete mapButtonS2;
-	delete mapButtonL3;
-	delete mapButtonR3;
-	delete mapButtonA1;
-	delete mapButtonA2;
-	delete mapButtonFn;
-	
 	this->clearState();
-
+	macroEngine.reset();
 }
 
 
+/**
+ * @brief 读取虚拟引脚掩码，每个字节查一次表，没有分支
+ * 配置了连发/锁定或宏时，先由 macroEngine 处理虚拟引脚，宏输出的按键在 process 之前叠加
+ * @param values 虚拟引脚掩码
+ */
 void Gamepad::read(Mask_t values)
 {
-	
-	state.aux = 0
-		| (values & mapButtonFn->virtualPinMask)   ? mapButtonFn->buttonMask : 0;
-
-	state.dpad = 0
-		| ((values & mapDpadUp->virtualPinMask)    ? mapDpadUp->buttonMask : 0)
-		| ((values & mapDpadDown->virtualPinMask)  ? mapDpadDown->buttonMask : 0)
-		| ((values & mapDpadLeft->virtualPinMask)  ? mapDpadLeft->buttonMask  : 0)
-		| ((values & mapDpadRight->virtualPinMask) ? mapDpadRight->buttonMask : 0)
-	;
-
-	state.buttons = 0
-		| ((values & mapButtonB1->virtualPinMask)  ? mapButtonB1->buttonMask  : 0)
-		| ((values & mapButtonB2->virtualPinMask)  ? mapButtonB2->buttonMask  : 0)
-		| ((values & mapButtonB3->virtualPinMask)  ? mapButtonB3->buttonMask  : 0)
-		| ((values & mapButtonB4->virtualPinMask)  ? mapButtonB4->buttonMask  : 0)
-		| ((values & mapButtonL1->virtualPinMask)  ? mapButtonL1->buttonMask  : 0)
-		| ((values & mapButtonR1->virtualPinMask)  ? mapButtonR1->buttonMask  : 0)
-		| ((values & mapButtonL2->virtualPinMask)  ? mapButtonL2->buttonMask  : 0)
-		| ((values & mapButtonR2->virtualPinMask)  ? mapButtonR2->buttonMask  : 0)
-		| ((values & mapButtonS1->virtualPinMask)  ? mapButtonS1->buttonMask  : 0)
-		| ((values & mapButtonS2->virtualPinMask)  ? mapButtonS2->buttonMask  : 0)
-		| ((values & mapButtonL3->virtualPinMask)  ? mapButtonL3->buttonMask  : 0)
-		| ((values & mapButtonR3->virtualPinMask)  ? mapButtonR3->buttonMask  : 0)
-		| ((values & mapButtonA1->virtualPinMask)  ? mapButtonA1->buttonMask  : 0)
-		| ((values & mapButtonA2->virtualPinMask)  ? mapButtonA2->buttonMask  : 0)
-	;
+	const bool macrosActive = macroEngine.isActive();
+	if (macrosActive) {
+		values = macroEngine.filterPins(values, MICROS_TIMER.cycles());
+	}
 
-	state.lx = GAMEPAD_JOYSTICK_MID;
-	state.ly = GAMEPAD_JOYSTICK_MID;
-	state.rx = GAMEPAD_JOYSTICK_MID;
-	state.ry = GAMEPAD_JOYSTICK_MID;
-	state.lt = 0;
-	state.rt = 0;
+	uint32_t buttons = 0;
+	uint16_t aux = 0;
+	uint8_t dpad = 0;
+
+	for (uint8_t byteIndex = 0; byteIndex < GAMEPAD_READ_LUT_BYTES; byteIndex++) {
+		const GamepadReadLutEntry& entry = readLut[byteIndex][(values >> (byteIndex * 8)) & 0xFF];
+		buttons |= entry.buttons;
+		aux |= entry.aux;
+		dpad |= entry.dpad;
+	}
+
+	if (macrosActive) {
+		buttons |= macroEngine.getButtons();
+		dpad |= macroEngine.getDpad();
+	}
+
+	state.aux = aux;
+	state.dpad = dpad;
+	state.buttons = buttons;
+
+	if (isAnalogSOCDMode(resolveSOCDMode(*options))) {
+		readSOCDInputs(values);
+	}
+
+	if (analogSourceMask != 0) {
+		readAnalog();
+	} else {
+		state.lx = GAMEPAD_JOYSTICK_MID;
+		state.ly = GAMEPAD_JOYSTICK_MID;
+		state.rx = GAMEPAD_JOYSTICK_MID;
+		state.ry = GAMEPAD_JOYSTICK_MID;
+		state.lt = 0;
+		state.rt = 0;
+	}
 
 	process();
 }
 
+/**
+ * @brief 模拟输出的当前值，没有来源的输出为0
+ * @param travel 按virtualPin索引的行程深度
+ * @param output 模拟输出
+ */
+uint16_t Gamepad::getAnalogOutput(const uint16_t* travel, const AnalogOutput output) const
+{
+	const GamepadAnalogRoute& route = analogRoutes[output];
+	if (route.virtualPin < 0 || travel[route.virtualPin] <= route.start) {
+		return 0;
+	}
+
+	const uint32_t depth = travel[route.virtualPin] - route.start;
+	if (depth >= route.range) {
+		return (uint16_t)((route.range * route.scale) >> 16);
+	}
+	return (uint16_t)((depth * route.scale) >> 16);
+}
+
+/**
+ * @brief 根据按键行程深度生成扳机和摇杆值
+ * 摇杆每个轴由正负两个半轴合成，同时按下时相互抵消
+ */
+void Gamepad::readAnalog()
+{
+	const uint16_t* travel = ADC_BTNS_WORKER.getTravel();
+
+	state.lt = (uint8_t)getAnalogOutput(travel, ANALOG_OUTPUT_LT);
+	state.rt = (uint8_t)getAnalogOutput(travel, ANALOG_OUTPUT_RT);
+	state.lx = (uint16_t)(GAMEPAD_JOYSTICK_MID - getAnalogOutput(travel, ANALOG_OUTPUT_LX_NEGATIVE) + getAnalogOutput(travel, ANALOG_OUTPUT_LX_POSITIVE));
+	state.ly = (uint16_t)(GAMEPAD_JOYSTICK_MID - getAnalogOutput(travel, ANALOG_OUTPUT_LY_NEGATIVE) + getAnalogOutput(travel, ANALOG_OUTPUT_LY_POSITIVE));
+	state.rx = (uint16_t)(GAMEPAD_JOYSTICK_MID - getAnalogOutput(travel, ANALOG_OUTPUT_RX_NEGATIVE) + getAnalogOutput(travel, ANALOG_OUTPUT_RX_POSITIVE));
+	state.ry = (uint16_t)(GAMEPAD_JOYSTICK_MID - getAnalogOutput(travel, ANALOG_OUTPUT_RY_NEGATIVE) + getAnalogOutput(travel, ANALOG_OUTPUT_RY_POSITIVE));
+}
+
 void Gamepad::clearState()
 {
 	state.dpad = 0;
@@ -191,6 +374,8 @@ void Gamepad::clearState()
 
 void Gamepad::setSOCDMode(SOCDMode socdMode) {
     options->keysConfig.socdMode = socdMode;
+    memset(&socdState, 0, sizeof(socdState));
+    updateTravelOutputMask();
 }
 
 
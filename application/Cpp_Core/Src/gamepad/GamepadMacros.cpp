@@ -0,0 +1,188 @@
+#include "gamepad/GamepadMacros.hpp"
+#include "gamepad/GamepadState.hpp"
+#include <string.h>
+
+GamepadMacroEngine::GamepadMacroEngine()
+    : turboMask_(0)
+    , latchMask_(0)
+    , macroTriggerMask_(0)
+    , numMacros_(0) {
+    memset(halfPeriod_, 0, sizeof(halfPeriod_));
+    memset(macros_, 0, sizeof(macros_));
+    reset();
+}
+
+void GamepadMacroEngine::setup(const GamepadProfile& profile) {
+    turboMask_ = 0;
+    latchMask_ = 0;
+    macroTriggerMask_ = 0;
+    numMacros_ = 0;
+
+    for(uint8_t pin = 0; pin < GAMEPAD_MACRO_NUM_PINS; pin++) {
+        const TurboConfig& turbo = profile.turboConfigs[pin];
+        const uint8_t rate = turbo.rate < 1 ? 1 : (turbo.rate > TURBO_MAX_RATE_HZ ? TURBO_MAX_RATE_HZ : turbo.rate);
+        halfPeriod_[pin] = SYSTEM_CLOCK_FREQ / (2UL * rate);
+
+        // FN 键不参与连发和锁定
+        if((1U << pin) & FN_BUTTON_VIRTUAL_PIN) {
+            continue;
+        }
+        if(turbo.mode == TurboMode::TURBO_MODE_HOLD || turbo.mode == TurboMode::TURBO_MODE_LATCH_TURBO) {
+            turboMask_ |= 1U << pin;
+        }
+        if(turbo.mode == TurboMode::TURBO_MODE_LATCH || turbo.mode == TurboMode::TURBO_MODE_LATCH_TURBO) {
+            latchMask_ |= 1U << pin;
+        }
+    }
+
+    // 启用的宏按顺序压缩到前面，每次扫描只遍历有效的宏
+    for(uint8_t m = 0; m < NUM_MACROS; m++) {
+        const MacroConfig& config = profile.macros[m];
+        if(!config.enabled || config.virtualPin < 0 || config.virtualPin >= GAMEPAD_MACRO_NUM_PINS
+            || ((1U << config.virtualPin) & FN_BUTTON_VIRTUAL_PIN)
+            || config.numSteps == 0 || config.mode >= MacroMode::NUM_MACRO_MODES) {
+            continue;
+        }
+
+        MacroSlot& slot = macros_[numMacros_++];
+        slot.triggerMask = 1U << config.virtualPin;
+        slot.mode = (MacroMode)config.mode;
+        slot.numSteps = config.numSteps > NUM_MACRO_STEPS ? NUM_MACRO_STEPS : config.numSteps;
+        for(uint8_t s = 0; s < slot.numSteps; s++) {
+            const MacroStep& step = config.steps[s];
+            const uint16_t duration = step.duration < 1 ? 1 : (step.duration > MACRO_STEP_MAX_DURATION_MS ? MACRO_STEP_MAX_DURATION_MS : step.duration);
+            slot.stepCycles[s] = duration * GAMEPAD_MACRO_CYCLES_PER_MS;
+            slot.buttons[s] = step.buttons;
+            slot.dpad[s] = step.dpad & GAMEPAD_MASK_DPAD;
+        }
+        macroTriggerMask_ |= slot.triggerMask;
+    }
+
+    reset();
+}
+
+void GamepadMacroEngine::reset() {
+    lastPins_ = 0;
+    latched_ = 0;
+    turboRunning_ = 0;
+    turboPhase_ = 0;
+    memset(turboToggleAt_, 0, sizeof(turboToggleAt_));
+    for(uint8_t m = 0; m < NUM_MACROS; m++) {
+        macros_[m].playing = false;
+        macros_[m].step = 0;
+    }
+    buttons_ = 0;
+    dpad_ = 0;
+}
+
+void GamepadMacroEngine::startMacro(MacroSlot& slot, const uint32_t now) {
+    slot.playing = true;
+    slot.step = 0;
+    slot.stepEnd = now + slot.stepCycles[0];
+}
+
+/**
+ * 当前步骤到期时进入下一步，每次扫描最多前进一步
+ * 下一步的结束时间从上一步的结束时间算起，不累积扫描间隔带来的误差；落后超过一步（如FN按下期间没有扫描）时从当前时间重新计时
+ */
+void GamepadMacroEngine::advanceMacro(MacroSlot& slot, const uint32_t now) {
+    if((int32_t)(now - slot.stepEnd) < 0) {
+        return;
+    }
+
+    if(++slot.step >= slot.numSteps) {
+        if(slot.mode == MacroMode::MACRO_MODE_ONCE) {
+            slot.playing = false;
+            return;
+        }
+        slot.step = 0;
+    }
+
+    slot.stepEnd += slot.stepCycles[slot.step];
+    if((int32_t)(now - slot.stepEnd) >= 0) {
+        slot.stepEnd = now + slot.stepCycles[slot.step];
+    }
+}
+
+Mask_t GamepadMacroEngine::filterPins(const Mask_t pins, const uint32_t now) {
+    const Mask_t pressed = pins & ~lastPins_;
+    lastPins_ = pins;
+
+    // 锁定：按下沿翻转
+    latched_ ^= pressed & latchMask_;
+    Mask_t out = (pins & ~latchMask_) | latched_;
+
+    // 连发：新开始的引脚立即输出按下，其余引脚到期翻转
+    const Mask_t lanes = out & turboMask_;
+    Mask_t started = lanes & ~turboRunning_;
+    Mask_t running = lanes & turboRunning_;
+    turboRunning_ = lanes;
+    turboPhase_ = (turboPhase_ & lanes) | started;
+
+    while(started) {
+        const uint8_t pin = __builtin_ctz(started);
+        started &= started - 1;
+        turboToggleAt_[pin] = now + halfPeriod_[pin];
+    }
+
+    while(running) {
+        const uint8_t pin = __builtin_ctz(running);
+        running &= running - 1;
+        if((int32_t)(now - turboToggleAt_[pin]) >= 0) {
+            turboPhase_ ^= 1U << pin;
+            turboToggleAt_[pin] += halfPeriod_[pin];
+            if((int32_t)(now - turboToggleAt_[pin]) >= 0) {
+                turboToggleAt_[pin] = now + halfPeriod_[pin];
+            }
+        }
+    }
+    out = (out & ~turboMask_) | turboPhase_;
+
+    // 宏：按触发键的按下沿和按住状态启动/停止，播放中的宏按步骤表输出
+    buttons_ = 0;
+    dpad_ = 0;
+    for(uint8_t m = 0; m < numMacros_; m++) {
+        MacroSlot& slot = macros_[m];
+        const bool held = (pins & slot.triggerMask) != 0;
+        const bool edge = (pressed & slot.triggerMask) != 0;
+
+        switch(slot.mode) {
+            case MacroMode::MACRO_MODE_ONCE:
+                if(edge && !slot.playing) {
+                    startMacro(slot, now);
+                } else if(slot.playing) {
+                    advanceMacro(slot, now);
+                }
+                break;
+            case MacroMode::MACRO_MODE_HOLD:
+                if(!held) {
+                    slot.playing = false;
+                } else if(!slot.playing) {
+                    startMacro(slot, now);
+                } else {
+                    advanceMacro(slot, now);
+                }
+                break;
+            case MacroMode::MACRO_MODE_TOGGLE:
+                if(edge) {
+                    if(slot.playing) {
+                        slot.playing = false;
+                    } else {
+                        startMacro(slot, now);
+                    }
+                } else if(slot.playing) {
+                    advanceMacro(slot, now);
+                }
+                break;
+            default:
+                break;
+        }
+
+        if(slot.playing) {
+            buttons_ |= slot.buttons[slot.step];
+            dpad_ |= slot.dpad[slot.step];
+        }
+    }
+
+    return out & ~macroTriggerMask_;
+}
@@ -1,5 +1,6 @@
 #include "gamepad/GamepadState.hpp"
 #include "drivermanager.hpp"
+#include "board_cfg.h"
 
 // Convert the horizontal GamepadState dpad axis value into an analog value
 uint16_t dpadToAnalogX(uint8_t dpad)
@@ -166,3 +167,47 @@ uint8_t runSOCDCleaner(SOCDMode mode, uint8_t dpad)
 
 	return newDpad;
 }
+
+/**
+ * @brief Resolve one axis of the analog SOCD modes.
+ *
+ * @param lastWinner The direction that won on the previous scan, updated in place.
+ * @return uint8_t The D-pad bits of this axis.
+ */
+static uint8_t resolveAnalogAxis(SOCDMode mode, uint8_t dpad, uint8_t negativeMask, uint8_t positiveMask,
+	const SOCDDirectionInput& negative, const SOCDDirectionInput& positive, uint8_t& lastWinner)
+{
+	const uint8_t pressed = dpad & (negativeMask | positiveMask);
+	if (pressed != (negativeMask | positiveMask)) {
+		lastWinner = pressed;
+		return pressed;
+	}
+
+	uint8_t winner = 0;
+	if (mode == SOCD_MODE_SNAP_TAP) {
+		if (positive.pressSequence > negative.pressSequence)
+			winner = positiveMask;
+		else if (positive.pressSequence < negative.pressSequence)
+			winner = negativeMask;
+	}
+
+	if (winner == 0) {
+		if (negative.depth >= positive.depth + SOCD_DEPTH_HYSTERESIS)
+			winner = negativeMask;
+		else if (positive.depth >= negative.depth + SOCD_DEPTH_HYSTERESIS)
+			winner = positiveMask;
+		else if (lastWinner != 0)
+			winner = lastWinner;
+		else if (negative.depth != positive.depth)
+			winner = (negative.depth > positive.depth) ? negativeMask : positiveMask;
+	}
+
+	lastWinner = winner;
+	return winner;
+}
+
+uint8_t runAnalogSOCDCleaner(SOCDMode mode, uint8_t dpad, const SOCDAnalogInputs& inputs, SOCDAnalogState& state)
+{
+	return resolveAnalogAxis(mode, dpad, GAMEPAD_MASK_UP, GAMEPAD_MASK_DOWN, inputs.up, inputs.down, state.lastUD)
+		| resolveAnalogAxis(mode, dpad, GAMEPAD_MASK_LEFT, GAMEPAD_MASK_RIGHT, inputs.left, inputs.right, state.lastLR);
+}
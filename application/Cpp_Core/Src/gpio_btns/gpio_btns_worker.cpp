@@ -1,12 +1,24 @@
 #include "gpio_btns/gpio_btns_worker.hpp"
+#include "latency_trace.hpp"
+
+static_assert((GPIO_BUTTONS_EXTI_QUEUE_SIZE & (GPIO_BUTTONS_EXTI_QUEUE_SIZE - 1)) == 0, "GPIO_BUTTONS_EXTI_QUEUE_SIZE must be a power of 2");
 
 // 定义静态成员
 GPIOBtnsWorker *GPIOBtnsWorker::instance_ = nullptr;
 
-GPIOBtnsWorker::GPIOBtnsWorker() : virtualPinMask(0x0), buttonStateChanged(false)
+GPIOBtnsWorker::GPIOBtnsWorker()
+    : lastTimestamp(0)
+    , stateChanged(false)
+    , edgeHead(0)
+    , edgeTail(0)
+    , edgeOverflows(0)
+    , virtualPinMask(0x0)
 {
     instance_ = this;
     GPIO_Btns_Init();
+    for(uint8_t i = 0; i < NUM_GPIO_BUTTONS; i++) {
+        virtualPins[i] = gpio_btns_mapping[i].virtualPin;
+    }
 }
 
 GPIOBtnsWorker::~GPIOBtnsWorker()
@@ -16,81 +28,101 @@ GPIOBtnsWorker::~GPIOBtnsWorker()
 
 void GPIOBtnsWorker::setup()
 {
-    // 初始化按钮状态 re
-    GPIO_Btns_Iterate([](uint8_t virtualPin, bool isPressed, uint8_t idx) {
-        instance_->buttonStates[idx].virtualPin = virtualPin;
-        instance_->buttonStates[idx].state = isPressed ? ButtonState::PRESSED : ButtonState::RELEASED;
-        instance_->buttonStates[idx].lastRawState = isPressed;
-        instance_->buttonStates[idx].lastStateTime = 0;
-        instance_->buttonStates[idx].debounceTime = GPIO_BUTTONS_DEBOUNCE;
-        instance_->virtualPinMask |= isPressed ? (1U << virtualPin) : 0; 
-    });
+    // 以当前按钮状态作为稳定状态，上电时已按住的按钮不需要再经过防抖
+    const uint32_t rawMask = GPIO_Btns_ReadMask();
+    debounceFilter.reset(rawMask);
+    lastTimestamp = MICROS_TIMER.cycles();
+
+    virtualPinMask = 0x0;
+    for(uint8_t i = 0; i < NUM_GPIO_BUTTONS; i++) {
+        virtualPinMask |= (rawMask & (1U << i)) ? (1U << virtualPins[i]) : 0;
+    }
+
+#if GPIO_BUTTONS_EXTI_ENABLED
+    // 丢弃之前的边沿，再使能中断
+    edgeTail = edgeHead;
+    GPIO_Btns_InitEXTI(onEdge);
+#endif
 }
 
 uint32_t GPIOBtnsWorker::read()
 {
-    buttonStateChanged = false;
-    
-    GPIO_Btns_Iterate([](uint8_t virtualPin, bool isPressed, uint8_t idx) {
-        if (!instance_) return;
-        
-        // APP_DBG("virtualPin: %d, isPressed: %d", virtualPin, isPressed);
-
-        GPIOBtn* btn = &instance_->buttonStates[idx];
-        const bool currentState = isPressed;
-        bool& changed = instance_->buttonStateChanged;
-        
-        // 根据当前状态处理
-        switch(btn->state) {
-            case ButtonState::RELEASED:
-                if(currentState) { // 检测到按下
-                    btn->state = ButtonState::PRESSING;
-                    btn->lastStateTime = MICROS_TIMER.micros();
-                }
-                break;
-
-            case ButtonState::PRESSING:
-                if(!currentState) { // 在防抖期间松开
-                    btn->state = ButtonState::RELEASED;
-                    btn->lastStateTime = 0;
-                }
-                else if(MICROS_TIMER.checkInterval(btn->debounceTime, btn->lastStateTime)) {
-                    // 防抖时间到，确认按下
-                    btn->state = ButtonState::PRESSED;
-                    instance_->virtualPinMask |= 1U << btn->virtualPin;
-                    MC.publish(MessageId::GPIO_BTNS_PRESSED, &btn->virtualPin);
-                    changed = true;
-                }
-                break;
-
-            case ButtonState::PRESSED:
-                if(!currentState) { // 检测到松开
-                    btn->state = ButtonState::RELEASING;
-                    btn->lastStateTime = MICROS_TIMER.micros();
-                }
-                break;
-
-            case ButtonState::RELEASING:
-                if(currentState) { // 在防抖期间又按下
-                    btn->state = ButtonState::PRESSED;
-                    btn->lastStateTime = 0;
-                }
-                else if(MICROS_TIMER.checkInterval(btn->debounceTime, btn->lastStateTime)) {
-                    // 防抖时间到，确认松开
-                    btn->state = ButtonState::RELEASED;
-                    instance_->virtualPinMask &= ~(1U << btn->virtualPin);
-                    MC.publish(MessageId::GPIO_BTNS_RELEASED, &btn->virtualPin);
-                    changed = true;
-                }
-                break;
-        }
-    });
+    stateChanged = false;
+
+#if GPIO_BUTTONS_EXTI_ENABLED
+    // 按边沿发生的时间依次防抖，立即确认模式下上报的是真实的边沿时间
+    uint32_t tail = edgeTail;
+    while(tail != edgeHead) {
+        __DMB();
+        const EdgeEvent event = edgeQueue[tail & (GPIO_BUTTONS_EXTI_QUEUE_SIZE - 1)];
+        __DMB();
+        edgeTail = ++tail;
+        filterSample(event.buttonMask, event.timestamp);
+    }
+#endif
+
+    // 每次扫描仍然读取一次IDR：延迟确认需要在没有边沿时推进时间，边沿队列溢出时也能恢复到真实状态
+    const uint32_t timestamp = MICROS_TIMER.cycles();
+    filterSample(GPIO_Btns_ReadMask(), timestamp);
 
     // 如果状态发生变化，发送消息
-    if (buttonStateChanged)
-    {
+    if(stateChanged) {
         MC.publish(MessageId::GPIO_BTNS_STATE_CHANGED, &this->virtualPinMask);
     }
 
     return this->virtualPinMask;
 }
+
+void GPIOBtnsWorker::filterSample(uint32_t buttonMask, uint32_t timestamp)
+{
+    // 上一次扫描读取IDR之后、进入下一次扫描之前产生的边沿，时间戳可能早于上一次扫描，按上一次扫描的时间处理
+    if((int32_t)(timestamp - lastTimestamp) < 0) {
+        timestamp = lastTimestamp;
+    }
+    lastTimestamp = timestamp;
+
+    const uint32_t lastMask = debounceFilter.getStableMask();
+    const uint32_t stableMask = debounceFilter.filter(buttonMask, timestamp);
+    if(stableMask != lastMask) {
+        publishChanges(stableMask ^ lastMask, timestamp);
+        stateChanged = true;
+    }
+}
+
+void GPIOBtnsWorker::publishChanges(const uint32_t changedMask, const uint32_t timestamp)
+{
+    const uint32_t stableMask = debounceFilter.getStableMask();
+    uint32_t changed = changedMask;
+    while(changed) {
+        const uint8_t i = __builtin_ctz(changed);
+        changed &= changed - 1;
+
+        LATENCY_TRACE_BUTTON_CHANGED_AT(virtualPins[i], timestamp);
+        if(stableMask & (1U << i)) {
+            virtualPinMask |= 1U << virtualPins[i];
+            MC.publish(MessageId::GPIO_BTNS_PRESSED, &virtualPins[i]);
+        } else {
+            virtualPinMask &= ~(1U << virtualPins[i]);
+            MC.publish(MessageId::GPIO_BTNS_RELEASED, &virtualPins[i]);
+        }
+    }
+}
+
+void GPIOBtnsWorker::onEdge(uint32_t buttonMask, uint32_t timestamp)
+{
+    GPIOBtnsWorker* const worker = instance_;
+    if(!worker) {
+        return;
+    }
+
+    const uint32_t head = worker->edgeHead;
+    if(head - worker->edgeTail >= GPIO_BUTTONS_EXTI_QUEUE_SIZE) {
+        // 队列已满，丢弃本次边沿，主循环下一次扫描读取IDR时恢复
+        worker->edgeOverflows++;
+        return;
+    }
+
+    worker->edgeQueue[head & (GPIO_BUTTONS_EXTI_QUEUE_SIZE - 1)] = EdgeEvent{buttonMask, timestamp};
+    __DMB();
+    worker->edgeHead = head + 1;
+}
@@ -0,0 +1,59 @@
+#include "gpio_btns/gpio_debounce_filter.hpp"
+#include <string.h>
+
+GPIODebounceFilter::GPIODebounceFilter(const Config& config) : config_(config) {
+    reset();
+}
+
+uint32_t GPIODebounceFilter::filter(const uint32_t rawMask, const uint32_t timestamp) {
+    const uint32_t buttonsMask = (NUM_GPIO_BUTTONS >= 32) ? 0xFFFFFFFF : ((1U << NUM_GPIO_BUTTONS) - 1);
+    const uint32_t changed = (rawMask ^ stableMask_) & buttonsMask;
+
+    if (config_.eager) {
+        // 锁定期已过的按钮解除锁定
+        uint32_t locked = pendingMask_;
+        while (locked) {
+            const uint8_t i = __builtin_ctz(locked);
+            locked &= locked - 1;
+            if ((uint32_t)(timestamp - timestamps_[i]) >= config_.windowCycles) {
+                pendingMask_ &= ~(1U << i);
+            }
+        }
+
+        // 未锁定的按钮立即跟随原始状态，并进入锁定期
+        uint32_t edges = changed & ~pendingMask_;
+        stableMask_ ^= edges;
+        pendingMask_ |= edges;
+        while (edges) {
+            const uint8_t i = __builtin_ctz(edges);
+            edges &= edges - 1;
+            timestamps_[i] = timestamp;
+        }
+        return stableMask_;
+    }
+
+    // 延迟确认：原始状态变回稳定状态的按钮取消确认
+    pendingMask_ &= changed;
+
+    uint32_t candidates = changed;
+    while (candidates) {
+        const uint8_t i = __builtin_ctz(candidates);
+        const uint32_t bit = 1U << i;
+        candidates &= candidates - 1;
+
+        if (!(pendingMask_ & bit)) {
+            pendingMask_ |= bit;
+            timestamps_[i] = timestamp;
+        } else if ((uint32_t)(timestamp - timestamps_[i]) >= config_.windowCycles) {
+            stableMask_ ^= bit;
+            pendingMask_ &= ~bit;
+        }
+    }
+    return stableMask_;
+}
+
+void GPIODebounceFilter::reset(const uint32_t stableMask) {
+    stableMask_ = stableMask;
+    pendingMask_ = 0;
+    memset(timestamps_, 0, sizeof(timestamps_));
+}
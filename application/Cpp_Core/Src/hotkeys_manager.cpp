@@ -1,5 +1,8 @@
 #include "hotkeys_manager.hpp"
 #include "system_logger.h"
+#include "perf_trace.hpp"
+#include "latency_trace.hpp"
+#include "adc_btns/adc_btns_worker.hpp"
 
 HotkeysManager::HotkeysManager() : hotkeys(STORAGE_MANAGER.getGamepadHotkeyEntry()) {
     // 初始化所有热键状态
@@ -152,7 +155,18 @@ void HotkeysManager::runAction(GamepadHotkey hotkeyAction) {
 }
 
 void HotkeysManager::rebootSystem() {
+    // 写入延迟保存的配置和基准值跟踪修改的校准值，重启前不能丢失
+    STORAGE_MANAGER.flushConfig();
+    #if ADC_BASELINE_TRACKING_ENABLED
+    ADC_BTNS_WORKER.flushBaselineValues();
+    #endif
     WS2812B_Stop();
+    #if PERF_TRACE_ENABLED
+    PERF_TRACE.flush(); // 耗时统计写回备份SRAM，重启后可在网页配置模式中读取
+    #endif
+    #if LATENCY_TRACE_ENABLED
+    LATENCY_TRACE.flush();
+    #endif
     NVIC_SystemReset();
 }
 
@@ -0,0 +1,97 @@
+#include "latency_trace.hpp"
+#include <string.h>
+#include <algorithm>
+
+// 备份SRAM中的地址，系统复位后内容保持（需要VDD保持供电）
+#define LATENCY_TRACE_BKPSRAM_ADDR  (D3_BKPSRAM_BASE + BKPSRAM_LATENCY_TRACE_OFFSET)
+
+LatencyTrace::LatencyTrace()
+    : data((LatencyTraceData*)LATENCY_TRACE_BKPSRAM_ADDR)
+    , pendingMask(0) {
+    // 使能备份SRAM时钟并解除备份域写保护
+    __HAL_RCC_BKPRAM_CLK_ENABLE();
+    HAL_PWR_EnableBkUpAccess();
+    memset(pendingTimestamps, 0, sizeof(pendingTimestamps));
+}
+
+void LatencyTrace::reset() {
+    memset(data, 0, sizeof(LatencyTraceData));
+    data->magic = LATENCY_TRACE_MAGIC;
+    data->version = LATENCY_TRACE_VERSION;
+    pendingMask = 0;
+}
+
+void LatencyTrace::flush() {
+    SCB_CleanDCache_by_Addr((uint32_t*)data, sizeof(LatencyTraceData));
+}
+
+bool LatencyTrace::isValid() const {
+    return data->magic == LATENCY_TRACE_MAGIC && data->version == LATENCY_TRACE_VERSION;
+}
+
+void LatencyTrace::discardPending() {
+    if(pendingMask != 0) {
+        data->discardedEvents += __builtin_popcount(pendingMask);
+        pendingMask = 0;
+    }
+}
+
+/**
+ * @brief 结束所有待处理按键事件的计时并计入直方图
+ * @param now 报告发出时的DWT周期
+ */
+void LatencyTrace::commit(const uint32_t now) {
+    uint32_t mask = pendingMask;
+    pendingMask = 0;
+
+    while(mask != 0) {
+        const uint8_t virtualPin = (uint8_t)__builtin_ctz(mask);
+        mask &= mask - 1;
+
+        const uint32_t cycles = now - pendingTimestamps[virtualPin];
+        if(cycles >= (uint32_t)LATENCY_TRACE_TIMEOUT_US * CYCLES_PER_MICROSECOND) {
+            data->timeoutEvents++;
+            continue;
+        }
+
+        LatencyButtonStats& stats = data->buttons[virtualPin];
+        stats.count++;
+        stats.totalCycles += cycles;
+        if(cycles > stats.maxCycles) {
+            stats.maxCycles = cycles;
+        }
+
+        const uint32_t us = cycles / CYCLES_PER_MICROSECOND;
+        const uint32_t bin = us == 0 ? 0 : std::min<uint32_t>(32 - __CLZ(us), LATENCY_TRACE_HISTOGRAM_BINS - 1);
+        if(stats.histogram[bin] < UINT16_MAX) {
+            stats.histogram[bin]++;
+        }
+    }
+}
+
+uint32_t LatencyTrace::getPercentileUs(const uint8_t virtualPin, const uint8_t percent) const {
+    if(virtualPin >= LATENCY_TRACE_NUM_BUTTONS) {
+        return 0;
+    }
+
+    const LatencyButtonStats& stats = data->buttons[virtualPin];
+    uint32_t total = 0;
+    for(uint8_t bin = 0; bin < LATENCY_TRACE_HISTOGRAM_BINS; bin++) {
+        total += stats.histogram[bin];
+    }
+    if(total == 0) {
+        return 0;
+    }
+
+    const uint32_t maxUs = stats.maxCycles / CYCLES_PER_MICROSECOND;
+    const uint32_t target = (total * percent + 99) / 100;
+    uint32_t accumulated = 0;
+    for(uint8_t bin = 0; bin < LATENCY_TRACE_HISTOGRAM_BINS - 1; bin++) {
+        accumulated += stats.histogram[bin];
+        if(accumulated >= target) {
+            return std::min<uint32_t>(1U << bin, maxUs);
+        }
+    }
+
+    return maxUs;
+}
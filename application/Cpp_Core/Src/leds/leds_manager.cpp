@@ -280,9 +280,9 @@ void LEDsManager::deinit()
 void LEDsManager::effectStyleNext() {
     opts->ledEffect = static_cast<LEDEffect>((opts->ledEffect + 1) % LEDEffect::NUM_EFFECTS);
     
-    // 只有在使用默认配置时才保存到存储
+    // 只有在使用默认配置时才保存到存储，由主循环延迟合并写入
     if (!usingTemporaryConfig) {
-        STORAGE_MANAGER.saveConfig();
+        STORAGE_MANAGER.markConfigDirty();
     }
     
     deinit();
@@ -292,9 +292,9 @@ void LEDsManager::effectStyleNext() {
 void LEDsManager::effectStylePrev() {
     opts->ledEffect = static_cast<LEDEffect>((opts->ledEffect - 1 + LEDEffect::NUM_EFFECTS) % LEDEffect::NUM_EFFECTS);
     
-    // 只有在使用默认配置时才保存到存储
+    // 只有在使用默认配置时才保存到存储，由主循环延迟合并写入
     if (!usingTemporaryConfig) {
-        STORAGE_MANAGER.saveConfig();
+        STORAGE_MANAGER.markConfigDirty();
     }
     
     deinit();
@@ -307,10 +307,9 @@ void LEDsManager::brightnessUp() {
     } else {
         opts->ledBrightness = std::min((int)opts->ledBrightness + 20, 100); // 增加10%
         setLedsBrightness(opts->ledBrightness);
-        // 只有在使用默认配置时才保存到存储
+        // 只有在使用默认配置时才保存到存储，由主循环延迟合并写入
         if (!usingTemporaryConfig) {
-            STORAGE_MANAGER.saveConfig();
-            HAL_Delay(20); // 等待保存完成
+            STORAGE_MANAGER.markConfigDirty();
         }
         
         
@@ -323,10 +322,9 @@ void LEDsManager::brightnessDown() {
     } else {
         opts->ledBrightness = std::max((int)opts->ledBrightness - 20, 0); // 减少10%
         setLedsBrightness(opts->ledBrightness);
-        // 只有在使用默认配置时才保存到存储
+        // 只有在使用默认配置时才保存到存储，由主循环延迟合并写入
         if (!usingTemporaryConfig) {
-            STORAGE_MANAGER.saveConfig();
-            HAL_Delay(20); // 等待保存完成
+            STORAGE_MANAGER.markConfigDirty();
         }
         
         
@@ -336,9 +334,9 @@ void LEDsManager::brightnessDown() {
 void LEDsManager::enableSwitch() {
     opts->ledEnabled = !opts->ledEnabled;
     
-    // 只有在使用默认配置时才保存到存储
+    // 只有在使用默认配置时才保存到存储，由主循环延迟合并写入
     if (!usingTemporaryConfig) {
-        STORAGE_MANAGER.saveConfig();
+        STORAGE_MANAGER.markConfigDirty();
     }
     
     deinit();
@@ -630,9 +628,9 @@ void LEDsManager::updateAroundLedColors()
 void LEDsManager::ambientLightEffectStyleNext() {
     opts->aroundLedEffect = static_cast<AroundLEDEffect>((opts->aroundLedEffect + 1) % AroundLEDEffect::NUM_AROUND_LED_EFFECTS);
     
-    // 只有在使用默认配置时才保存到存储
+    // 只有在使用默认配置时才保存到存储，由主循环延迟合并写入
     if (!usingTemporaryConfig) {
-        STORAGE_MANAGER.saveConfig();
+        STORAGE_MANAGER.markConfigDirty();
     }
     
     deinit();
@@ -645,9 +643,9 @@ void LEDsManager::ambientLightEffectStyleNext() {
 void LEDsManager::ambientLightEffectStylePrev() {
     opts->aroundLedEffect = static_cast<AroundLEDEffect>((opts->aroundLedEffect - 1 + AroundLEDEffect::NUM_AROUND_LED_EFFECTS) % AroundLEDEffect::NUM_AROUND_LED_EFFECTS);
     
-    // 只有在使用默认配置时才保存到存储
+    // 只有在使用默认配置时才保存到存储，由主循环延迟合并写入
     if (!usingTemporaryConfig) {
-        STORAGE_MANAGER.saveConfig();
+        STORAGE_MANAGER.markConfigDirty();
     }
     
     deinit();
@@ -664,10 +662,9 @@ void LEDsManager::ambientLightBrightnessUp() {
         opts->aroundLedBrightness = std::min((int)opts->aroundLedBrightness + 20, 100); // 增加10%
         setAmbientLightBrightness(opts->aroundLedBrightness);
 
-        // 只有在使用默认配置时才保存到存储
+        // 只有在使用默认配置时才保存到存储，由主循环延迟合并写入
         if (!usingTemporaryConfig) {
-            STORAGE_MANAGER.saveConfig();
-            HAL_Delay(20); // 等待保存完成
+            STORAGE_MANAGER.markConfigDirty();
         }
     }
 }
@@ -681,10 +678,9 @@ void LEDsManager::ambientLightBrightnessDown() {
     } else {
         opts->aroundLedBrightness = std::max((int)opts->aroundLedBrightness - 20, 0); // 减少10%
         setAmbientLightBrightness(opts->aroundLedBrightness);
-        // 只有在使用默认配置时才保存到存储
+        // 只有在使用默认配置时才保存到存储，由主循环延迟合并写入
         if (!usingTemporaryConfig) {
-            STORAGE_MANAGER.saveConfig();
-            HAL_Delay(20); // 等待保存完成
+            STORAGE_MANAGER.markConfigDirty();
         }
         
     }
@@ -696,9 +692,9 @@ void LEDsManager::ambientLightBrightnessDown() {
 void LEDsManager::ambientLightEnableSwitch() {
     opts->aroundLedEnabled = !opts->aroundLedEnabled;
     
-    // 只有在使用默认配置时才保存到存储
+    // 只有在使用默认配置时才保存到存储，由主循环延迟合并写入
     if (!usingTemporaryConfig) {
-        STORAGE_MANAGER.saveConfig();
+        STORAGE_MANAGER.markConfigDirty();
     }
     
     deinit();
@@ -1,82 +1,129 @@
 #include "message_center.hpp"
-#include <algorithm>
+#include <string.h>
+#include "stm32h7xx.h"
+
+MessageCenter::MessageCenter()
+    : deferredHead(0)
+    , deferredTail(0)
+    , droppedDeferred(0)
+    , reportedDropped(0) {
+    memset(handlers, 0, sizeof(handlers));
+    memset(handlerCount, 0, sizeof(handlerCount));
+    memset(registered, 0, sizeof(registered));
+    memset(deferredQueue, 0, sizeof(deferredQueue));
+}
 
 bool MessageCenter::registerMessage(MessageId msgId) {
-    // 检查消息ID是否已存在
-    if (handlers.find(msgId) != handlers.end()) {
+    const uint8_t id = (uint8_t)msgId;
+
+    // 检查消息ID是否有效或已存在
+    if (id >= NUM_MESSAGE_IDS || registered[id]) {
         return false;
     }
     
     // 注册新消息ID
-    handlers[msgId] = std::vector<MessageHandler>();
+    registered[id] = true;
+    handlerCount[id] = 0;
     return true;
 }
 
 bool MessageCenter::unregisterMessage(MessageId msgId) {
+    const uint8_t id = (uint8_t)msgId;
+
     // 检查消息ID是否存在
-    auto it = handlers.find(msgId);
-    if (it == handlers.end()) {
+    if (id >= NUM_MESSAGE_IDS || !registered[id]) {
         return false;
     }
     
     // 移除消息ID及其所有处理函数
-    handlers.erase(it);
+    registered[id] = false;
+    handlerCount[id] = 0;
     return true;
 }
 
-bool MessageCenter::subscribe(MessageId msgId, MessageHandler handler) {
-    if (!handler) return false;
-    
-    // 检查消息ID是否存在
-    auto it = handlers.find(msgId);
-    if (it == handlers.end()) {
+bool MessageCenter::subscribe(MessageId msgId, MessageCallback callback, void* context) {
+    const uint8_t id = (uint8_t)msgId;
+    if (!callback || id >= NUM_MESSAGE_IDS || !registered[id]) {
+        return false;
+    }
+
+    // 已经订阅过
+    for (uint8_t i = 0; i < handlerCount[id]; i++) {
+        if (handlers[id][i].callback == callback && handlers[id][i].context == context) {
+            return true;
+        }
+    }
+
+    // 处理函数表已满
+    if (handlerCount[id] >= MESSAGE_MAX_HANDLERS) {
         return false;
     }
     
     // 添加处理函数到列表
-    it->second.push_back(handler);
+    handlers[id][handlerCount[id]] = MessageHandler{callback, context};
+    handlerCount[id]++;
     return true;
 }
 
-bool MessageCenter::unsubscribe(MessageId msgId, MessageHandler handler) {
-    if (!handler) return false;
-    
-    // 检查消息ID是否存在
-    auto it = handlers.find(msgId);
-    if (it == handlers.end()) {
+bool MessageCenter::unsubscribe(MessageId msgId, MessageCallback callback, void* context) {
+    const uint8_t id = (uint8_t)msgId;
+    if (!callback || id >= NUM_MESSAGE_IDS || !registered[id]) {
         return false;
     }
     
-    // 从列表中移除处理函数
-    auto& handlers_list = it->second;
-    handlers_list.erase(
-        std::remove_if(
-            handlers_list.begin(),
-            handlers_list.end(),
-            [&handler](const MessageHandler& h) {
-                // 使用std::function的target()方法来比较函数对象
-                return h.target<void(const void*)>() == handler.target<void(const void*)>();
+    // 从列表中移除处理函数，后面的处理函数前移以保持订阅顺序
+    for (uint8_t i = 0; i < handlerCount[id]; i++) {
+        if (handlers[id][i].callback == callback && handlers[id][i].context == context) {
+            for (uint8_t j = i + 1; j < handlerCount[id]; j++) {
+                handlers[id][j - 1] = handlers[id][j];
             }
-        ),
-        handlers_list.end()
-    );
+            handlerCount[id]--;
+            return true;
+        }
+    }
     
-    return true;
+    return false;
 }
 
-bool MessageCenter::publish(MessageId msgId, const void* data) {
-    // 检查消息ID是否存在
-    auto it = handlers.find(msgId);
-    if (it == handlers.end()) {
+bool MessageCenter::publishFromISR(MessageId msgId, const void* data) {
+    if (!hasSubscribers(msgId)) {
         return false;
     }
-    
-    // 调用所有注册的处理函数
-    for (const auto& handler : it->second) {
-        if (handler) {
-            handler(data);
-        }
+
+    // 多个中断可能互相抢占，入队时关中断
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    const uint32_t tail = deferredTail;
+    if (tail - deferredHead >= MESSAGE_DEFERRED_QUEUE_SIZE) {
+        droppedDeferred++;
+        __set_PRIMASK(primask);
+        return false;
     }
-    
+
+    deferredQueue[tail & (MESSAGE_DEFERRED_QUEUE_SIZE - 1)] = DeferredMessage{msgId, data};
+    deferredTail = tail + 1;
+
+    __set_PRIMASK(primask);
     return true;
 }
+
+void MessageCenter::dispatchDeferred() {
+    // 只分发调用时已经入队的消息，处理函数执行期间新入队的消息留到下一次
+    const uint32_t tail = deferredTail;
+    uint32_t head = deferredHead;
+
+    while (head != tail) {
+        const DeferredMessage message = deferredQueue[head & (MESSAGE_DEFERRED_QUEUE_SIZE - 1)];
+        head++;
+        deferredHead = head;
+        publish(message.msgId, message.data);
+    }
+
+    // 中断中丢弃的消息在主循环中报告
+    const uint32_t dropped = droppedDeferred;
+    if (dropped != reportedDropped) {
+        APP_ERR("MessageCenter: %lu deferred messages dropped (total %lu)", (unsigned long)(dropped - reportedDropped), (unsigned long)dropped);
+        reportedDropped = dropped;
+    }
+}
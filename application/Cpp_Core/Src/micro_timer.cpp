@@ -1,9 +1,6 @@
 #include "micro_timer.hpp"
 #include "board_cfg.h"
 
-// STM32H750的CPU频率 - 根据实际系统时钟配置调整
-#define CYCLES_PER_MICROSECOND (SYSTEM_CLOCK_FREQ / 1000000UL)
-
 MicrosTimer::MicrosTimer() : overflowCount(0) {
     // 启用DWT和CYCCNT
     initDWT();
@@ -0,0 +1,120 @@
+#include "perf_trace.hpp"
+#include <string.h>
+#include <algorithm>
+
+// 备份SRAM中的地址，系统复位后内容保持（需要VDD保持供电）
+#define PERF_TRACE_BKPSRAM_ADDR     (D3_BKPSRAM_BASE + BKPSRAM_PERF_TRACE_OFFSET)
+
+static const char* const PERF_STAGE_NAMES[NUM_PERF_STAGES] = {
+    "gpioRead",
+    "adcRead",
+    "gamepadRead",
+    "driverProcess",
+    "tudTask",
+    "usbHostProcess",
+    "driverProcessAux",
+    "ledsLoop",
+    "loopTotal",
+};
+
+PerfTrace::PerfTrace() : data((PerfTraceData*)PERF_TRACE_BKPSRAM_ADDR) {
+    // 使能备份SRAM时钟并解除备份域写保护
+    __HAL_RCC_BKPRAM_CLK_ENABLE();
+    HAL_PWR_EnableBkUpAccess();
+}
+
+void PerfTrace::reset() {
+    memset(data, 0, sizeof(PerfTraceData));
+    data->magic = PERF_TRACE_MAGIC;
+    data->version = PERF_TRACE_VERSION;
+    for(uint8_t i = 0; i < NUM_PERF_STAGES; i++) {
+        data->stages[i].minCycles = UINT32_MAX;
+    }
+}
+
+void PerfTrace::flush() {
+    SCB_CleanDCache_by_Addr((uint32_t*)data, sizeof(PerfTraceData));
+}
+
+bool PerfTrace::isValid() const {
+    return data->magic == PERF_TRACE_MAGIC && data->version == PERF_TRACE_VERSION;
+}
+
+/**
+ * @brief 计算耗时所在的直方图桶
+ * @param cycles 耗时（周期）
+ */
+uint8_t PerfTrace::getBin(const uint32_t cycles) {
+    if(cycles < (1U << PERF_TRACE_HISTOGRAM_MIN_BITS)) {
+        return 0;
+    }
+
+    const uint32_t msb = 31 - __CLZ(cycles);
+    const uint32_t sub = (cycles >> (msb - PERF_TRACE_HISTOGRAM_SUB_BITS)) & ((1U << PERF_TRACE_HISTOGRAM_SUB_BITS) - 1);
+    const uint32_t bin = 1 + ((msb - PERF_TRACE_HISTOGRAM_MIN_BITS) << PERF_TRACE_HISTOGRAM_SUB_BITS) + sub;
+
+    return (uint8_t)std::min<uint32_t>(bin, PERF_TRACE_HISTOGRAM_BINS - 1);
+}
+
+uint32_t PerfTrace::getBinLowerCycles(const uint8_t bin) {
+    if(bin == 0) {
+        return 0;
+    }
+
+    const uint32_t k = bin - 1;
+    const uint32_t msb = PERF_TRACE_HISTOGRAM_MIN_BITS + (k >> PERF_TRACE_HISTOGRAM_SUB_BITS);
+    const uint32_t sub = k & ((1U << PERF_TRACE_HISTOGRAM_SUB_BITS) - 1);
+
+    return ((1U << PERF_TRACE_HISTOGRAM_SUB_BITS) + sub) << (msb - PERF_TRACE_HISTOGRAM_SUB_BITS);
+}
+
+void PerfTrace::update(const uint8_t stage, const uint32_t cycles) {
+    PerfStageStats& stats = data->stages[stage];
+
+    stats.count++;
+    stats.totalCycles += cycles;
+    if(cycles < stats.minCycles) {
+        stats.minCycles = cycles;
+    }
+    if(cycles > stats.maxCycles) {
+        stats.maxCycles = cycles;
+    }
+    stats.histogram[getBin(cycles)]++;
+
+    if(cycles >= PERF_TRACE_SPIKE_THRESHOLD_US * CYCLES_PER_MICROSECOND) {
+        PerfSpikeRecord& spike = data->spikes[data->spikeCount % PERF_TRACE_SPIKE_RING_SIZE];
+        spike.tick = HAL_GetTick();
+        spike.cycles = cycles;
+        spike.stage = stage;
+        data->spikeCount++;
+    }
+}
+
+uint32_t PerfTrace::getPercentileCycles(const uint8_t stage, const uint8_t percent) const {
+    if(stage >= NUM_PERF_STAGES) {
+        return 0;
+    }
+
+    const PerfStageStats& stats = data->stages[stage];
+    if(stats.count == 0) {
+        return 0;
+    }
+
+    const uint64_t target = ((uint64_t)stats.count * percent + 99) / 100;
+    uint64_t accumulated = 0;
+    for(uint8_t bin = 0; bin < PERF_TRACE_HISTOGRAM_BINS; bin++) {
+        accumulated += stats.histogram[bin];
+        if(accumulated >= target) {
+            if(bin == PERF_TRACE_HISTOGRAM_BINS - 1) {
+                return stats.maxCycles;
+            }
+            return std::min<uint32_t>(getBinLowerCycles(bin + 1), stats.maxCycles);
+        }
+    }
+
+    return stats.maxCycles;
+}
+
+const char* PerfTrace::getStageName(const uint8_t stage) {
+    return stage < NUM_PERF_STAGES ? PERF_STAGE_NAMES[stage] : "unknown";
+}
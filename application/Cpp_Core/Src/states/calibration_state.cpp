@@ -2,6 +2,7 @@
 #include "adc_btns/adc_calibration.hpp"
 #include "pwm-ws2812b.h"
 #include "storagemanager.hpp"
+#include "message_center.hpp"
 
 #include "system_logger.h"
 
@@ -43,6 +44,7 @@ void CalibrationState::loop() {
             Logger_Flush(); // 确保日志被写入Flash
             NVIC_SystemReset();
         } else {    
+            MC.dispatchDeferred(); // 分发中断中发布的消息
             ADC_CALIBRATION_MANAGER.processCalibration();
         }
         // 可根据需要添加更多校准相关的处理逻辑
@@ -11,6 +11,8 @@
 #include "usbhostmanager.hpp"
 #include "gpdriver.hpp"
 #include "system_logger.h"
+#include "perf_trace.hpp"
+#include "latency_trace.hpp"
 
 void InputState::setup() {
     LOG_INFO("INPUT", "Starting input state setup");
@@ -67,8 +69,18 @@ void InputState::setup() {
     LEDS_MANAGER.setup();
     #endif
 
+    #if PERF_TRACE_ENABLED
+    PERF_TRACE.reset();  // 开始新的耗时统计会话
+    #endif
+    #if LATENCY_TRACE_ENABLED
+    LATENCY_TRACE.reset();  // 开始新的延迟统计会话
+    #endif
+
     workTime = MICROS_TIMER.micros();  // 微秒级
+    adcVirtualPinMask = 0;
     ledAnimationTime = HAL_GetTick();  // 毫秒级
+    driftCompensationTime = HAL_GetTick();
+    baselineTrackingTime = HAL_GetTick();
 
     isRunning = true;
     LOG_INFO("INPUT", "Input state setup completed successfully");
@@ -77,35 +89,83 @@ void InputState::setup() {
 }
 
 void InputState::loop() { 
+    PERF_TRACE_BEGIN(loopStart);
+    PERF_TRACE_BEGIN(stageStart);
+
+    // ADC有新的转换帧时立即处理；只有ADC按键状态变化时才提前走后面的流程，否则按固定间隔轮询GPIO和处理手柄数据
+    bool adcMaskChanged = false;
+    if(ADC_MANAGER.hasFreshADCFrame()) {
+        PERF_TRACE_RESTART(stageStart);
+
+        const uint32_t mask = ADC_BTNS_WORKER.read();
+        adcMaskChanged = (mask != adcVirtualPinMask);
+        adcVirtualPinMask = mask;
+        PERF_TRACE_MARK(stageStart, PerfStage::ADC_READ);
+    }
 
-    if(MICROS_TIMER.checkInterval(READ_BTNS_INTERVAL, workTime)) {
+    if(adcMaskChanged || MICROS_TIMER.checkInterval(READ_BTNS_INTERVAL, workTime)) {
+        PERF_TRACE_RESTART(stageStart);
 
-        virtualPinMask = GPIO_BTNS_WORKER.read() | ADC_BTNS_WORKER.read();
+        virtualPinMask = GPIO_BTNS_WORKER.read() | adcVirtualPinMask;
+        PERF_TRACE_MARK(stageStart, PerfStage::GPIO_READ);
 
         // 只有在没有按下FN键时才处理游戏手柄数据
         if((virtualPinMask & FN_BUTTON_VIRTUAL_PIN) == 0) {
             GAMEPAD.read(virtualPinMask);
+            PERF_TRACE_MARK(stageStart, PerfStage::GAMEPAD_READ);
             inputDriver->process(&GAMEPAD);  // 处理游戏手柄数据，将按键数据映射到xinput协议 形成 report 数据，然后通过 usb 发送出去
+            PERF_TRACE_MARK(stageStart, PerfStage::DRIVER_PROCESS);
         } else {
             // 更新热键状态，处理hold和click逻辑
             HOTKEYS_MANAGER.updateHotkeyState(virtualPinMask, lastVirtualPinMask);
+            LATENCY_TRACE_DISCARD();  // FN组合键不会产生报告
         }
 
         lastVirtualPinMask = virtualPinMask;
     }
 
+    PERF_TRACE_RESTART(stageStart);
+
     // 处理USB任务
     tud_task(); // 设备模式任务
+    PERF_TRACE_MARK(stageStart, PerfStage::TUD_TASK);
     USB_HOST_MANAGER.process();
+    PERF_TRACE_MARK(stageStart, PerfStage::USB_HOST_PROCESS);
     inputDriver->processAux();
+    PERF_TRACE_MARK(stageStart, PerfStage::DRIVER_PROCESS_AUX);
 
     #if HAS_LED == 1
     uint32_t currentTime = HAL_GetTick();
     if(currentTime - ledAnimationTime >= LEDS_ANIMATION_INTERVAL) {
+        PERF_TRACE_RESTART(stageStart);
         LEDS_MANAGER.loop(virtualPinMask);
+        PERF_TRACE_MARK(stageStart, PerfStage::LEDS_LOOP);
         ledAnimationTime = currentTime;
     }
     #endif
+
+    #if ADC_DRIFT_COMPENSATION_ENABLED
+    // 温漂补偿：低频采样温度，只在阈值需要平移时改写按键的映射和阈值
+    if(HAL_GetTick() - driftCompensationTime >= ADC_DRIFT_SAMPLE_INTERVAL_MS) {
+        ADC_BTNS_WORKER.compensateDrift();
+        driftCompensationTime = HAL_GetTick();
+    }
+    #endif
+
+    #if ADC_BASELINE_TRACKING_ENABLED
+    // 基准值跟踪：低频采样静止值，校准值修改后按间隔合并写入Flash
+    if(HAL_GetTick() - baselineTrackingTime >= ADC_BASELINE_SAMPLE_INTERVAL_MS) {
+        ADC_BTNS_WORKER.trackBaseline();
+        baselineTrackingTime = HAL_GetTick();
+    }
+    #endif
+
+    // 热键修改的配置：静默一段时间且没有按键按下时合并写入一次，不在热键处理中擦写Flash
+    if(STORAGE_MANAGER.isConfigDirty()) {
+        STORAGE_MANAGER.processDeferredSave(virtualPinMask == 0);
+    }
+
+    PERF_TRACE_MARK(loopStart, PerfStage::LOOP_TOTAL);
 }
 
 void InputState::reset() {
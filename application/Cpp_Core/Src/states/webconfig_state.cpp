@@ -46,6 +46,7 @@ void WebConfigState::setup() {
 
 void WebConfigState::loop() {
     if(isRunning) {
+        MC.dispatchDeferred(); // 分发中断中发布的消息（ADC采样统计等）
         ADC_CALIBRATION_MANAGER.processCalibration(); // 处理校准逻辑
         CONFIG_MANAGER.loop();
         
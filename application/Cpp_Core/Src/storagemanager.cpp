@@ -13,7 +13,52 @@ void Storage::initConfig() {
 
 bool Storage::saveConfig()
 {
-	return ConfigUtils::save(config);
+	if(!ConfigUtils::save(config)) {
+		return false;
+	}
+	configDirty = false;
+	return true;
+}
+
+void Storage::markConfigDirty()
+{
+	configDirty = true;
+	configDirtyTime = HAL_GetTick();
+}
+
+/**
+ * @brief 延迟写入配置
+ * 连续的修改（如连按亮度热键）只在最后一次修改静默后写入一次；有按键按下时推迟到全部释放，
+ * 写入失败时保留修改标记，静默时间后重试。
+ * 写入之后的循环中分步回收配置存储的旧扇区，每次最多一个Flash操作，擦除只发命令、之后每次查询忙标志，
+ * 下一次保存不需要等待擦除
+ * @param idle 当前是否没有按键按下
+ */
+void Storage::processDeferredSave(bool idle)
+{
+	if(!idle) {
+		return;
+	}
+
+	if(configDirty && HAL_GetTick() - configDirtyTime >= CONFIG_SAVE_QUIET_MS) {
+		APP_DBG("Storage::processDeferredSave - save config.");
+		if(!saveConfig()) {
+			APP_ERR("Storage::processDeferredSave - save config failed.");
+			configDirtyTime = HAL_GetTick();
+			return;
+		}
+		gcPending = true;
+		return;
+	}
+
+	if(gcPending && !ConfigUtils::collectGarbageStep()) {
+		gcPending = false;
+	}
+}
+
+bool Storage::flushConfig()
+{
+	return configDirty ? saveConfig() : true;
 }
 
 /**
@@ -352,6 +352,38 @@ void MX_ADC3_Init(void)
         Error_Handler();
     }
 
+#if ADC_DRIFT_COMPENSATION_ENABLED
+    /** Configure Injected Channels
+     * 温漂补偿：内部温度传感器和 VREFINT 走注入组，软件触发，低频转换，不影响规则组的DMA
+     */
+    ADC_InjectionConfTypeDef sConfigInjected = {0};
+    sConfigInjected.InjectedChannel = ADC_CHANNEL_TEMPSENSOR;
+    sConfigInjected.InjectedRank = ADC_INJECTED_RANK_1;
+    sConfigInjected.InjectedSamplingTime = ADC_SAMPLETIME_810CYCLES_5;  // 温度传感器要求较长的采样时间
+    sConfigInjected.InjectedSingleDiff = ADC_SINGLE_ENDED;
+    sConfigInjected.InjectedOffsetNumber = ADC_OFFSET_NONE;
+    sConfigInjected.InjectedOffset = 0;
+    sConfigInjected.InjectedOffsetSignedSaturation = DISABLE;
+    sConfigInjected.InjectedNbrOfConversion = 2;
+    sConfigInjected.InjectedDiscontinuousConvMode = DISABLE;
+    sConfigInjected.AutoInjectedConv = DISABLE;
+    sConfigInjected.QueueInjectedContext = DISABLE;
+    sConfigInjected.ExternalTrigInjecConv = ADC_INJECTED_SOFTWARE_START;
+    sConfigInjected.ExternalTrigInjecConvEdge = ADC_EXTERNALTRIGINJECCONV_EDGE_NONE;
+    sConfigInjected.InjecOversamplingMode = DISABLE;
+    if (HAL_ADCEx_InjectedConfigChannel(&hadc3, &sConfigInjected) != HAL_OK)
+    {
+        Error_Handler();
+    }
+
+    sConfigInjected.InjectedChannel = ADC_CHANNEL_VREFINT;
+    sConfigInjected.InjectedRank = ADC_INJECTED_RANK_2;
+    if (HAL_ADCEx_InjectedConfigChannel(&hadc3, &sConfigInjected) != HAL_OK)
+    {
+        Error_Handler();
+    }
+#endif
+
     // 检查 ADC3 时钟
     if(!__HAL_RCC_ADC3_IS_CLK_ENABLED()) {
         APP_ERR("ADC3 Clock not enabled!");
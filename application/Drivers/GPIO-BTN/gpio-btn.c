@@ -1,5 +1,15 @@
 #include "gpio-btn.h"
 
+// 按钮涉及的端口，每次扫描每个端口只读一次IDR
+static GPIO_TypeDef* gpio_btns_ports[NUM_GPIO_BUTTONS];
+static uint8_t gpio_btns_port_count = 0;
+// 每个按钮所在端口在 gpio_btns_ports 中的索引和引脚在IDR中的位号，初始化时预先计算
+static uint8_t gpio_btns_port_index[NUM_GPIO_BUTTONS];
+static uint8_t gpio_btns_pin_shift[NUM_GPIO_BUTTONS];
+// 按钮引脚对应的EXTI线掩码和边沿回调
+static uint32_t gpio_btns_exti_lines = 0;
+static GPIO_Btns_EdgeCallback gpio_btns_edge_callback = NULL;
+
 
 
 
@@ -16,6 +26,19 @@ void GPIO_Btns_Init()
         GPIO_Init.Pin = gpio_btns_mapping[i].pin;
         HAL_GPIO_Init(gpio_btns_mapping[i].port, &GPIO_Init);
     }
+
+    gpio_btns_port_count = 0;
+    for(uint8_t i = 0; i < NUM_GPIO_BUTTONS; i++) {
+        uint8_t port = 0;
+        while(port < gpio_btns_port_count && gpio_btns_ports[port] != gpio_btns_mapping[i].port) {
+            port++;
+        }
+        if(port == gpio_btns_port_count) {
+            gpio_btns_ports[gpio_btns_port_count++] = gpio_btns_mapping[i].port;
+        }
+        gpio_btns_port_index[i] = port;
+        gpio_btns_pin_shift[i] = (uint8_t)__builtin_ctz(gpio_btns_mapping[i].pin);
+    }
 }
 
 void GPIO_Btns_Iterate( void (*callback)(uint8_t virtualPin, bool isPressed, uint8_t idx) ) {
@@ -26,5 +49,90 @@ void GPIO_Btns_Iterate( void (*callback)(uint8_t virtualPin, bool isPressed, uin
     }
 }
 
+/**
+ * 读取所有按钮状态
+ * 每个端口只读一次IDR（同一时刻的快照），再按预先计算的位号移位拼成掩码，不经过 HAL_GPIO_ReadPin
+ * 按钮为上拉输入，低电平表示按下
+ * @return bit i 对应 gpio_btns_mapping[i]，1 表示按下
+ */
+uint32_t GPIO_Btns_ReadMask(void)
+{
+    uint32_t pressed[NUM_GPIO_BUTTONS];
+    for(uint8_t port = 0; port < gpio_btns_port_count; port++) {
+        pressed[port] = ~gpio_btns_ports[port]->IDR;
+    }
+
+    uint32_t mask = 0;
+    for(uint8_t i = 0; i < NUM_GPIO_BUTTONS; i++) {
+        mask |= ((pressed[gpio_btns_port_index[i]] >> gpio_btns_pin_shift[i]) & 1U) << i;
+    }
+    return mask;
+}
+
+// 引脚号对应的EXTI中断号，EXTI5~9、EXTI10~15 共用中断
+static IRQn_Type GPIO_Btns_EXTI_IRQn(uint8_t pinShift)
+{
+    if(pinShift <= 4) {
+        static const IRQn_Type lowIRQs[5] = {EXTI0_IRQn, EXTI1_IRQn, EXTI2_IRQn, EXTI3_IRQn, EXTI4_IRQn};
+        return lowIRQs[pinShift];
+    }
+    return pinShift <= 9 ? EXTI9_5_IRQn : EXTI15_10_IRQn;
+}
+
+/**
+ * 按钮引脚改为双边沿中断输入
+ * 需要在 GPIO_Btns_Init 之后调用，引脚仍保持上拉输入，GPIO_Btns_ReadMask 不受影响
+ * @param callback 边沿回调，在中断上下文中调用
+ */
+void GPIO_Btns_InitEXTI(GPIO_Btns_EdgeCallback callback)
+{
+    GPIO_InitTypeDef GPIO_Init;
+
+    GPIO_Init.Mode = GPIO_MODE_IT_RISING_FALLING;
+    GPIO_Init.Pull = GPIO_PULLUP;
+    GPIO_Init.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+
+    gpio_btns_edge_callback = callback;
+    gpio_btns_exti_lines = 0;
+    for(uint8_t i = 0; i < NUM_GPIO_BUTTONS; i++) {
+        GPIO_Init.Pin = gpio_btns_mapping[i].pin;
+        HAL_GPIO_Init(gpio_btns_mapping[i].port, &GPIO_Init);
+        gpio_btns_exti_lines |= gpio_btns_mapping[i].pin;
+    }
+    __HAL_GPIO_EXTI_CLEAR_IT(gpio_btns_exti_lines);
+
+    for(uint8_t i = 0; i < NUM_GPIO_BUTTONS; i++) {
+        const IRQn_Type irq = GPIO_Btns_EXTI_IRQn(gpio_btns_pin_shift[i]);
+        HAL_NVIC_SetPriority(irq, GPIO_BUTTONS_EXTI_IRQ_PRIORITY, 0);
+        HAL_NVIC_EnableIRQ(irq);
+    }
+}
+
+/**
+ * 按钮引脚的EXTI中断处理
+ * 先记录时间戳，再清除挂起标志并读取所有按钮的状态，清除之后的新边沿会再次触发中断，不会丢失最终状态
+ */
+void GPIO_Btns_EXTI_IRQHandler(void)
+{
+    const uint32_t timestamp = DWT->CYCCNT;
+    const uint32_t pending = __HAL_GPIO_EXTI_GET_IT(gpio_btns_exti_lines);
+    if(pending == 0) {
+        return;
+    }
+    __HAL_GPIO_EXTI_CLEAR_IT(pending);
 
+    if(gpio_btns_edge_callback != NULL) {
+        gpio_btns_edge_callback(GPIO_Btns_ReadMask(), timestamp);
+    }
+}
 
+#if GPIO_BUTTONS_EXTI_ENABLED
+// 按钮引脚所在的EXTI中断，只有 GPIO_Btns_InitEXTI 使能的中断会进入
+void EXTI0_IRQHandler(void)     { GPIO_Btns_EXTI_IRQHandler(); }
+void EXTI1_IRQHandler(void)     { GPIO_Btns_EXTI_IRQHandler(); }
+void EXTI2_IRQHandler(void)     { GPIO_Btns_EXTI_IRQHandler(); }
+void EXTI3_IRQHandler(void)     { GPIO_Btns_EXTI_IRQHandler(); }
+void EXTI4_IRQHandler(void)     { GPIO_Btns_EXTI_IRQHandler(); }
+void EXTI9_5_IRQHandler(void)   { GPIO_Btns_EXTI_IRQHandler(); }
+void EXTI15_10_IRQHandler(void) { GPIO_Btns_EXTI_IRQHandler(); }
+#endif
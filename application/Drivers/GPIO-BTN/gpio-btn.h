@@ -24,6 +24,13 @@ const struct gpio_pin_def gpio_btns_mapping[NUM_GPIO_BUTTONS] = {
 
 void GPIO_Btns_Init(void);
 void GPIO_Btns_Iterate( void (*callback)(uint8_t virtualPin, bool isPressed, uint8_t idx) );
+uint32_t GPIO_Btns_ReadMask(void);     // 读取所有按钮状态 bit i 对应 gpio_btns_mapping[i]，1 表示按下
+
+// 边沿中断回调 buttonMask: 中断时所有按钮的状态（同 GPIO_Btns_ReadMask） timestamp: 进入中断时的DWT周期
+typedef void (*GPIO_Btns_EdgeCallback)(uint32_t buttonMask, uint32_t timestamp);
+
+void GPIO_Btns_InitEXTI(GPIO_Btns_EdgeCallback callback);   // 按钮引脚改为双边沿中断输入，每个边沿调用 callback（中断上下文）
+void GPIO_Btns_EXTI_IRQHandler(void);                        // 按钮引脚的EXTI中断处理
 
 #ifdef __cplusplus
 }
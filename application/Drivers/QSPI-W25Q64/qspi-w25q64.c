@@ -51,6 +51,7 @@
 
 QSPI_HandleTypeDef hqspi;
 static bool xip_enabled = false;  // 跟踪XIP模式状态
+static bool erase_pending = false;  // 已发出擦除命令、还未确认完成（非阻塞擦除）
 
 /**
  * @brief 
@@ -682,6 +683,29 @@ int8_t QSPI_W25Qxx_WriteBuffer(uint8_t* pBuffer, uint32_t WriteAddr, uint32_t Nu
 		}
 	}
 
+	return QSPI_W25Qxx_ProgramBuffer(pBuffer, WriteAddr, NumByteToWrite);
+}
+
+/**
+ * @brief 
+ *	函数功能: 按页编程写入数据，不擦除，目标区域必须已经擦除（全部为0xFF）
+ *	说    明: 	1.用于追加写入的日志类数据，写入少量字节只需要一次页编程的时间，不需要擦除整个扇区
+ *				2.跨页的数据自动拆分为多次页编程
+ * 
+ * @param pBuffer 			要写入的数据
+ * @param WriteAddr 		要写入 W25Qxx 的地址
+ * @param NumByteToWrite 	数据长度
+ * @return int8_t 			QSPI_W25Qxx_OK 		     - 写数据成功
+ *				 			W25Qxx_ERROR_WriteEnable - 写使能失败
+ *				 			W25Qxx_ERROR_TRANSMIT	 - 传输失败
+ *				 			W25Qxx_ERROR_AUTOPOLLING - 轮询等待无响应
+ */
+int8_t QSPI_W25Qxx_ProgramBuffer(uint8_t* pBuffer, uint32_t WriteAddr, uint32_t NumByteToWrite)
+{
+	WriteAddr &= 0x00FFFFFF;
+
+	int8_t status;
+
 	// 执行写入操作
 	uint32_t current_addr = WriteAddr;
 	uint32_t end_addr = WriteAddr + NumByteToWrite;
@@ -773,6 +797,8 @@ int8_t QSPI_W25Qxx_ReadBuffer(uint8_t* pBuffer, uint32_t ReadAddr, uint32_t NumB
 
 int8_t QSPI_W25Qxx_WriteBuffer_WithXIPOrNot(uint8_t* pData, uint32_t WriteAddr, uint32_t NumByteToWrite)
 {
+	QSPI_W25Qxx_WaitEraseDone();
+
 	bool is_xip = xip_enabled;
 	if(is_xip == true) {
 		QSPI_W25Qxx_ExitMemoryMappedMode();
@@ -787,8 +813,155 @@ int8_t QSPI_W25Qxx_WriteBuffer_WithXIPOrNot(uint8_t* pData, uint32_t WriteAddr,
 	return result;
 }
 
+int8_t QSPI_W25Qxx_ProgramBuffer_WithXIPOrNot(uint8_t* pData, uint32_t WriteAddr, uint32_t NumByteToWrite)
+{
+	QSPI_W25Qxx_WaitEraseDone();
+
+	bool is_xip = xip_enabled;
+	if(is_xip == true) {
+		QSPI_W25Qxx_ExitMemoryMappedMode();
+	}
+
+	int8_t result = QSPI_W25Qxx_ProgramBuffer(pData, WriteAddr, NumByteToWrite);
+
+	if(is_xip == true) {
+		QSPI_W25Qxx_EnterMemoryMappedMode();
+	}
+
+	return result;
+}
+
+int8_t QSPI_W25Qxx_SectorErase_WithXIPOrNot(uint32_t SectorAddress)
+{
+	QSPI_W25Qxx_WaitEraseDone();
+
+	bool is_xip = xip_enabled;
+	if(is_xip == true) {
+		QSPI_W25Qxx_ExitMemoryMappedMode();
+	}
+
+	int8_t result = QSPI_W25Qxx_SectorErase(SectorAddress & 0x00FFFFFF);
+
+	if(is_xip == true) {
+		QSPI_W25Qxx_EnterMemoryMappedMode();
+	}
+
+	return result;
+}
+
+/**
+ * @brief 
+ * 函数功能: 发出扇区擦除命令后立即返回，不等待擦除完成（参考擦除时间 45ms）
+ * 1.擦除期间由 QSPI_W25Qxx_PollEraseDone 查询是否完成，调用方可以在主循环中分多次查询
+ * 2.擦除完成前调用其它 _WithXIPOrNot 函数时，会先阻塞等待擦除完成
+ * 3.内存映射模式下擦除期间无法读取，退化为阻塞擦除
+ * 
+ * @param SectorAddress 		要擦除的地址
+ * @return int8_t 
+ * QSPI_W25Qxx_OK - 擦除命令已发出（内存映射模式下为擦除完成）
+ * W25Qxx_ERROR_WriteEnable - 写使能失败
+ * W25Qxx_ERROR_Erase - 擦除命令发送失败
+ */
+int8_t QSPI_W25Qxx_SectorEraseStart_WithXIPOrNot(uint32_t SectorAddress)
+{
+	if(xip_enabled == true) {
+		return QSPI_W25Qxx_SectorErase_WithXIPOrNot(SectorAddress);
+	}
+
+	QSPI_W25Qxx_WaitEraseDone();
+
+	QSPI_CommandTypeDef s_command;	// QSPI传输配置
+	
+	s_command.InstructionMode   	= QSPI_INSTRUCTION_1_LINE;    // 1线指令模式
+	s_command.AddressSize       	= QSPI_ADDRESS_24_BITS;       // 24位地址模式
+	s_command.AlternateByteMode 	= QSPI_ALTERNATE_BYTES_NONE;  //	无交替字节 
+	s_command.DdrMode           	= QSPI_DDR_MODE_DISABLE;      // 禁止DDR模式
+	s_command.DdrHoldHalfCycle  	= QSPI_DDR_HHC_ANALOG_DELAY;  // DDR模式中数据延迟，这里用不到
+	s_command.SIOOMode          	= QSPI_SIOO_INST_EVERY_CMD;	// 每次传输数据都发送指令
+	s_command.AddressMode 			= QSPI_ADDRESS_1_LINE;        // 1线地址模式
+	s_command.DataMode 				= QSPI_DATA_NONE;             // 无数据
+	s_command.DummyCycles 			= 0;                          // 空周期个数
+	s_command.Address           	= SectorAddress & 0x00FFFFFF; // 要擦除的地址
+	s_command.Instruction	 		= W25Qxx_CMD_SectorErase;     // 扇区擦除命令
+
+	// 发送写使能
+	if (QSPI_W25Qxx_WriteEnable() != QSPI_W25Qxx_OK)
+	{
+		QSPI_W25Qxx_ERR("QSPI_W25Qxx_SectorEraseStart: QSPI_W25Qxx_WriteEnable failure!");
+		return W25Qxx_ERROR_WriteEnable;		// 写使能失败
+	}
+	// 发出擦除命令，不等待完成
+	if (HAL_QSPI_Command(&hqspi, &s_command, HAL_QPSI_TIMEOUT_DEFAULT_VALUE) != HAL_OK)
+	{
+		QSPI_W25Qxx_ERR("QSPI_W25Qxx_SectorEraseStart: HAL_QSPI_Command failure!");
+		return W25Qxx_ERROR_Erase;				// 擦除失败
+	}
+	erase_pending = true;
+	return QSPI_W25Qxx_OK;
+}
+
+/**
+ * @brief 
+ * 函数功能: 读取一次状态寄存器1，查询非阻塞擦除是否完成
+ * 
+ * @return int8_t 
+ * 1 - 擦除仍在进行
+ * QSPI_W25Qxx_OK - 没有进行中的擦除
+ * W25Qxx_ERROR_TRANSMIT - 读取状态寄存器失败
+ */
+int8_t QSPI_W25Qxx_PollEraseDone(void)
+{
+	if(erase_pending == false) {
+		return QSPI_W25Qxx_OK;
+	}
+
+	QSPI_CommandTypeDef s_command;
+	uint8_t reg;
+
+	s_command.InstructionMode   = QSPI_INSTRUCTION_1_LINE;
+	s_command.Instruction       = W25Qxx_CMD_ReadStatus_REG1;
+	s_command.AddressMode       = QSPI_ADDRESS_NONE;
+	s_command.AlternateByteMode = QSPI_ALTERNATE_BYTES_NONE;
+	s_command.DataMode         = QSPI_DATA_1_LINE;
+	s_command.DummyCycles      = 0;
+	s_command.NbData          = 1;
+	s_command.DdrMode         = QSPI_DDR_MODE_DISABLE;
+	s_command.DdrHoldHalfCycle = QSPI_DDR_HHC_ANALOG_DELAY;
+	s_command.SIOOMode        = QSPI_SIOO_INST_EVERY_CMD;
+
+	if (HAL_QSPI_Command(&hqspi, &s_command, HAL_QPSI_TIMEOUT_DEFAULT_VALUE) != HAL_OK
+		|| HAL_QSPI_Receive(&hqspi, &reg, HAL_QPSI_TIMEOUT_DEFAULT_VALUE) != HAL_OK) {
+		return W25Qxx_ERROR_TRANSMIT;
+	}
+
+	if (reg & W25Qxx_Status_REG1_BUSY) {
+		return 1;
+	}
+	erase_pending = false;
+	return QSPI_W25Qxx_OK;
+}
+
+/**
+ * @brief 
+ * 函数功能: 有进行中的非阻塞擦除时阻塞等待完成
+ * 
+ * @return int8_t 
+ * QSPI_W25Qxx_OK - 没有进行中的擦除或擦除已完成
+ * W25Qxx_ERROR_AUTOPOLLING - 轮询等待无响应
+ */
+int8_t QSPI_W25Qxx_WaitEraseDone(void)
+{
+	if(erase_pending == false) {
+		return QSPI_W25Qxx_OK;
+	}
+	erase_pending = false;
+	return QSPI_W25Qxx_AutoPollingMemReady();
+}
+
 int8_t QSPI_W25Qxx_ReadBuffer_WithXIPOrNot(uint8_t* pBuffer, uint32_t ReadAddr, uint32_t NumByteToRead)
 {
+	QSPI_W25Qxx_WaitEraseDone();
+
 	bool is_xip = xip_enabled;
 	if(is_xip == true) {
 		QSPI_W25Qxx_ExitMemoryMappedMode();
@@ -926,6 +1099,9 @@ int8_t QSPI_W25Qxx_EnterMemoryMappedMode(void)
 		return QSPI_W25Qxx_OK;
 	}
 
+	// 擦除进行中不能读取，进入内存映射前等待完成
+	QSPI_W25Qxx_WaitEraseDone();
+
 	xip_enabled = true;
 
 	QSPI_CommandTypeDef      s_command;
@@ -1027,6 +1203,7 @@ int8_t QSPI_W25Qxx_ReadString(char* buffer, uint32_t ReadAddr)
  */
 int8_t QSPI_W25Qxx_BufferErase(uint32_t StartAddr, uint32_t Size)
 {
+	QSPI_W25Qxx_WaitEraseDone();
 
 	StartAddr &= 0x00FFFFFF;
 
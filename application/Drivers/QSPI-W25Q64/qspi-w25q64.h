@@ -116,10 +116,16 @@ int8_t QSPI_W25Qxx_ChipErase (void);                         // 整片擦除，
 int8_t QSPI_W25Qxx_WritePage(uint8_t* pBuffer, uint32_t WriteAddr, uint16_t NumByteToWrite);	// 按页写入，最大256字节
 
 int8_t QSPI_W25Qxx_WriteBuffer(uint8_t* pBuffer, uint32_t WriteAddr, uint32_t NumByteToWrite);				// 写入数据，最大不能超过flash芯片的大小
+int8_t QSPI_W25Qxx_ProgramBuffer(uint8_t* pBuffer, uint32_t WriteAddr, uint32_t NumByteToWrite);			// 写入数据，不擦除，目标区域必须已擦除
 int8_t QSPI_W25Qxx_ReadBuffer(uint8_t* pBuffer, uint32_t ReadAddr, uint32_t NumByteToRead);	// 读取数据，最大不能超过flash芯片的大小
 
 int8_t QSPI_W25Qxx_WriteBuffer_WithXIPOrNot(uint8_t* pData, uint32_t WriteAddr, uint32_t NumByteToWrite);
 int8_t QSPI_W25Qxx_ReadBuffer_WithXIPOrNot(uint8_t* pBuffer, uint32_t ReadAddr, uint32_t NumByteToRead);
+int8_t QSPI_W25Qxx_ProgramBuffer_WithXIPOrNot(uint8_t* pData, uint32_t WriteAddr, uint32_t NumByteToWrite);
+int8_t QSPI_W25Qxx_SectorErase_WithXIPOrNot(uint32_t SectorAddress);
+int8_t QSPI_W25Qxx_SectorEraseStart_WithXIPOrNot(uint32_t SectorAddress);	// 发出扇区擦除命令后立即返回
+int8_t QSPI_W25Qxx_PollEraseDone(void);		// 查询非阻塞擦除，返回 1 表示仍在擦除
+int8_t QSPI_W25Qxx_WaitEraseDone(void);		// 等待非阻塞擦除完成
 
 int8_t QSPI_W25Qxx_WriteString(char* string, uint32_t ReadAddr);
 int8_t QSPI_W25Qxx_ReadString(char* buffer, uint32_t ReadAddr);
@@ -80,6 +80,15 @@ bss_loop:
     strlt r3, [r2], #4      /* 写入0并递增地址 */
     blt bss_loop            /* 继续循环 */
 
+    /* 清零 DTCM 热数据段 */
+    ldr r2, =_sdtcm         /* DTCM 段起始地址 */
+    ldr r4, =_edtcm         /* DTCM 段结束地址 */
+dtcm_loop:
+    cmp r2, r4              /* 比较当前地址和结束地址 */
+    itt lt                  /* if r2 < r4 */
+    strlt r3, [r2], #4      /* 写入0并递增地址 */
+    blt dtcm_loop           /* 继续循环 */
+
     /* 拷贝数据段 */
     ldr r0, =_sidata        /* Flash 中的源地址 */
     ldr r1, =_sdata         /* RAM 中的目标地址 */
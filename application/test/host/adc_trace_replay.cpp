@@ -0,0 +1,328 @@
+/*
+ * ADC按键轨迹回放
+ *
+ * 把记录（或合成）的ADC采样序列按时间顺序推给 ADCBtnsWorker::read()，和期望的按键状态比较，报告：
+ * - 每帧 read() 的主机耗时（x86 上为 TSC 周期，其他平台为纳秒）；
+ * - 延迟：期望状态翻转到输出翻转之间的采样数；
+ * - 误触发：输出翻转到与期望状态不一致的值的次数；漏触发：期望状态翻转后直到下一次翻转都没有跟上的次数。
+ *
+ * 轨迹文件为 CSV，# 开头的行为注释：
+ *   mapping,<step mm>,<samplingNoise>,<v0>,<v1>,...    映射，v0 为完全按下，最后一个值为完全释放
+ *   t_us,truth,b<pin>,b<pin>,...                        表头，b<pin> 为该列对应的 virtualPin
+ *   <t_us>,<truth 掩码>,<ADC值>,<ADC值>,...              每帧一行，truth 按 virtualPin 的期望状态
+ * 表头中没有出现的按键保持完全释放值，第一帧用于初始化映射，应处于释放状态
+ *
+ * 用法：adc_trace_replay <trace.csv> [选项]
+ *   --debounce none|normal|max|adaptive    防抖算法，默认使用默认配置中的算法
+ *   --press-accuracy <mm> --release-accuracy <mm> --top-deadzone <mm> --bottom-deadzone <mm>
+ *   --max-latency <samples>                任一翻转的延迟超过该值时失败
+ *   --max-false-triggers <n>               误触发次数超过该值时失败
+ *   --quiet                                不打印每个按键的统计
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <chrono>
+#include "host_hal.hpp"
+#include "adc_btns/adc_btns_worker.hpp"
+#include "storagemanager.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+static inline uint64_t hostCounter() { return __rdtsc(); }
+static const char* const HOST_COUNTER_UNIT = "tsc cycles";
+#else
+static inline uint64_t hostCounter() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+static const char* const HOST_COUNTER_UNIT = "ns";
+#endif
+
+struct TraceFrame {
+    uint32_t timeUs;
+    uint32_t truth;
+    uint32_t values[NUM_ADC_BUTTONS];
+};
+
+struct Trace {
+    float step = 0.0f;
+    uint16_t samplingNoise = 0;
+    std::vector<uint32_t> mapping;
+    std::vector<TraceFrame> frames;
+};
+
+struct ButtonStats {
+    uint32_t edges;             // 期望状态翻转次数
+    uint32_t detected;          // 跟上的翻转次数
+    uint32_t missed;            // 漏触发
+    uint32_t falseTriggers;     // 误触发
+    uint32_t totalLatency;      // 采样数
+    uint32_t maxLatency;
+};
+
+static bool splitCsv(char* line, std::vector<char*>& fields) {
+    fields.clear();
+    line[strcspn(line, "\r\n")] = '\0';
+    if(line[0] == '\0' || line[0] == '#') {
+        return false;
+    }
+    for(char* token = strtok(line, ","); token; token = strtok(nullptr, ",")) {
+        while(*token == ' ') {
+            token++;
+        }
+        fields.push_back(token);
+    }
+    return !fields.empty();
+}
+
+static bool loadTrace(const char* path, Trace& trace) {
+    FILE* file = fopen(path, "r");
+    if(!file) {
+        printf("cannot open %s\n", path);
+        return false;
+    }
+
+    char line[1024];
+    std::vector<char*> fields;
+    std::vector<int> columnPins;
+    bool ok = true;
+
+    while(ok && fgets(line, sizeof(line), file)) {
+        if(!splitCsv(line, fields)) {
+            continue;
+        }
+
+        if(strcmp(fields[0], "mapping") == 0) {
+            if(fields.size() < 5) {
+                ok = false;
+                break;
+            }
+            trace.step = strtof(fields[1], nullptr);
+            trace.samplingNoise = (uint16_t)strtoul(fields[2], nullptr, 10);
+            for(size_t i = 3; i < fields.size(); i++) {
+                trace.mapping.push_back((uint32_t)strtoul(fields[i], nullptr, 10));
+            }
+        } else if(strcmp(fields[0], "t_us") == 0) {
+            columnPins.clear();
+            for(size_t i = 2; i < fields.size(); i++) {
+                const int pin = fields[i][0] == 'b' ? atoi(fields[i] + 1) : -1;
+                if(pin < 0 || pin >= NUM_ADC_BUTTONS) {
+                    ok = false;
+                    break;
+                }
+                columnPins.push_back(pin);
+            }
+        } else {
+            if(trace.mapping.empty() || fields.size() != columnPins.size() + 2) {
+                ok = false;
+                break;
+            }
+            TraceFrame frame;
+            frame.timeUs = (uint32_t)strtoul(fields[0], nullptr, 10);
+            frame.truth = (uint32_t)strtoul(fields[1], nullptr, 0);
+            for(uint8_t i = 0; i < NUM_ADC_BUTTONS; i++) {
+                frame.values[i] = trace.mapping.back();
+            }
+            for(size_t i = 0; i < columnPins.size(); i++) {
+                frame.values[columnPins[i]] = (uint32_t)strtoul(fields[i + 2], nullptr, 10);
+            }
+            trace.frames.push_back(frame);
+        }
+    }
+    fclose(file);
+
+    if(!ok || trace.mapping.size() < 2 || trace.mapping.size() > MAX_ADC_VALUES_LENGTH || trace.frames.empty()) {
+        printf("invalid trace %s\n", path);
+        return false;
+    }
+    return true;
+}
+
+static bool parseDebounce(const char* name, ADCDebounceFilter::Config& config) {
+    config.adaptive = false;
+    if(strcmp(name, "none") == 0) {
+        config.ultrafastThreshold = ULTRAFast_THRESHOLD_NONE;
+    } else if(strcmp(name, "normal") == 0) {
+        config.ultrafastThreshold = ULTRAFast_THRESHOLD_NORMAL;
+    } else if(strcmp(name, "max") == 0) {
+        config.ultrafastThreshold = ULTRAFast_THRESHOLD_MAX;
+    } else if(strcmp(name, "adaptive") == 0) {
+        config.ultrafastThreshold = ULTRAFast_THRESHOLD_NONE;
+        config.adaptive = true;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if(argc < 2) {
+        printf("usage: %s <trace.csv> [--debounce none|normal|max|adaptive] [--press-accuracy mm] [--release-accuracy mm]\n"
+               "       [--top-deadzone mm] [--bottom-deadzone mm] [--max-latency samples] [--max-false-triggers n] [--quiet]\n", argv[0]);
+        return 2;
+    }
+
+    Trace trace;
+    if(!loadTrace(argv[1], trace)) {
+        return 2;
+    }
+
+    hostFlashReset();
+    STORAGE_MANAGER.initConfig();
+    GamepadProfile* profile = STORAGE_MANAGER.getDefaultGamepadProfile();
+
+    bool overrideDebounce = false;
+    ADCDebounceFilter::Config debounceConfig;
+    long maxLatencyLimit = -1;
+    long maxFalseTriggers = -1;
+    bool quiet = false;
+
+    for(int i = 2; i < argc; i++) {
+        const char* const option = argv[i];
+        const char* const value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if(strcmp(option, "--quiet") == 0) {
+            quiet = true;
+            continue;
+        }
+        if(!value) {
+            printf("missing value for %s\n", option);
+            return 2;
+        }
+        i++;
+        if(strcmp(option, "--debounce") == 0) {
+            if(!parseDebounce(value, debounceConfig)) {
+                printf("unknown debounce algorithm %s\n", value);
+                return 2;
+            }
+            overrideDebounce = true;
+        } else if(strcmp(option, "--max-latency") == 0) {
+            maxLatencyLimit = atol(value);
+        } else if(strcmp(option, "--max-false-triggers") == 0) {
+            maxFalseTriggers = atol(value);
+        } else {
+            const float mm = strtof(value, nullptr);
+            for(uint8_t k = 0; k < NUM_ADC_BUTTONS; k++) {
+                RapidTriggerProfile& trigger = profile->triggerConfigs.triggerConfigs[k];
+                if(strcmp(option, "--press-accuracy") == 0) {
+                    trigger.pressAccuracy = mm;
+                } else if(strcmp(option, "--release-accuracy") == 0) {
+                    trigger.releaseAccuracy = mm;
+                } else if(strcmp(option, "--top-deadzone") == 0) {
+                    trigger.topDeadzone = mm;
+                } else if(strcmp(option, "--bottom-deadzone") == 0) {
+                    trigger.bottomDeadzone = mm;
+                } else {
+                    printf("unknown option %s\n", option);
+                    return 2;
+                }
+            }
+        }
+    }
+
+    if(!hostInstallADCMapping(trace.mapping.data(), trace.mapping.size(), trace.step, trace.samplingNoise)) {
+        printf("install mapping failed\n");
+        return 2;
+    }
+    if(ADC_BTNS_WORKER.setup() != ADCBtnsError::SUCCESS) {
+        printf("ADCBtnsWorker setup failed\n");
+        return 2;
+    }
+    if(overrideDebounce) {
+        ADC_BTNS_WORKER.setDebounceConfig(debounceConfig);
+    }
+
+    ButtonStats stats[NUM_ADC_BUTTONS];
+    memset(stats, 0, sizeof(stats));
+    uint32_t pendingSince[NUM_ADC_BUTTONS];     // 期望状态翻转后尚未跟上的起始帧，UINT32_MAX 表示没有
+    for(uint8_t i = 0; i < NUM_ADC_BUTTONS; i++) {
+        pendingSince[i] = UINT32_MAX;
+    }
+
+    uint64_t totalCounter = 0;
+    uint64_t maxCounter = 0;
+    uint32_t lastTruth = trace.frames[0].truth;
+    uint32_t lastOutput = 0;
+
+    for(size_t n = 0; n < trace.frames.size(); n++) {
+        const TraceFrame& frame = trace.frames[n];
+        hostSetCycles(frame.timeUs * (SYSTEM_CLOCK_FREQ / 1000000UL));
+        hostSetTick(frame.timeUs / 1000);
+        hostPushADCFrame(frame.values);
+
+        const uint64_t start = hostCounter();
+        const uint32_t output = ADC_BTNS_WORKER.read();
+        const uint64_t elapsed = hostCounter() - start;
+        totalCounter += elapsed;
+        maxCounter = std::max(maxCounter, elapsed);
+
+        // 第一帧只用于初始化映射
+        if(n == 0) {
+            lastOutput = output;
+            continue;
+        }
+
+        for(uint8_t i = 0; i < NUM_ADC_BUTTONS; i++) {
+            const uint32_t bit = 1U << i;
+            if((frame.truth ^ lastTruth) & bit) {
+                // 上一次翻转还没有跟上就又翻转了
+                if(pendingSince[i] != UINT32_MAX) {
+                    stats[i].missed++;
+                }
+                stats[i].edges++;
+                pendingSince[i] = (uint32_t)n;
+            }
+            if((output ^ lastOutput) & bit) {
+                if((output ^ frame.truth) & bit) {
+                    stats[i].falseTriggers++;
+                }
+            }
+            if(pendingSince[i] != UINT32_MAX && !((output ^ frame.truth) & bit)) {
+                const uint32_t latency = (uint32_t)n - pendingSince[i];
+                stats[i].detected++;
+                stats[i].totalLatency += latency;
+                stats[i].maxLatency = std::max(stats[i].maxLatency, latency);
+                pendingSince[i] = UINT32_MAX;
+            }
+        }
+        lastTruth = frame.truth;
+        lastOutput = output;
+    }
+
+    ButtonStats total;
+    memset(&total, 0, sizeof(total));
+    for(uint8_t i = 0; i < NUM_ADC_BUTTONS; i++) {
+        if(pendingSince[i] != UINT32_MAX) {
+            stats[i].missed++;
+        }
+        if(!quiet && (stats[i].edges || stats[i].falseTriggers)) {
+            printf("button %2u: edges %u, detected %u, missed %u, false triggers %u, latency avg %.2f max %u samples\n",
+                i, stats[i].edges, stats[i].detected, stats[i].missed, stats[i].falseTriggers,
+                stats[i].detected ? (double)stats[i].totalLatency / stats[i].detected : 0.0, stats[i].maxLatency);
+        }
+        total.edges += stats[i].edges;
+        total.detected += stats[i].detected;
+        total.missed += stats[i].missed;
+        total.falseTriggers += stats[i].falseTriggers;
+        total.totalLatency += stats[i].totalLatency;
+        total.maxLatency = std::max(total.maxLatency, stats[i].maxLatency);
+    }
+
+    printf("frames %zu, read() avg %.0f max %llu %s\n", trace.frames.size(),
+        (double)totalCounter / trace.frames.size(), (unsigned long long)maxCounter, HOST_COUNTER_UNIT);
+    printf("edges %u, detected %u, missed %u, false triggers %u, latency avg %.2f max %u samples\n",
+        total.edges, total.detected, total.missed, total.falseTriggers,
+        total.detected ? (double)total.totalLatency / total.detected : 0.0, total.maxLatency);
+
+    bool pass = true;
+    if(maxLatencyLimit >= 0 && (total.missed != 0 || (long)total.maxLatency > maxLatencyLimit)) {
+        printf("FAIL: latency above %ld samples or missed edges\n", maxLatencyLimit);
+        pass = false;
+    }
+    if(maxFalseTriggers >= 0 && (long)total.falseTriggers > maxFalseTriggers) {
+        printf("FAIL: false triggers above %ld\n", maxFalseTriggers);
+        pass = false;
+    }
+    return pass ? 0 : 1;
+}
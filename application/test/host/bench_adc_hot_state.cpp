@@ -0,0 +1,269 @@
+/*
+ * ADC按键扫描热路径布局微基准
+ *
+ * 比较改为 HotState（SoA）前后每帧扫描的耗时：
+ * - 布局模型：AoSButton 按改动之前 ADCBtn 的字段顺序把热字段夹在映射表、校准窗口和距离查找表之间，每个按键单独在堆上分配；
+ *   SoAState 与现在的 HotState 一样按字段连续存放。两者运行同一段整数引擎的快速触发判断（getButtonEvent + updateLimitValue，
+ *   触发值换算用固定差值代替），输出必须一致；
+ * - ADCBtnsWorker::processSamples：当前实现每帧的实际耗时。
+ *
+ * 每种情况分别在缓存命中（连续扫描）和每帧之间读一遍 EVICT_BYTES 的缓冲区（模拟主循环其他工作把热数据挤出 L1）两种条件下测量，
+ * 耗时包含一次 steady_clock 读取的开销（timer overhead，单独输出）。
+ *
+ * 用法：bench_adc_hot_state [frames]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+#include "host_hal.hpp"
+#include "adc_btns/adc_btns_worker.hpp"
+#include "adc_btns/ring_buffer_sliding_window.hpp"
+#include "storagemanager.hpp"
+
+#define EVICT_BYTES     (256 * 1024)
+#define PRESS_DELTA     40
+#define RELEASE_DELTA   30
+#define NOISE           2
+
+enum class BenchState : uint8_t { RELEASED, PRESSED };
+
+// 改为 SoA 之前 ADCBtn 的字段顺序（热字段加 hot 注释）
+struct AoSButton {
+    uint8_t virtualPin;
+    uint16_t valueMapping[MAX_ADC_VALUES_LENGTH];
+    uint16_t calibratedMapping[MAX_ADC_VALUES_LENGTH];
+    BenchState state;                       // hot
+    bool initCompleted;                     // hot
+    float lastTravelDistance;
+    uint16_t lastAdcValue;                  // hot
+    float pressAccuracyMm;
+    float releaseAccuracyMm;
+    float highPrecisionReleaseAccuracyMm;
+    float topDeadzoneMm;
+    float bottomDeadzoneMm;
+    float halfwayDistanceMm;
+    uint16_t triggerValue;                  // hot
+    bool needCalibration;
+    bool needSaveCalibration;
+    uint32_t lastCalibrationTime;
+    uint32_t lastSaveTime;
+    RingBufferSlidingWindow<uint16_t, NUM_MAPPING_INDEX_WINDOW_SIZE> topValueWindow;
+    RingBufferSlidingWindow<uint16_t, NUM_MAPPING_INDEX_WINDOW_SIZE> bottomValueWindow;
+    uint16_t limitValue;                    // hot
+    uint16_t noiseQ4;
+    uint16_t distanceLut[ADC_DISTANCE_LUT_SIZE + 1];
+    uint16_t lutBaseValue;
+    uint16_t lutTopValue;
+    uint8_t lutShift;
+    uint16_t topDeadzoneValue;              // hot
+    uint16_t bottomDeadzoneValue;           // hot
+    uint16_t halfwayValue;
+};
+
+// 现在的 HotState 布局
+struct SoAState {
+    uint16_t lastAdcValue[NUM_ADC_BUTTONS];
+    uint16_t limitValue[NUM_ADC_BUTTONS];
+    uint16_t triggerValue[NUM_ADC_BUTTONS];
+    uint16_t noiseQ4[NUM_ADC_BUTTONS];
+    uint16_t topDeadzoneValue[NUM_ADC_BUTTONS];
+    uint16_t bottomDeadzoneValue[NUM_ADC_BUTTONS];
+    uint16_t halfwayValue[NUM_ADC_BUTTONS];
+    float lastTravelDistance[NUM_ADC_BUTTONS];
+    BenchState state[NUM_ADC_BUTTONS];
+    bool initCompleted[NUM_ADC_BUTTONS];
+};
+
+// 整数引擎每个按键每帧的判断，两种布局通过字段引用共用
+static inline bool scanButton(const uint16_t value, BenchState& state, uint16_t& lastAdcValue, uint16_t& limitValue,
+    uint16_t& triggerValue, const uint16_t topDeadzoneValue, const uint16_t bottomDeadzoneValue) {
+    if(state == BenchState::RELEASED) {
+        if(value + NOISE < limitValue) {
+            limitValue = value + NOISE;
+            triggerValue = limitValue + PRESS_DELTA;
+        }
+    } else if(value - NOISE > limitValue) {
+        limitValue = value - NOISE;
+        triggerValue = limitValue - RELEASE_DELTA;
+    }
+    lastAdcValue = value;
+
+    if(state == BenchState::RELEASED && value >= triggerValue && value >= topDeadzoneValue) {
+        state = BenchState::PRESSED;
+        limitValue = value + NOISE;
+        triggerValue = limitValue - RELEASE_DELTA;
+    } else if(state == BenchState::PRESSED && value <= triggerValue && value <= bottomDeadzoneValue) {
+        state = BenchState::RELEASED;
+        limitValue = value - NOISE;
+        triggerValue = limitValue + PRESS_DELTA;
+    }
+    return state == BenchState::PRESSED;
+}
+
+static uint32_t scanAoS(AoSButton* const* buttons, const uint16_t* values) {
+    uint32_t mask = 0;
+    for(uint8_t i = 0; i < NUM_ADC_BUTTONS; i++) {
+        AoSButton* const btn = buttons[i];
+        if(!btn->initCompleted) {
+            continue;
+        }
+        if(scanButton(values[i], btn->state, btn->lastAdcValue, btn->limitValue, btn->triggerValue,
+            btn->topDeadzoneValue, btn->bottomDeadzoneValue)) {
+            mask |= 1U << btn->virtualPin;
+        }
+    }
+    return mask;
+}
+
+static uint32_t scanSoA(SoAState& hot, AoSButton* const* buttons, const uint16_t* values) {
+    uint32_t mask = 0;
+    for(uint8_t i = 0; i < NUM_ADC_BUTTONS; i++) {
+        if(!hot.initCompleted[i]) {
+            continue;
+        }
+        if(scanButton(values[i], hot.state[i], hot.lastAdcValue[i], hot.limitValue[i], hot.triggerValue[i],
+            hot.topDeadzoneValue[i], hot.bottomDeadzoneValue[i])) {
+            mask |= 1U << buttons[i]->virtualPin;
+        }
+    }
+    return mask;
+}
+
+static std::vector<uint8_t> evictBuffer(EVICT_BYTES, 1);
+static volatile uint32_t evictSink;
+
+static void evictCache() {
+    uint32_t sum = 0;
+    for(size_t i = 0; i < evictBuffer.size(); i += 64) {
+        sum += evictBuffer[i];
+    }
+    evictSink = sum;
+}
+
+struct FrameTimer {
+    double totalNs = 0.0;
+    uint32_t frames = 0;
+
+    template<typename Scan>
+    uint32_t measure(Scan scan) {
+        const auto start = std::chrono::steady_clock::now();
+        const uint32_t mask = scan();
+        totalNs += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        frames++;
+        return mask;
+    }
+
+    double average() const {
+        return frames ? totalNs / frames : 0.0;
+    }
+};
+
+// 每个按键在完全释放和完全按下之间随机移动
+static void makeFrames(std::vector<uint16_t>& frames, const uint32_t count, const uint16_t low, const uint16_t high) {
+    frames.resize((size_t)count * NUM_ADC_BUTTONS);
+    double position[NUM_ADC_BUTTONS] = { 0 };
+    double velocity[NUM_ADC_BUTTONS] = { 0 };
+    srand(14);
+    for(uint32_t n = 0; n < count; n++) {
+        for(uint8_t k = 0; k < NUM_ADC_BUTTONS; k++) {
+            if(rand() % 50 == 0) {
+                velocity[k] = ((rand() % 2001) - 1000) / 20000.0;
+            }
+            position[k] = std::max(0.0, std::min(1.0, position[k] + velocity[k]));
+            frames[(size_t)n * NUM_ADC_BUTTONS + k] = (uint16_t)(low + position[k] * (high - low) + rand() % (2 * NOISE + 1));
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    const uint32_t frames = argc > 1 ? (uint32_t)strtoul(argv[1], nullptr, 10) : 50000;
+    const uint16_t low = 1000;
+    const uint16_t high = 3000;
+
+    std::vector<uint16_t> trace;
+    makeFrames(trace, frames, low, high);
+
+    // 布局模型：按键对象之间插入其他分配，与固件上 setup 时的堆布局类似
+    AoSButton* buttons[NUM_ADC_BUTTONS];
+    std::vector<void*> spacers;
+    SoAState hot;
+    memset(&hot, 0, sizeof(hot));
+    for(uint8_t i = 0; i < NUM_ADC_BUTTONS; i++) {
+        buttons[i] = new AoSButton();
+        spacers.push_back(malloc(64 + i * 8));
+        buttons[i]->virtualPin = i;
+        buttons[i]->initCompleted = hot.initCompleted[i] = true;
+        buttons[i]->limitValue = hot.limitValue[i] = high;
+        buttons[i]->triggerValue = hot.triggerValue[i] = high;
+        buttons[i]->topDeadzoneValue = hot.topDeadzoneValue[i] = low + 100;
+        buttons[i]->bottomDeadzoneValue = hot.bottomDeadzoneValue[i] = high - 100;
+    }
+
+    FrameTimer aosWarm, soaWarm, aosCold, soaCold;
+    uint64_t aosChecksum = 0;
+    uint64_t soaChecksum = 0;
+    for(uint32_t n = 0; n < frames; n++) {
+        const uint16_t* values = &trace[(size_t)n * NUM_ADC_BUTTONS];
+        // 前一半缓存命中，后一半每帧之前挤出缓存；两种布局交替运行同一帧
+        const bool cold = n >= frames / 2;
+        if(cold) {
+            evictCache();
+        }
+        aosChecksum = aosChecksum * 31 + (cold ? aosCold : aosWarm).measure([&] { return scanAoS(buttons, values); });
+        if(cold) {
+            evictCache();
+        }
+        soaChecksum = soaChecksum * 31 + (cold ? soaCold : soaWarm).measure([&] { return scanSoA(hot, buttons, values); });
+    }
+
+    // 当前的 ADCBtnsWorker::processSamples
+    uint32_t mapping[36];
+    for(uint32_t i = 0; i < 36; i++) {
+        mapping[i] = (uint32_t)lround(low + (high - low) * pow((35 - i) / 35.0, 1.3));
+    }
+    hostFlashReset();
+    STORAGE_MANAGER.initConfig();
+    if(!hostInstallADCMapping(mapping, 36, 0.1f, NOISE) || ADC_BTNS_WORKER.setup() != ADCBtnsError::SUCCESS) {
+        printf("ADCBtnsWorker setup failed\n");
+        return 2;
+    }
+    FrameTimer workerWarm, workerCold;
+    uint32_t samples[NUM_ADC_BUTTONS];
+    for(uint32_t n = 0; n < frames; n++) {
+        for(uint8_t k = 0; k < NUM_ADC_BUTTONS; k++) {
+            samples[k] = n == 0 ? low : trace[(size_t)n * NUM_ADC_BUTTONS + k];
+        }
+        hostSetCycles(n * 250 * (SYSTEM_CLOCK_FREQ / 1000000UL));
+        const bool cold = n >= frames / 2;
+        if(cold) {
+            evictCache();
+        }
+        (cold ? workerCold : workerWarm).measure([&] { return ADC_BTNS_WORKER.processSamples(samples); });
+    }
+
+    FrameTimer timerOnly;
+    for(uint32_t n = 0; n < frames; n++) {
+        timerOnly.measure([] { return 0u; });
+    }
+
+    printf("%u frames x %d buttons, eviction %d KB between cold frames, timer overhead %.1f ns\n",
+        frames, NUM_ADC_BUTTONS, EVICT_BYTES / 1024, timerOnly.average());
+    printf("                         warm ns/frame   cold ns/frame\n");
+    printf("AoS (before HotState):   %12.1f   %13.1f   hot fields spread over %zu-byte objects\n", aosWarm.average(), aosCold.average(), sizeof(AoSButton));
+    printf("SoA (HotState):          %12.1f   %13.1f   hot fields in %zu bytes\n", soaWarm.average(), soaCold.average(), sizeof(SoAState));
+    printf("processSamples (SoA):    %12.1f   %13.1f\n", workerWarm.average(), workerCold.average());
+
+    for(uint8_t i = 0; i < NUM_ADC_BUTTONS; i++) {
+        delete buttons[i];
+        free(spacers[i]);
+    }
+
+    if(aosChecksum != soaChecksum) {
+        printf("FAIL: AoS and SoA scans differ\n");
+        return 1;
+    }
+    return 0;
+}
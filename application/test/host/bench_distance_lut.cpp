@@ -0,0 +1,94 @@
+/*
+ * ADC值->行程距离查找表微基准
+ *
+ * 与改为查表之前的实现（遍历映射表找到所在区间再插值，现在只在生成查找表时使用）比较
+ * 扫描路径上 getDistanceByValue 的耗时。映射为 36 个点的霍尔曲线（与 traces/gen_press_release_trace.py 相同），
+ * ADC值在映射两端之外各多出一段，覆盖完全按下/完全释放的快速路径。
+ * 查表结果只在节点之间插值，与遍历结果的差值必须不超过 MAX_ERROR_MM。
+ *
+ * 用法：bench_distance_lut [iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+#include "host_hal.hpp"
+#include "adc_btns/adc_btns_worker.hpp"
+#include "storagemanager.hpp"
+
+#define MAPPING_LENGTH  36
+#define MAPPING_STEP    0.1f
+#define MAX_ERROR_MM    0.005f      // 精度设置最小 0.01mm 的一半
+
+template<typename Lookup>
+static double run(const std::vector<uint16_t>& values, const uint32_t iterations, Lookup lookup, double& checksum) {
+    const auto start = std::chrono::steady_clock::now();
+    for(uint32_t i = 0; i < iterations; i++) {
+        checksum += lookup(values[i % values.size()]);
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+}
+
+int main(int argc, char** argv) {
+    const uint32_t iterations = argc > 1 ? (uint32_t)strtoul(argv[1], nullptr, 10) : 5000000;
+
+    uint32_t mapping[MAPPING_LENGTH];
+    for(uint32_t i = 0; i < MAPPING_LENGTH; i++) {
+        const double travel = (MAPPING_LENGTH - 1 - i) * MAPPING_STEP;
+        mapping[i] = (uint32_t)lround(1000 + 2000 * pow(travel / 3.5, 1.3));
+    }
+
+    hostFlashReset();
+    STORAGE_MANAGER.initConfig();
+    if(!hostInstallADCMapping(mapping, MAPPING_LENGTH, MAPPING_STEP, 2)
+        || ADC_BTNS_WORKER.setup() != ADCBtnsError::SUCCESS) {
+        printf("ADCBtnsWorker setup failed\n");
+        return 2;
+    }
+    // 第一帧完全释放，初始化映射和查找表
+    uint32_t frame[NUM_ADC_BUTTONS];
+    for(uint8_t k = 0; k < NUM_ADC_BUTTONS; k++) {
+        frame[k] = mapping[MAPPING_LENGTH - 1];
+    }
+    hostPushADCFrame(frame);
+    ADC_BTNS_WORKER.read();
+
+    // 逐值比较查表与遍历的结果
+    const uint16_t low = (uint16_t)(mapping[MAPPING_LENGTH - 1] - 100);
+    const uint16_t high = (uint16_t)(mapping[0] + 100);
+    float maxError = 0.0f;
+    for(uint32_t value = low; value <= high; value++) {
+        const float error = fabsf(ADC_BTNS_WORKER.getButtonDistance(0, (uint16_t)value)
+            - ADC_BTNS_WORKER.getButtonDistance(0, (uint16_t)value, true));
+        maxError = std::max(maxError, error);
+    }
+
+    // 扫描时的ADC值没有规律，打乱顺序避免分支预测只走映射表开头
+    std::vector<uint16_t> values;
+    for(uint32_t i = 0; i < 4096; i++) {
+        values.push_back((uint16_t)(low + (i * 2654435761u >> 8) % (high - low + 1)));
+    }
+
+    double scanChecksum = 0.0;
+    double lutChecksum = 0.0;
+    const double scanNs = run(values, iterations, [](uint16_t value) {
+        return ADC_BTNS_WORKER.getButtonDistance(0, value, true);
+    }, scanChecksum);
+    const double lutNs = run(values, iterations, [](uint16_t value) {
+        return ADC_BTNS_WORKER.getButtonDistance(0, value);
+    }, lutChecksum);
+
+    printf("mapping %d points, ADC values %u..%u, %u lookups\n", MAPPING_LENGTH, low, high, iterations);
+    printf("scan mapping: %6.1f ns/op\n", scanNs);
+    printf("distance LUT: %6.1f ns/op\n", lutNs);
+    printf("max difference %.5f mm (checksum %.1f / %.1f)\n", maxError, scanChecksum, lutChecksum);
+
+    if(maxError > MAX_ERROR_MM) {
+        printf("FAIL: LUT differs from the mapping scan by more than %.3f mm\n", (double)MAX_ERROR_MM);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,155 @@
+/*
+ * MessageCenter 分发微基准
+ *
+ * 与改为静态处理函数表之前的实现（std::map<MessageId, std::vector<std::function>>）比较 publish 的耗时。
+ * 按键扫描的典型用法：每次扫描发布一次没有订阅者的状态变化消息，按下/释放消息各有两个订阅者。
+ * 两者调用处理函数的次数和收到的数据必须一致；另外输出中断延迟队列（publishFromISR + dispatchDeferred）的耗时。
+ *
+ * 用法：bench_message_center [iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <map>
+#include <vector>
+#include <functional>
+#include <chrono>
+#include "message_center.hpp"
+
+// 改为静态处理函数表之前的实现
+class MapMessageCenter {
+public:
+    using Handler = std::function<void(const void*)>;
+
+    bool registerMessage(MessageId msgId) {
+        if (handlers.find(msgId) != handlers.end()) {
+            return false;
+        }
+        handlers[msgId] = std::vector<Handler>();
+        return true;
+    }
+
+    bool subscribe(MessageId msgId, Handler handler) {
+        auto it = handlers.find(msgId);
+        if (!handler || it == handlers.end()) {
+            return false;
+        }
+        it->second.push_back(handler);
+        return true;
+    }
+
+    bool publish(MessageId msgId, const void* data) {
+        auto it = handlers.find(msgId);
+        if (it == handlers.end()) {
+            return false;
+        }
+        for (const auto& handler : it->second) {
+            if (handler) {
+                handler(data);
+            }
+        }
+        return true;
+    }
+
+private:
+    std::map<MessageId, std::vector<Handler>> handlers;
+};
+
+// 订阅者：累加收到的虚拟引脚
+struct Subscriber {
+    uint64_t sum = 0;
+    uint32_t calls = 0;
+
+    void onMessage(const void* data) {
+        sum = sum * 31 + *(const uint8_t*)data;
+        calls++;
+    }
+
+    static void onMessageStatic(void* context, const void* data) {
+        static_cast<Subscriber*>(context)->onMessage(data);
+    }
+};
+
+static const MessageId benchMessages[] = {
+    MessageId::GPIO_BTNS_STATE_CHANGED,
+    MessageId::ADC_BTNS_STATE_CHANGED,
+    MessageId::GPIO_BTNS_PRESSED,
+    MessageId::GPIO_BTNS_RELEASED,
+    MessageId::ADC_BTNS_PRESSED,
+    MessageId::ADC_BTNS_RELEASED,
+};
+
+// 每次扫描：一次没有订阅者的状态变化消息，每 4 次扫描一次按下或释放
+template<typename Publish>
+static double run(const uint32_t iterations, Publish publish) {
+    const auto start = std::chrono::steady_clock::now();
+    for(uint32_t i = 0; i < iterations; i++) {
+        const uint8_t pin = (uint8_t)(i & 31);
+        publish(MessageId::ADC_BTNS_STATE_CHANGED, &pin);
+        if((i & 3) == 0) {
+            publish((i & 4) ? MessageId::ADC_BTNS_RELEASED : MessageId::ADC_BTNS_PRESSED, &pin);
+        }
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+}
+
+int main(int argc, char** argv) {
+    const uint32_t iterations = argc > 1 ? (uint32_t)strtoul(argv[1], nullptr, 10) : 5000000;
+
+    MapMessageCenter mapCenter;
+    Subscriber mapSubscribers[2];
+    Subscriber subscribers[2];
+    for(const MessageId msgId : benchMessages) {
+        mapCenter.registerMessage(msgId);
+        MC.registerMessage(msgId);
+    }
+    for(Subscriber& subscriber : mapSubscribers) {
+        mapCenter.subscribe(MessageId::ADC_BTNS_PRESSED, [&subscriber](const void* data) { subscriber.onMessage(data); });
+        mapCenter.subscribe(MessageId::ADC_BTNS_RELEASED, [&subscriber](const void* data) { subscriber.onMessage(data); });
+    }
+    for(Subscriber& subscriber : subscribers) {
+        MC.subscribe(MessageId::ADC_BTNS_PRESSED, Subscriber::onMessageStatic, &subscriber);
+        MC.subscribe(MessageId::ADC_BTNS_RELEASED, Subscriber::onMessageStatic, &subscriber);
+    }
+
+    const double mapNs = run(iterations, [&mapCenter](MessageId msgId, const void* data) {
+        mapCenter.publish(msgId, data);
+    });
+    const double tableNs = run(iterations, [](MessageId msgId, const void* data) {
+        MC.publish(msgId, data);
+    });
+
+    // 中断中发布、主循环分发：数据在分发前必须保持有效，这里每次入队后立即分发
+    Subscriber deferredSubscriber;
+    MC.subscribe(MessageId::GPIO_BTNS_PRESSED, Subscriber::onMessageStatic, &deferredSubscriber);
+    const auto start = std::chrono::steady_clock::now();
+    for(uint32_t i = 0; i < iterations; i++) {
+        const uint8_t pin = (uint8_t)(i & 31);
+        MC.publishFromISR(MessageId::GPIO_BTNS_PRESSED, &pin);
+        MC.dispatchDeferred();
+    }
+    const double deferredNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+
+    printf("%u scans: 1 unsubscribed publish + 1/4 press/release publish with 2 subscribers\n", iterations);
+    printf("std::map + std::function: %6.1f ns/scan\n", mapNs);
+    printf("static handler table:     %6.1f ns/scan\n", tableNs);
+    printf("publishFromISR + dispatchDeferred: %6.1f ns/message, %u dropped\n", deferredNs, MC.getDroppedDeferred());
+
+    bool pass = deferredSubscriber.calls == iterations && MC.getDroppedDeferred() == 0;
+    for(uint8_t k = 0; k < 2; k++) {
+        pass = pass && subscribers[k].calls == mapSubscribers[k].calls && subscribers[k].sum == mapSubscribers[k].sum;
+    }
+    // 新实现按 callback + context 取消订阅
+    pass = pass && MC.unsubscribe(MessageId::ADC_BTNS_PRESSED, Subscriber::onMessageStatic, &subscribers[0]);
+    const uint8_t pin = 0;
+    const uint32_t calls = subscribers[0].calls;
+    MC.publish(MessageId::ADC_BTNS_PRESSED, &pin);
+    pass = pass && subscribers[0].calls == calls && subscribers[1].calls == calls + 1;
+
+    if(!pass) {
+        printf("FAIL: handler calls differ\n");
+        return 1;
+    }
+    return 0;
+}
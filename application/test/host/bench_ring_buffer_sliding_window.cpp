@@ -0,0 +1,93 @@
+/*
+ * RingBufferSlidingWindow 微基准
+ *
+ * 与改为定长之前的实现（std::vector 缓冲区，每次 push 重新累加求平均，查询最小/最大值时扫描整个窗口）比较
+ * 校准路径上的典型用法：窗口 32 个 uint16_t，每次 push 之后读取平均值、最小值和最大值。
+ * 两者的查询结果必须一致，输出每次操作的耗时和对象大小。
+ *
+ * 用法：bench_ring_buffer_sliding_window [iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+#include <chrono>
+#include "adc_btns/ring_buffer_sliding_window.hpp"
+
+#define BENCH_WINDOW_SIZE 32
+
+// 改为定长之前的实现
+template<typename T>
+class ScanSlidingWindow {
+public:
+    explicit ScanSlidingWindow(size_t windowSize)
+        : windowSize(windowSize), currentIndex(0), validDataCount(0), cachedAverage(T()) {
+        buffer.resize(windowSize);
+    }
+
+    void push(T value) {
+        buffer[currentIndex] = value;
+        currentIndex = (currentIndex + 1) % windowSize;
+        if (validDataCount < windowSize) {
+            validDataCount++;
+        }
+        const int64_t sum = std::accumulate(buffer.begin(), buffer.begin() + validDataCount, int64_t(0));
+        cachedAverage = static_cast<T>(sum / validDataCount);
+    }
+
+    T getAverageValue() const {
+        return cachedAverage;
+    }
+
+    T getMinValue() const {
+        return validDataCount == 0 ? T() : *std::min_element(buffer.begin(), buffer.begin() + validDataCount);
+    }
+
+    T getMaxValue() const {
+        return validDataCount == 0 ? T() : *std::max_element(buffer.begin(), buffer.begin() + validDataCount);
+    }
+
+private:
+    std::vector<T> buffer;
+    size_t windowSize;
+    size_t currentIndex;
+    size_t validDataCount;
+    T cachedAverage;
+};
+
+template<typename Window>
+static double run(Window& window, const uint32_t iterations, uint64_t& checksum) {
+    const auto start = std::chrono::steady_clock::now();
+    for(uint32_t i = 0; i < iterations; i++) {
+        // 静止值附近的小幅噪声，偶尔出现完全按下的值
+        const uint16_t value = (uint16_t)(i % 97 == 0 ? 3000 : 1000 + ((i * 2654435761u) >> 28));
+        window.push(value);
+        checksum = checksum * 31 + window.getAverageValue() + window.getMinValue() * 7 + window.getMaxValue() * 13;
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+}
+
+int main(int argc, char** argv) {
+    const uint32_t iterations = argc > 1 ? (uint32_t)strtoul(argv[1], nullptr, 10) : 2000000;
+
+    ScanSlidingWindow<uint16_t> scan(BENCH_WINDOW_SIZE);
+    RingBufferSlidingWindow<uint16_t, BENCH_WINDOW_SIZE> ring;
+    uint64_t scanChecksum = 0;
+    uint64_t ringChecksum = 0;
+
+    const double scanNs = run(scan, iterations, scanChecksum);
+    const double ringNs = run(ring, iterations, ringChecksum);
+
+    printf("window %d x uint16_t, %u push + average/min/max\n", BENCH_WINDOW_SIZE, iterations);
+    printf("scan (vector):     %6.1f ns/op, sizeof %zu + %zu heap bytes\n", scanNs, sizeof(scan), BENCH_WINDOW_SIZE * sizeof(uint16_t));
+    printf("RingBufferSliding: %6.1f ns/op, sizeof %zu\n", ringNs, sizeof(ring));
+
+    if(scanChecksum != ringChecksum) {
+        printf("FAIL: results differ\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,165 @@
+/*
+ * 温漂补偿轨迹回放
+ *
+ * 把记录（或合成）的温度和静止基准值偏差按时间顺序交给 ADCDriftCompensator，温度经过 ADC3 注入组的换算路径
+ * （hostSetTemperature → sampleTemperature），与 ADCBtnsWorker::compensateDrift() 每 ADC_DRIFT_SAMPLE_INTERVAL_MS 的调用方式相同。
+ * 报告模型预测的偏移与真实偏移之间的误差：
+ * - RMS 误差，以及不补偿时（偏移为 0）的 RMS 误差；
+ * - 静止时和按住时（没有静止采样，只能按温度预测）的最大误差。
+ *
+ * 轨迹文件为 CSV，# 开头的行为注释，每行一次采样：
+ *   t_s,temp_c,held,o<pin>,r<pin>,...     表头，每个按键一对 o（真实偏移）/r（测得的基准值偏差）列
+ *   <t_s>,<℃>,<按住掩码>,<偏移>,<偏差>,...  held 中置位的按键本次没有静止采样
+ *
+ * 用法：drift_trace_replay <trace.csv> [--skip <s>] [--max-rms <counts>] [--max-held-error <counts>]
+ *   --skip <s>               开始统计前跳过的时间（模型收敛），默认 600
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include "host_hal.hpp"
+#include "adc_btns/adc_drift_compensator.hpp"
+
+struct DriftColumn {
+    uint8_t pin;
+    size_t truthField;
+    size_t residualField;
+};
+
+struct DriftStats {
+    double squaredError;
+    double squaredUncompensated;
+    uint32_t samples;
+    float maxIdleError;
+    float maxHeldError;
+};
+
+int main(int argc, char** argv) {
+    if(argc < 2) {
+        printf("usage: %s <trace.csv> [--skip s] [--max-rms counts] [--max-held-error counts]\n", argv[0]);
+        return 2;
+    }
+
+    double skipSeconds = 600.0;
+    double maxRms = -1.0;
+    double maxHeldError = -1.0;
+    for(int i = 2; i + 1 < argc; i += 2) {
+        const double value = strtod(argv[i + 1], nullptr);
+        if(strcmp(argv[i], "--skip") == 0) {
+            skipSeconds = value;
+        } else if(strcmp(argv[i], "--max-rms") == 0) {
+            maxRms = value;
+        } else if(strcmp(argv[i], "--max-held-error") == 0) {
+            maxHeldError = value;
+        } else {
+            printf("unknown option %s\n", argv[i]);
+            return 2;
+        }
+    }
+
+    FILE* file = fopen(argv[1], "r");
+    if(!file) {
+        printf("cannot open %s\n", argv[1]);
+        return 2;
+    }
+
+    ADCDriftCompensator compensator;
+    std::vector<DriftColumn> columns;
+    DriftStats stats[NUM_ADC_BUTTONS];
+    memset(stats, 0, sizeof(stats));
+    uint32_t rows = 0;
+
+    char line[1024];
+    std::vector<char*> fields;
+    while(fgets(line, sizeof(line), file)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if(line[0] == '\0' || line[0] == '#') {
+            continue;
+        }
+        fields.clear();
+        for(char* token = strtok(line, ","); token; token = strtok(nullptr, ",")) {
+            fields.push_back(token);
+        }
+
+        if(strcmp(fields[0], "t_s") == 0) {
+            columns.clear();
+            for(size_t i = 3; i < fields.size(); i++) {
+                if(fields[i][0] != 'o') {
+                    continue;
+                }
+                const int pin = atoi(fields[i] + 1);
+                for(size_t j = 3; j < fields.size(); j++) {
+                    if(fields[j][0] == 'r' && atoi(fields[j] + 1) == pin && pin >= 0 && pin < NUM_ADC_BUTTONS) {
+                        columns.push_back({ (uint8_t)pin, i, j });
+                    }
+                }
+            }
+            continue;
+        }
+        if(columns.empty() || fields.size() < 3) {
+            printf("invalid trace %s\n", argv[1]);
+            fclose(file);
+            return 2;
+        }
+
+        const double seconds = strtod(fields[0], nullptr);
+        const uint32_t held = (uint32_t)strtoul(fields[2], nullptr, 0);
+        hostSetTemperature(strtof(fields[1], nullptr));
+        compensator.sampleTemperature();
+        if(!compensator.hasTemperature()) {
+            continue;
+        }
+        const float temperature = compensator.getTemperature();
+        rows++;
+
+        for(const DriftColumn& column : columns) {
+            if(column.truthField >= fields.size() || column.residualField >= fields.size()) {
+                continue;
+            }
+            const bool isHeld = (held >> column.pin) & 1;
+            if(!isHeld) {
+                compensator.addIdleSample(column.pin, temperature, atoi(fields[column.residualField]));
+            }
+            if(seconds <= skipSeconds) {
+                continue;
+            }
+
+            const float truth = strtof(fields[column.truthField], nullptr);
+            const float error = fabsf((float)compensator.getOffset(column.pin, temperature) - truth);
+            DriftStats& s = stats[column.pin];
+            s.squaredError += (double)error * error;
+            s.squaredUncompensated += (double)truth * truth;
+            s.samples++;
+            if(isHeld) {
+                s.maxHeldError = std::max(s.maxHeldError, error);
+            } else {
+                s.maxIdleError = std::max(s.maxIdleError, error);
+            }
+        }
+    }
+    fclose(file);
+
+    bool pass = rows > 0;
+    for(const DriftColumn& column : columns) {
+        const DriftStats& s = stats[column.pin];
+        if(s.samples == 0) {
+            continue;
+        }
+        const double rms = sqrt(s.squaredError / s.samples);
+        printf("button %2u: rms error %.2f (uncompensated %.2f), max idle error %.2f, max held error %.2f counts\n",
+            column.pin, rms, sqrt(s.squaredUncompensated / s.samples), s.maxIdleError, s.maxHeldError);
+        if(maxRms >= 0 && rms > maxRms) {
+            printf("FAIL: button %u rms error above %.2f\n", column.pin, maxRms);
+            pass = false;
+        }
+        if(maxHeldError >= 0 && s.maxHeldError > maxHeldError) {
+            printf("FAIL: button %u held error above %.2f\n", column.pin, maxHeldError);
+            pass = false;
+        }
+    }
+    printf("%u samples\n", rows);
+    return pass ? 0 : 1;
+}
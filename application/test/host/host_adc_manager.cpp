@@ -0,0 +1,191 @@
+#include "adc_btns/adc_manager.hpp"
+#include "host_hal.hpp"
+#include "micro_timer.hpp"
+
+/*
+ * ADCManager 的主机替身
+ * 只实现 ADCBtnsWorker 用到的接口：映射只保存在内存中，校准值的写入总是成功；
+ * 帧快照只使用 ADC1 的序号，一帧包含全部按键，readFreshADCValues 与固件一样每帧只返回一次
+ */
+
+uint32_t ADCManager::ADC1_Values[ADC_DMA_BUFFER_LENGTH(NUM_ADC1_BUTTONS)];
+uint32_t ADCManager::ADC2_Values[ADC_DMA_BUFFER_LENGTH(NUM_ADC2_BUTTONS)];
+uint32_t ADCManager::ADC3_Values[ADC_DMA_BUFFER_LENGTH(NUM_ADC3_BUTTONS)];
+uint32_t ADCManager::ADC_Values_Result[NUM_ADC_BUTTONS];
+
+// 下一次 handleADCConvCplt 发布的帧
+static uint32_t hostPendingFrame[NUM_ADC_BUTTONS];
+
+ADCManager::ADCManager() {
+    memset(&store, 0, sizeof(store));
+    store.version = ADC_MAPPING_VERSION;
+    memset(pendingAutoCalibrationMask, 0, sizeof(pendingAutoCalibrationMask));
+    memset(pendingManualCalibrationMask, 0, sizeof(pendingManualCalibrationMask));
+
+    this->adcBufferInfo[0] = {ADC1_Values, sizeof(ADC1_Values), nullptr, NUM_ADC1_BUTTONS};
+    this->adcBufferInfo[1] = {ADC2_Values, sizeof(ADC2_Values), nullptr, NUM_ADC2_BUTTONS};
+    this->adcBufferInfo[2] = {ADC3_Values, sizeof(ADC3_Values), nullptr, NUM_ADC3_BUTTONS};
+    for(uint8_t i = 0; i < NUM_ADC_BUTTONS; i++) {
+        this->ADCBufferInfoList[i].virtualPin = i;
+        this->ADCBufferInfoList[i].valuePtr = &ADC_Values_Result[i];
+    }
+
+    memset(this->frameSnapshots, 0, sizeof(this->frameSnapshots));
+    memset(this->lastFrameSequence, 0, sizeof(this->lastFrameSequence));
+    memset(this->frameStats, 0, sizeof(this->frameStats));
+    this->isStarted = false;
+}
+
+ADCManager::~ADCManager() {
+}
+
+int8_t ADCManager::findMappingById(const char* const id) const {
+    if (!id) return -1;
+    for(uint8_t i = 0; i < store.num; i++) {
+        if(strcmp(store.mapping[i].id, id) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+ADCBtnsError ADCManager::createADCMapping(const char* name, size_t length, float_t step) {
+    if (!name || length == 0 || length > MAX_ADC_VALUES_LENGTH) return ADCBtnsError::INVALID_PARAMS;
+    if (store.num >= NUM_ADC_VALUES_MAPPING) return ADCBtnsError::MAPPING_STORAGE_FULL;
+
+    ADCValuesMapping& mapping = store.mapping[store.num];
+    memset(&mapping, 0, sizeof(ADCValuesMapping));
+    snprintf(mapping.id, sizeof(mapping.id), "host-%u", (unsigned)store.num);
+    snprintf(mapping.name, sizeof(mapping.name), "%s", name);
+    mapping.length = length;
+    mapping.step = step;
+    store.num++;
+    return ADCBtnsError::SUCCESS;
+}
+
+std::vector<ADCValuesMapping*> ADCManager::getMappingList() {
+    std::vector<ADCValuesMapping*> mappingList;
+    for(uint8_t i = 0; i < store.num; i++) {
+        mappingList.push_back(&store.mapping[i]);
+    }
+    return mappingList;
+}
+
+ADCBtnsError ADCManager::updateADCMapping(const char* id, const ADCValuesMapping& map) {
+    const int8_t idx = findMappingById(id);
+    if(idx == -1) return ADCBtnsError::MAPPING_NOT_FOUND;
+    memcpy(&store.mapping[idx], &map, sizeof(ADCValuesMapping));
+    return ADCBtnsError::SUCCESS;
+}
+
+ADCBtnsError ADCManager::setDefaultMapping(const char* id) {
+    if(findMappingById(id) == -1) return ADCBtnsError::MAPPING_NOT_FOUND;
+    snprintf(store.defaultId, sizeof(store.defaultId), "%s", id);
+    return ADCBtnsError::SUCCESS;
+}
+
+std::string ADCManager::getDefaultMapping() const {
+    if(store.num == 0) return std::string("");
+    if(store.defaultId[0] == '\0') return std::string(store.mapping[0].id);
+    return std::string(store.defaultId);
+}
+
+const ADCValuesMapping* ADCManager::getMapping(const char* const id) const {
+    const int8_t idx = findMappingById(id);
+    return idx == -1 ? nullptr : &store.mapping[idx];
+}
+
+ADCBtnsError ADCManager::getCalibrationValues(const char* mappingId, uint8_t buttonIndex, bool isAutoCalibration, uint16_t& topValue, uint16_t& bottomValue) const {
+    if (!mappingId || buttonIndex >= NUM_ADC_BUTTONS) return ADCBtnsError::INVALID_PARAMS;
+    const int8_t idx = findMappingById(mappingId);
+    if (idx == -1) return ADCBtnsError::MAPPING_NOT_FOUND;
+
+    const ADCValuesMapping& mapping = store.mapping[idx];
+    if (isAutoCalibration) {
+        topValue = mapping.autoCalibrationValues[buttonIndex].topValue;
+        bottomValue = mapping.autoCalibrationValues[buttonIndex].bottomValue;
+    } else {
+        topValue = mapping.manualCalibrationValues[buttonIndex].topValue;
+        bottomValue = mapping.manualCalibrationValues[buttonIndex].bottomValue;
+    }
+    if (topValue == 0 && bottomValue == 0) return ADCBtnsError::CALIBRATION_VALUES_NOT_FOUND;
+    return ADCBtnsError::SUCCESS;
+}
+
+ADCBtnsError ADCManager::setCalibrationValues(const char* mappingId, uint8_t buttonIndex, bool isAutoCalibration, uint16_t topValue, uint16_t bottomValue, bool saveToFlash) {
+    if (!mappingId || buttonIndex >= NUM_ADC_BUTTONS) return ADCBtnsError::INVALID_PARAMS;
+    const int8_t idx = findMappingById(mappingId);
+    if (idx == -1) return ADCBtnsError::MAPPING_NOT_FOUND;
+
+    ADCValuesMapping& mapping = store.mapping[idx];
+    if (isAutoCalibration) {
+        mapping.autoCalibrationValues[buttonIndex].topValue = topValue;
+        mapping.autoCalibrationValues[buttonIndex].bottomValue = bottomValue;
+    } else {
+        mapping.manualCalibrationValues[buttonIndex].topValue = topValue;
+        mapping.manualCalibrationValues[buttonIndex].bottomValue = bottomValue;
+    }
+    (void)saveToFlash;
+    return ADCBtnsError::SUCCESS;
+}
+
+ADCBtnsError ADCManager::commitCalibrationValues() {
+    return ADCBtnsError::SUCCESS;
+}
+
+ADCBtnsError ADCManager::startADCSamping(bool enableSamplingRate, uint8_t virtualPin, uint32_t samplingCountMax) {
+    (void)enableSamplingRate;
+    (void)virtualPin;
+    (void)samplingCountMax;
+    isStarted = true;
+    return ADCBtnsError::SUCCESS;
+}
+
+void ADCManager::stopADCSamping() {
+    isStarted = false;
+}
+
+void ADCManager::handleADCConvCplt(const ADC_HandleTypeDef* const hadc, const uint8_t frameIndex) {
+    (void)hadc;
+    (void)frameIndex;
+    ADCFrameSnapshot& snapshot = frameSnapshots[0];
+    snapshot.sequence++;
+    memcpy(ADC_Values_Result, hostPendingFrame, sizeof(ADC_Values_Result));
+    snapshot.sequence++;
+    frameStats[0].frames++;
+}
+
+uint8_t ADCManager::readFreshADCValues(uint32_t* const values) {
+    const uint32_t sequence = frameSnapshots[0].sequence;
+    if(sequence == lastFrameSequence[0]) {
+        return 0;
+    }
+    frameStats[0].droppedFrames += ((sequence - lastFrameSequence[0]) >> 1) - 1;
+    lastFrameSequence[0] = sequence;
+    memcpy(values, ADC_Values_Result, sizeof(ADC_Values_Result));
+    return 1;
+}
+
+bool ADCManager::getFrameStats(const uint8_t adcIndex, ADCFrameStats& stats) const {
+    if(adcIndex >= NUM_ADC) {
+        return false;
+    }
+    stats = frameStats[adcIndex];
+    return true;
+}
+
+void hostPushADCFrame(const uint32_t* values) {
+    memcpy(hostPendingFrame, values, sizeof(hostPendingFrame));
+    ADC_MANAGER.handleADCConvCplt(&hadc1, 0);
+}
+
+bool hostInstallADCMapping(const uint32_t* values, size_t length, float step, uint16_t samplingNoise) {
+    if(ADC_MANAGER.createADCMapping("host", length, step) != ADCBtnsError::SUCCESS) {
+        return false;
+    }
+    ADCValuesMapping mapping = *ADC_MANAGER.getMappingList().back();
+    memcpy(mapping.originalValues, values, length * sizeof(uint32_t));
+    mapping.samplingNoise = samplingNoise;
+    return ADC_MANAGER.updateADCMapping(mapping.id, mapping) == ADCBtnsError::SUCCESS
+        && ADC_MANAGER.setDefaultMapping(mapping.id) == ADCBtnsError::SUCCESS;
+}
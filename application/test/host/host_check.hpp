@@ -0,0 +1,29 @@
+#ifndef __HOST_CHECK_HPP__
+#define __HOST_CHECK_HPP__
+
+/*
+ * 主机测试的最小断言：失败时打印位置继续执行，main 返回失败数作为 ctest 结果
+ */
+
+#include <stdio.h>
+
+static int hostCheckFailures = 0;
+
+#define CHECK(cond) do { \
+    if(!(cond)) { \
+        printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+        hostCheckFailures++; \
+    } \
+} while(0)
+
+#define CHECK_EQ(a, b) do { \
+    const long long _a = (long long)(a), _b = (long long)(b); \
+    if(_a != _b) { \
+        printf("%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", __FILE__, __LINE__, #a, #b, _a, _b); \
+        hostCheckFailures++; \
+    } \
+} while(0)
+
+#define HOST_TEST_RESULT() (hostCheckFailures == 0 ? 0 : 1)
+
+#endif // __HOST_CHECK_HPP__
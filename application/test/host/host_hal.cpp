@@ -0,0 +1,375 @@
+#include "host_hal.hpp"
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "stm32h7xx_hal.h"
+#include "qspi-w25q64.h"
+#include "tusb.h"
+
+/* ---------------- HAL/CMSIS 替身的存储 ---------------- */
+
+DWT_Type host_dwt;
+CoreDebug_Type host_core_debug;
+GPIO_TypeDef host_gpio[11];
+uint8_t host_bkpsram[4096];
+uint32_t host_exti_pending = 0;
+
+ADC_HandleTypeDef hadc1;
+ADC_HandleTypeDef hadc2;
+ADC_HandleTypeDef hadc3;
+QSPI_HandleTypeDef hqspi;
+
+// 温度传感器出厂校准值：30℃ 12000，110℃ 16000，VREFINT 读数等于校准值时 VDDA = 3.3V
+uint16_t host_ts_cal[2] = { 12000, 16000 };
+uint16_t host_vrefint_cal = 20000;
+
+static uint32_t hostTick = 0;
+static uint32_t hostExtiLines = 0;
+
+/* ---------------- 时间 ---------------- */
+
+void hostSetCycles(uint32_t cycles) {
+    host_dwt.CYCCNT = cycles;
+}
+
+void hostAdvanceCycles(uint32_t cycles) {
+    host_dwt.CYCCNT += cycles;
+}
+
+void hostAdvanceMicros(uint32_t us) {
+    host_dwt.CYCCNT += us * (SYSTEM_CLOCK_FREQ / 1000000UL);
+}
+
+void hostSetTick(uint32_t ms) {
+    hostTick = ms;
+}
+
+void hostAdvanceTick(uint32_t ms) {
+    hostTick += ms;
+}
+
+extern "C" uint32_t HAL_GetTick(void) {
+    return hostTick;
+}
+
+extern "C" void HAL_Delay(uint32_t delay) {
+    hostTick += delay;
+}
+
+extern "C" GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef* port, uint16_t pin) {
+    return (port->IDR & pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+/* ---------------- GPIO ---------------- */
+
+extern "C" void HAL_GPIO_Init(GPIO_TypeDef* port, GPIO_InitTypeDef* init) {
+    (void)port;
+    if(init->Mode == GPIO_MODE_IT_RISING_FALLING) {
+        hostExtiLines |= init->Pin;
+    } else {
+        hostExtiLines &= ~init->Pin;
+    }
+}
+
+void hostSetGPIOInput(GPIO_TypeDef* port, uint16_t pins, bool high) {
+    const uint32_t before = port->IDR;
+    port->IDR = high ? (before | pins) : (before & ~(uint32_t)pins);
+    host_exti_pending |= (before ^ port->IDR) & hostExtiLines;
+}
+
+extern "C" void HAL_PWR_EnableBkUpAccess(void) {
+}
+
+/* ---------------- ADC3 注入组 ---------------- */
+
+extern "C" uint32_t HAL_ADCEx_InjectedGetValue(ADC_HandleTypeDef* hadc, uint32_t rank) {
+    return rank < 2 ? hadc->injected[rank] : 0;
+}
+
+extern "C" HAL_StatusTypeDef HAL_ADCEx_InjectedStart(ADC_HandleTypeDef* hadc) {
+    (void)hadc;
+    return HAL_OK;
+}
+
+void hostSetTemperature(float celsius) {
+    const float raw = (float)host_ts_cal[0] + (celsius - (float)TEMPSENSOR_CAL1_TEMP)
+        * (float)(host_ts_cal[1] - host_ts_cal[0]) / (float)(TEMPSENSOR_CAL2_TEMP - TEMPSENSOR_CAL1_TEMP);
+    hadc3.injected[0] = (uint32_t)(raw + 0.5f);
+    hadc3.injected[1] = host_vrefint_cal;
+    hadc3.flags |= ADC_FLAG_JEOC | ADC_FLAG_JEOS;
+}
+
+/* ---------------- TinyUSB 设备栈替身 ---------------- */
+
+static HostUSBStats usbStats;
+static bool hidReady = true;
+
+HostUSBStats& hostUSBStats() {
+    return usbStats;
+}
+
+void hostUSBReset() {
+    memset(&usbStats, 0, sizeof(usbStats));
+    hidReady = true;
+}
+
+void hostUSBSetHIDReady(bool ready) {
+    hidReady = ready;
+}
+
+extern "C" bool tud_mounted(void) {
+    return true;
+}
+
+extern "C" bool tud_suspended(void) {
+    return false;
+}
+
+extern "C" bool tud_remote_wakeup(void) {
+    return false;
+}
+
+extern "C" void tud_task(void) {
+}
+
+extern "C" bool tud_hid_n_ready(uint8_t instance) {
+    (void)instance;
+    return hidReady;
+}
+
+extern "C" bool tud_hid_n_report(uint8_t instance, uint8_t report_id, void const* report, uint16_t len) {
+    (void)instance;
+    (void)report_id;
+    if(!hidReady || len > HOST_USB_REPORT_MAX) {
+        usbStats.rejected++;
+        return false;
+    }
+    usbStats.reports++;
+    usbStats.lastCycles = host_dwt.CYCCNT;
+    usbStats.lastLength = len;
+    memcpy(usbStats.lastReport, report, len);
+    return true;
+}
+
+extern "C" void hidd_init(void) {
+}
+
+extern "C" bool hidd_deinit(void) {
+    return true;
+}
+
+extern "C" void hidd_reset(uint8_t rhport) {
+    (void)rhport;
+}
+
+extern "C" uint16_t hidd_open(uint8_t rhport, tusb_desc_interface_t const* itf_desc, uint16_t max_len) {
+    (void)rhport;
+    (void)itf_desc;
+    (void)max_len;
+    return 0;
+}
+
+extern "C" bool hidd_control_xfer_cb(uint8_t rhport, uint8_t stage, tusb_control_request_t const* request) {
+    (void)rhport;
+    (void)stage;
+    (void)request;
+    return false;
+}
+
+extern "C" bool hidd_xfer_cb(uint8_t rhport, uint8_t ep_addr, xfer_result_t event, uint32_t xferred_bytes) {
+    (void)rhport;
+    (void)ep_addr;
+    (void)event;
+    (void)xferred_bytes;
+    return true;
+}
+
+/* ---------------- QSPI Flash 内存模型 ---------------- */
+
+static std::vector<uint8_t> flashData(HOST_FLASH_SIZE, 0xFF);
+static HostFlashStats flashStats;
+static int32_t programBudget = -1;
+static bool poweredOff = false;
+static int32_t pendingEraseSector = -1;
+static uint32_t pendingErasePolls = 0;
+static uint32_t erasePolls = 0;
+
+uint8_t* hostFlashData() {
+    return flashData.data();
+}
+
+HostFlashStats& hostFlashStats() {
+    return flashStats;
+}
+
+void hostFlashReset(uint8_t fill) {
+    memset(flashData.data(), fill, flashData.size());
+    memset(&flashStats, 0, sizeof(flashStats));
+    programBudget = -1;
+    poweredOff = false;
+    pendingEraseSector = -1;
+}
+
+void hostFlashSetProgramBudget(int32_t bytes) {
+    programBudget = bytes;
+}
+
+bool hostFlashPoweredOff() {
+    return poweredOff;
+}
+
+void hostFlashPowerOn() {
+    poweredOff = false;
+    programBudget = -1;
+    pendingEraseSector = -1;
+}
+
+void hostFlashSetErasePolls(uint32_t polls) {
+    erasePolls = polls;
+}
+
+static inline uint32_t flashOffset(uint32_t address) {
+    return address & 0x00FFFFFF;
+}
+
+// 掉电注入打开且预算不足一页时，擦除被掉电打断：扇区内随机一部分字节已经变成 0xFF
+static bool eraseInterrupted(uint32_t sector) {
+    if(programBudget < 0 || programBudget >= 256) {
+        return false;
+    }
+    uint8_t* const data = &flashData[sector * W25Qxx_SECTOR_SIZE];
+    for(uint32_t i = 0; i < W25Qxx_SECTOR_SIZE; i++) {
+        if(rand() & 1) {
+            data[i] = 0xFF;
+        }
+    }
+    poweredOff = true;
+    return true;
+}
+
+static void completeErase(uint32_t sector) {
+    memset(&flashData[sector * W25Qxx_SECTOR_SIZE], 0xFF, W25Qxx_SECTOR_SIZE);
+    flashStats.erases[sector]++;
+    flashStats.totalErases++;
+}
+
+static int8_t waitPendingErase() {
+    if(pendingEraseSector >= 0) {
+        completeErase((uint32_t)pendingEraseSector);
+        pendingEraseSector = -1;
+    }
+    return QSPI_W25Qxx_OK;
+}
+
+extern "C" int8_t QSPI_W25Qxx_ReadBuffer_WithXIPOrNot(uint8_t* pBuffer, uint32_t ReadAddr, uint32_t NumByteToRead) {
+    if(poweredOff) {
+        return W25Qxx_ERROR_TRANSMIT;
+    }
+    waitPendingErase();
+    const uint32_t offset = flashOffset(ReadAddr);
+    if(offset + NumByteToRead > HOST_FLASH_SIZE) {
+        return W25Qxx_ERROR_TRANSMIT;
+    }
+    memcpy(pBuffer, &flashData[offset], NumByteToRead);
+    flashStats.readBytes += NumByteToRead;
+    return QSPI_W25Qxx_OK;
+}
+
+// NOR Flash 编程只能把 1 写成 0
+extern "C" int8_t QSPI_W25Qxx_ProgramBuffer_WithXIPOrNot(uint8_t* pData, uint32_t WriteAddr, uint32_t NumByteToWrite) {
+    if(poweredOff) {
+        return W25Qxx_ERROR_TRANSMIT;
+    }
+    waitPendingErase();
+    const uint32_t offset = flashOffset(WriteAddr);
+    if(offset + NumByteToWrite > HOST_FLASH_SIZE) {
+        return W25Qxx_ERROR_TRANSMIT;
+    }
+    for(uint32_t i = 0; i < NumByteToWrite; i++) {
+        if(programBudget == 0) {
+            poweredOff = true;
+            return W25Qxx_ERROR_TRANSMIT;
+        }
+        if(programBudget > 0) {
+            programBudget--;
+        }
+        flashData[offset + i] &= pData[i];
+        flashStats.programmedBytes++;
+    }
+    return QSPI_W25Qxx_OK;
+}
+
+extern "C" int8_t QSPI_W25Qxx_SectorErase_WithXIPOrNot(uint32_t SectorAddress) {
+    if(poweredOff) {
+        return W25Qxx_ERROR_Erase;
+    }
+    waitPendingErase();
+    const uint32_t sector = flashOffset(SectorAddress) / W25Qxx_SECTOR_SIZE;
+    if(sector >= HOST_FLASH_SECTORS) {
+        return W25Qxx_ERROR_Erase;
+    }
+    if(eraseInterrupted(sector)) {
+        return W25Qxx_ERROR_Erase;
+    }
+    completeErase(sector);
+    return QSPI_W25Qxx_OK;
+}
+
+extern "C" int8_t QSPI_W25Qxx_SectorEraseStart_WithXIPOrNot(uint32_t SectorAddress) {
+    if(poweredOff) {
+        return W25Qxx_ERROR_Erase;
+    }
+    waitPendingErase();
+    const uint32_t sector = flashOffset(SectorAddress) / W25Qxx_SECTOR_SIZE;
+    if(sector >= HOST_FLASH_SECTORS) {
+        return W25Qxx_ERROR_Erase;
+    }
+    if(eraseInterrupted(sector)) {
+        return W25Qxx_ERROR_Erase;
+    }
+    pendingEraseSector = (int32_t)sector;
+    pendingErasePolls = erasePolls;
+    return QSPI_W25Qxx_OK;
+}
+
+extern "C" int8_t QSPI_W25Qxx_PollEraseDone(void) {
+    if(poweredOff) {
+        return W25Qxx_ERROR_TRANSMIT;
+    }
+    if(pendingEraseSector < 0) {
+        return QSPI_W25Qxx_OK;
+    }
+    if(pendingErasePolls > 0) {
+        pendingErasePolls--;
+        return 1;
+    }
+    return waitPendingErase();
+}
+
+extern "C" int8_t QSPI_W25Qxx_WaitEraseDone(void) {
+    return waitPendingErase();
+}
+
+extern "C" int8_t QSPI_W25Qxx_WriteBuffer_WithXIPOrNot(uint8_t* pData, uint32_t WriteAddr, uint32_t NumByteToWrite) {
+    const uint32_t offset = flashOffset(WriteAddr);
+    const uint32_t first = offset / W25Qxx_SECTOR_SIZE;
+    const uint32_t last = (offset + NumByteToWrite - 1) / W25Qxx_SECTOR_SIZE;
+    for(uint32_t sector = first; sector <= last; sector++) {
+        const int8_t result = QSPI_W25Qxx_SectorErase_WithXIPOrNot(sector * W25Qxx_SECTOR_SIZE);
+        if(result != QSPI_W25Qxx_OK) {
+            return result;
+        }
+    }
+    return QSPI_W25Qxx_ProgramBuffer_WithXIPOrNot(pData, WriteAddr, NumByteToWrite);
+}
+
+extern "C" int8_t QSPI_W25Qxx_BufferErase(uint32_t StartAddr, uint32_t Size) {
+    const uint32_t offset = flashOffset(StartAddr);
+    for(uint32_t address = offset & ~(W25Qxx_SECTOR_SIZE - 1); address < offset + Size; address += W25Qxx_SECTOR_SIZE) {
+        const int8_t result = QSPI_W25Qxx_SectorErase_WithXIPOrNot(address);
+        if(result != QSPI_W25Qxx_OK) {
+            return result;
+        }
+    }
+    return QSPI_W25Qxx_OK;
+}
@@ -0,0 +1,118 @@
+#ifndef __HOST_HAL_HPP__
+#define __HOST_HAL_HPP__
+
+/*
+ * 主机测试环境
+ *
+ * stubs/ 下的头文件替换 HAL/CMSIS，固件源码不做修改直接在主机上编译：
+ * - DWT->CYCCNT 和 HAL_GetTick() 不会自己走，由测试推进，所有时间相关逻辑都可以精确复现；
+ * - GPIO 输入由测试通过 hostSetGPIOInput 改变，边沿中断引脚的电平变化置位EXTI挂起标志；
+ * - QSPI Flash 是 8MB 的内存模型，写入只能把 1 变成 0，擦除按扇区计数，可以注入掉电；
+ * - ADCManager 用 host_adc_manager.cpp 替换，测试按 virtualPin 顺序推入ADC帧；
+ * - TinyUSB 由 stubs/tusb.h 替换，tud_hid_report 记录发出的报告，端点忙由测试控制。
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "board_cfg.h"
+#include "stm32h7xx_hal.h"
+
+#define HOST_FLASH_SIZE         (8 * 1024 * 1024)
+#define HOST_FLASH_SECTORS      (HOST_FLASH_SIZE / 4096)
+
+/* ---------------- 时间 ---------------- */
+
+void hostSetCycles(uint32_t cycles);
+void hostAdvanceCycles(uint32_t cycles);
+void hostAdvanceMicros(uint32_t us);
+void hostSetTick(uint32_t ms);
+void hostAdvanceTick(uint32_t ms);
+
+/* ---------------- GPIO ---------------- */
+
+/**
+ * 改变输入引脚电平，配置为边沿中断（GPIO_MODE_IT_RISING_FALLING）的引脚电平变化时置位EXTI挂起标志
+ * 中断不会自动进入，测试在需要的时刻调用中断处理函数
+ * @param port 端口
+ * @param pins 引脚掩码 GPIO_PIN_x
+ * @param high 高电平
+ */
+void hostSetGPIOInput(GPIO_TypeDef* port, uint16_t pins, bool high);
+
+/* ---------------- ADC ---------------- */
+
+/**
+ * 发布一帧ADC采样，相当于三个ADC的DMA传输完成中断都已经触发
+ * @param values 按virtualPin排序的ADC值，长度 NUM_ADC_BUTTONS
+ */
+void hostPushADCFrame(const uint32_t* values);
+
+/**
+ * 安装一个映射并设为默认映射，所有按键使用同一个映射
+ * @param values 原始映射值，values[0] 为完全按下，values[length - 1] 为完全释放
+ * @param length 映射长度
+ * @param step 步长（mm）
+ * @param samplingNoise 采样噪声
+ * @return 是否成功
+ */
+bool hostInstallADCMapping(const uint32_t* values, size_t length, float step, uint16_t samplingNoise);
+
+/**
+ * 写入一次温度传感器注入转换结果，下一次 sampleTemperature() 读取
+ * @param celsius 温度（℃），按 host_ts_cal 的出厂校准值换算为原始值
+ */
+void hostSetTemperature(float celsius);
+
+/* ---------------- USB HID ---------------- */
+
+#define HOST_USB_REPORT_MAX     64
+
+struct HostUSBStats {
+    uint32_t reports;                               // tud_hid_report 接受的报告数
+    uint32_t rejected;                              // 端点忙时被拒绝的报告数
+    uint32_t lastCycles;                            // 最后一份报告被接受时的DWT周期
+    uint16_t lastLength;
+    uint8_t lastReport[HOST_USB_REPORT_MAX];
+};
+
+HostUSBStats& hostUSBStats();
+
+/**
+ * 清空报告记录，端点恢复空闲
+ */
+void hostUSBReset();
+
+/**
+ * 设置 HID 端点是否空闲：忙时 tud_hid_ready() 返回 false，tud_hid_report() 拒绝报告
+ * 相当于主机还没有取走上一份报告
+ */
+void hostUSBSetHIDReady(bool ready);
+
+/* ---------------- QSPI Flash ---------------- */
+
+struct HostFlashStats {
+    uint32_t erases[HOST_FLASH_SECTORS];   // 每个扇区的擦除次数
+    uint32_t totalErases;
+    uint32_t programmedBytes;
+    uint32_t readBytes;
+};
+
+uint8_t* hostFlashData();
+HostFlashStats& hostFlashStats();
+void hostFlashReset(uint8_t fill = 0xFF);
+
+/**
+ * 掉电注入：再写入 bytes 个字节后掉电，之后所有操作失败直到 hostFlashPowerOn()
+ * 掉电时正在擦除的扇区只有随机一部分字节被擦除
+ * @param bytes 剩余可写入字节数，-1 关闭
+ */
+void hostFlashSetProgramBudget(int32_t bytes);
+bool hostFlashPoweredOff();
+void hostFlashPowerOn();
+
+/**
+ * 非阻塞擦除完成前 QSPI_W25Qxx_PollEraseDone() 返回忙的次数
+ */
+void hostFlashSetErasePolls(uint32_t polls);
+
+#endif // __HOST_HAL_HPP__
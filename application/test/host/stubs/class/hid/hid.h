@@ -0,0 +1,3 @@
+#pragma once
+// 主机测试：HID 类型和函数都在 stubs/tusb.h 中
+#include "tusb.h"
@@ -0,0 +1,3 @@
+#pragma once
+// 主机测试：usbd_class_driver_t 在 stubs/tusb.h 中
+#include "tusb.h"
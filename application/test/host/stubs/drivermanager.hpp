@@ -0,0 +1,20 @@
+#pragma once
+/*
+ * 主机测试用的 DriverManager 替身：GamepadState 只用它取摇杆中点，
+ * 没有驱动时 getDriver() 返回 nullptr，与固件未初始化驱动时一致；
+ * 测试驱动真实的输入驱动（TinyUSB 由 stubs/tusb.h 替换）时用 setDriver 设置
+ */
+#include <stdint.h>
+#include "gpdriver.hpp"
+
+class DriverManager {
+    public:
+        static DriverManager& getInstance() {
+            static DriverManager instance;
+            return instance;
+        }
+        GPDriver* getDriver() { return driver; }
+        void setDriver(GPDriver* driver) { this->driver = driver; }
+    private:
+        GPDriver* driver = nullptr;
+};
@@ -0,0 +1,3 @@
+#pragma once
+// 主机测试：Cpp_Core/Inc/tusb_config.h 只用 lwIP 配置计算 NCM 缓冲区大小，主机测试不编译网络部分
+#define TCP_MSS     1460
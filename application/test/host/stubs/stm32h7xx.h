@@ -0,0 +1,2 @@
+#pragma once
+#include "stm32h7xx_hal.h"
@@ -0,0 +1,176 @@
+#ifndef __HOST_STM32H7XX_HAL_H__
+#define __HOST_STM32H7XX_HAL_H__
+
+/*
+ * 主机测试用的 HAL/CMSIS 替身：只提供 Cpp_Core 按键扫描相关代码用到的类型和函数，
+ * DWT->CYCCNT 和 HAL_GetTick() 由测试通过 host_hal.hpp 控制
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define __IO volatile
+
+typedef enum {
+    HAL_OK       = 0x00U,
+    HAL_ERROR    = 0x01U,
+    HAL_BUSY     = 0x02U,
+    HAL_TIMEOUT  = 0x03U
+} HAL_StatusTypeDef;
+
+typedef enum {
+    GPIO_PIN_RESET = 0U,
+    GPIO_PIN_SET
+} GPIO_PinState;
+
+typedef struct {
+    __IO uint32_t CTRL;
+    __IO uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct {
+    __IO uint32_t DEMCR;
+} CoreDebug_Type;
+
+#define DWT_CTRL_CYCCNTENA_Msk          (1UL)
+#define CoreDebug_DEMCR_TRCENA_Msk      (1UL << 24)
+
+typedef struct {
+    __IO uint32_t IDR;
+    __IO uint32_t ODR;
+    __IO uint32_t BSRR;
+} GPIO_TypeDef;
+
+typedef struct { void* Instance; uint32_t flags; uint32_t injected[2]; } ADC_HandleTypeDef;
+typedef struct { uint32_t Instance; } DMA_HandleTypeDef;
+typedef struct { uint32_t Instance; } TIM_HandleTypeDef;
+typedef struct { uint32_t Instance; } UART_HandleTypeDef;
+typedef struct { uint32_t Instance; } QSPI_HandleTypeDef;
+
+extern DWT_Type host_dwt;
+extern CoreDebug_Type host_core_debug;
+#define DWT (&host_dwt)
+#define CoreDebug (&host_core_debug)
+
+// 备份SRAM：LatencyTrace/PerfTrace 直接按地址访问
+extern uint8_t host_bkpsram[4096];
+#define D3_BKPSRAM_BASE ((uintptr_t)host_bkpsram)
+#define __HAL_RCC_BKPRAM_CLK_ENABLE() ((void)0)
+void HAL_PWR_EnableBkUpAccess(void);
+
+// ADC3 注入组：温度传感器和 VREFINT，由测试写入 hadc3.injected 并置位 ADC_FLAG_JEOS
+#define ADC_FLAG_JEOC                   (1UL << 5)
+#define ADC_FLAG_JEOS                   (1UL << 6)
+#define ADC_INJECTED_RANK_1             (0UL)
+#define ADC_INJECTED_RANK_2             (1UL)
+#define __HAL_ADC_GET_FLAG(h, f)        ((((h)->flags) & (f)) == (f))
+#define __HAL_ADC_CLEAR_FLAG(h, f)      ((h)->flags &= ~(uint32_t)(f))
+uint32_t HAL_ADCEx_InjectedGetValue(ADC_HandleTypeDef* hadc, uint32_t rank);
+HAL_StatusTypeDef HAL_ADCEx_InjectedStart(ADC_HandleTypeDef* hadc);
+
+extern uint16_t host_ts_cal[2];
+extern uint16_t host_vrefint_cal;
+#define TEMPSENSOR_CAL1_ADDR            (&host_ts_cal[0])
+#define TEMPSENSOR_CAL2_ADDR            (&host_ts_cal[1])
+#define TEMPSENSOR_CAL1_TEMP            (30L)
+#define TEMPSENSOR_CAL2_TEMP            (110L)
+#define TEMPSENSOR_CAL_VREFANALOG       (3300UL)
+#define VREFINT_CAL_ADDR                (&host_vrefint_cal)
+#define VREFINT_CAL_VREF                (3300UL)
+
+extern ADC_HandleTypeDef hadc1;
+extern ADC_HandleTypeDef hadc2;
+extern ADC_HandleTypeDef hadc3;
+
+extern GPIO_TypeDef host_gpio[11];
+#define GPIOA (&host_gpio[0])
+#define GPIOB (&host_gpio[1])
+#define GPIOC (&host_gpio[2])
+#define GPIOD (&host_gpio[3])
+#define GPIOE (&host_gpio[4])
+#define GPIOF (&host_gpio[5])
+#define GPIOG (&host_gpio[6])
+#define GPIOH (&host_gpio[7])
+#define GPIOI (&host_gpio[8])
+#define GPIOJ (&host_gpio[9])
+#define GPIOK (&host_gpio[10])
+
+#define GPIO_PIN_0   ((uint16_t)0x0001)
+#define GPIO_PIN_1   ((uint16_t)0x0002)
+#define GPIO_PIN_2   ((uint16_t)0x0004)
+#define GPIO_PIN_3   ((uint16_t)0x0008)
+#define GPIO_PIN_4   ((uint16_t)0x0010)
+#define GPIO_PIN_5   ((uint16_t)0x0020)
+#define GPIO_PIN_6   ((uint16_t)0x0040)
+#define GPIO_PIN_7   ((uint16_t)0x0080)
+#define GPIO_PIN_8   ((uint16_t)0x0100)
+#define GPIO_PIN_9   ((uint16_t)0x0200)
+#define GPIO_PIN_10  ((uint16_t)0x0400)
+#define GPIO_PIN_11  ((uint16_t)0x0800)
+#define GPIO_PIN_12  ((uint16_t)0x1000)
+#define GPIO_PIN_13  ((uint16_t)0x2000)
+#define GPIO_PIN_14  ((uint16_t)0x4000)
+#define GPIO_PIN_15  ((uint16_t)0x8000)
+
+// GPIO 初始化和 EXTI：HAL_GPIO_Init 记录配置为边沿中断的引脚，hostSetGPIOInput 改变这些引脚时置位挂起标志
+typedef struct {
+    uint32_t Pin;
+    uint32_t Mode;
+    uint32_t Pull;
+    uint32_t Speed;
+    uint32_t Alternate;
+} GPIO_InitTypeDef;
+
+#define GPIO_MODE_INPUT                 (0x00000000UL)
+#define GPIO_MODE_IT_RISING_FALLING     (0x10310000UL)
+#define GPIO_NOPULL                     (0x00000000UL)
+#define GPIO_PULLUP                     (0x00000001UL)
+#define GPIO_PULLDOWN                   (0x00000002UL)
+#define GPIO_SPEED_FREQ_VERY_HIGH       (0x00000003UL)
+
+typedef enum {
+    EXTI0_IRQn      = 6,
+    EXTI1_IRQn      = 7,
+    EXTI2_IRQn      = 8,
+    EXTI3_IRQn      = 9,
+    EXTI4_IRQn      = 10,
+    EXTI9_5_IRQn    = 23,
+    EXTI15_10_IRQn  = 40
+} IRQn_Type;
+
+extern uint32_t host_exti_pending;
+#define __HAL_GPIO_EXTI_GET_IT(line)    (host_exti_pending & (line))
+#define __HAL_GPIO_EXTI_CLEAR_IT(line)  (host_exti_pending &= ~(uint32_t)(line))
+
+void HAL_GPIO_Init(GPIO_TypeDef* port, GPIO_InitTypeDef* init);
+static inline void HAL_NVIC_SetPriority(IRQn_Type irq, uint32_t preempt, uint32_t sub) { (void)irq; (void)preempt; (void)sub; }
+static inline void HAL_NVIC_EnableIRQ(IRQn_Type irq) { (void)irq; }
+
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t delay);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef* port, uint16_t pin);
+
+static inline void SCB_CleanInvalidateDCache_by_Addr(void* addr, int32_t size) { (void)addr; (void)size; }
+static inline void SCB_InvalidateDCache_by_Addr(void* addr, int32_t size) { (void)addr; (void)size; }
+static inline void SCB_CleanDCache_by_Addr(void* addr, int32_t size) { (void)addr; (void)size; }
+static inline void __disable_irq(void) {}
+static inline void __enable_irq(void) {}
+static inline uint32_t __get_PRIMASK(void) { return 0; }
+static inline void __set_PRIMASK(uint32_t mask) { (void)mask; }
+static inline void __DSB(void) {}
+static inline void __DMB(void) {}
+static inline void __ISB(void) {}
+static inline void __NOP(void) {}
+static inline uint32_t __CLZ(uint32_t value) { return value == 0 ? 32 : (uint32_t)__builtin_clz(value); }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __HOST_STM32H7XX_HAL_H__
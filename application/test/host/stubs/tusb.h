@@ -0,0 +1,95 @@
+#ifndef __HOST_TUSB_H__
+#define __HOST_TUSB_H__
+
+/*
+ * 主机测试用的 TinyUSB 替身：只提供输入驱动（GPDriver）用到的类型和设备栈函数，
+ * 签名与 Libs/tinyusb 一致。tud_hid_report 把报告记录到 host_hal.cpp，
+ * 端点是否空闲由测试通过 hostUSBSetHIDReady 控制；其余函数为空实现。
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "tusb_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    HID_REPORT_TYPE_INVALID = 0,
+    HID_REPORT_TYPE_INPUT,
+    HID_REPORT_TYPE_OUTPUT,
+    HID_REPORT_TYPE_FEATURE
+} hid_report_type_t;
+
+typedef enum {
+    XFER_RESULT_SUCCESS = 0,
+    XFER_RESULT_FAILED,
+    XFER_RESULT_STALLED,
+    XFER_RESULT_TIMEOUT,
+    XFER_RESULT_INVALID
+} xfer_result_t;
+
+typedef struct __attribute__((packed)) {
+    uint8_t bmRequestType;
+    uint8_t bRequest;
+    uint16_t wValue;
+    uint16_t wIndex;
+    uint16_t wLength;
+} tusb_control_request_t;
+
+typedef struct __attribute__((packed)) {
+    uint8_t bLength;
+    uint8_t bDescriptorType;
+    uint8_t bInterfaceNumber;
+    uint8_t bAlternateSetting;
+    uint8_t bNumEndpoints;
+    uint8_t bInterfaceClass;
+    uint8_t bInterfaceSubClass;
+    uint8_t bInterfaceProtocol;
+    uint8_t iInterface;
+} tusb_desc_interface_t;
+
+typedef struct {
+    char const* name;
+    void     (* init             ) (void);
+    bool     (* deinit           ) (void);
+    void     (* reset            ) (uint8_t rhport);
+    uint16_t (* open             ) (uint8_t rhport, tusb_desc_interface_t const * desc_intf, uint16_t max_len);
+    bool     (* control_xfer_cb  ) (uint8_t rhport, uint8_t stage, tusb_control_request_t const * request);
+    bool     (* xfer_cb          ) (uint8_t rhport, uint8_t ep_addr, xfer_result_t result, uint32_t xferred_bytes);
+    void     (* sof              ) (uint8_t rhport, uint32_t frame_count);
+} usbd_class_driver_t;
+
+/* 设备栈 */
+bool tud_mounted(void);
+bool tud_suspended(void);
+bool tud_remote_wakeup(void);
+void tud_task(void);
+
+/* HID 设备类 */
+bool tud_hid_n_ready(uint8_t instance);
+bool tud_hid_n_report(uint8_t instance, uint8_t report_id, void const* report, uint16_t len);
+
+static inline bool tud_hid_ready(void) {
+    return tud_hid_n_ready(0);
+}
+
+static inline bool tud_hid_report(uint8_t report_id, void const* report, uint16_t len) {
+    return tud_hid_n_report(0, report_id, report, len);
+}
+
+void     hidd_init            (void);
+bool     hidd_deinit          (void);
+void     hidd_reset           (uint8_t rhport);
+uint16_t hidd_open            (uint8_t rhport, tusb_desc_interface_t const * itf_desc, uint16_t max_len);
+bool     hidd_control_xfer_cb (uint8_t rhport, uint8_t stage, tusb_control_request_t const * request);
+bool     hidd_xfer_cb         (uint8_t rhport, uint8_t ep_addr, xfer_result_t event, uint32_t xferred_bytes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __HOST_TUSB_H__
@@ -0,0 +1,6 @@
+#pragma once
+// Core/Inc/utils.h 声明的 abort() 与主机 C++ 标准库冲突，包含时改名
+#include <stdlib.h>
+#define abort host_utils_abort
+#include_next "utils.h"
+#undef abort
@@ -0,0 +1,248 @@
+/*
+ * ADC按钮防抖
+ *
+ * 位切片防抖与逐个按键的原始状态机逐次等价：
+ * 参考模型是位切片之前 ADCDebounceFilter::filterUltraFastSingle 的逐按键实现，
+ * 对阈值 0/1/2/3/15/30 用随机的输入和参与掩码驱动两者，比较每次的输出以及每个按键的
+ * 最后输入、稳定状态和计数器（getDetailedDebounceState）。
+ *
+ * 自适应防抖（filterAdaptive）：
+ * - 孤立的噪声尖峰之间按键不再是候选时计时作废，第二个尖峰不会被确认；持续的候选跨过 CYCCNT 回绕按确认时间确认；
+ * - 通过 ADCBtnsWorker 驱动：静止时来回跳动的噪声使确认时间变长，平稳的按下/释放行程不计入噪声。
+ */
+
+#include <stdio.h>
+#include <random>
+#include "host_check.hpp"
+#include "host_hal.hpp"
+#include "adc_btns/adc_debounce_filter.hpp"
+#include "adc_btns/adc_btns_worker.hpp"
+#include "storagemanager.hpp"
+
+#define ITERATIONS 300000
+#define CYCLES_PER_US       ADC_DEBOUNCE_CYCLES_PER_US
+
+// 位切片之前的逐按键状态机
+struct ReferenceButton {
+    bool lastStableValue = false;
+    bool lastInputValue = false;
+    uint8_t sameValueCounter = 0;
+
+    bool filterUltraFastSingle(const uint8_t threshold, const bool currentState) {
+        if (currentState == lastInputValue) {
+            if (sameValueCounter < threshold) {
+                sameValueCounter++;
+            }
+            if (sameValueCounter >= threshold && currentState != lastStableValue) {
+                lastStableValue = currentState;
+            }
+        } else {
+            lastInputValue = currentState;
+            sameValueCounter = 1;
+        }
+        return lastStableValue == currentState;
+    }
+};
+
+static uint32_t compareStates(const ADCDebounceFilter& filter, const ReferenceButton* reference) {
+    uint32_t mismatches = 0;
+    for(uint8_t i = 0; i < NUM_ADC_BUTTONS; i++) {
+        bool lastInput, stableValue;
+        uint8_t counter;
+        filter.getDetailedDebounceState(i, lastInput, stableValue, counter);
+        if(lastInput != reference[i].lastInputValue || stableValue != reference[i].lastStableValue
+            || counter != reference[i].sameValueCounter || filter.getButtonDebounceState(i) != counter) {
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+static void testBitSlicedEquivalence() {
+    const uint32_t allButtons = (1U << NUM_ADC_BUTTONS) - 1;
+    const uint8_t thresholds[] = { 0, 1, 2, 3, 15, 30 };
+    std::mt19937 rng(5);
+
+    for(const uint8_t threshold : thresholds) {
+        ADCDebounceFilter::Config config;
+        config.ultrafastThreshold = threshold;
+        ADCDebounceFilter filter(config);
+        ReferenceButton reference[NUM_ADC_BUTTONS];
+        uint32_t outputMismatches = 0;
+        uint32_t stateMismatches = 0;
+        uint32_t confirmedChanges = 0;
+
+        for(uint32_t it = 0; it < ITERATIONS; it++) {
+            // 所有按键一起长时间按下/释放，抖动阶段四分之一的扫描是随机输入；参与掩码随机
+            const bool noisy = (it / 2000) % 2 == 0;
+            const uint32_t steady = (it / 200) % 2 ? allButtons : 0;
+            const uint32_t input = (noisy && rng() % 4 == 0) ? rng() & allButtons : steady;
+            const bool wholeMask = rng() % 8 == 0;
+            const uint32_t active = wholeMask ? allButtons : (rng() & rng() & allButtons);
+
+            // 偶尔单独重置一个按键
+            if(rng() % 1000 == 0) {
+                const uint8_t button = rng() % NUM_ADC_BUTTONS;
+                filter.resetButton(button);
+                reference[button] = ReferenceButton();
+            }
+
+            uint32_t expected = 0;
+            for(uint8_t i = 0; i < NUM_ADC_BUTTONS; i++) {
+                if(active & (1U << i)) {
+                    const bool before = reference[i].lastStableValue;
+                    if(reference[i].filterUltraFastSingle(threshold, (input >> i) & 1)) {
+                        expected |= 1U << i;
+                    }
+                    confirmedChanges += before != reference[i].lastStableValue;
+                }
+            }
+
+            const uint32_t result = wholeMask ? filter.filterMask(input, 0) : filter.filter(input, active);
+            if(result != expected) {
+                if(outputMismatches < 5) {
+                    printf("threshold %u iteration %u: got 0x%05x, expect 0x%05x\n", threshold, it, result, expected);
+                }
+                outputMismatches++;
+            }
+            stateMismatches += compareStates(filter, reference);
+        }
+
+        printf("threshold %2u: %u confirmed changes, %u output mismatches, %u state mismatches\n",
+            threshold, confirmedChanges, outputMismatches, stateMismatches);
+        CHECK(confirmedChanges > 0);
+        CHECK_EQ(outputMismatches, 0);
+        CHECK_EQ(stateMismatches, 0);
+    }
+}
+
+static void testAdaptiveStaleTimer() {
+    const uint32_t window = 200 * CYCLES_PER_US;
+    ADCDebounceFilter::Config config;
+    config.adaptive = true;
+    ADCDebounceFilter filter(config);
+    filter.setButtonWindow(0, window);
+
+    // 孤立的尖峰：中间按键不是候选，第二个尖峰在第一个之后超过确认时间也不能确认
+    uint32_t now = 1000;
+    CHECK_EQ(filter.filterAdaptive(1U << 0, 1U << 0, now), 0);
+    for(uint32_t i = 0; i < 10; i++) {
+        now += 50 * CYCLES_PER_US;
+        CHECK_EQ(filter.filterAdaptive(0, 0, now), 0);
+    }
+    CHECK(now - 1000 > window);
+    now += 50 * CYCLES_PER_US;
+    CHECK_EQ(filter.filterAdaptive(1U << 0, 1U << 0, now), 0);
+    bool lastInput, stableValue;
+    uint8_t counter;
+    filter.getDetailedDebounceState(0, lastInput, stableValue, counter);
+    CHECK(!stableValue);
+
+    // 持续的候选从 CYCCNT 回绕前 100us 开始，恰好在确认时间后确认
+    filter.reset();
+    filter.setButtonWindow(0, window);
+    const uint32_t start = (uint32_t)0 - (uint32_t)(100 * CYCLES_PER_US);
+    uint32_t confirmedAt = 0;
+    for(uint32_t t = 0; t <= 300; t += 10) {
+        if(filter.filterAdaptive(1U << 0, 1U << 0, start + t * CYCLES_PER_US) && confirmedAt == 0) {
+            confirmedAt = t;
+        }
+    }
+    CHECK_EQ(confirmedAt, 200);
+}
+
+// ADCBtnsWorker 自适应防抖：按键 0 静止时噪声大，按键 1 平稳地反复按下释放，按键 2 静止且没有噪声
+#define MAPPING_LENGTH      36
+#define MAPPING_STEP        0.1f
+#define FRAME_US            100
+#define REST_VALUE          1000
+#define NOISE_AMPLITUDE     50      // 按键 0 在静止值上下跳动的幅度，不超过顶部死区
+#define PRESS_VALUE         1130    // 刚越过顶部死区（0.2mm）的ADC值
+
+static uint32_t frame[NUM_ADC_BUTTONS];
+
+static uint32_t scanFrame() {
+    hostPushADCFrame(frame);
+    const uint32_t mask = ADC_BTNS_WORKER.read();
+    hostAdvanceMicros(FRAME_US);
+    return mask;
+}
+
+static void testAdaptiveNoiseLevel() {
+    // 线性映射：完全释放 1000，完全按下 3000
+    uint32_t mapping[MAPPING_LENGTH];
+    for(uint32_t i = 0; i < MAPPING_LENGTH; i++) {
+        mapping[i] = REST_VALUE + 2000 * (MAPPING_LENGTH - 1 - i) / (MAPPING_LENGTH - 1);
+    }
+
+    hostFlashReset();
+    STORAGE_MANAGER.initConfig();
+    if(!hostInstallADCMapping(mapping, MAPPING_LENGTH, MAPPING_STEP, 0)
+        || ADC_BTNS_WORKER.setup() != ADCBtnsError::SUCCESS) {
+        printf("ADCBtnsWorker setup failed\n");
+        CHECK(false);
+        return;
+    }
+    ADCDebounceFilter::Config config;
+    config.ultrafastThreshold = ULTRAFast_THRESHOLD_NONE;
+    config.adaptive = true;
+    ADC_BTNS_WORKER.setDebounceConfig(config);
+
+    // 第一帧初始化映射
+    for(uint8_t i = 0; i < NUM_ADC_BUTTONS; i++) {
+        frame[i] = REST_VALUE;
+    }
+    CHECK_EQ(scanFrame(), 0);
+
+    uint32_t button1Presses = 0;
+    uint32_t lastMask = 0;
+    for(uint32_t it = 0; it < 960; it++) {
+        frame[0] = REST_VALUE + ((it & 1) ? NOISE_AMPLITUDE : -NOISE_AMPLITUDE);
+        // 按键 1：每次 10 个ADC值平稳下压到 2500，短暂停留后平稳回到静止值
+        const uint32_t phase = it % 320;
+        frame[1] = phase < 150 ? REST_VALUE + phase * 10
+                 : phase < 160 ? 2500
+                 : phase < 310 ? 2500 - (phase - 160) * 10
+                 : REST_VALUE;
+        const uint32_t mask = scanFrame();
+        button1Presses += (mask & ~lastMask & (1U << 1)) != 0;
+        lastMask = mask;
+        CHECK_EQ(mask & ((1U << 0) | (1U << 2)), 0);
+    }
+    CHECK_EQ(lastMask, 0);
+
+    const uint16_t noisyLevel = ADC_BTNS_WORKER.getButtonNoiseLevel(0);
+    const uint16_t motionLevel = ADC_BTNS_WORKER.getButtonNoiseLevel(1);
+    const uint16_t idleLevel = ADC_BTNS_WORKER.getButtonNoiseLevel(2);
+    printf("adaptive noise (Q4): noisy idle %u, clean motion %u (%u presses), clean idle %u\n",
+        noisyLevel, motionLevel, button1Presses, idleLevel);
+    CHECK(button1Presses >= 2);
+    CHECK(noisyLevel >= (NOISE_AMPLITUDE * 2 * 9 / 10) << 4);
+    CHECK(motionLevel < 1 << 3);
+    CHECK_EQ(idleLevel, 0);
+
+    // 三个按键同时刚越过触发点并保持：没有噪声的按键立即确认，噪声大的按键需要等待确认时间
+    frame[0] = frame[1] = frame[2] = PRESS_VALUE;
+    uint32_t confirmedScan[3] = { 0, 0, 0 };
+    for(uint32_t scan = 1; scan <= 10; scan++) {
+        const uint32_t mask = scanFrame();
+        for(uint8_t i = 0; i < 3; i++) {
+            if((mask & (1U << i)) && confirmedScan[i] == 0) {
+                confirmedScan[i] = scan;
+            }
+        }
+    }
+    printf("adaptive confirm scans: noisy idle %u, clean motion %u, clean idle %u\n",
+        confirmedScan[0], confirmedScan[1], confirmedScan[2]);
+    CHECK(confirmedScan[0] > 1);
+    CHECK_EQ(confirmedScan[1], 1);
+    CHECK_EQ(confirmedScan[2], 1);
+}
+
+int main() {
+    testBitSlicedEquivalence();
+    testAdaptiveStaleTimer();
+    testAdaptiveNoiseLevel();
+
+    return HOST_TEST_RESULT();
+}
@@ -0,0 +1,257 @@
+/*
+ * ADC校准值追加日志的掉电模拟
+ *
+ * 在 host_hal 的 Flash 内存模型上运行 ADCCalibrationJournal，映射存储用内存中的校准值表代替，
+ * 压缩与 ADCManager::saveStore 相同：先更新存储，再用新存储的CRC32清空日志。检查：
+ * - 掉电时只写入了一部分的最后一条记录回放时跳过，之前的记录都能回放，之后的追加写在它后面；
+ * - 记录内容损坏（包括旧的异或校验字节查不出的两处相同位翻转）时CRC32校验失败，只跳过这一条；
+ * - 扇区写满后追加失败，压缩后日志清空，旧存储CRC的日志被丢弃；
+ * - 随机追加 + 随机掉电（包括清空日志时擦除被打断），每次重新上电回放的校准值与写入成功的一致。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "host_check.hpp"
+#include "host_hal.hpp"
+#include "CRC32.hpp"
+#include "adc_btns/adc_calibration_journal.hpp"
+
+#define JOURNAL_ADDR        (ADC_VALUES_MAPPING_ADDR_STATIC + ADC_CALIBRATION_JOURNAL_OFFSET)
+#define HEADER_SIZE         16      // 日志头部：魔数、版本、基准CRC、头部CRC
+#define RECORD_CAPACITY     ((ADC_CALIBRATION_JOURNAL_SIZE - HEADER_SIZE) / sizeof(ADCCalibrationRecord))
+#define NUM_MAPPINGS        2
+#define ITERATIONS          20000
+
+// 校准值表：[映射][按钮][手动/自动] = 释放值 << 16 | 按下值
+typedef uint32_t CalibrationTable[NUM_MAPPINGS][NUM_ADC_BUTTONS][2];
+
+static CalibrationTable store;          // 映射存储（压缩时整体写入）
+static CalibrationTable replayed;       // 回放得到的校准值
+
+static uint32_t storeCrc() {
+    return CRC32::calculate((const uint8_t*)&store, sizeof(store));
+}
+
+static void onRecord(void* context, const ADCCalibrationRecord& record) {
+    CalibrationTable& table = *(CalibrationTable*)context;
+    if(record.mappingIndex < NUM_MAPPINGS) {
+        table[record.mappingIndex][record.buttonIndex][record.flags & ADC_CALIBRATION_RECORD_FLAG_AUTO]
+            = (uint32_t)record.topValue << 16 | record.bottomValue;
+    }
+}
+
+// 上电：从存储开始回放日志，日志无效时清空（与 ADCManager 构造函数相同）
+static bool powerUp(ADCCalibrationJournal& journal) {
+    memcpy(replayed, store, sizeof(store));
+    if(!journal.load(JOURNAL_ADDR, storeCrc(), onRecord, &replayed)) {
+        journal.reset(storeCrc());
+        return false;
+    }
+    return true;
+}
+
+static ADCCalibrationRecord makeRecord(const uint8_t mapping, const uint8_t button, const bool isAuto, const uint16_t top, const uint16_t bottom) {
+    ADCCalibrationRecord record;
+    memset(&record, 0, sizeof(record));
+    record.mappingIndex = mapping;
+    record.buttonIndex = button;
+    record.flags = isAuto ? ADC_CALIBRATION_RECORD_FLAG_AUTO : 0;
+    record.topValue = top;
+    record.bottomValue = bottom;
+    return record;
+}
+
+static ADCCalibrationRecord randomRecord() {
+    return makeRecord(rand() % NUM_MAPPINGS, rand() % NUM_ADC_BUTTONS, rand() & 1, 800 + rand() % 400, 2800 + rand() % 400);
+}
+
+static uint8_t* recordInFlash(const uint32_t index) {
+    return hostFlashData() + (JOURNAL_ADDR & 0x00FFFFFF) + HEADER_SIZE + index * sizeof(ADCCalibrationRecord);
+}
+
+static void testTornRecord() {
+    // 最后一条记录在每个字节处掉电
+    for(uint32_t written = 1; written < sizeof(ADCCalibrationRecord); written++) {
+        hostFlashReset();
+        memset(store, 0, sizeof(store));
+        ADCCalibrationJournal journal;
+        CHECK(!powerUp(journal));
+        CHECK_EQ(journal.append(makeRecord(0, 1, false, 1000, 3000)), QSPI_W25Qxx_OK);
+        CHECK_EQ(journal.append(makeRecord(0, 2, true, 1001, 3001)), QSPI_W25Qxx_OK);
+
+        hostFlashSetProgramBudget((int32_t)written);
+        CHECK(journal.append(makeRecord(0, 1, false, 1100, 3100)) != QSPI_W25Qxx_OK);
+        CHECK(hostFlashPoweredOff());
+        hostFlashPowerOn();
+
+        ADCCalibrationJournal rebooted;
+        CHECK(powerUp(rebooted));
+        CHECK_EQ(replayed[0][1][0], 1000U << 16 | 3000);
+        CHECK_EQ(replayed[0][2][1], 1001U << 16 | 3001);
+        CHECK_EQ(rebooted.getRecordCount(), 3);
+
+        // 新记录写在损坏的记录之后，下一次上电能回放
+        CHECK_EQ(rebooted.append(makeRecord(0, 1, false, 1200, 3200)), QSPI_W25Qxx_OK);
+        ADCCalibrationJournal again;
+        CHECK(powerUp(again));
+        CHECK_EQ(replayed[0][1][0], 1200U << 16 | 3200);
+        CHECK_EQ(again.getRecordCount(), 4);
+    }
+}
+
+static void testChecksumMismatch() {
+    hostFlashReset();
+    memset(store, 0, sizeof(store));
+    ADCCalibrationJournal journal;
+    powerUp(journal);
+    CHECK_EQ(journal.append(makeRecord(1, 0, false, 1001, 3001)), QSPI_W25Qxx_OK);
+    CHECK_EQ(journal.append(makeRecord(1, 1, false, 1003, 3003)), QSPI_W25Qxx_OK);
+    CHECK_EQ(journal.append(makeRecord(1, 2, false, 1005, 3005)), QSPI_W25Qxx_OK);
+
+    // 第二条记录的释放值和按下值最低位同时变成0：异或校验字节不变，CRC32不一致
+    ADCCalibrationRecord record;
+    memcpy(&record, recordInFlash(1), sizeof(record));
+    record.topValue &= ~1;
+    record.bottomValue &= ~1;
+    memcpy(recordInFlash(1), &record, sizeof(record));
+
+    ADCCalibrationJournal rebooted;
+    CHECK(powerUp(rebooted));
+    CHECK_EQ(replayed[1][0][0], 1001U << 16 | 3001);
+    CHECK_EQ(replayed[1][1][0], 0);
+    CHECK_EQ(replayed[1][2][0], 1005U << 16 | 3005);
+    CHECK_EQ(rebooted.getRecordCount(), 3);
+}
+
+static void testCompaction() {
+    hostFlashReset();
+    memset(store, 0, sizeof(store));
+    ADCCalibrationJournal journal;
+    powerUp(journal);
+    const uint32_t sector = (JOURNAL_ADDR & 0x00FFFFFF) / W25Qxx_SECTOR_SIZE;
+    const uint32_t erases = hostFlashStats().erases[sector];
+
+    // 写满扇区：追加失败，不擦除
+    uint32_t appended = 0;
+    while(!journal.isFull()) {
+        CHECK_EQ(journal.append(makeRecord(0, appended % NUM_ADC_BUTTONS, false, 1000 + appended, 3000)), QSPI_W25Qxx_OK);
+        appended++;
+    }
+    CHECK_EQ(appended, RECORD_CAPACITY);
+    CHECK_EQ(journal.getRecordCount(), RECORD_CAPACITY);
+    CHECK(journal.append(makeRecord(0, 0, false, 1, 1)) != QSPI_W25Qxx_OK);
+    CHECK_EQ(hostFlashStats().erases[sector], erases);
+
+    // 写满的日志仍然可以回放
+    ADCCalibrationJournal full;
+    CHECK(powerUp(full));
+    CHECK(full.isFull());
+    for(uint32_t i = appended - NUM_ADC_BUTTONS; i < appended; i++) {
+        CHECK_EQ(replayed[0][i % NUM_ADC_BUTTONS][0], (1000 + i) << 16 | 3000);
+    }
+
+    // 压缩：回放结果写入存储，用新存储的CRC清空日志
+    const uint32_t oldCrc = storeCrc();
+    memcpy(store, replayed, sizeof(store));
+    CHECK_EQ(full.reset(storeCrc()), QSPI_W25Qxx_OK);
+    CHECK_EQ(hostFlashStats().erases[sector], erases + 1);
+    CHECK_EQ(full.getRecordCount(), 0);
+    CHECK(!full.isFull());
+    CHECK_EQ(full.append(makeRecord(0, 0, true, 900, 2900)), QSPI_W25Qxx_OK);
+
+    // 旧存储对应的日志不回放
+    ADCCalibrationJournal stale;
+    CHECK(!stale.load(JOURNAL_ADDR, oldCrc, onRecord, &replayed));
+    ADCCalibrationJournal rebooted;
+    CHECK(powerUp(rebooted));
+    CHECK_EQ(rebooted.getRecordCount(), 1);
+    CHECK_EQ(replayed[0][0][1], 900U << 16 | 2900);
+    CHECK_EQ(replayed[0][NUM_ADC_BUTTONS - 1][0], store[0][NUM_ADC_BUTTONS - 1][0]);
+}
+
+static void testPowerLossReplay() {
+    hostFlashReset();
+    memset(store, 0, sizeof(store));
+    srand(3);
+
+    CalibrationTable expected;          // 追加成功的校准值
+    ADCCalibrationRecord uncertain;     // 掉电时正在追加的记录，写入可能完整也可能不完整
+    bool hasUncertain = false;
+    uint32_t powerLosses = 0;
+    uint32_t compactions = 0;
+    uint32_t mismatches = 0;
+
+    ADCCalibrationJournal* journal = new ADCCalibrationJournal();
+    powerUp(*journal);
+    memcpy(expected, store, sizeof(store));
+
+    for(uint32_t it = 0; it < ITERATIONS; it++) {
+        const bool powerLoss = rand() % 20 == 0;
+        if(powerLoss) {
+            hostFlashSetProgramBudget(rand() % (sizeof(ADCCalibrationRecord) + 1));
+        }
+
+        if(journal->isFull()) {
+            // 压缩：存储在日志清空之前已经是最新的，清空时掉电只会丢弃已经包含在存储中的记录
+            memcpy(store, expected, sizeof(store));
+            journal->reset(storeCrc());
+            compactions++;
+        } else {
+            const ADCCalibrationRecord record = randomRecord();
+            if(journal->append(record) == QSPI_W25Qxx_OK) {
+                onRecord(&expected, record);
+            } else {
+                uncertain = record;
+                hasUncertain = true;
+            }
+        }
+
+        if(!hostFlashPoweredOff()) {
+            hostFlashSetProgramBudget(-1);
+            if(!powerLoss) {
+                continue;
+            }
+        }
+
+        // 重新上电回放
+        hostFlashPowerOn();
+        powerLosses++;
+        delete journal;
+        journal = new ADCCalibrationJournal();
+        powerUp(*journal);
+
+        if(hasUncertain) {
+            CalibrationTable applied;
+            memcpy(applied, expected, sizeof(expected));
+            onRecord(&applied, uncertain);
+            if(memcmp(replayed, applied, sizeof(applied)) == 0) {
+                memcpy(expected, applied, sizeof(applied));
+            }
+            hasUncertain = false;
+        }
+        if(memcmp(replayed, expected, sizeof(expected)) != 0) {
+            if(mismatches < 5) {
+                printf("power loss replay: iteration %u, replayed table differs\n", it);
+            }
+            mismatches++;
+            memcpy(expected, replayed, sizeof(expected));
+        }
+    }
+    delete journal;
+
+    printf("power loss replay: %u iterations, %u power losses, %u compactions, %u mismatches\n",
+        ITERATIONS, powerLosses, compactions, mismatches);
+    CHECK(powerLosses > 100);
+    CHECK(compactions > 10);
+    CHECK_EQ(mismatches, 0);
+}
+
+int main() {
+    testTornRecord();
+    testChecksumMismatch();
+    testCompaction();
+    testPowerLossReplay();
+
+    return HOST_TEST_RESULT();
+}
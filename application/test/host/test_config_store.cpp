@@ -0,0 +1,195 @@
+/*
+ * 配置日志存储的掉电模拟
+ *
+ * 在 host_hal 的 Flash 内存模型上运行 ConfigStore：写入只能把 1 变成 0，掉电注入在任意字节处中断写入，
+ * 擦除中掉电时扇区只有随机一部分被擦除。检查：
+ * - 格式化被打断时旧版整块配置仍然完整；
+ * - 只修改一个分区时写入量与分区大小相当，不擦除；内容没有变化时不写入；
+ * - 随机修改 + 随机掉电 + 后台回收，每次掉电重新上电后存储完整，每个分区要么是修改前的内容要么是修改后的内容；
+ * - 擦除次数均匀分布在环的所有扇区上。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include "host_check.hpp"
+#include "host_hal.hpp"
+#include "config_store.hpp"
+
+#define NUM_SECTIONS    18
+#define PROFILE_SIZE    1048
+#define IMAGE_SIZE      (32 + 16 * PROFILE_SIZE + 136)
+#define ITERATIONS      20000
+#define LEGACY_SECTORS  5
+
+static ConfigStore::Section sections[NUM_SECTIONS];
+static uint8_t image[IMAGE_SIZE];
+static uint8_t previous[IMAGE_SIZE];
+static uint8_t loaded[IMAGE_SIZE];
+
+// 按版本号生成分区内容
+static void fillSection(uint8_t* data, const int section, const uint32_t version) {
+    for(uint32_t i = 0; i < sections[section].size; i++) {
+        data[sections[section].offset + i] = (uint8_t)(version * 31 + i * 7 + section);
+    }
+}
+
+static bool legacyIntact() {
+    const uint8_t* const flash = hostFlashData() + (CONFIG_ADDR & 0x00FFFFFF);
+    for(uint32_t i = 0; i < IMAGE_SIZE; i++) {
+        if(flash[i] != (uint8_t)(i * 13)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static uint32_t ringErases(const uint8_t sector) {
+    return hostFlashStats().erases[(CONFIG_ADDR & 0x00FFFFFF) / W25Qxx_SECTOR_SIZE + sector];
+}
+
+int main() {
+    sections[0] = { 0, 32 };
+    for(uint32_t k = 0; k < 16; k++) {
+        sections[k + 1] = { 32 + k * PROFILE_SIZE, PROFILE_SIZE };
+    }
+    sections[17] = { 32 + 16 * PROFILE_SIZE, 136 };
+    srand(1);
+
+    // 旧版整块配置在前 LEGACY_SECTORS 个扇区，格式化从其后开始，全部写入成功之前不能破坏旧配置
+    hostFlashReset();
+    uint8_t* const flash = hostFlashData() + (CONFIG_ADDR & 0x00FFFFFF);
+    for(uint32_t i = 0; i < IMAGE_SIZE; i++) {
+        flash[i] = (uint8_t)(i * 13);
+    }
+    for(int s = 0; s < NUM_SECTIONS; s++) {
+        fillSection(image, s, 0);
+    }
+    {
+        ConfigStore store(CONFIG_ADDR, sections, NUM_SECTIONS);
+        CHECK(!store.mount());
+        hostFlashSetProgramBudget(9000);
+        CHECK(!store.format(image, LEGACY_SECTORS));
+        CHECK(hostFlashPoweredOff());
+        hostFlashPowerOn();
+
+        ConfigStore remounted(CONFIG_ADDR, sections, NUM_SECTIONS);
+        CHECK(!remounted.mount());
+        CHECK(legacyIntact());
+        CHECK(remounted.format(image, LEGACY_SECTORS));
+    }
+
+    ConfigStore store(CONFIG_ADDR, sections, NUM_SECTIONS);
+    CHECK(store.mount());
+    CHECK(store.load(loaded));
+    CHECK(memcmp(loaded, image, IMAGE_SIZE) == 0);
+    CHECK(legacyIntact());
+
+    // 只写入变化的分区
+    HostFlashStats& stats = hostFlashStats();
+    stats.programmedBytes = 0;
+    stats.totalErases = 0;
+    fillSection(image, 3, 1);
+    CHECK(store.save(image));
+    printf("one profile save: %u bytes programmed, %u erases\n", stats.programmedBytes, stats.totalErases);
+    CHECK(stats.programmedBytes >= PROFILE_SIZE && stats.programmedBytes <= PROFILE_SIZE + 64);
+    CHECK_EQ(stats.totalErases, 0);
+
+    stats.programmedBytes = 0;
+    image[5] ^= 1;
+    CHECK(store.save(image));
+    printf("header-only save: %u bytes programmed\n", stats.programmedBytes);
+    CHECK(stats.programmedBytes <= 32 + 64);
+
+    stats.programmedBytes = 0;
+    CHECK(store.save(image));
+    CHECK_EQ(stats.programmedBytes, 0);
+
+    // 随机修改 + 随机掉电 + 后台回收
+    uint32_t version[NUM_SECTIONS] = { 0 };
+    version[3] = 1;
+    uint32_t powerCuts = 0;
+    uint32_t saves = 0;
+    uint32_t programmed = 0;
+    const uint32_t erasesBefore = stats.totalErases;
+    uint32_t ringErasesBefore[CONFIG_STORE_NUM_SECTORS];
+    for(uint8_t s = 0; s < CONFIG_STORE_NUM_SECTORS; s++) {
+        ringErasesBefore[s] = ringErases(s);
+    }
+
+    ConfigStore* current = new ConfigStore(CONFIG_ADDR, sections, NUM_SECTIONS);
+    CHECK(current->mount());
+    stats.programmedBytes = 0;
+
+    for(int it = 0; it < ITERATIONS && hostCheckFailures == 0; it++) {
+        memcpy(previous, image, IMAGE_SIZE);
+        const int changes = 1 + rand() % 3;
+        for(int j = 0; j < changes; j++) {
+            const int s = rand() % NUM_SECTIONS;
+            fillSection(image, s, ++version[s]);
+        }
+
+        const bool cut = rand() % 10 == 0;
+        hostFlashSetProgramBudget(cut ? rand() % 3000 : -1);
+        hostFlashSetErasePolls(rand() % 5);
+        const bool ok = current->save(image);
+        saves++;
+        for(int k = rand() % 40; k > 0 && current->collectGarbageStep(); k--) {
+        }
+
+        if(cut && hostFlashPoweredOff()) {
+            powerCuts++;
+            hostFlashPowerOn();
+            delete current;
+            current = new ConfigStore(CONFIG_ADDR, sections, NUM_SECTIONS);
+            if(!current->mount()) {
+                printf("store incomplete after power cut at iteration %d\n", it);
+                CHECK(false);
+                break;
+            }
+            CHECK(current->load(loaded));
+            for(int s = 0; s < NUM_SECTIONS; s++) {
+                const uint32_t offset = sections[s].offset;
+                if(memcmp(loaded + offset, previous + offset, sections[s].size) != 0
+                    && memcmp(loaded + offset, image + offset, sections[s].size) != 0) {
+                    printf("section %d torn at iteration %d\n", s, it);
+                    CHECK(false);
+                }
+            }
+            memcpy(image, loaded, IMAGE_SIZE);
+        } else {
+            hostFlashSetProgramBudget(-1);
+            CHECK(ok);
+            if(rand() % 50 == 0) {
+                delete current;
+                current = new ConfigStore(CONFIG_ADDR, sections, NUM_SECTIONS);
+                CHECK(current->mount());
+            }
+            CHECK(current->load(loaded));
+            CHECK(memcmp(loaded, image, IMAGE_SIZE) == 0);
+        }
+    }
+    programmed = stats.programmedBytes;
+    delete current;
+
+    uint32_t minErases = UINT32_MAX;
+    uint32_t maxErases = 0;
+    printf("%u saves, %u power cuts, %u erases, %.1f bytes programmed per save\nerases per sector:",
+        saves, powerCuts, stats.totalErases - erasesBefore, (double)programmed / saves);
+    for(uint8_t s = 0; s < CONFIG_STORE_NUM_SECTORS; s++) {
+        const uint32_t erases = ringErases(s) - ringErasesBefore[s];
+        minErases = std::min(minErases, erases);
+        maxErases = std::max(maxErases, erases);
+        printf(" %u", erases);
+    }
+    printf("\n");
+
+    // 环按顺序使用，各扇区的擦除次数相差不超过 1/4
+    CHECK(minErases > 0);
+    CHECK(maxErases - minErases <= maxErases / 4);
+    // 旧版整块写入每次保存擦除 LEGACY_SECTORS 个扇区，日志存储至少少擦除 4 倍
+    CHECK((stats.totalErases - erasesBefore) * 4 < saves * LEGACY_SECTORS);
+
+    return HOST_TEST_RESULT();
+}
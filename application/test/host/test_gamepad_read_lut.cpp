@@ -0,0 +1,104 @@
+/*
+ * Gamepad::read 查找表与逐个映射判断的等价性
+ *
+ * 参考模型是改为查表之前 Gamepad::read 的表达式（每个功能键判断一次 values & virtualPinMask），
+ * 对默认配置和随机生成的多引脚布局（一个功能键配置多个虚拟引脚、多个功能键共用引脚、引脚不映射）
+ * 穷举全部 2^(NUM_ADC_BUTTONS + NUM_GPIO_BUTTONS) 个虚拟引脚掩码，比较 rawState 的 buttons/dpad/aux。
+ */
+
+#include <stdio.h>
+#include <random>
+#include "host_check.hpp"
+#include "host_hal.hpp"
+#include "gamepad.hpp"
+#include "storagemanager.hpp"
+
+#define NUM_VIRTUAL_PINS    (NUM_ADC_BUTTONS + NUM_GPIO_BUTTONS)
+#define RANDOM_LAYOUTS      6
+
+// 改为查表之前的 Gamepad::read
+static void referenceRead(const KeysConfig& keys, const Mask_t values, GamepadState& state) {
+    state.aux = (values & keys.keyButtonFn) ? AUX_MASK_FUNCTION : 0;
+
+    state.dpad = 0
+        | ((values & keys.keyDpadUp)    ? GAMEPAD_MASK_UP : 0)
+        | ((values & keys.keyDpadDown)  ? GAMEPAD_MASK_DOWN : 0)
+        | ((values & keys.keyDpadLeft)  ? GAMEPAD_MASK_LEFT : 0)
+        | ((values & keys.keyDpadRight) ? GAMEPAD_MASK_RIGHT : 0)
+    ;
+
+    state.buttons = 0
+        | ((values & keys.keyButtonB1)  ? GAMEPAD_MASK_B1 : 0)
+        | ((values & keys.keyButtonB2)  ? GAMEPAD_MASK_B2 : 0)
+        | ((values & keys.keyButtonB3)  ? GAMEPAD_MASK_B3 : 0)
+        | ((values & keys.keyButtonB4)  ? GAMEPAD_MASK_B4 : 0)
+        | ((values & keys.keyButtonL1)  ? GAMEPAD_MASK_L1 : 0)
+        | ((values & keys.keyButtonR1)  ? GAMEPAD_MASK_R1 : 0)
+        | ((values & keys.keyButtonL2)  ? GAMEPAD_MASK_L2 : 0)
+        | ((values & keys.keyButtonR2)  ? GAMEPAD_MASK_R2 : 0)
+        | ((values & keys.keyButtonS1)  ? GAMEPAD_MASK_S1 : 0)
+        | ((values & keys.keyButtonS2)  ? GAMEPAD_MASK_S2 : 0)
+        | ((values & keys.keyButtonL3)  ? GAMEPAD_MASK_L3 : 0)
+        | ((values & keys.keyButtonR3)  ? GAMEPAD_MASK_R3 : 0)
+        | ((values & keys.keyButtonA1)  ? GAMEPAD_MASK_A1 : 0)
+        | ((values & keys.keyButtonA2)  ? GAMEPAD_MASK_A2 : 0)
+    ;
+}
+
+// 穷举所有虚拟引脚掩码，返回不一致的次数
+static uint32_t compareAllMasks(const char* name) {
+    GAMEPAD.setup();
+    const KeysConfig& keys = GAMEPAD.getOptions()->keysConfig;
+    uint32_t mismatches = 0;
+    uint32_t pressed = 0;
+
+    for(Mask_t values = 0; values < (1U << NUM_VIRTUAL_PINS); values++) {
+        GamepadState expected;
+        referenceRead(keys, values, expected);
+        GAMEPAD.read(values);
+        const GamepadState& actual = GAMEPAD.rawState;
+        if(actual.buttons != expected.buttons || actual.dpad != expected.dpad || actual.aux != expected.aux) {
+            if(mismatches < 5) {
+                printf("%s: mask 0x%06x got %05x/%x/%x, expect %05x/%x/%x\n", name, values,
+                    actual.buttons, actual.dpad, actual.aux, expected.buttons, expected.dpad, expected.aux);
+            }
+            mismatches++;
+        }
+        pressed += expected.buttons != 0 || expected.dpad != 0 || expected.aux != 0;
+    }
+    printf("%-16s %u masks, %u with output, %u mismatches\n", name, 1U << NUM_VIRTUAL_PINS, pressed, mismatches);
+    return mismatches;
+}
+
+int main() {
+    hostFlashReset();
+    STORAGE_MANAGER.initConfig();
+    GamepadProfile* profile = STORAGE_MANAGER.getDefaultGamepadProfile();
+    KeysConfig& keys = profile->keysConfig;
+
+    // 默认配置：上方向配置了两个引脚，引脚 3 不映射
+    CHECK_EQ(compareAllMasks("default"), 0);
+
+    // 随机布局：每个功能键 0~3 个引脚，允许与其他功能键重叠
+    uint32_t* const mappings[] = {
+        &keys.keyDpadUp, &keys.keyDpadDown, &keys.keyDpadLeft, &keys.keyDpadRight,
+        &keys.keyButtonB1, &keys.keyButtonB2, &keys.keyButtonB3, &keys.keyButtonB4,
+        &keys.keyButtonL1, &keys.keyButtonR1, &keys.keyButtonL2, &keys.keyButtonR2,
+        &keys.keyButtonS1, &keys.keyButtonS2, &keys.keyButtonL3, &keys.keyButtonR3,
+        &keys.keyButtonA1, &keys.keyButtonA2, &keys.keyButtonFn,
+    };
+    std::mt19937 rng(9);
+    for(uint32_t layout = 0; layout < RANDOM_LAYOUTS; layout++) {
+        for(uint32_t* const mapping : mappings) {
+            *mapping = 0;
+            for(uint32_t n = rng() % 4; n > 0; n--) {
+                *mapping |= 1U << (rng() % NUM_VIRTUAL_PINS);
+            }
+        }
+        char name[32];
+        snprintf(name, sizeof(name), "random %u", layout);
+        CHECK_EQ(compareAllMasks(name), 0);
+    }
+
+    return HOST_TEST_RESULT();
+}
@@ -0,0 +1,194 @@
+/*
+ * GPIO 按钮扫描防抖轨迹
+ *
+ * 在 GPIOC 的 IDR 上模拟一次带抖动的按下和释放（上拉输入，低电平为按下），经过真实的 GPIO_Btns_ReadMask 每 50us 扫描一次：
+ * - 只扫描 IDR：立即确认和延迟确认两种模式分别检查按下/释放上报的时间，每种模式恰好两次状态变化；
+ * - 边沿中断：GPIO_Btns_EXTI_IRQHandler 在每个边沿记录时间戳，立即确认上报的是真实的边沿时间；
+ * - GPIOBtnsWorker（board_cfg 默认配置）：虚拟引脚掩码在边沿之后的第一次扫描变化，上电时已按住的按钮不经过防抖。
+ */
+
+#include <stdio.h>
+#include <vector>
+#include "host_check.hpp"
+#include "host_hal.hpp"
+#include "gpio-btn.h"
+#include "gpio_btns/gpio_debounce_filter.hpp"
+#include "gpio_btns/gpio_btns_worker.hpp"
+
+#define SCAN_INTERVAL_US    50
+#define TRACE_END_US        7000
+#define CYCLES_PER_US       (SYSTEM_CLOCK_FREQ / 1000000UL)
+
+// 一次电平变化：时间、按钮索引、是否按下
+struct GPIOEdge {
+    uint32_t us;
+    uint8_t button;
+    bool pressed;
+};
+
+// 按钮 0：100us 附近开始按下，抖动到 280us 稳定；5000us 附近开始释放，抖动到 5170us 稳定
+// 边沿都不在扫描时刻上，扫描看到的是扫描之前最后一个边沿的电平
+static const GPIOEdge bouncyTrace[] = {
+    { 110, 0, true }, { 160, 0, false }, { 190, 0, true }, { 240, 0, false }, { 280, 0, true },
+    { 5010, 0, false }, { 5030, 0, true }, { 5080, 0, false }, { 5120, 0, true }, { 5170, 0, false },
+};
+
+// 一次稳定状态变化：上报的时间和变化后的状态
+struct GPIOTransition {
+    uint32_t us;
+    uint8_t button;
+    bool pressed;
+};
+
+static void setButton(const uint8_t button, const bool pressed) {
+    hostSetGPIOInput(gpio_btns_mapping[button].port, gpio_btns_mapping[button].pin, !pressed);
+}
+
+// 所有按钮释放，按钮 3 从上电起一直按住
+static void resetInputs() {
+    for(uint8_t i = 0; i < NUM_GPIO_BUTTONS; i++) {
+        setButton(i, i == 3);
+    }
+    hostSetCycles(0);
+}
+
+// 边沿中断回调记录的边沿（按钮状态、DWT时间戳）
+static std::vector<std::pair<uint32_t, uint32_t>> capturedEdges;
+
+static void captureEdge(uint32_t buttonMask, uint32_t timestamp) {
+    capturedEdges.push_back({ buttonMask, timestamp });
+}
+
+static void recordChanges(std::vector<GPIOTransition>& transitions, const uint32_t before, const uint32_t after, const uint32_t timestamp) {
+    for(uint8_t i = 0; i < NUM_GPIO_BUTTONS; i++) {
+        if(((before ^ after) >> i) & 1) {
+            transitions.push_back({ (uint32_t)(timestamp / CYCLES_PER_US), i, (bool)((after >> i) & 1) });
+        }
+    }
+}
+
+/**
+ * 按轨迹驱动 IDR，每 SCAN_INTERVAL_US 扫描一次
+ * @param eager 立即确认
+ * @param exti 边沿中断中读取按钮状态并以边沿时间防抖（同 GPIOBtnsWorker::read 的处理顺序）
+ */
+static std::vector<GPIOTransition> runTrace(const bool eager, const bool exti) {
+    GPIODebounceFilter::Config config;
+    config.windowCycles = GPIO_BUTTONS_DEBOUNCE * CYCLES_PER_US;
+    config.eager = eager;
+    GPIODebounceFilter filter(config);
+    std::vector<GPIOTransition> transitions;
+    capturedEdges.clear();
+
+    resetInputs();
+    GPIO_Btns_Init();
+    filter.reset(GPIO_Btns_ReadMask());
+    if(exti) {
+        GPIO_Btns_InitEXTI(captureEdge);
+    }
+
+    size_t next = 0;
+    for(uint32_t scan = SCAN_INTERVAL_US; scan <= TRACE_END_US; scan += SCAN_INTERVAL_US) {
+        while(next < sizeof(bouncyTrace) / sizeof(bouncyTrace[0]) && bouncyTrace[next].us < scan) {
+            hostSetCycles(bouncyTrace[next].us * CYCLES_PER_US);
+            setButton(bouncyTrace[next].button, bouncyTrace[next].pressed);
+            if(exti) {
+                GPIO_Btns_EXTI_IRQHandler();
+            }
+            next++;
+        }
+        hostSetCycles(scan * CYCLES_PER_US);
+
+        for(const auto& edge : capturedEdges) {
+            const uint32_t before = filter.getStableMask();
+            recordChanges(transitions, before, filter.filter(edge.first, edge.second), edge.second);
+        }
+        capturedEdges.clear();
+        const uint32_t before = filter.getStableMask();
+        recordChanges(transitions, before, filter.filter(GPIO_Btns_ReadMask(), DWT->CYCCNT), DWT->CYCCNT);
+    }
+    return transitions;
+}
+
+static void checkTransitions(const char* name, const std::vector<GPIOTransition>& transitions, const uint32_t pressUs, const uint32_t releaseUs) {
+    printf("%-18s", name);
+    for(const GPIOTransition& t : transitions) {
+        printf(" button %u %s at %u us", t.button, t.pressed ? "pressed" : "released", t.us);
+    }
+    printf("\n");
+
+    CHECK_EQ(transitions.size(), 2);
+    if(transitions.size() == 2) {
+        CHECK_EQ(transitions[0].button, 0);
+        CHECK(transitions[0].pressed);
+        CHECK_EQ(transitions[0].us, pressUs);
+        CHECK_EQ(transitions[1].button, 0);
+        CHECK(!transitions[1].pressed);
+        CHECK_EQ(transitions[1].us, releaseUs);
+    }
+}
+
+int main() {
+    // 立即确认：第一次看到按下的扫描（150us）上报，之后 1ms 内的抖动被忽略；
+    // 释放时 5050us 的扫描看到的是抖动中的低电平，5100us 上报
+    checkTransitions("scan eager:", runTrace(true, false), 150, 5100);
+
+    // 延迟确认：250us 和 5150us 的扫描看到抖动取消计时，300us 和 5200us 重新开始，电平稳定 1ms 之后才确认
+    checkTransitions("scan deferred:", runTrace(false, false), 1300, 6200);
+
+    // 边沿中断 + 立即确认：上报第一个边沿的时间
+    checkTransitions("exti eager:", runTrace(true, true), 110, 5010);
+
+    // 边沿中断 + 延迟确认：从最后一个边沿开始计时，之后第一次扫描确认
+    checkTransitions("exti deferred:", runTrace(false, true), 1300, 6200);
+
+    // GPIOBtnsWorker：按 board_cfg 的默认配置扫描同一条轨迹
+    {
+        resetInputs();
+        GPIOBtnsWorker worker;
+        worker.setup();
+        const uint32_t pin0 = 1U << gpio_btns_mapping[0].virtualPin;
+        const uint32_t pin3 = 1U << gpio_btns_mapping[3].virtualPin;
+        CHECK_EQ(worker.read(), pin3);
+
+        uint32_t lastMask = pin3;
+        uint32_t changes = 0;
+        uint32_t pressedAt = 0;
+        uint32_t releasedAt = 0;
+        size_t next = 0;
+        for(uint32_t scan = SCAN_INTERVAL_US; scan <= TRACE_END_US; scan += SCAN_INTERVAL_US) {
+            while(next < sizeof(bouncyTrace) / sizeof(bouncyTrace[0]) && bouncyTrace[next].us < scan) {
+                hostSetCycles(bouncyTrace[next].us * CYCLES_PER_US);
+                setButton(bouncyTrace[next].button, bouncyTrace[next].pressed);
+                GPIO_Btns_EXTI_IRQHandler();
+                next++;
+            }
+            hostSetCycles(scan * CYCLES_PER_US);
+            const uint32_t mask = worker.read();
+            if(mask != lastMask) {
+                changes++;
+                if(mask & pin0) {
+                    pressedAt = scan;
+                } else {
+                    releasedAt = scan;
+                }
+                lastMask = mask;
+            }
+        }
+        printf("worker:            pressed at scan %u us, released at scan %u us, %u edge overflows\n",
+            pressedAt, releasedAt, worker.getEdgeOverflows());
+        CHECK_EQ(changes, 2);
+        CHECK_EQ(lastMask, pin3);
+        CHECK_EQ(worker.getEdgeOverflows(), 0);
+        // 边沿中断下释放的边沿在 5050us 的扫描之前已经进入队列
+#if GPIO_BUTTONS_DEBOUNCE_EAGER
+        CHECK_EQ(pressedAt, 150);
+        CHECK_EQ(releasedAt, GPIO_BUTTONS_EXTI_ENABLED ? 5050 : 5100);
+#else
+        CHECK_EQ(pressedAt, 1300);
+        CHECK_EQ(releasedAt, 6200);
+#endif
+    }
+
+    return HOST_TEST_RESULT();
+}
@@ -0,0 +1,229 @@
+/*
+ * 连发/锁定和宏引擎（GamepadMacroEngine）
+ *
+ * 引擎不访问硬件，按给定的扫描时间（DWT周期）直接驱动 filterPins，检查：
+ * - 连发从 CYCCNT 回绕前开始，按下/松开的相位在回绕前后都按半周期翻转；
+ * - 锁定按下沿翻转，锁定连发在松开触发键后继续连发，再按一次停止；
+ * - 宏的单次/按住/切换三种模式；
+ * - advanceMacro 每次扫描前进一步，步骤结束时间从上一步的结束时间算起，落后超过一步时从当前时间重新计时；
+ * - 宏触发键不出现在输出的虚拟引脚中。
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "host_check.hpp"
+#include "gamepad/GamepadMacros.hpp"
+#include "gamepad/GamepadState.hpp"
+
+#define MS                  ((uint32_t)GAMEPAD_MACRO_CYCLES_PER_MS)
+
+#define PIN_TURBO           3       // 按住连发 10Hz
+#define PIN_LATCH_TURBO     4       // 锁定连发 20Hz
+#define PIN_LATCH           5       // 锁定
+#define PIN_ONCE            6       // 宏：单次
+#define PIN_HOLD            7       // 宏：按住
+#define PIN_TOGGLE          8       // 宏：切换
+#define PIN_PLAIN           0       // 没有配置的引脚
+
+static GamepadProfile profile;
+
+static void setMacro(const uint8_t index, const int8_t pin, const MacroMode mode) {
+    MacroConfig& macro = profile.macros[index];
+    macro.enabled = true;
+    macro.virtualPin = pin;
+    macro.mode = mode;
+    macro.numSteps = 3;
+    macro.steps[0] = { GAMEPAD_MASK_B1, 0, 10 };
+    macro.steps[1] = { GAMEPAD_MASK_B2, GAMEPAD_MASK_UP, 20 };
+    macro.steps[2] = { GAMEPAD_MASK_B3, 0, 10 };
+}
+
+// 宏在开始后 t ms 时应输出的按键（一轮 40ms）
+static uint32_t macroButtonsAt(const uint32_t t) {
+    const uint32_t phase = t % 40;
+    return phase < 10 ? GAMEPAD_MASK_B1 : phase < 30 ? GAMEPAD_MASK_B2 : GAMEPAD_MASK_B3;
+}
+
+static void testTurboAcrossWrap(GamepadMacroEngine& engine) {
+    // 连发在回绕前 75ms 开始，半周期 50ms：第一次翻转在回绕前，第二次在回绕后
+    engine.reset();
+    const uint32_t start = (uint32_t)0 - (uint32_t)(75 * MS);
+    uint32_t mismatches = 0;
+    uint32_t toggles = 0;
+    bool last = false;
+    for(uint32_t t = 0; t < 300; t++) {
+        const Mask_t out = engine.filterPins(1U << PIN_TURBO, start + t * MS);
+        const bool pressed = (out & (1U << PIN_TURBO)) != 0;
+        if(pressed != ((t / 50) % 2 == 0)) {
+            if(mismatches < 5) {
+                printf("turbo across wrap: t = %u ms, got %d\n", t, pressed);
+            }
+            mismatches++;
+        }
+        toggles += t > 0 && pressed != last;
+        last = pressed;
+    }
+    CHECK_EQ(mismatches, 0);
+    CHECK_EQ(toggles, 5);
+
+    // 松开后不再输出，再次按下立即输出按下
+    CHECK_EQ(engine.filterPins(0, start + 300 * MS), 0);
+    CHECK_EQ(engine.filterPins(1U << PIN_TURBO, start + 301 * MS), 1U << PIN_TURBO);
+}
+
+static void testLatch(GamepadMacroEngine& engine) {
+    engine.reset();
+    uint32_t now = 1000 * MS;
+
+    // 锁定：按下沿锁定，松开后保持按下，再按一次释放
+    CHECK_EQ(engine.filterPins(1U << PIN_LATCH, now), 1U << PIN_LATCH);
+    CHECK_EQ(engine.filterPins(1U << PIN_LATCH, now += MS), 1U << PIN_LATCH);
+    CHECK_EQ(engine.filterPins(0, now += MS), 1U << PIN_LATCH);
+    CHECK_EQ(engine.filterPins(0, now += 100 * MS), 1U << PIN_LATCH);
+    CHECK_EQ(engine.filterPins(1U << PIN_LATCH, now += MS), 0);
+    CHECK_EQ(engine.filterPins(0, now += MS), 0);
+
+    // 锁定连发：按一下开始连发，松开后继续按 25ms 半周期翻转，再按一下停止
+    const uint32_t start = now += MS;
+    uint32_t mismatches = 0;
+    for(uint32_t t = 0; t < 200; t++) {
+        const Mask_t pins = t < 5 ? (1U << PIN_LATCH_TURBO) : 0;
+        const Mask_t out = engine.filterPins(pins, start + t * MS);
+        const bool pressed = (out & (1U << PIN_LATCH_TURBO)) != 0;
+        mismatches += pressed != ((t / 25) % 2 == 0);
+    }
+    CHECK_EQ(mismatches, 0);
+    now = start + 200 * MS;
+    CHECK_EQ(engine.filterPins(1U << PIN_LATCH_TURBO, now), 0);
+    CHECK_EQ(engine.filterPins(0, now += MS), 0);
+    CHECK_EQ(engine.filterPins(0, now += 100 * MS), 0);
+}
+
+/**
+ * 按 1ms 扫描驱动 ms 毫秒，按键由 pinsAt 给出，检查宏输出与 expectAt 一致
+ * @return 不一致的扫描数
+ */
+template<typename PinsAt, typename ExpectAt>
+static uint32_t runMacro(GamepadMacroEngine& engine, const char* name, const uint32_t start, const uint32_t ms,
+    PinsAt pinsAt, ExpectAt expectAt) {
+    uint32_t mismatches = 0;
+    for(uint32_t t = 0; t < ms; t++) {
+        engine.filterPins(pinsAt(t), start + t * MS);
+        const uint32_t expect = expectAt(t);
+        const uint8_t expectDpad = expect == GAMEPAD_MASK_B2 ? GAMEPAD_MASK_UP : 0;
+        if(engine.getButtons() != expect || engine.getDpad() != expectDpad) {
+            if(mismatches < 5) {
+                printf("%s: t = %u ms, buttons 0x%x dpad 0x%x, expect 0x%x 0x%x\n",
+                    name, t, engine.getButtons(), engine.getDpad(), expect, expectDpad);
+            }
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+static void testMacroModes(GamepadMacroEngine& engine) {
+    // 单次：按下沿播放一轮，按住不重复，播放中再按不重新开始
+    engine.reset();
+    CHECK_EQ(runMacro(engine, "once", 5000 * MS, 100,
+        [](uint32_t t) { return t < 15 || (t >= 20 && t < 25) ? (1U << PIN_ONCE) : 0U; },
+        [](uint32_t t) { return t < 40 ? macroButtonsAt(t) : 0U; }), 0);
+
+    // 按住：按住期间循环播放，松开立即停止；再按从第一步开始
+    engine.reset();
+    CHECK_EQ(runMacro(engine, "hold", 6000 * MS, 150,
+        [](uint32_t t) { return t < 90 || t >= 120 ? (1U << PIN_HOLD) : 0U; },
+        [](uint32_t t) { return t < 90 ? macroButtonsAt(t) : t >= 120 ? macroButtonsAt(t - 120) : 0U; }), 0);
+
+    // 切换：第一次按下开始循环播放，第二次按下停止
+    engine.reset();
+    CHECK_EQ(runMacro(engine, "toggle", 7000 * MS, 150,
+        [](uint32_t t) { return t < 3 || (t >= 95 && t < 98) ? (1U << PIN_TOGGLE) : 0U; },
+        [](uint32_t t) { return t < 95 ? macroButtonsAt(t) : 0U; }), 0);
+}
+
+static void testMacroCatchUp(GamepadMacroEngine& engine) {
+    // 每 3ms 扫描一次：步骤按 10/20/10ms 的边界切换，不累积扫描间隔带来的误差
+    engine.reset();
+    const uint32_t start = 8000 * MS;
+    uint32_t mismatches = 0;
+    for(uint32_t t = 0; t < 40; t += 3) {
+        engine.filterPins(t == 0 ? (1U << PIN_ONCE) : 0, start + t * MS);
+        mismatches += engine.getButtons() != macroButtonsAt(t);
+    }
+    CHECK_EQ(mismatches, 0);
+    CHECK_EQ(engine.filterPins(0, start + 42 * MS), 0);
+    CHECK_EQ(engine.getButtons(), 0);
+
+    // 漏掉扫描：第一步在 10ms 结束，下一次扫描在 45ms，只前进一步，第二步从 45ms 重新计时 20ms
+    engine.reset();
+    engine.filterPins(1U << PIN_ONCE, start);
+    CHECK_EQ(engine.getButtons(), GAMEPAD_MASK_B1);
+    engine.filterPins(0, start + 45 * MS);
+    CHECK_EQ(engine.getButtons(), GAMEPAD_MASK_B2);
+    engine.filterPins(0, start + 64 * MS);
+    CHECK_EQ(engine.getButtons(), GAMEPAD_MASK_B2);
+    engine.filterPins(0, start + 65 * MS);
+    CHECK_EQ(engine.getButtons(), GAMEPAD_MASK_B3);
+    engine.filterPins(0, start + 75 * MS);
+    CHECK_EQ(engine.getButtons(), 0);
+
+    // 落后不到一步：第一步在 10ms 结束，12ms 扫描进入第二步，第二步仍在 30ms 结束
+    engine.reset();
+    engine.filterPins(1U << PIN_ONCE, start);
+    engine.filterPins(0, start + 12 * MS);
+    CHECK_EQ(engine.getButtons(), GAMEPAD_MASK_B2);
+    engine.filterPins(0, start + 29 * MS);
+    CHECK_EQ(engine.getButtons(), GAMEPAD_MASK_B2);
+    engine.filterPins(0, start + 30 * MS);
+    CHECK_EQ(engine.getButtons(), GAMEPAD_MASK_B3);
+}
+
+static void testTriggerRemoved(GamepadMacroEngine& engine) {
+    engine.reset();
+    const Mask_t triggers = (1U << PIN_ONCE) | (1U << PIN_HOLD) | (1U << PIN_TOGGLE);
+    uint32_t now = 500 * MS;
+
+    // 触发键按下和播放期间都不输出，其他引脚不受影响
+    CHECK_EQ(engine.filterPins(triggers | (1U << PIN_PLAIN), now), 1U << PIN_PLAIN);
+    CHECK(engine.getButtons() != 0);
+    CHECK_EQ(engine.filterPins(triggers, now += 5 * MS), 0);
+    CHECK_EQ(engine.filterPins(1U << PIN_PLAIN, now += 5 * MS), 1U << PIN_PLAIN);
+
+    // 禁用的宏和 FN 键上的宏不生效，触发键按原样输出
+    GamepadProfile plain = profile;
+    plain.macros[1].enabled = false;
+    plain.macros[2].virtualPin = (int8_t)__builtin_ctz(FN_BUTTON_VIRTUAL_PIN);
+    GamepadMacroEngine other;
+    other.setup(plain);
+    CHECK_EQ(other.filterPins((1U << PIN_HOLD) | (1U << PIN_ONCE), now), 1U << PIN_HOLD);
+    CHECK_EQ(other.getButtons(), GAMEPAD_MASK_B1);
+    other.filterPins(FN_BUTTON_VIRTUAL_PIN, now += MS);
+    CHECK_EQ(other.getButtons(), GAMEPAD_MASK_B1);
+}
+
+int main() {
+    memset(&profile, 0, sizeof(profile));
+    for(uint8_t pin = 0; pin < GAMEPAD_MACRO_NUM_PINS; pin++) {
+        profile.turboConfigs[pin] = { TurboMode::TURBO_MODE_OFF, 10 };
+    }
+    profile.turboConfigs[PIN_TURBO] = { TurboMode::TURBO_MODE_HOLD, 10 };
+    profile.turboConfigs[PIN_LATCH_TURBO] = { TurboMode::TURBO_MODE_LATCH_TURBO, 20 };
+    profile.turboConfigs[PIN_LATCH] = { TurboMode::TURBO_MODE_LATCH, 10 };
+    setMacro(0, PIN_ONCE, MacroMode::MACRO_MODE_ONCE);
+    setMacro(1, PIN_HOLD, MacroMode::MACRO_MODE_HOLD);
+    setMacro(2, PIN_TOGGLE, MacroMode::MACRO_MODE_TOGGLE);
+
+    GamepadMacroEngine engine;
+    CHECK(!engine.isActive());
+    engine.setup(profile);
+    CHECK(engine.isActive());
+
+    testTurboAcrossWrap(engine);
+    testLatch(engine);
+    testMacroModes(engine);
+    testMacroCatchUp(engine);
+    testTriggerRemoved(engine);
+
+    return HOST_TEST_RESULT();
+}
@@ -0,0 +1,233 @@
+/*
+ * 按键到USB报告的延迟统计（LatencyTrace）
+ *
+ * 按 InputState::loop 的顺序驱动完整的输入链路：ADCBtnsWorker::read -> GPIOBtnsWorker::read -> Gamepad::read
+ * -> SwitchDriver::process -> tud_hid_report（stubs/tusb.h，端点忙由测试控制）。
+ * 每帧 ADC 读取、GPIO 读取、手柄处理之间按固定时间推进 DWT，检查：
+ * - 端点空闲时延迟等于按键翻转到 tud_hid_report 接受报告的时间，计入正确的直方图桶；
+ * - 端点忙（tud_hid_ready() 为 false）时报告没有发出，不结束计时，延迟包含等待的帧；
+ * - GPIO 按钮使用边沿中断记录的时间戳；
+ * - 超过 LATENCY_TRACE_TIMEOUT_US 才发出的报告计为超时，FN 组合键计为丢弃，百分位按直方图计算。
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+#include "host_check.hpp"
+#include "host_hal.hpp"
+#include "adc_btns/adc_btns_worker.hpp"
+#include "gpio_btns/gpio_btns_worker.hpp"
+#include "gpio-btn.h"
+#include "gamepad.hpp"
+#include "storagemanager.hpp"
+#include "drivermanager.hpp"
+#include "drivers/switch/SwitchDriver.hpp"
+#include "latency_trace.hpp"
+
+#define MAPPING_LENGTH      36
+#define MAPPING_STEP        0.1f
+#define FRAME_US            100     // ADC帧间隔
+#define ADC_READ_US         20      // ADC读取之后到GPIO读取
+#define GAMEPAD_READ_US     15      // GPIO读取之后到驱动发出报告
+#define REPORT_US           (ADC_READ_US + GAMEPAD_READ_US)
+#define GPIO_EDGE_LEAD_US   40      // GPIO边沿早于下一帧开始的时间
+#define CYCLES_PER_US       (SYSTEM_CLOCK_FREQ / 1000000UL)
+
+static uint32_t mapping[MAPPING_LENGTH];
+static uint32_t adcPressed = 0;     // 按下的ADC按键，按 virtualPin
+static uint32_t adcMask = 0;        // ADCBtnsWorker::read 的输出
+static bool adcChanged = false;     // 本帧 ADC按键状态翻转
+static SwitchDriver switchDriver;
+
+// 直方图桶：bin0 <1us，binN [2^(N-1), 2^N) us
+static uint32_t histogramBin(const uint32_t us) {
+    return us == 0 ? 0 : std::min<uint32_t>(32 - __builtin_clz(us), LATENCY_TRACE_HISTOGRAM_BINS - 1);
+}
+
+static void setGPIOButton(const uint8_t button, const bool pressed) {
+    hostSetGPIOInput(gpio_btns_mapping[button].port, gpio_btns_mapping[button].pin, !pressed);
+}
+
+/**
+ * 一次主循环：帧开始时 ADC 读取（按键翻转的时间戳），之后 REPORT_US 发出报告，再等到下一帧
+ * @return 本帧是否发出了报告
+ */
+static bool loopOnce() {
+    uint32_t frame[NUM_ADC_BUTTONS];
+    for(uint8_t k = 0; k < NUM_ADC_BUTTONS; k++) {
+        frame[k] = (adcPressed & (1U << k)) ? mapping[0] : mapping[MAPPING_LENGTH - 1];
+    }
+    const uint32_t reports = hostUSBStats().reports;
+
+    hostPushADCFrame(frame);
+    const uint32_t mask = ADC_BTNS_WORKER.read();
+    adcChanged = (mask != adcMask);
+    adcMask = mask;
+    hostAdvanceMicros(ADC_READ_US);
+    const uint32_t virtualPinMask = GPIO_BTNS_WORKER.read() | adcMask;
+    hostAdvanceMicros(GAMEPAD_READ_US);
+    if((virtualPinMask & FN_BUTTON_VIRTUAL_PIN) == 0) {
+        GAMEPAD.read(virtualPinMask);
+        switchDriver.process(&GAMEPAD);
+    } else {
+        LATENCY_TRACE_DISCARD();
+    }
+    hostAdvanceMicros(FRAME_US - REPORT_US);
+    hostAdvanceTick(1);     // 不影响结果：Switch 模式没有保活发送
+
+    return hostUSBStats().reports != reports;
+}
+
+// 运行到报告发出，最多 frames 帧，返回运行的帧数
+static uint32_t loopUntilReport(const uint32_t frames) {
+    for(uint32_t i = 1; i <= frames; i++) {
+        if(loopOnce()) {
+            return i;
+        }
+    }
+    return 0;
+}
+
+// 运行到 ADC按键状态翻转（确认需要的采样数由触发配置决定），最多 frames 帧，返回运行的帧数
+static uint32_t loopUntilADCChanged(const uint32_t frames) {
+    for(uint32_t i = 1; i <= frames; i++) {
+        loopOnce();
+        if(adcChanged) {
+            return i;
+        }
+    }
+    return 0;
+}
+
+static void checkButton(const char* name, const uint8_t virtualPin, const uint32_t count, const uint32_t lastUs) {
+    const LatencyButtonStats& stats = LATENCY_TRACE.getData().buttons[virtualPin];
+    printf("%-22s pin %2u: count %u, max %u us, avg %.1f us\n", name, virtualPin, stats.count,
+        (unsigned)(stats.maxCycles / CYCLES_PER_US), stats.count ? (double)stats.totalCycles / stats.count / CYCLES_PER_US : 0.0);
+    CHECK_EQ(stats.count, count);
+    CHECK(stats.histogram[histogramBin(lastUs)] > 0);
+    CHECK(stats.maxCycles >= lastUs * CYCLES_PER_US);
+}
+
+int main() {
+    for(uint32_t i = 0; i < MAPPING_LENGTH; i++) {
+        const double travel = (MAPPING_LENGTH - 1 - i) * MAPPING_STEP;
+        mapping[i] = (uint32_t)lround(1000 + 2000 * pow(travel / 3.5, 1.3));
+    }
+
+    hostFlashReset();
+    hostUSBReset();
+    for(uint8_t i = 0; i < NUM_GPIO_BUTTONS; i++) {
+        setGPIOButton(i, false);
+    }
+    STORAGE_MANAGER.initConfig();
+    if(!hostInstallADCMapping(mapping, MAPPING_LENGTH, MAPPING_STEP, 2)
+        || ADC_BTNS_WORKER.setup() != ADCBtnsError::SUCCESS) {
+        printf("ADCBtnsWorker setup failed\n");
+        return 2;
+    }
+    GPIO_BTNS_WORKER.setup();
+    GAMEPAD.setup();
+    switchDriver.initialize();
+    DriverManager::getInstance().setDriver(&switchDriver);
+    LATENCY_TRACE.reset();
+    CHECK(LATENCY_TRACE.isValid());
+
+    // 第一帧：所有按键释放，初始化映射；驱动强制发出第一份报告，没有待处理的按键事件
+    CHECK(loopOnce());
+    uint8_t releasedReport[HOST_USB_REPORT_MAX];
+    memcpy(releasedReport, hostUSBStats().lastReport, sizeof(releasedReport));
+    CHECK_EQ(hostUSBStats().lastLength, sizeof(SwitchReport));
+    // 没有变化时不发送
+    CHECK(!loopOnce());
+    for(uint8_t pin = 0; pin < LATENCY_TRACE_NUM_BUTTONS; pin++) {
+        CHECK_EQ(LATENCY_TRACE.getData().buttons[pin].count, 0);
+    }
+
+    // ADC按键 0 按下，端点空闲：翻转的同一帧发出报告，延迟为 ADC 读取到 tud_hid_report 的时间
+    adcPressed = 1U << 0;
+    const uint32_t releasedReports = hostUSBStats().reports;
+    CHECK(loopUntilADCChanged(4) > 0);
+    CHECK_EQ(adcMask, 1U << 0);
+    CHECK_EQ(hostUSBStats().reports, releasedReports + 1);
+    CHECK(memcmp(hostUSBStats().lastReport, releasedReport, sizeof(SwitchReport)) != 0);
+    checkButton("adc press, ready:", 0, 1, REPORT_US);
+    CHECK_EQ(LATENCY_TRACE.getData().buttons[0].maxCycles, REPORT_US * CYCLES_PER_US);
+    CHECK_EQ(LATENCY_TRACE.getData().buttons[0].histogram[histogramBin(REPORT_US)], 1);
+
+    // ADC按键 0 释放，端点从翻转的那一帧开始忙 3 帧：没有发出的报告不结束计时，第 4 帧发出
+    const uint32_t busyFrames = 3;
+    hostUSBSetHIDReady(false);
+    adcPressed = 0;
+    CHECK(loopUntilADCChanged(4) > 0);
+    CHECK_EQ(adcMask, 0);
+    for(uint32_t i = 1; i < busyFrames; i++) {
+        CHECK(!loopOnce());
+    }
+    // 端点忙时 tud_hid_ready() 为 false，驱动不会调用 tud_hid_report
+    CHECK_EQ(hostUSBStats().rejected, 0);
+    hostUSBSetHIDReady(true);
+    CHECK(loopOnce());
+    CHECK_EQ(memcmp(hostUSBStats().lastReport, releasedReport, sizeof(SwitchReport)), 0);
+    const uint32_t busyUs = busyFrames * FRAME_US + REPORT_US;
+    checkButton("adc release, busy:", 0, 2, busyUs);
+    CHECK_EQ(LATENCY_TRACE.getData().buttons[0].maxCycles, busyUs * CYCLES_PER_US);
+    CHECK_EQ(LATENCY_TRACE.getData().buttons[0].totalCycles, (uint64_t)(REPORT_US + busyUs) * CYCLES_PER_US);
+
+    // 百分位：两个事件分别在 [32, 64) 和 [256, 512) us 桶，结果为桶上限，不超过最大值
+    CHECK_EQ(LATENCY_TRACE.getPercentileUs(0, 50), 1U << histogramBin(REPORT_US));
+    CHECK_EQ(LATENCY_TRACE.getPercentileUs(0, 99), busyUs);
+
+    // GPIO 按钮 0：边沿在帧开始前 GPIO_EDGE_LEAD_US 到达，边沿中断记录时间戳
+    // 立即确认 + 边沿中断时延迟从边沿开始计算；只扫描IDR或延迟确认时从确认的那次扫描开始计算
+    const uint8_t gpioPin = gpio_btns_mapping[0].virtualPin;
+    hostAdvanceMicros(FRAME_US - GPIO_EDGE_LEAD_US);
+    setGPIOButton(0, true);
+    GPIO_Btns_EXTI_IRQHandler();
+    hostAdvanceMicros(GPIO_EDGE_LEAD_US);
+    CHECK(loopUntilReport(GPIO_BUTTONS_DEBOUNCE / FRAME_US + 2) > 0);
+#if GPIO_BUTTONS_EXTI_ENABLED && GPIO_BUTTONS_DEBOUNCE_EAGER
+    const uint32_t gpioUs = GPIO_EDGE_LEAD_US + REPORT_US;
+#else
+    const uint32_t gpioUs = GAMEPAD_READ_US;
+#endif
+    checkButton("gpio press:", gpioPin, 1, gpioUs);
+    CHECK_EQ(LATENCY_TRACE.getData().buttons[gpioPin].maxCycles, gpioUs * CYCLES_PER_US);
+
+    setGPIOButton(0, false);
+    GPIO_Btns_EXTI_IRQHandler();
+    CHECK(loopUntilReport(GPIO_BUTTONS_DEBOUNCE / FRAME_US + 2) > 0);
+    CHECK_EQ(LATENCY_TRACE.getData().buttons[gpioPin].count, 2);
+    CHECK_EQ(LATENCY_TRACE.getData().timeoutEvents, 0);
+
+    // ADC按键 1 按下后端点一直忙，超过 LATENCY_TRACE_TIMEOUT_US 才发出：计为超时，不计入直方图
+    hostUSBSetHIDReady(false);
+    adcPressed = 1U << 1;
+    CHECK(loopUntilADCChanged(4) > 0);
+    for(uint32_t i = 0; i < LATENCY_TRACE_TIMEOUT_US / FRAME_US; i++) {
+        loopOnce();
+    }
+    hostUSBSetHIDReady(true);
+    CHECK(loopOnce());
+    printf("%-22s timeout events %u\n", "adc press, timeout:", LATENCY_TRACE.getData().timeoutEvents);
+    CHECK_EQ(LATENCY_TRACE.getData().timeoutEvents, 1);
+    CHECK_EQ(LATENCY_TRACE.getData().buttons[1].count, 0);
+
+    // ADC按键 1 释放后按住 FN 再按 ADC按键 2：FN 组合键不发报告，待处理的事件计为丢弃
+    adcPressed = 0;
+    CHECK(loopUntilADCChanged(4) > 0);
+    CHECK_EQ(LATENCY_TRACE.getData().buttons[1].count, 1);
+    const uint8_t fnButton = NUM_GPIO_BUTTONS - 1;
+    CHECK_EQ(1U << gpio_btns_mapping[fnButton].virtualPin, FN_BUTTON_VIRTUAL_PIN);
+    setGPIOButton(fnButton, true);
+    GPIO_Btns_EXTI_IRQHandler();
+    adcPressed = 1U << 2;
+    const uint32_t reports = hostUSBStats().reports;
+    CHECK(loopUntilADCChanged(4) > 0);
+    CHECK_EQ(hostUSBStats().reports, reports);
+    printf("%-22s discarded events %u\n", "fn combination:", LATENCY_TRACE.getData().discardedEvents);
+    CHECK_EQ(LATENCY_TRACE.getData().discardedEvents, 2);
+    CHECK_EQ(LATENCY_TRACE.getData().buttons[2].count, 0);
+
+    printf("%u reports sent, %u rejected\n", hostUSBStats().reports, hostUSBStats().rejected);
+    return HOST_TEST_RESULT();
+}
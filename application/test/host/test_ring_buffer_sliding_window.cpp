@@ -0,0 +1,223 @@
+/*
+ * RingBufferSlidingWindow 单元测试
+ *
+ * 固定用例覆盖空窗口、回绕、multiplier、clear、相等值的单调队列、负数平均值、非2的幂窗口和 findViolationPoint；
+ * 随机用例与按定义逐项计算的参考窗口（最近 N 个值）比较平均值、最小/最大值、历史数据和索引。
+ */
+
+#include <stdio.h>
+#include <deque>
+#include <random>
+#include <algorithm>
+#include "host_check.hpp"
+#include "adc_btns/ring_buffer_sliding_window.hpp"
+
+// 按定义计算的参考窗口
+template<typename T, size_t N>
+struct ReferenceWindow {
+    std::deque<T> values;       // 最新的在末尾
+    size_t pushes = 0;
+
+    void push(T value, size_t multiplier) {
+        for(size_t i = 0; i < multiplier; i++) {
+            values.push_back(value);
+            if(values.size() > N) {
+                values.pop_front();
+            }
+            pushes++;
+        }
+    }
+
+    void clear() {
+        values.clear();
+        pushes = 0;
+    }
+
+    T average() const {
+        if(values.empty()) {
+            return T();
+        }
+        int64_t sum = 0;
+        for(const T value : values) {
+            sum += value;
+        }
+        return (T)(sum / (int64_t)values.size());
+    }
+
+    T history(size_t backSteps) const {
+        return backSteps < values.size() ? values[values.size() - 1 - backSteps] : T();
+    }
+};
+
+template<typename T, size_t N>
+static uint32_t compareRandom(uint32_t seed, uint32_t trials, int32_t minValue, int32_t maxValue) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int32_t> wide(minValue, maxValue);
+    uint32_t mismatches = 0;
+
+    for(uint32_t trial = 0; trial < trials; trial++) {
+        RingBufferSlidingWindow<T, N> window;
+        ReferenceWindow<T, N> reference;
+        const uint32_t steps = rng() % 300;
+        // 一半的试验只用很少几个不同的值，覆盖单调队列中的相等值
+        const bool fewValues = trial % 2 == 0;
+
+        for(uint32_t s = 0; s < steps; s++) {
+            if(rng() % 50 == 0) {
+                window.clear();
+                reference.clear();
+            }
+            const T value = (T)(fewValues ? minValue + (int32_t)(rng() % 4) : wide(rng));
+            const size_t multiplier = rng() % 7 == 0 ? rng() % (2 * N + 2) : 1;
+            window.push(value, multiplier);
+            reference.push(value, multiplier);
+
+            const size_t count = reference.values.size();
+            bool ok = window.getValidDataCount() == count
+                && window.getCurrentIndex() == reference.pushes % N
+                && window.getAverageValue() == reference.average();
+            if(count > 0) {
+                ok = ok && window.getMinValue() == *std::min_element(reference.values.begin(), reference.values.end())
+                    && window.getMaxValue() == *std::max_element(reference.values.begin(), reference.values.end());
+            } else {
+                ok = ok && window.getMinValue() == T() && window.getMaxValue() == T();
+            }
+            for(size_t k = 0; k < N + 2; k++) {
+                ok = ok && window.getHistoryAt(k) == reference.history(k);
+            }
+            mismatches += ok ? 0 : 1;
+        }
+    }
+    return mismatches;
+}
+
+int main() {
+    // 空窗口
+    {
+        RingBufferSlidingWindow<uint16_t, 4> window;
+        CHECK_EQ(window.getWindowSize(), 4);
+        CHECK_EQ(window.getValidDataCount(), 0);
+        CHECK_EQ(window.getAverageValue(), 0);
+        CHECK_EQ(window.getMinValue(), 0);
+        CHECK_EQ(window.getMaxValue(), 0);
+        CHECK_EQ(window.getHistoryAt(0), 0);
+        CHECK(!window.findViolationPoint([](uint16_t, uint16_t, size_t) { return true; }).found);
+    }
+
+    // 填满后回绕：最旧的值被覆盖，极值随之过期
+    {
+        RingBufferSlidingWindow<uint16_t, 4> window;
+        const uint16_t values[] = { 10, 50, 20, 30 };
+        for(const uint16_t value : values) {
+            window.push(value);
+        }
+        CHECK_EQ(window.getValidDataCount(), 4);
+        CHECK_EQ(window.getCurrentIndex(), 0);
+        CHECK_EQ(window.getAverageValue(), 27);
+        CHECK_EQ(window.getMinValue(), 10);
+        CHECK_EQ(window.getMaxValue(), 50);
+        CHECK_EQ(window.getHistoryAt(0), 30);
+        CHECK_EQ(window.getHistoryAt(3), 10);
+        CHECK_EQ(window.getHistoryAt(4), 0);
+
+        window.push(40);    // 覆盖 10
+        CHECK_EQ(window.getMinValue(), 20);
+        CHECK_EQ(window.getMaxValue(), 50);
+        window.push(25);    // 覆盖 50
+        CHECK_EQ(window.getMaxValue(), 40);
+        CHECK_EQ(window.getAverageValue(), (20 + 30 + 40 + 25) / 4);
+        CHECK_EQ(window.getHistoryAt(0), 25);
+        CHECK_EQ(window.getHistoryAt(3), 20);
+    }
+
+    // multiplier 超过窗口大小时窗口只保留该值
+    {
+        RingBufferSlidingWindow<uint16_t, 4> window;
+        window.push(7);
+        window.push(100, 9);
+        CHECK_EQ(window.getValidDataCount(), 4);
+        CHECK_EQ(window.getCurrentIndex(), 10 % 4);
+        CHECK_EQ(window.getMinValue(), 100);
+        CHECK_EQ(window.getMaxValue(), 100);
+        CHECK_EQ(window.getAverageValue(), 100);
+    }
+
+    // 相等值：最小值出队后，相等的较新值仍然是最小值
+    {
+        RingBufferSlidingWindow<uint16_t, 3> window;
+        window.push(5);
+        window.push(5);
+        window.push(9);
+        window.push(9);     // 覆盖第一个 5
+        CHECK_EQ(window.getMinValue(), 5);
+        window.push(9);     // 覆盖第二个 5
+        CHECK_EQ(window.getMinValue(), 9);
+        CHECK_EQ(window.getMaxValue(), 9);
+    }
+
+    // clear 之后从头开始
+    {
+        RingBufferSlidingWindow<uint16_t, 4> window;
+        window.push(1000, 3);
+        window.clear();
+        CHECK_EQ(window.getValidDataCount(), 0);
+        CHECK_EQ(window.getCurrentIndex(), 0);
+        CHECK_EQ(window.getAverageValue(), 0);
+        window.push(3);
+        CHECK_EQ(window.getMinValue(), 3);
+        CHECK_EQ(window.getMaxValue(), 3);
+        CHECK_EQ(window.getHistoryAt(1), 0);
+    }
+
+    // 有符号整数的平均值向零截断，浮点平均值不截断
+    {
+        RingBufferSlidingWindow<int16_t, 4> window;
+        window.push(-7);
+        window.push(-2);
+        CHECK_EQ(window.getAverageValue(), -4);
+        CHECK_EQ(window.getMinValue(), -7);
+        CHECK_EQ(window.getMaxValue(), -2);
+
+        RingBufferSlidingWindow<float, 4> floats;
+        floats.push(0.25f);
+        floats.push(0.5f);
+        CHECK(floats.getAverageValue() == 0.375f);
+    }
+
+    // 窗口大小为 1
+    {
+        RingBufferSlidingWindow<uint8_t, 1> window;
+        window.push(3);
+        window.push(8);
+        CHECK_EQ(window.getValidDataCount(), 1);
+        CHECK_EQ(window.getMinValue(), 8);
+        CHECK_EQ(window.getMaxValue(), 8);
+        CHECK_EQ(window.getHistoryAt(0), 8);
+        CHECK_EQ(window.getHistoryAt(1), 0);
+    }
+
+    // findViolationPoint 从最新的数据往回找
+    {
+        RingBufferSlidingWindow<uint16_t, 8> window;
+        const uint16_t values[] = { 100, 110, 120, 90, 130, 140 };
+        for(const uint16_t value : values) {
+            window.push(value);
+        }
+        const auto violation = window.findViolationPoint([](uint16_t current, uint16_t previous, size_t) {
+            return current < previous;
+        });
+        CHECK(violation.found);
+        CHECK_EQ(violation.index, 2);
+        CHECK_EQ(violation.value, 90);
+        CHECK_EQ(violation.prevValue, 120);
+    }
+
+    // 随机序列与参考窗口比较，包含非2的幂窗口
+    CHECK_EQ((compareRandom<uint16_t, 32>(1, 2000, 0, UINT16_MAX)), 0);
+    CHECK_EQ((compareRandom<uint16_t, 5>(2, 2000, 0, UINT16_MAX)), 0);
+    CHECK_EQ((compareRandom<int16_t, 7>(3, 2000, INT16_MIN, INT16_MAX)), 0);
+    CHECK_EQ((compareRandom<uint8_t, 1>(4, 500, 0, UINT8_MAX)), 0);
+    CHECK_EQ((compareRandom<uint32_t, 300>(5, 200, 0, INT32_MAX)), 0);
+
+    return HOST_TEST_RESULT();
+}
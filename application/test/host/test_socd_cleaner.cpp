@@ -0,0 +1,173 @@
+/*
+ * 模拟量SOCD（深度优先 / Snap Tap）的状态转换表
+ * 每行是一次扫描，按顺序执行，上一行的胜者通过 SOCDAnalogState 带到下一行；
+ * reset 行清空状态，相当于切换配置或SOCD模式。
+ * 最后按 ADCBtnsWorker::read -> Gamepad::read 驱动 Snap Tap，
+ * 左键按住超过 2^31 个DWT周期（480MHz 下约4.5秒）后再按右键，右键仍然是后按下的。
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+#include "host_check.hpp"
+#include "host_hal.hpp"
+#include "gamepad/GamepadState.hpp"
+#include "adc_btns/adc_btns_worker.hpp"
+#include "gamepad.hpp"
+#include "storagemanager.hpp"
+#include "board_cfg.h"
+
+#define MAPPING_LENGTH      36
+#define MAPPING_STEP        0.1f
+#define FRAME_US            1000
+#define LONG_HOLD_FRAMES    4600    // 4.6秒，超过 2^31 个周期
+
+enum {
+    U = GAMEPAD_MASK_UP,
+    D = GAMEPAD_MASK_DOWN,
+    L = GAMEPAD_MASK_LEFT,
+    R = GAMEPAD_MASK_RIGHT
+};
+
+struct SOCDRow {
+    const char* name;
+    SOCDMode mode;
+    uint8_t dpad;
+    uint16_t depthUp, depthDown, depthLeft, depthRight;     // 0.01mm
+    uint32_t seqUp, seqDown, seqLeft, seqRight;             // 按下序号，越大越晚
+    uint8_t expect;
+    bool reset;                                             // 执行前清空状态
+};
+
+static const SOCDRow rows[] = {
+    // 深度优先，上下轴；SOCD_DEPTH_HYSTERESIS = 10
+    { "none",                               SOCD_MODE_DEEPER_PRIORITY, 0,     0,   0,   0,   0,   0, 0, 0, 0,   0,     true  },
+    { "up only",                            SOCD_MODE_DEEPER_PRIORITY, U,     200, 0,   0,   0,   1, 0, 0, 0,   U,     false },
+    { "down joins shallower",               SOCD_MODE_DEEPER_PRIORITY, U | D, 200, 100, 0,   0,   1, 2, 0, 0,   U,     false },
+    { "down within hysteresis keeps up",    SOCD_MODE_DEEPER_PRIORITY, U | D, 200, 205, 0,   0,   1, 2, 0, 0,   U,     false },
+    { "down deeper by hysteresis",          SOCD_MODE_DEEPER_PRIORITY, U | D, 200, 210, 0,   0,   1, 2, 0, 0,   D,     false },
+    { "up back within band keeps down",     SOCD_MODE_DEEPER_PRIORITY, U | D, 215, 210, 0,   0,   1, 2, 0, 0,   D,     false },
+    { "up deeper by hysteresis",            SOCD_MODE_DEEPER_PRIORITY, U | D, 220, 210, 0,   0,   1, 2, 0, 0,   U,     false },
+    { "up released",                        SOCD_MODE_DEEPER_PRIORITY, D,     0,   210, 0,   0,   1, 2, 0, 0,   D,     false },
+    { "released",                           SOCD_MODE_DEEPER_PRIORITY, 0,     0,   0,   0,   0,   1, 2, 0, 0,   0,     false },
+    { "both same scan, equal depth",        SOCD_MODE_DEEPER_PRIORITY, U | D, 100, 100, 0,   0,   5, 5, 0, 0,   0,     false },
+    { "both released",                      SOCD_MODE_DEEPER_PRIORITY, 0,     0,   0,   0,   0,   0, 0, 0, 0,   0,     false },
+    { "both same scan, down deeper by 1",   SOCD_MODE_DEEPER_PRIORITY, U | D, 100, 101, 0,   0,   5, 5, 0, 0,   D,     false },
+    { "down keeps winning at equal depth",  SOCD_MODE_DEEPER_PRIORITY, U | D, 101, 101, 0,   0,   5, 5, 0, 0,   D,     false },
+    // 两个轴互相独立
+    { "left+right, right deeper, up alone", SOCD_MODE_DEEPER_PRIORITY, U | L | R, 100, 0, 50, 300, 0, 0, 0, 0, U | R, true  },
+    { "left deeper, down alone",            SOCD_MODE_DEEPER_PRIORITY, D | L | R, 0, 100, 320, 300, 0, 0, 0, 0, D | L, false },
+    // Snap Tap，左右轴
+    { "snap: left",                         SOCD_MODE_SNAP_TAP, L,     0, 0, 300, 0,   0, 0, 10, 0,   L,     true  },
+    { "snap: right pressed later",          SOCD_MODE_SNAP_TAP, L | R, 0, 0, 300, 50,  0, 0, 10, 20,  R,     false },
+    { "snap: left re-pressed later",        SOCD_MODE_SNAP_TAP, L | R, 0, 0, 300, 300, 0, 0, 30, 20,  L,     false },
+    { "snap: left released, right instantly", SOCD_MODE_SNAP_TAP, R,   0, 0, 0,   300, 0, 0, 30, 20,  R,     false },
+    { "snap: left pressed again",           SOCD_MODE_SNAP_TAP, L | R, 0, 0, 10,  300, 0, 0, 40, 20,  L,     false },
+    { "snap: large sequence numbers",       SOCD_MODE_SNAP_TAP, L | R, 0, 0, 10,  300, 0, 0, 0xFFFFFFF0u, 0xFFFFFFF1u, R, false },
+    // Snap Tap 同时按下时按深度判断
+    { "snap: equal seqs, depth fallback",   SOCD_MODE_SNAP_TAP, U | D, 50, 300, 0, 0, 7, 7, 0, 0,    D,     true  },
+    { "snap: equal seqs, depth hysteresis", SOCD_MODE_SNAP_TAP, U | D, 305, 300, 0, 0, 7, 7, 0, 0,  D,     false },
+    { "snap: equal seqs, equal depth",        SOCD_MODE_SNAP_TAP, U | D, 50, 50, 0, 0,   7, 7, 0, 0,   0,     true  },
+    { "snap: up pressed later",             SOCD_MODE_SNAP_TAP, U | D, 50, 50, 0, 0,   9, 7, 0, 0,   U,     false },
+};
+
+// 左键（引脚5）按下后按住 LONG_HOLD_FRAMES 帧，再按下右键（引脚6）
+static void testLongHold() {
+    uint32_t mapping[MAPPING_LENGTH];
+    for(uint8_t i = 0; i < MAPPING_LENGTH; i++) {
+        const double travel = (MAPPING_LENGTH - 1 - i) * MAPPING_STEP;
+        mapping[i] = (uint32_t)lround(1000 + 2000 * pow(travel / 3.5, 1.3));
+    }
+    hostFlashReset();
+    STORAGE_MANAGER.initConfig();
+    GamepadProfile* profile = STORAGE_MANAGER.getGamepadProfile(STORAGE_MANAGER.config.defaultProfileId);
+    profile->keysConfig.socdMode = SOCD_MODE_SNAP_TAP;
+    if(!hostInstallADCMapping(mapping, MAPPING_LENGTH, MAPPING_STEP, 2)
+        || ADC_BTNS_WORKER.setup() != ADCBtnsError::SUCCESS) {
+        printf("ADCBtnsWorker setup failed\n");
+        CHECK(false);
+        return;
+    }
+    GAMEPAD.setup();
+
+    const uint8_t left = 5, right = 6;
+    CHECK_EQ(profile->keysConfig.keyDpadLeft, 1U << left);
+    CHECK_EQ(profile->keysConfig.keyDpadRight, 1U << right);
+
+    uint32_t frame[NUM_ADC_BUTTONS];
+    uint8_t dpad = 0;
+    const uint32_t start = MICROS_TIMER.cycles();
+    auto scan = [&](const uint32_t pressed) {
+        for(uint8_t k = 0; k < NUM_ADC_BUTTONS; k++) {
+            frame[k] = (pressed & (1U << k)) ? mapping[0] : mapping[MAPPING_LENGTH - 1];
+        }
+        hostPushADCFrame(frame);
+        GAMEPAD.read(ADC_BTNS_WORKER.read());
+        dpad = GAMEPAD.state.dpad;
+        hostAdvanceMicros(FRAME_US);
+    };
+
+    // 先释放所有按键运行一段时间，初始化映射和校准
+    for(uint32_t i = 0; i < 100; i++) {
+        scan(0);
+    }
+    CHECK_EQ(dpad, 0);
+    for(uint32_t i = 0; i < LONG_HOLD_FRAMES; i++) {
+        scan(1U << left);
+    }
+    CHECK_EQ(dpad, L);
+    CHECK(MICROS_TIMER.cycles() - start > (uint32_t)INT32_MAX);
+
+    // 两个键都按下后右键胜出，并保持到右键松开
+    for(uint32_t i = 0; i < 10; i++) {
+        scan(1U << left | 1U << right);
+    }
+    CHECK_EQ(dpad, R);
+    scan(1U << left);
+    scan(1U << left);
+    CHECK_EQ(dpad, L);
+}
+
+int main() {
+    SOCDAnalogState state;
+    memset(&state, 0, sizeof(state));
+
+    CHECK_EQ(sizeof(rows) / sizeof(rows[0]), 25);
+    for(const SOCDRow& row : rows) {
+        if(row.reset) {
+            memset(&state, 0, sizeof(state));
+        }
+        const SOCDAnalogInputs inputs = {
+            { row.depthUp, row.seqUp },
+            { row.depthDown, row.seqDown },
+            { row.depthLeft, row.seqLeft },
+            { row.depthRight, row.seqRight },
+        };
+        const uint8_t result = runAnalogSOCDCleaner(row.mode, row.dpad, inputs, state);
+        if(result != row.expect) {
+            printf("row \"%s\": got 0x%x, expect 0x%x\n", row.name, result, row.expect);
+        }
+        CHECK_EQ(result, row.expect);
+    }
+
+    // GPIO按键没有按下序号，按0处理（gamepad.cpp readSOCDInputs），模拟量按键按下过就总是更晚
+    memset(&state, 0, sizeof(state));
+    const SOCDAnalogInputs gpioVsAnalog = { {}, {}, { 300, 0 }, { 20, 1 } };
+    CHECK_EQ(runAnalogSOCDCleaner(SOCD_MODE_SNAP_TAP, L | R, gpioVsAnalog, state), R);
+
+    // 两组状态互不影响：每个 Gamepad 持有自己的 SOCDAnalogState
+    SOCDAnalogState other;
+    memset(&other, 0, sizeof(other));
+    const SOCDAnalogInputs held = { { 200, 1 }, { 205, 2 }, {}, {} };
+    memset(&state, 0, sizeof(state));
+    state.lastUD = D;
+    CHECK_EQ(runAnalogSOCDCleaner(SOCD_MODE_DEEPER_PRIORITY, U | D, held, state), D);
+    CHECK_EQ(runAnalogSOCDCleaner(SOCD_MODE_DEEPER_PRIORITY, U | D, held, other), D);
+    other.lastUD = U;
+    CHECK_EQ(runAnalogSOCDCleaner(SOCD_MODE_DEEPER_PRIORITY, U | D, held, other), U);
+    CHECK_EQ(runAnalogSOCDCleaner(SOCD_MODE_DEEPER_PRIORITY, U | D, held, state), D);
+
+    testLongHold();
+
+    return HOST_TEST_RESULT();
+}
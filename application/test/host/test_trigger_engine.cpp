@@ -0,0 +1,212 @@
+/*
+ * 整数引擎与浮点引擎的判断等价性
+ *
+ * 同一个可执行文件分别链接整数引擎（ADC_BTNS_FIXED_POINT_ENGINE=1）和浮点引擎编译的按键扫描，
+ * 用固定种子生成的随机行程驱动全部按键：每个按键的精度/死区不同，行程包含慢速移动、中途反向、
+ * 越过映射两端的值和单帧跳变。浮点引擎把每帧的输出掩码写入文件，整数引擎逐帧比较。
+ *
+ * 用法：test_trigger_engine --mapping curve|linear|coarse --write <file>
+ *       test_trigger_engine --mapping curve|linear|coarse --compare <file>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <random>
+#include <vector>
+#include "host_hal.hpp"
+#include "adc_btns/adc_btns_worker.hpp"
+#include "storagemanager.hpp"
+
+#define FRAMES 60000
+#define FRAME_PERIOD_US 250
+
+struct TestMapping {
+    float step;
+    uint16_t samplingNoise;
+    std::vector<uint32_t> values;   // values[0] 为完全按下
+};
+
+static bool makeMapping(const char* name, TestMapping& mapping) {
+    size_t length;
+    if(strcmp(name, "curve") == 0) {
+        // 与 traces/gen_press_release_trace.py 相同的霍尔曲线
+        mapping.step = 0.1f;
+        mapping.samplingNoise = 2;
+        length = 36;
+        for(size_t i = 0; i < length; i++) {
+            const double travel = (length - 1 - i) * mapping.step;
+            mapping.values.push_back((uint32_t)lround(1000 + 2000 * pow(travel / 3.5, 1.3)));
+        }
+    } else if(strcmp(name, "linear") == 0) {
+        mapping.step = 0.1f;
+        mapping.samplingNoise = 0;
+        length = 36;
+        for(size_t i = 0; i < length; i++) {
+            mapping.values.push_back(30000 - (uint32_t)i * 500);
+        }
+    } else if(strcmp(name, "coarse") == 0) {
+        // 区间少、ADC值跨度小，查找表区间内的插值误差最明显
+        mapping.step = 0.5f;
+        mapping.samplingNoise = 3;
+        const uint32_t values[] = { 2900, 2710, 2420, 2210, 2090, 2030, 2008, 2000 };
+        mapping.values.assign(values, values + sizeof(values) / sizeof(values[0]));
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// 行程 travel（0 为完全释放）对应的ADC值，映射两端之外线性外推
+static uint32_t valueAt(const TestMapping& mapping, const double travel) {
+    const size_t last = mapping.values.size() - 1;
+    const double distance = last * mapping.step - travel;  // 0 为完全按下
+    double index = distance / mapping.step;
+    size_t i = index <= 0 ? 0 : std::min<size_t>((size_t)index, last - 1);
+    const double fraction = index - i;
+    const double value = mapping.values[i] + fraction * ((double)mapping.values[i + 1] - mapping.values[i]);
+    return (uint32_t)std::max(1.0, std::min(65535.0, value));
+}
+
+struct Motion {
+    double travel;
+    double velocity;    // mm/帧
+    uint32_t hold;      // 剩余静止帧数
+};
+
+int main(int argc, char** argv) {
+    const char* mappingName = nullptr;
+    const char* writePath = nullptr;
+    const char* comparePath = nullptr;
+    for(int i = 1; i + 1 < argc; i += 2) {
+        if(strcmp(argv[i], "--mapping") == 0) {
+            mappingName = argv[i + 1];
+        } else if(strcmp(argv[i], "--write") == 0) {
+            writePath = argv[i + 1];
+        } else if(strcmp(argv[i], "--compare") == 0) {
+            comparePath = argv[i + 1];
+        }
+    }
+
+    TestMapping mapping;
+    if(!mappingName || !makeMapping(mappingName, mapping) || (!writePath == !comparePath)) {
+        printf("usage: %s --mapping curve|linear|coarse --write <file> | --compare <file>\n", argv[0]);
+        return 2;
+    }
+
+    printf("engine: %s, mapping: %s\n", ADC_BTNS_FIXED_POINT_ENGINE ? "fixed point" : "float", mappingName);
+
+    std::mt19937 rng(20240611);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    hostFlashReset();
+    STORAGE_MANAGER.initConfig();
+    GamepadProfile* profile = STORAGE_MANAGER.getDefaultGamepadProfile();
+    const double maxTravel = (mapping.values.size() - 1) * mapping.step;
+    for(uint8_t k = 0; k < NUM_ADC_BUTTONS; k++) {
+        RapidTriggerProfile& trigger = profile->triggerConfigs.triggerConfigs[k];
+        trigger.pressAccuracy = (float)(0.01 + 0.5 * uniform(rng));
+        trigger.releaseAccuracy = (float)(0.01 + 0.5 * uniform(rng));
+        trigger.topDeadzone = (float)(maxTravel * 0.3 * uniform(rng));
+        trigger.bottomDeadzone = (float)(maxTravel * 0.3 * uniform(rng));
+    }
+
+    if(!hostInstallADCMapping(mapping.values.data(), mapping.values.size(), mapping.step, mapping.samplingNoise)) {
+        printf("install mapping failed\n");
+        return 2;
+    }
+    if(ADC_BTNS_WORKER.setup() != ADCBtnsError::SUCCESS) {
+        printf("ADCBtnsWorker setup failed\n");
+        return 2;
+    }
+    ADCDebounceFilter::Config debounceConfig;
+    debounceConfig.ultrafastThreshold = ULTRAFast_THRESHOLD_NONE;
+    debounceConfig.adaptive = false;
+    ADC_BTNS_WORKER.setDebounceConfig(debounceConfig);
+
+    Motion motion[NUM_ADC_BUTTONS];
+    memset(motion, 0, sizeof(motion));
+
+    std::vector<uint32_t> outputs;
+    outputs.reserve(FRAMES);
+    uint32_t edges = 0;
+    uint32_t lastOutput = 0;
+    uint32_t values[NUM_ADC_BUTTONS];
+
+    for(uint32_t n = 0; n < FRAMES; n++) {
+        for(uint8_t k = 0; k < NUM_ADC_BUTTONS; k++) {
+            Motion& m = motion[k];
+            // 第一帧用于初始化映射，保持完全释放
+            if(n > 0) {
+                if(m.hold > 0) {
+                    m.hold--;
+                } else {
+                    m.travel += m.velocity;
+                    const double r = uniform(rng);
+                    if(r < 0.02) {
+                        m.velocity = -m.velocity;                               // 中途反向
+                    } else if(r < 0.04) {
+                        m.velocity = (uniform(rng) - 0.5) * maxTravel * 0.1;    // 换速度
+                    } else if(r < 0.045) {
+                        m.hold = (uint32_t)(uniform(rng) * 50);                 // 停住
+                    }
+                    if(m.travel < -0.1 * maxTravel || m.travel > 1.1 * maxTravel) {
+                        m.velocity = -m.velocity;
+                        m.travel = std::max(-0.1 * maxTravel, std::min(1.1 * maxTravel, m.travel));
+                    }
+                }
+            }
+            int32_t value = (int32_t)valueAt(mapping, m.travel);
+            value += (int32_t)lround((uniform(rng) * 2.0 - 1.0) * mapping.samplingNoise);
+            if(n > 0 && uniform(rng) < 0.002) {
+                value += (int32_t)((uniform(rng) - 0.5) * (mapping.values.front() - mapping.values.back()) * 0.2);  // 单帧跳变
+            }
+            values[k] = (uint32_t)std::max<int32_t>(1, std::min<int32_t>(UINT16_MAX, value));
+        }
+
+        hostSetCycles(n * FRAME_PERIOD_US * (SYSTEM_CLOCK_FREQ / 1000000UL));
+        hostSetTick(n * FRAME_PERIOD_US / 1000);
+        hostPushADCFrame(values);
+        const uint32_t output = ADC_BTNS_WORKER.read();
+        edges += __builtin_popcount(output ^ lastOutput);
+        lastOutput = output;
+        outputs.push_back(output);
+    }
+
+    printf("frames %u, output edges %u\n", FRAMES, edges);
+    if(edges < FRAMES / 20) {
+        printf("FAIL: too few edges, trace does not exercise the trigger logic\n");
+        return 1;
+    }
+
+    if(writePath) {
+        FILE* file = fopen(writePath, "wb");
+        if(!file || fwrite(outputs.data(), sizeof(uint32_t), outputs.size(), file) != outputs.size()) {
+            printf("cannot write %s\n", writePath);
+            return 2;
+        }
+        fclose(file);
+        return 0;
+    }
+
+    std::vector<uint32_t> expected(FRAMES);
+    FILE* file = fopen(comparePath, "rb");
+    if(!file || fread(expected.data(), sizeof(uint32_t), expected.size(), file) != expected.size()) {
+        printf("cannot read %s\n", comparePath);
+        return 2;
+    }
+    fclose(file);
+
+    uint32_t mismatches = 0;
+    for(uint32_t n = 0; n < FRAMES; n++) {
+        if(outputs[n] != expected[n]) {
+            if(mismatches < 10) {
+                printf("frame %u: got 0x%05x, expect 0x%05x\n", n, outputs[n], expected[n]);
+            }
+            mismatches++;
+        }
+    }
+    printf("mismatched frames %u\n", mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
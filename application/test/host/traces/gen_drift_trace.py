@@ -0,0 +1,50 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+生成 drift_warmup_4h.csv：4 小时的板温和按键静止基准值偏差轨迹，每秒一行（ADC_DRIFT_SAMPLE_INTERVAL_MS）
+
+- 温度：前 2 小时从 25℃ 按时间常数 20 分钟升温约 20℃，之后按同样的时间常数回落，温度传感器噪声 σ = 0.5℃；
+- b0：基准值偏差 = 8·(T - 25) + 3（ADC值），静止采样噪声 σ = 5；
+- b0 在升温过程中被按住 20 分钟（held 位），这段时间没有静止采样，偏移只能按温度预测。
+
+o<pin> 为真实偏移，r<pin> 为静止时测得的基准值偏差，按住时 r 仍然输出但回放时忽略。
+
+用法：python3 gen_drift_trace.py > drift_warmup_4h.csv
+"""
+
+import math
+import random
+
+DURATION_S = 4 * 3600
+HEAT_S = 7200
+TAU_S = 1200.0
+RISE_C = 20.0
+SLOPE = 8.0             # ADC值/℃
+BIAS = 3.0
+RESIDUAL_NOISE = 5.0
+SENSOR_NOISE = 0.5
+HELD = (3000, 4200)
+
+
+def board_temperature(t):
+    if t < HEAT_S:
+        return 25.0 + RISE_C * (1.0 - math.exp(-t / TAU_S))
+    peak = RISE_C * (1.0 - math.exp(-HEAT_S / TAU_S))
+    return 25.0 + peak * math.exp(-(t - HEAT_S) / TAU_S)
+
+
+def main():
+    rng = random.Random(1)
+    print("# 合成温漂轨迹，由 gen_drift_trace.py 生成")
+    print("t_s,temp_c,held,o0,r0")
+    for t in range(DURATION_S):
+        temperature = board_temperature(t)
+        truth = SLOPE * (temperature - 25.0) + BIAS
+        held = 1 if HELD[0] < t < HELD[1] else 0
+        residual = int(round(truth + rng.gauss(0.0, RESIDUAL_NOISE)))
+        sensed = temperature + rng.gauss(0.0, SENSOR_NOISE)
+        print("%d,%.2f,%d,%.2f,%d" % (t, sensed, held, truth, residual))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+生成 press_release_noise.csv：两个按键的合成霍尔轨迹
+
+- b0：完整按下/释放、行程中途反向（快速触发），以及停在触发点附近的慢速按压；
+- b3：始终静止，只有采样噪声和单帧尖峰，用于统计误触发。
+
+truth 是在无噪声行程上按快速触发规则（按下精度 0.1mm，释放精度 0.1mm，顶部/底部死区 0.2mm）
+计算的理想状态，固件在有噪声的采样上应当最多晚一帧跟上，且不产生误触发。
+
+用法：python3 gen_press_release_trace.py > press_release_noise.csv
+"""
+
+import random
+
+STEP = 0.1              # mm
+TRAVEL = 3.5            # mm
+LENGTH = int(round(TRAVEL / STEP)) + 1
+REST = 1000
+FULL = 3000
+NOISE = 2               # 采样噪声幅度（ADC值）
+PERIOD_US = 250         # 帧间隔
+
+PRESS_ACC = 0.1
+RELEASE_ACC = 0.1
+TOP_DZ = 0.2
+BOTTOM_DZ = 0.2
+
+
+def value_at(travel):
+    """行程（0 为完全释放）对应的ADC值，霍尔传感器在行程末端灵敏度更高"""
+    return REST + (FULL - REST) * (travel / TRAVEL) ** 1.3
+
+
+def mapping_values():
+    # v0 为完全按下，最后一个值为完全释放
+    return [int(round(value_at((LENGTH - 1 - i) * STEP))) for i in range(LENGTH)]
+
+
+def ramp(start, end, samples):
+    return [start + (end - start) * (k + 1) / samples for k in range(samples)]
+
+
+def b0_motion():
+    path = [0.0] * 40
+    path += ramp(0.0, TRAVEL, 80) + [TRAVEL] * 40 + ramp(TRAVEL, 0.0, 80) + [0.0] * 40
+    # 中途反向：按到 2.0mm，抬起 0.6mm，再按到 2.5mm，最后释放
+    path += ramp(0.0, 2.0, 50) + ramp(2.0, 1.4, 20) + ramp(1.4, 2.5, 30) + [2.5] * 20 + ramp(2.5, 0.0, 60)
+    path += [0.0] * 40
+    # 慢速按压到底再慢速释放
+    path += ramp(0.0, TRAVEL, 300) + ramp(TRAVEL, 0.0, 300) + [0.0] * 40
+    return path
+
+
+class RapidTrigger:
+    """无噪声行程上的理想快速触发状态"""
+
+    def __init__(self):
+        self.pressed = False
+        self.limit = 0.0
+
+    def update(self, travel):
+        if not self.pressed:
+            self.limit = min(self.limit, travel)
+            if travel >= TOP_DZ and travel - self.limit >= PRESS_ACC:
+                self.pressed = True
+                self.limit = travel
+        else:
+            self.limit = max(self.limit, travel)
+            if travel <= TRAVEL - BOTTOM_DZ and self.limit - travel >= RELEASE_ACC:
+                self.pressed = False
+                self.limit = travel
+        return self.pressed
+
+
+def main():
+    rng = random.Random(1)
+    path = b0_motion()
+    rt = RapidTrigger()
+
+    print("# 合成轨迹，由 gen_press_release_trace.py 生成")
+    print("mapping,%.1f,%d,%s" % (STEP, NOISE, ",".join(str(v) for v in mapping_values())))
+    print("t_us,truth,b0,b3")
+    for n, travel in enumerate(path):
+        truth = 1 if rt.update(travel) else 0
+        v0 = int(round(value_at(travel) + rng.uniform(-NOISE, NOISE)))
+        v3 = int(round(REST + rng.uniform(-NOISE, NOISE)))
+        # 静止按键上偶尔出现单帧尖峰，幅度小于 0.1mm 对应的ADC差值
+        if n % 97 == 50:
+            v3 += 6
+        print("%d,%d,%d,%d" % (n * PERIOD_US, truth, v0, v3))
+
+
+if __name__ == "__main__":
+    main()
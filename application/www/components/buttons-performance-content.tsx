@@ -77,6 +77,10 @@ export function ButtonsPerformanceContent() {
         [ADCButtonDebounceAlgorithm.MAX, {
             label: t.SETTINGS_ADC_BUTTON_DEBOUNCE_LABEL_MAX,
             description: t.SETTINGS_ADC_BUTTON_DEBOUNCE_LABEL_MAX_DESC
+        }],
+        [ADCButtonDebounceAlgorithm.ADAPTIVE, {
+            label: t.SETTINGS_ADC_BUTTON_DEBOUNCE_LABEL_ADAPTIVE,
+            description: t.SETTINGS_ADC_BUTTON_DEBOUNCE_LABEL_ADAPTIVE_DESC
         }]
     ]);
 
@@ -392,6 +392,7 @@ const converProfileDetails = (profile: any) => {
             fourWayMode: profile.keysConfig?.fourWayMode as boolean ?? false,
             keyMapping: profile.keysConfig?.keyMapping as { [key in GameControllerButton]?: number[] } ?? {},
             keysEnableTag: profile.keysConfig?.keysEnableTag as boolean[] ?? [],
+            analogSources: profile.keysConfig?.analogSources as number[] ?? [],
         },
         ledsConfigs: {
             ledEnabled: profile.ledsConfigs?.ledEnabled as boolean ?? false,
@@ -411,6 +412,7 @@ const converProfileDetails = (profile: any) => {
         },
         hotkeys: profile.hotkeys as Hotkey[] ?? [],
         triggerConfigs: profile.triggerConfigs ?? {},
+        dksConfigs: profile.dksConfigs ?? [],
     }
     return newProfile;
 }
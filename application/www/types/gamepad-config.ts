@@ -198,7 +198,9 @@ export enum GameSocdMode {
     SOCD_MODE_SECOND_INPUT_PRIORITY = 2,    // 第二输入优先 
     SOCD_MODE_FIRST_INPUT_PRIORITY = 3,     // 第一输入优先 
     SOCD_MODE_BYPASS = 4,                   // 绕过 不做任何处理 所有dpad信号都有效
-    SOCD_MODE_NUM_MODES = 5,                // 模式数量
+    SOCD_MODE_DEEPER_PRIORITY = 5,          // 行程更深的方向优先
+    SOCD_MODE_SNAP_TAP = 6,                 // 最后按下的方向优先，松开后另一方向立即恢复
+    SOCD_MODE_NUM_MODES = 7,                // 模式数量
 }
 
 export const GameSocdModeLabelMap = new Map<GameSocdMode, { label: string, description: string }>([
@@ -222,6 +224,14 @@ export const GameSocdModeLabelMap = new Map<GameSocdMode, { label: string, descr
         label: "Bypass", 
         description: "Bypass the SOCD mode and use the first input." 
     }],
+    [GameSocdMode.SOCD_MODE_DEEPER_PRIORITY, { 
+        label: "Deeper Priority", 
+        description: "The key pressed deeper is prioritized when the two inputs are different." 
+    }],
+    [GameSocdMode.SOCD_MODE_SNAP_TAP, { 
+        label: "Snap Tap", 
+        description: "The last pressed key is prioritized, the other key takes over as soon as it is released." 
+    }],
 ]);
 
 export enum HotkeyAction {
@@ -324,6 +334,69 @@ export type Hotkey = {
     isHold?: boolean,
 }
 
+// 多点触发动作，对应固件 DKSAction
+export enum DksAction {
+    NONE = 0,
+    PRESS = 1,
+    RELEASE = 2,
+    TAP = 3,
+}
+
+export interface DksActuationPoint {
+    distance: number; // 触发点行程 mm，自顶部算起
+    virtualPin: number; // 目标虚拟引脚，-1 表示不使用
+    pressAction: DksAction;
+    releaseAction: DksAction;
+}
+
+export interface DksConfig {
+    enabled: boolean;
+    points: DksActuationPoint[];
+}
+
+// 连发/锁定模式，对应固件 TurboMode
+export enum TurboMode {
+    OFF = 0,
+    HOLD = 1, // 按住连发
+    LATCH = 2, // 按下锁定，再按解除
+    LATCH_TURBO = 3, // 锁定期间连发
+}
+
+export interface TurboConfig {
+    mode: TurboMode;
+    rate: number; // 连发频率 Hz
+}
+
+// 宏播放模式，对应固件 MacroMode
+export enum MacroMode {
+    ONCE = 0, // 按下播放一次
+    HOLD = 1, // 按住循环播放
+    TOGGLE = 2, // 按下开始循环，再按停止
+}
+
+export interface MacroStep {
+    buttons: number; // GAMEPAD_MASK_* 按键掩码
+    dpad: number; // GAMEPAD_MASK_UP/DOWN/LEFT/RIGHT 方向掩码
+    duration: number; // 持续时间 ms
+}
+
+export interface MacroConfig {
+    enabled: boolean;
+    virtualPin: number; // 触发键虚拟引脚，-1 表示不使用
+    mode: MacroMode;
+    steps: MacroStep[];
+}
+
+// /api/macros-config 和 /api/update-macros-config 的数据
+export interface MacrosConfig {
+    profileId: string;
+    maxTurboRateHz?: number;
+    maxStepDurationMs?: number;
+    numMacroSteps?: number;
+    turboConfigs: TurboConfig[]; // 按虚拟引脚索引
+    macros: MacroConfig[];
+}
+
 export interface KeysConfig {
     inputMode?: Platform;
     socdMode?: GameSocdMode;
@@ -331,6 +404,7 @@ export interface KeysConfig {
     invertYAxis?: boolean;
     fourWayMode?: boolean;
     keysEnableTag?: boolean[]; // 按键启用状态数组，对应 NUM_ADC_BUTTONS 个按键
+    analogSources?: number[]; // 模拟输出来源按键，顺序为 LT, RT, LX-, LX+, LY-, LY+, RX-, RX+, RY-, RY+，-1 表示不使用
     keyMapping?: {
         [key in GameControllerButton]?: number[];
     };
@@ -345,6 +419,7 @@ export interface GameProfile {
         debounceAlgorithm?: number;
         triggerConfigs?: RapidTriggerConfig[];
     };
+    dksConfigs?: DksConfig[]; // 多点触发配置，对应 NUM_ADC_BUTTONS 个按键
     ledsConfigs?: {
         ledEnabled: boolean;
         ledsEffectStyle: LedsEffectStyle;
@@ -432,6 +507,7 @@ export enum ADCButtonDebounceAlgorithm {
     NONE = 0,
     NORMAL = 1,
     MAX = 2,
+    ADAPTIVE = 3,
 }
 
 export const ledColorsLabel = [ "Front Color", "Back Color 1", "Back Color 2" ];
@@ -567,6 +643,8 @@ export const UI_TEXT = {
     SETTINGS_ADC_BUTTON_DEBOUNCE_LABEL_NONE_DESC: "No debounce, low latency",
     SETTINGS_ADC_BUTTON_DEBOUNCE_LABEL_NORMAL_DESC: "Balanced, increase the latency by 0.25ms",
     SETTINGS_ADC_BUTTON_DEBOUNCE_LABEL_MAX_DESC: "More stable, increase the latency by 0.5ms",
+    SETTINGS_ADC_BUTTON_DEBOUNCE_LABEL_ADAPTIVE: "Adaptive",
+    SETTINGS_ADC_BUTTON_DEBOUNCE_LABEL_ADAPTIVE_DESC: "Debounce time follows the measured noise of each key, quiet keys get no extra latency",
 
     // Hotkeys Settings
     SETTINGS_HOTKEYS_TITLE: "HOTKEYS SETTINGS",
@@ -832,6 +910,8 @@ export const UI_TEXT_ZH = {
     SETTINGS_ADC_BUTTON_DEBOUNCE_LABEL_NONE_DESC: "无防抖，延迟最低",
     SETTINGS_ADC_BUTTON_DEBOUNCE_LABEL_NORMAL_DESC: "平衡，增加0.25ms延迟",
     SETTINGS_ADC_BUTTON_DEBOUNCE_LABEL_MAX_DESC: "稳定，增加0.5ms延迟",
+    SETTINGS_ADC_BUTTON_DEBOUNCE_LABEL_ADAPTIVE: "自适应",
+    SETTINGS_ADC_BUTTON_DEBOUNCE_LABEL_ADAPTIVE_DESC: "根据每个按键实测的噪声调整防抖时间，噪声小的按键不增加延迟",
     
     // 热键设置
     SETTINGS_HOTKEYS_TITLE: "快捷键设置",
@@ -0,0 +1,149 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+STM32 HBox 主循环耗时统计解析工具
+
+读取网页配置模式下 /api/perf-stats 的返回（或保存下来的JSON文件），
+根据直方图计算各阶段的 p50/p90/p99/p99.9 耗时，并列出最近的耗时尖峰。
+
+统计数据在输入模式下采集，保存在备份SRAM中，通过热键重启进入网页配置模式后读取。
+
+用法:
+    python perf_stats_decoder.py                          # 从设备读取 http://192.168.7.1/api/perf-stats
+    python perf_stats_decoder.py --url http://192.168.7.1
+    python perf_stats_decoder.py --file perf_stats.json   # 解析保存的JSON
+    python perf_stats_decoder.py --save perf_stats.json   # 从设备读取并保存
+"""
+
+import argparse
+import json
+import sys
+import urllib.request
+from typing import Dict, List, Optional
+
+DEFAULT_DEVICE_URL = "http://192.168.7.1"
+PERF_STATS_API = "/api/perf-stats"
+PERCENTILES = [50.0, 90.0, 99.0, 99.9]
+
+
+def fetch_perf_stats(base_url: str) -> Dict:
+    """从设备读取耗时统计"""
+    url = base_url.rstrip("/") + PERF_STATS_API
+    with urllib.request.urlopen(url, timeout=5) as response:
+        return json.loads(response.read().decode("utf-8"))
+
+
+def bin_lower_cycles(bin_index: int, min_bits: int, sub_bits: int) -> int:
+    """直方图桶的下限（周期），与固件 PerfTrace::getBinLowerCycles 一致"""
+    if bin_index == 0:
+        return 0
+    k = bin_index - 1
+    msb = min_bits + (k >> sub_bits)
+    sub = k & ((1 << sub_bits) - 1)
+    return ((1 << sub_bits) + sub) << (msb - sub_bits)
+
+
+def percentile_cycles(histogram: List[int], percent: float, max_cycles: int,
+                      min_bits: int, sub_bits: int) -> int:
+    """根据直方图计算百分位耗时，返回所在桶的上限"""
+    total = sum(histogram)
+    if total == 0:
+        return 0
+    target = total * percent / 100.0
+    accumulated = 0
+    for index, count in enumerate(histogram):
+        accumulated += count
+        if accumulated >= target:
+            if index == len(histogram) - 1:
+                return max_cycles
+            return min(bin_lower_cycles(index + 1, min_bits, sub_bits), max_cycles)
+    return max_cycles
+
+
+def format_us(cycles: float, cycles_per_us: int) -> str:
+    return f"{cycles / cycles_per_us:10.2f}"
+
+
+def print_report(data: Dict, show_histogram: Optional[str]) -> None:
+    if not data.get("enabled", False):
+        print("固件未开启 PERF_TRACE_ENABLED")
+        return
+    if not data.get("valid", False):
+        print("备份SRAM中没有有效的统计数据（输入模式下运行后再通过热键进入网页配置模式）")
+        return
+
+    cycles_per_us = data["cyclesPerUs"]
+    min_bits = data["histogramMinBits"]
+    sub_bits = data["histogramSubBits"]
+
+    header = f"{'stage':<18}{'count':>12}{'min':>11}{'avg':>11}"
+    for p in PERCENTILES:
+        header += f"{'p' + format(p, 'g'):>11}"
+    header += f"{'max':>11}"
+    print("单位: us")
+    print(header)
+    print("-" * len(header))
+
+    for stage in data["stages"]:
+        histogram = stage["histogram"]
+        line = f"{stage['name']:<18}{stage['count']:>12}"
+        line += format_us(stage["minCycles"], cycles_per_us) + " "
+        line += format_us(stage["avgCycles"], cycles_per_us) + " "
+        for p in PERCENTILES:
+            line += format_us(percentile_cycles(histogram, p, stage["maxCycles"], min_bits, sub_bits),
+                              cycles_per_us) + " "
+        line += format_us(stage["maxCycles"], cycles_per_us)
+        print(line)
+
+    spikes = data.get("spikes", [])
+    print()
+    print(f"耗时尖峰: 共 {data.get('spikeCount', 0)} 次，最近 {len(spikes)} 次:")
+    for spike in spikes:
+        print(f"  tick={spike['tick']:>10} ms  {spike['stage']:<18}{spike['cycles'] / cycles_per_us:10.2f} us")
+
+    if show_histogram:
+        for stage in data["stages"]:
+            if stage["name"] != show_histogram:
+                continue
+            print()
+            print(f"{show_histogram} 直方图:")
+            total = max(sum(stage["histogram"]), 1)
+            for index, count in enumerate(stage["histogram"]):
+                if count == 0:
+                    continue
+                lower = bin_lower_cycles(index, min_bits, sub_bits) / cycles_per_us
+                bar = "#" * max(1, int(count * 50 / total))
+                print(f"  >= {lower:10.2f} us {count:>10}  {bar}")
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description="解析 /api/perf-stats 主循环耗时统计")
+    parser.add_argument("--url", default=DEFAULT_DEVICE_URL, help="设备地址")
+    parser.add_argument("--file", help="解析保存的JSON文件，而不是从设备读取")
+    parser.add_argument("--save", help="把从设备读取的原始JSON保存到文件")
+    parser.add_argument("--histogram", help="打印指定阶段的直方图，例如 adcRead")
+    args = parser.parse_args()
+
+    try:
+        if args.file:
+            with open(args.file, "r", encoding="utf-8") as f:
+                response = json.load(f)
+        else:
+            response = fetch_perf_stats(args.url)
+            if args.save:
+                with open(args.save, "w", encoding="utf-8") as f:
+                    json.dump(response, f, indent=2)
+    except Exception as e:
+        print(f"读取耗时统计失败: {e}")
+        return 1
+
+    if response.get("errNo", 0) != 0:
+        print(f"设备返回错误: {response.get('errorMessage', response.get('errNo'))}")
+        return 1
+
+    print_report(response.get("data", {}), args.histogram)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())